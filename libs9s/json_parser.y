@@ -44,15 +44,19 @@ int json_error(S9sJsonParseContext &context, const char *c);
 %type <mval> json_object
 %type <lval> json_literal_list
 
-%destructor { delete $$; } <vval>
-%destructor { delete $$; } <mval>
-%destructor { delete $$; } <lval>
+/*
+ * All the values are allocated in the arena of the context, we only need to
+ * call the destructors here, the memory is released with the arena.
+ */
+%destructor { context.m_arena.destroy($$); } <vval>
+%destructor { context.m_arena.destroy($$); } <mval>
+%destructor { context.m_arena.destroy($$); } <lval>
 
 %%
 json_string
     : json_object { 
             context.setValues($1);
-            delete $1;
+            context.m_arena.destroy($1);
         }
     ;
 
@@ -67,22 +71,22 @@ json_map
     ;
 
 json_opt_value_list
-    :                  { $$ = new S9sVariantMap; }
+    :                  { $$ = context.m_arena.create<S9sVariantMap>(); }
     | json_value_list  { $$ = $1; }
     ;
 
 json_value_list
     : JSON_STRING ':' literal {
-            $$ = new S9sVariantMap;
-            (*$$)[$1->toString()] = *$3;
-            delete $1;
-            delete $3;
+            $$ = context.m_arena.create<S9sVariantMap>();
+            (*$$)[$1->toString()] = std::move(*$3);
+            context.m_arena.destroy($1);
+            context.m_arena.destroy($3);
         }
     | json_value_list ',' JSON_STRING ':' literal {
             $$ = $1;
-            (*$$)[$3->toString()] = *$5;
-            delete $3;
-            delete $5;
+            (*$$)[$3->toString()] = std::move(*$5);
+            context.m_arena.destroy($3);
+            context.m_arena.destroy($5);
         }
     ;
 
@@ -93,21 +97,29 @@ literal
     | JSON_BOOLEAN
     | JSON_DOUBLE
     | json_map {
-            $$ = new S9sVariant((S9sVariantMap &) *$1);
-            delete $1;
+            $$ = context.m_arena.create<S9sVariant>(std::move(*$1));
+            context.m_arena.destroy($1);
         }
     | '[' json_literal_list ']' {
-            $$ = new S9sVariant((S9sVariantList &) *$2);
-            delete $2;
+            $$ = context.m_arena.create<S9sVariant>(std::move(*$2));
+            context.m_arena.destroy($2);
         }
     | '[' ']' {
-            $$ = new S9sVariant(S9sVariantList());
+            $$ = context.m_arena.create<S9sVariant>(S9sVariantList());
         }
     ;
 
 json_literal_list
-    : literal { $$ = new S9sVariantList; $$->push_back(*$1); delete $1; }
-    | json_literal_list ',' literal {$$ = $1; $$->push_back(*$3); delete $3; }
+    : literal {
+            $$ = context.m_arena.create<S9sVariantList>();
+            $$->push_back(std::move(*$1));
+            context.m_arena.destroy($1);
+        }
+    | json_literal_list ',' literal {
+            $$ = $1;
+            $$->push_back(std::move(*$3));
+            context.m_arena.destroy($3);
+        }
     ;
 %%
 
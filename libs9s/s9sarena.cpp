@@ -0,0 +1,129 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9sarena.h"
+
+#include <cstdlib>
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+/**
+ * Every block is aligned to this boundary, so any object can be placed into
+ * the arena.
+ */
+#define ARENA_ALIGNMENT 16
+
+std::atomic<ulonglong> S9sArena::sm_totalAllocations(0ull);
+
+S9sArena::S9sArena(
+        const size_t slabSize) :
+    m_slabSize(slabSize),
+    m_current(NULL),
+    m_remaining(0),
+    m_nAllocations(0),
+    m_bytesUsed(0)
+{
+}
+
+S9sArena::~S9sArena()
+{
+    reset();
+}
+
+/**
+ * \param size The number of bytes needed.
+ * \returns A new, properly aligned block of memory that remains valid until
+ *   the arena is reset or destroyed.
+ *
+ * Requests that are bigger than the slab size get a slab of their own, so the
+ * arena can hold any objects.
+ */
+void *
+S9sArena::allocate(
+        const size_t size)
+{
+    size_t alignedSize = 
+        (size + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1);
+    void  *retval;
+
+    if (alignedSize == 0)
+        alignedSize = ARENA_ALIGNMENT;
+
+    if (alignedSize > m_remaining)
+        addSlab(alignedSize > m_slabSize ? alignedSize : m_slabSize);
+
+    retval       = m_current;
+    m_current   += alignedSize;
+    m_remaining -= alignedSize;
+
+    ++m_nAllocations;
+    m_bytesUsed += alignedSize;
+
+    return retval;
+}
+
+/**
+ * Releases all the memory the arena holds in one step. The destructors of the
+ * objects are not called, all the objects that need destruction should be
+ * destroyed before the arena is reset.
+ */
+void
+S9sArena::reset()
+{
+    sm_totalAllocations += m_nAllocations;
+
+    for (size_t idx = 0u; idx < m_slabs.size(); ++idx)
+        free(m_slabs[idx]);
+
+    S9S_DEBUG("%u allocations, %u bytes, %u slabs", 
+            (uint) m_nAllocations, (uint) m_bytesUsed, (uint) m_slabs.size());
+
+    m_slabs.clear();
+    m_current      = NULL;
+    m_remaining    = 0;
+    m_nAllocations = 0;
+    m_bytesUsed    = 0;
+}
+
+/**
+ * \returns The number of allocations all the arenas of the process made
+ *   before they were reset. The RPC statistics use this to see how many
+ *   allocations the parsing of the replies needed.
+ */
+ulonglong
+S9sArena::totalAllocations()
+{
+    return sm_totalAllocations;
+}
+
+void
+S9sArena::addSlab(
+        const size_t size)
+{
+    char *slab = (char *) malloc(size);
+
+    if (slab == NULL)
+        throw std::bad_alloc();
+
+    m_slabs.push_back(slab);
+    m_current   = slab;
+    m_remaining = size;
+}
@@ -0,0 +1,98 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sGlobal"
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * A monotonic memory arena. Memory is taken from big slabs by simply moving a
+ * pointer forward, individual blocks are never freed, the slabs are all
+ * released at once when the arena is reset or destroyed.
+ *
+ * The JSON parser uses one arena for every reply it parses: the token values
+ * and the partially built maps and lists only live while the parser is
+ * running, so instead of a malloc()/free() pair for each of them they are all
+ * dropped together when the parsing is finished.
+ *
+ * The objects created in the arena are not allowed to escape from it, the
+ * values that should outlive the arena has to be moved into objects that are
+ * allocated in the usual way (see S9sVariant's move constructors).
+ */
+class S9sArena
+{
+    public:
+        S9sArena(const size_t slabSize = 64 * 1024);
+        virtual ~S9sArena();
+
+        void *allocate(const size_t size);
+
+        /**
+         * Creates a new object in the arena. The memory of the object is
+         * released when the arena is reset, the destructor however is only
+         * called by destroy().
+         */
+        template <typename T, typename... Args>
+        T *create(Args&&... args)
+        {
+            return new (allocate(sizeof(T))) T(std::forward<Args>(args)...);
+        };
+
+        /**
+         * Calls the destructor of an object that was created by create(). The
+         * memory of the object is not reused, it is released together with
+         * the slabs.
+         */
+        template <typename T>
+        void destroy(T *object)
+        {
+            if (object != NULL)
+                object->~T();
+        };
+
+        void reset();
+
+        size_t nSlabs() const { return m_slabs.size(); };
+        size_t nAllocations() const { return m_nAllocations; };
+        size_t bytesUsed() const { return m_bytesUsed; };
+
+        static ulonglong totalAllocations();
+
+    private:
+        S9sArena(const S9sArena &);
+        S9sArena &operator=(const S9sArena &);
+
+        void addSlab(const size_t size);
+
+    private:
+        std::vector<char *>  m_slabs;
+        size_t               m_slabSize;
+        char                *m_current;
+        size_t               m_remaining;
+        size_t               m_nAllocations;
+        size_t               m_bytesUsed;
+
+        static std::atomic<ulonglong> sm_totalAllocations;
+};
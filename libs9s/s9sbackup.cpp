@@ -421,10 +421,28 @@ S9sBackup::isCompressed() const
 int 
 S9sBackup::nBackups() const
 {
-    if (m_properties.contains("backup"))
-        return m_properties.at("backup").size();
+    return (int) backups().size();
+}
 
-    return 0;
+/**
+ * \returns The list of backups the object contains. The reference points into
+ *   the properties of the backup object, so the list is not copied.
+ */
+const S9sVariantList &
+S9sBackup::backups() const
+{
+    return m_properties.valueByPath("backup").toVariantList();
+}
+
+/**
+ * \returns The list of files the given backup contains without copying the
+ *   list.
+ */
+const S9sVariantList &
+S9sBackup::files(
+        const int backupIndex) const
+{
+    return backupMap(backupIndex).valueByPath("files").toVariantList();
 }
 
 S9sString
@@ -432,12 +450,10 @@ S9sBackup::databaseNamesAsString(
         const int        backupIndex,
         const S9sString &delimiter) const
 {
-    S9sVariantMap   theMap = backupMap(backupIndex);
-    S9sVariantList  theList;
-    S9sString       retval;
-
-    if (theMap.contains("database_names"))
-        theList = theMap.at("database_names").toVariantList();
+    const S9sVariantMap  &theMap = backupMap(backupIndex);
+    const S9sVariantList &theList = 
+        theMap.valueByPath("database_names").toVariantList();
+    S9sString             retval;
 
     for (uint idx = 0u; idx < theList.size(); ++idx)
     {
@@ -457,12 +473,7 @@ int
 S9sBackup::nFiles(
         const int backupIndex) const
 {
-    S9sVariantMap theMap = backupMap(backupIndex);
-
-    if (theMap.contains("files"))
-        return theMap.at("files").size();
-
-    return 0;
+    return (int) files(backupIndex).size();
 }
 
 /**
@@ -473,7 +484,7 @@ S9sBackup::fileName(
         const int backupIndex,
         const int fileIndex) const
 {
-    S9sVariantMap theFileMap = fileMap(backupIndex, fileIndex);
+    const S9sVariantMap &theFileMap = fileMap(backupIndex, fileIndex);
 
     if (theFileMap.contains("path"))
         return theFileMap.at("path").toString();
@@ -505,7 +516,7 @@ S9sBackup::fileSize(
         const int backupIndex,
         const int fileIndex) const
 {
-    S9sVariantMap theFileMap = fileMap(backupIndex, fileIndex);
+    const S9sVariantMap &theFileMap = fileMap(backupIndex, fileIndex);
 
     if (theFileMap.contains("size"))
         return theFileMap.at("size");
@@ -525,7 +536,7 @@ S9sBackup::fileCreated(
         const int backupIndex,
         const int fileIndex) const
 {
-    S9sVariantMap theFileMap = fileMap(backupIndex, fileIndex);
+    const S9sVariantMap &theFileMap = fileMap(backupIndex, fileIndex);
 
     if (theFileMap.contains("created"))
         return theFileMap.at("created");
@@ -558,7 +569,7 @@ S9sBackup::incremental(
         const int backupIndex,
         const int fileIndex) const
 {
-    S9sVariantMap theFileMap = fileMap(backupIndex, fileIndex);
+    const S9sVariantMap &theFileMap = fileMap(backupIndex, fileIndex);
 
     if (theFileMap.contains("type"))
         return theFileMap.at("type").toString() == "incr";
@@ -905,36 +916,29 @@ S9sBackup::toString(
     return retval;
 }
 
-S9sVariantMap
+const S9sVariantMap &
 S9sBackup::fileMap(
         const int backupIndex,
         const int fileIndex) const
 {
-    S9sVariantMap  theBackupMap = backupMap(backupIndex);
-    S9sVariantList theFileList;
-
-    if (theBackupMap.contains("files"))
-        theFileList = theBackupMap.at("files").toVariantList();
+    const S9sVariantList &theFileList = files(backupIndex);
 
     if (fileIndex >= 0 && fileIndex < (int) theFileList.size())
         return theFileList[fileIndex].toVariantMap();
 
-    return S9sVariantMap();
+    return S9sVariant::sm_emptyMap;
 }
 
-S9sVariantMap
+const S9sVariantMap &
 S9sBackup::backupMap(
         const int backupIndex) const
 {
-    S9sVariant backups;
+    const S9sVariantList &theList = backups();
 
-    if (m_properties.contains("backup"))
-        backups = m_properties.at("backup");
-
-    if (backupIndex >= 0 && backupIndex < backups.size())
-        return backups[backupIndex].toVariantMap();
+    if (backupIndex >= 0 && backupIndex < (int) theList.size())
+        return theList[backupIndex].toVariantMap();
     
-    return S9sVariantMap();
+    return S9sVariant::sm_emptyMap;
 }
 
 
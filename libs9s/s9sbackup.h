@@ -76,6 +76,8 @@ class S9sBackup
          * Properties by actual backups and files.
          */
         int nBackups() const;
+        const S9sVariantList &backups() const;
+        const S9sVariantList &files(const int backupIndex) const;
 
         S9sString databaseNamesAsString(
                 const int        backupIndex,
@@ -124,8 +126,12 @@ class S9sBackup
     private:
         S9sVariant configValue(const S9sString &key) const;
         S9sVariant config() const;
-        S9sVariantMap backupMap(const int backupIndex) const;
-        S9sVariantMap fileMap(const int backupIndex, const int fileIndex) const;
+        const S9sVariantMap &backupMap(const int backupIndex) const;
+
+        const S9sVariantMap &
+            fileMap(
+                const int backupIndex, 
+                const int fileIndex) const;
 
     private:
         S9sVariantMap    m_properties;
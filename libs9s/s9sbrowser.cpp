@@ -204,15 +204,15 @@ S9sBrowser::printLine(
     int         column1;
     int         column2;
     int         column3;
-    S9sFormat   header1Format(header, normal);
-    S9sFormat   header2Format(header, normal);
-    S9sFormat   header3Format(header, normal);
-    S9sFormat   header4Format(header, normal);
+    S9sFormat   header1Format(header, normal, m_output);
+    S9sFormat   header2Format(header, normal, m_output);
+    S9sFormat   header3Format(header, normal, m_output);
+    S9sFormat   header4Format(header, normal, m_output);
     
-    S9sFormat   column1Format;
-    S9sFormat   column2Format;
-    S9sFormat   column3Format;
-    S9sFormat   column4Format;
+    S9sFormat   column1Format(m_output);
+    S9sFormat   column2Format(m_output);
+    S9sFormat   column3Format(m_output);
+    S9sFormat   column4Format(m_output);
 
     // "Name"
     header1Format.setCenterJustify();
@@ -243,7 +243,7 @@ S9sBrowser::printLine(
     column3 = column2 + 10;
 
     m_nChars = 0;
-    ::printf("%s", normal);
+    ::fprintf(m_output, "%s", normal);
     if (lineIndex == 0)
     {
         printChar("╔");
@@ -254,9 +254,9 @@ S9sBrowser::printLine(
         {
             if (m_nChars == column1 || 
                     m_nChars == column2 || m_nChars == column3)
-                ::printf("╤"); 
+                ::fprintf(m_output, "╤"); 
             else
-                ::printf("═");
+                ::fprintf(m_output, "═");
 
             ++m_nChars;
         }
@@ -264,20 +264,20 @@ S9sBrowser::printLine(
         printChar("╗");
     } else if (lineIndex == 1) 
     {
-        ::printf("║");
+        ::fprintf(m_output, "║");
    
         header1Format.printf("Name");
-        ::printf("│"); 
+        ::fprintf(m_output, "│"); 
         
         header2Format.printf("User");
-        ::printf("│"); 
+        ::fprintf(m_output, "│"); 
         
         header3Format.printf("Group");
-        ::printf("│"); 
+        ::fprintf(m_output, "│"); 
         
         header4Format.printf("Mode");
 
-        ::printf("║");
+        ::fprintf(m_output, "║");
     } else if (lineIndex == height() - 1)
     {
         // Last line, frame.
@@ -294,9 +294,9 @@ S9sBrowser::printLine(
                     m_nChars == column2 || 
                     m_nChars == column3)
             {
-                ::printf("┴"); 
+                ::fprintf(m_output, "┴"); 
             } else {
-                ::printf("─");
+                ::fprintf(m_output, "─");
             }
 
             ++m_nChars;
@@ -355,48 +355,48 @@ S9sBrowser::printLine(
         }
 
 
-        ::printf("║");
+        ::fprintf(m_output, "║");
 
         if (selected)
-            ::printf("%s", selection);
+            ::fprintf(m_output, "%s", selection);
         else if (node.isFolder())
-            ::printf("%s", folder);
+            ::fprintf(m_output, "%s", folder);
         else if (node.isDevice())
-            ::printf("%s", deviceColor);
+            ::fprintf(m_output, "%s", deviceColor);
         else if (node.isFile() && node.isExecutable())
-            ::printf("%s", execColor);
+            ::fprintf(m_output, "%s", execColor);
         else if (false && node.isUser())
-            ::printf("%s", user);
+            ::fprintf(m_output, "%s", user);
         else if (false && node.isGroup())
-            ::printf("%s", groupColor);
+            ::fprintf(m_output, "%s", groupColor);
         else if (false && node.isFile())
-            ::printf("%s", file);
+            ::fprintf(m_output, "%s", file);
         else if (false && node.isCluster())
-            ::printf("%s", cluster);
+            ::fprintf(m_output, "%s", cluster);
         else if (false && node.isNode())
-            ::printf("%s", hostColor);
+            ::fprintf(m_output, "%s", hostColor);
 
         column1Format.printf(name);
         
         if (selected)
-            ::printf("%s%s", TERM_NORMAL, selection);
+            ::fprintf(m_output, "%s%s", TERM_NORMAL, selection);
         else
-            ::printf("%s%s", TERM_NORMAL, normal);
+            ::fprintf(m_output, "%s%s", TERM_NORMAL, normal);
 
-        ::printf("│"); 
+        ::fprintf(m_output, "│"); 
         
         column2Format.printf(owner);
-        ::printf("│"); 
+        ::fprintf(m_output, "│"); 
         
         column3Format.printf(group);
-        ::printf("│"); 
+        ::fprintf(m_output, "│"); 
         
         column4Format.printf(mode);
         
         //if (selected)
-        ::printf("%s%s", TERM_NORMAL, normal);
+        ::fprintf(m_output, "%s%s", TERM_NORMAL, normal);
 
-        ::printf("║");
+        ::fprintf(m_output, "║");
     }
 }
 
@@ -413,7 +413,7 @@ S9sBrowser::printString(
     if ((int)theString.length() > availableChars)
         myString.resize(availableChars);
 
-    ::printf("%s", STR(myString));
+    ::fprintf(m_output, "%s", STR(myString));
     m_nChars += myString.length();
 }
 
@@ -421,7 +421,7 @@ void
 S9sBrowser::printChar(
         int c)
 {
-    ::printf("%c", c);
+    ::fprintf(m_output, "%c", c);
     ++m_nChars;
 }
 
@@ -429,7 +429,7 @@ void
 S9sBrowser::printChar(
         const char *c)
 {
-    ::printf("%s", c);
+    ::fprintf(m_output, "%s", c);
     ++m_nChars;
 }
 
@@ -440,7 +440,7 @@ S9sBrowser::printChar(
 {
     while (m_nChars < lastColumn)
     {
-        ::printf("%s", c);
+        ::fprintf(m_output, "%s", c);
         ++m_nChars;
     }
 }
@@ -35,7 +35,11 @@
 #include "S9sMonitor"
 #include "S9sCalc"
 #include "S9sCommander"
+#include "S9sLogPageReader"
+#include "S9sReplicationTopology"
+#include "S9sRpcStats"
 
+#include <algorithm>
 #include <stdio.h>
 #include <unistd.h>
 #include <sys/types.h>
@@ -44,6 +48,11 @@
 //#define WARNING
 #include "s9sdebug.h"
 
+/*
+ * How many log entries are requested in one page when the log is streamed.
+ */
+#define LOG_PAGE_SIZE 1000
+
 /**
  * This method will execute whatever is requested by the user in the command
  * line.
@@ -1195,6 +1204,9 @@ S9sBusinessLogic::execute()
             client.getClusters(true, false);
             reply = client.reply();
             reply.printReplicationList();
+        } else if (options->isWatchRequested())
+        {
+            executeReplicationWatch(client);
         } else if (options->isStopRequested())
         {
             success = client.stopSlave();
@@ -1229,6 +1241,9 @@ S9sBusinessLogic::execute()
     } else {
         PRINT_ERROR("Unknown operation.");
     }
+
+    // The reply of the last request is printed by now.
+    S9sRpcStats::printingFinished();
 }
 
 /**
@@ -1981,6 +1996,12 @@ S9sBusinessLogic::executeLogList(
     S9sRpcReply reply;
     bool        success;
 
+    if (options->isStreamRequested() && !options->hasMessageId())
+    {
+        executeLogStream(client, 0);
+        return;
+    }
+
     success = client.getLog();
     client.setExitStatus();
 
@@ -2018,6 +2039,12 @@ S9sBusinessLogic::executeJobLog(
     int         jobId     = options->jobId();
     bool        success;
 
+    if (options->isStreamRequested())
+    {
+        executeLogStream(client, jobId);
+        return;
+    }
+
     success = client.getJobLog(jobId, options->limit(), options->offset());
     if (success)
     {
@@ -2039,6 +2066,137 @@ S9sBusinessLogic::executeJobLog(
     }
 }
 
+/**
+ * \param client A client for the communication.
+ * \param jobId The ID of the job to print the messages of or 0 to print the
+ *   cmon log.
+ *
+ * Prints the log messages from the oldest to the newest page by page, so the
+ * memory needed does not depend on the size of the log. While one page is
+ * printed the next one is already downloaded in the background on a separate
+ * connection.
+ */
+void
+S9sBusinessLogic::executeLogStream(
+        S9sRpcClient &client,
+        const int     jobId)
+{
+    S9sOptions       *options  = S9sOptions::instance();
+    int               limit    = options->limit();
+    int               offset   = options->offset();
+    int               nPrinted = 0;
+    int               pageSize;
+    S9sLogPageReader  reader1(client, jobId);
+    S9sLogPageReader  reader2(client, jobId);
+    S9sLogPageReader *current  = &reader1;
+    S9sLogPageReader *next     = &reader2;
+    S9sRpcReply       reply;
+
+    pageSize = limit > 0 && limit < LOG_PAGE_SIZE ? limit : LOG_PAGE_SIZE;
+    current->startRead(offset, pageSize);
+
+    for (;;)
+    {
+        int  nEntries;
+        bool lastPage;
+
+        if (!current->waitRead())
+        {
+            PRINT_ERROR("%s", STR(current->errorString()));
+            options->setExitStatus(S9sOptions::Failed);
+            break;
+        }
+
+        reply = current->reply();
+        if (!reply.isOk())
+        {
+            if (options->isJsonRequested())
+                reply.printJsonFormat();
+            else
+                PRINT_ERROR("%s", STR(reply.errorString()));
+
+            options->setExitStatus(S9sOptions::Failed);
+            break;
+        }
+
+        nEntries  = current->nEntries();
+        nPrinted += nEntries;
+        offset   += nEntries;
+        lastPage  = nEntries < pageSize || (limit > 0 && nPrinted >= limit);
+
+        if (!lastPage)
+        {
+            if (limit > 0 && limit - nPrinted < pageSize)
+                pageSize = limit - nPrinted;
+
+            next->startRead(offset, pageSize);
+        }
+
+        if (jobId > 0)
+            reply.printJobLog();
+        else
+            reply.printLogList(true);
+
+        fflush(stdout);
+
+        if (lastPage)
+            break;
+
+        std::swap(current, next);
+    }
+}
+
+/**
+ * \param client A client for the communication.
+ *
+ * Executes the "s9s replication --watch" command: the replication links are
+ * requested periodically and printed with the history of their lag. The
+ * topology is kept between the refreshes, it holds the lag samples.
+ */
+void
+S9sBusinessLogic::executeReplicationWatch(
+        S9sRpcClient &client)
+{
+    S9sOptions             *options = S9sOptions::instance();
+    S9sReplicationTopology  topology;
+    bool                    syntaxHighlight = options->useSyntaxHighlight();
+
+    for (;;)
+    {
+        S9sRpcReply reply;
+        S9sDateTime now = S9sDateTime::currentDateTime();
+        bool        success;
+
+        success = client.getClusters(true, false);
+        reply   = client.reply();
+
+        if (!success || !reply.isOk())
+        {
+            client.printMessages("", false);
+            client.setExitStatus();
+            return;
+        }
+
+        topology.build(reply.clusters());
+
+        if (syntaxHighlight)
+            printf("%s%s", TERM_HOME, TERM_CLEAR_SCREEN);
+
+        if (!options->isBatchRequested())
+        {
+            printf("Replication lag at %s, refreshed every %ds.\n\n", 
+                    STR(now.toString(S9sDateTime::LongTimeFormat)), 
+                    options->updateFreq());
+        }
+
+        reply.printReplicationLagList(topology);
+        S9sRpcStats::printingFinished();
+        fflush(stdout);
+
+        sleep(options->updateFreq());
+    }
+}
+
 /**
  * This method should be called when we sent a request that supposed to create a
  * new job. If a new job is indeed created this will take care of monitoring the
@@ -95,6 +95,12 @@ class S9sBusinessLogic
         void executeLogList(S9sRpcClient &client);
         void executeJobLog(S9sRpcClient &client);
 
+        void executeLogStream(
+                S9sRpcClient &client,
+                const int     jobId);
+
+        void executeReplicationWatch(S9sRpcClient &client);
+
         void executeDropCluster(S9sRpcClient &client);
 
         void executeMaintenanceCreate(S9sRpcClient &client);
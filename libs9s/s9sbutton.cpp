@@ -47,6 +47,6 @@ S9sButton::~S9sButton()
 void 
 S9sButton::print() const
 {
-    ::printf("[%s]", STR(m_labelText));
+    ::fprintf(m_output, "[%s]", STR(m_labelText));
 }
 
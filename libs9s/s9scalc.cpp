@@ -192,6 +192,17 @@ S9sCalc::processButton(
     return S9sDisplay::processButton(button, x, y);
 }
 
+/**
+ * \param output The stream where the screen is painted.
+ */
+void
+S9sCalc::setOutput(
+        FILE *output)
+{
+    S9sDisplay::setOutput(output);
+    m_formulaEntry.setOutput(output);
+}
+
 /**
  * \returns True if the program should continue refreshing the screen, false to
  *   exit.
@@ -202,7 +213,7 @@ S9sCalc::processButton(
 bool
 S9sCalc::refreshScreen()
 {
-    printf("%s", TERM_CURSOR_OFF);
+    ::fprintf(m_output, "%s", TERM_CURSOR_OFF);
 
     startScreen();
     printHeader();
@@ -212,7 +223,7 @@ S9sCalc::refreshScreen()
     printNewLine();
     
     m_spreadsheet.setScreenSize(width(), height() - 4);
-    m_spreadsheet.print();
+    m_spreadsheet.print(m_output);
     //printMiddle();
 
     printFooter();
@@ -235,10 +246,10 @@ S9sCalc::printHeader()
     if (!spreadsheetName().empty())
         title = spreadsheetName();
 
-    ::printf("%s%s%s ", bold, STR(title), normal);
-    ::printf("%s ", STR(dt.toString(S9sDateTime::LongTimeFormat)));
-    ::printf("0x%08x ",      lastKeyCode());
-    ::printf("%02dx%02d ",   width(), height());
+    ::fprintf(m_output, "%s%s%s ", bold, STR(title), normal);
+    ::fprintf(m_output, "%s ", STR(dt.toString(S9sDateTime::LongTimeFormat)));
+    ::fprintf(m_output, "0x%08x ",      lastKeyCode());
+    ::fprintf(m_output, "%02dx%02d ",   width(), height());
 
     printNewLine();
     
@@ -254,22 +265,22 @@ S9sCalc::printFooter()
     //const char *bold   = TERM_SCREEN_TITLE_BOLD;
     const char *normal = TERM_SCREEN_TITLE;
 
-    ::printf("%s ", normal);
+    ::fprintf(m_output, "%s ", normal);
 
     if (!m_errorString.empty())
     {
-        ::printf("%s", STR(m_errorString));
+        ::fprintf(m_output, "%s", STR(m_errorString));
     } else if (!warning.empty()) 
     {
-        ::printf("%s", STR(warning));
+        ::fprintf(m_output, "%s", STR(warning));
     } else {
-        ::printf("ok");
+        ::fprintf(m_output, "ok");
     }
         
     // No new-line at the end, this is the last line.
-    ::printf("%s", TERM_ERASE_EOL);
-    ::printf("%s", TERM_NORMAL);
-    fflush(stdout);    
+    ::fprintf(m_output, "%s", TERM_ERASE_EOL);
+    ::fprintf(m_output, "%s", TERM_NORMAL);
+    fflush(m_output);    
 }
 
 /**
@@ -38,6 +38,7 @@ class S9sCalc :
         virtual bool processButton(uint button, uint x, uint y);
 
         void main();
+        virtual void setOutput(FILE *output);
 
     protected:
         virtual bool refreshScreen();
@@ -583,16 +583,13 @@ S9sCluster::cpuUsagePercent() const
 S9sVector<S9sNode>
 S9sCluster::nodes() const
 {
-    S9sVector<S9sNode> retval;
-    S9sVariantList     variantList;
-    
-    if (m_properties.contains("hosts"))
-        variantList = m_properties.at("hosts").toVariantList();
+    S9sVector<S9sNode>    retval;
+    const S9sVariantList &variantList = 
+        m_properties.valueByPath("hosts").toVariantList();
 
     for (uint idx = 0u; idx < variantList.size(); ++idx)
     {
-        S9sVariantMap theMap = variantList[idx].toVariantMap();
-        S9sNode       node = theMap;
+        S9sNode node = variantList[idx].toVariantMap();
 
         retval << node;
     }
@@ -600,6 +597,36 @@ S9sCluster::nodes() const
     return retval;
 }
 
+/**
+ * \returns How many nodes the cluster has including the controller.
+ */
+int
+S9sCluster::nNodes() const
+{
+    return (int) m_properties.valueByPath("hosts").toVariantList().size();
+}
+
+/**
+ * \param idx The index of the node in the "hosts" list of the cluster.
+ * \returns The properties of the node without copying them, or an empty map if
+ *   the index is out of range.
+ *
+ * This is the cheap way to walk the nodes when only a few nodes are needed as
+ * S9sNode objects, nodes() creates an object for every node of the cluster.
+ */
+const S9sVariantMap &
+S9sCluster::nodeProperties(
+        const int idx) const
+{
+    const S9sVariantList &variantList = 
+        m_properties.valueByPath("hosts").toVariantList();
+
+    if (idx < 0 || idx >= (int) variantList.size())
+        return S9sVariant::sm_emptyMap;
+
+    return variantList[idx].toVariantMap();
+}
+
 
 /**
  * \returns How many hosts the cluster have including the controller.
@@ -617,16 +644,14 @@ S9sCluster::nHosts() const
 S9sVariantList 
 S9sCluster::hostIds() const
 {
-    S9sVariantList retval;
-    S9sVariantList tmpList;
-
-    if (m_properties.contains("hosts"))
-        tmpList = m_properties.at("hosts").toVariantList();
+    S9sVariantList        retval;
+    const S9sVariantList &tmpList = 
+        m_properties.valueByPath("hosts").toVariantList();
 
     for (uint idx = 0u; idx < tmpList.size(); ++idx)
     {
-        S9sVariantMap theMap = tmpList[idx].toVariantMap();
-        int           hostId = theMap["hostId"].toInt();
+        const S9sVariantMap &theMap = tmpList[idx].toVariantMap();
+        int                  hostId = theMap.valueByPath("hostId").toInt();
 
         retval << S9sVariant(hostId);
     }
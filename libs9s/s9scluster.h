@@ -75,6 +75,8 @@ class S9sCluster : public S9sObject
         int jobsRunning() const;
 
         S9sVector<S9sNode> nodes() const;
+        int nNodes() const;
+        const S9sVariantMap &nodeProperties(const int idx) const;
 
         // %h
         int nHosts() const;
@@ -506,6 +506,30 @@ S9sCommander::updateObject(
     }    
 }
 
+/**
+ * \param output The stream where the screen is painted.
+ *
+ * The panels and the dialogs are printed by the commander, so they are
+ * printing to the same stream.
+ */
+void
+S9sCommander::setOutput(
+        FILE *output)
+{
+    S9sDisplay::setOutput(output);
+    m_leftBrowser.setOutput(output);
+    m_leftInfo.setOutput(output);
+    m_rightBrowser.setOutput(output);
+    m_rightInfo.setOutput(output);
+    m_editor.setOutput(output);
+
+    if (m_dialog != NULL)
+        m_dialog->setOutput(output);
+
+    if (m_errorDialog != NULL)
+        m_errorDialog->setOutput(output);
+}
+
 /**
  * \returns True if the program should continue refreshing the screen, false to
  *   exit.
@@ -965,25 +989,25 @@ S9sCommander::printHeader()
     S9sDateTime dt = S9sDateTime::currentDateTime();
     S9sString   title = "S9S";
 
-    ::printf("%s%-12s%s ", 
+    ::fprintf(m_output, "%s%-12s%s ", 
             TERM_SCREEN_TITLE_BOLD, 
             STR(title), 
             TERM_SCREEN_TITLE);
 
-    ::printf("%c ", rotatingCharacter());
-    ::printf("%s ", STR(dt.toString(S9sDateTime::LongTimeFormat)));
+    ::fprintf(m_output, "%c ", rotatingCharacter());
+    ::fprintf(m_output, "%s ", STR(dt.toString(S9sDateTime::LongTimeFormat)));
 
     // Printing the network activity character.
     if (m_communicating || m_reloadRequested)
-        ::printf("❌ ");
+        ::fprintf(m_output, "❌ ");
     else
-        ::printf("⟳ ");
+        ::fprintf(m_output, "⟳ ");
 
     if (m_viewDebug)
     {
-        ::printf("0x%02x ",      lastKeyCode());
-        ::printf("%02dx%02d ",   width(), height());
-        ::printf("%02d:%03d,%03d ", m_lastButton, m_lastX, m_lastY);
+        ::fprintf(m_output, "0x%02x ",      lastKeyCode());
+        ::fprintf(m_output, "%02dx%02d ",   width(), height());
+        ::fprintf(m_output, "%02d:%03d,%03d ", m_lastButton, m_lastX, m_lastY);
     }
 
     printNewLine();
@@ -1000,9 +1024,9 @@ S9sCommander::printFooter()
 
     for (;m_lineCounter < height() - 1; ++m_lineCounter)
     {
-        ::printf("%s", TERM_ERASE_EOL);
-        ::printf("\n\r");
-        ::printf("%s", TERM_ERASE_EOL);
+        ::fprintf(m_output, "%s", TERM_ERASE_EOL);
+        ::fprintf(m_output, "\n\r");
+        ::fprintf(m_output, "%s", TERM_ERASE_EOL);
     } 
 
     fieldSize = (width() / 10) - 2;
@@ -1034,14 +1058,14 @@ S9sCommander::printFooter()
 
     for (uint idx = 0u; idx < labels.size(); ++idx)
     {
-        ::printf(STR(format), 
+        ::fprintf(m_output, STR(format), 
                 normal, idx + 1, inverse, 
                 STR(labels[idx].toString()), normal);
     }
 
-    ::printf("%s", TERM_ERASE_EOL);
-    ::printf("%s", TERM_NORMAL);
-    ::fflush(stdout);
+    ::fprintf(m_output, "%s", TERM_ERASE_EOL);
+    ::fprintf(m_output, "%s", TERM_NORMAL);
+    ::fflush(m_output);
 }
 
 void 
@@ -1092,8 +1116,8 @@ S9sCommander::entryActivated(
         //sleep(10);
         //setConioTerminalMode(true, true);
         m_waitingForKeyPress = true;
-        ::printf("\n*** Press any key to continue. ***\n");
-        fflush(stdout);
+        ::fprintf(m_output, "\n*** Press any key to continue. ***\n");
+        fflush(m_output);
     }
 }
 
@@ -1164,7 +1188,7 @@ S9sCommander::waitForJobWithLog(
             }
 
 
-            //printf("\n\n%s\n", STR(reply.toString()));
+            //::fprintf(m_output, "\n\n%s\n", STR(reply.toString()));
             ++nFailures;
             if (nFailures > 3)
                 break;
@@ -1190,13 +1214,13 @@ S9sCommander::waitForJobWithLog(
             job["status"] == "FINISHED"  ||
             job["status"] == "FAILED";
         
-        fflush(stdout);
+        fflush(m_output);
         if (finished)
             break;
         
         sleep(1);
     }
 
-    printf("\n");
+    ::fprintf(m_output, "\n");
 }
 
@@ -44,6 +44,7 @@ class S9sCommander :
         virtual void processKey(int key);
         virtual bool processButton(uint button, uint x, uint y);        
         virtual bool refreshScreen();
+        virtual void setOutput(FILE *output);
 
     protected:
         virtual void printHeader();
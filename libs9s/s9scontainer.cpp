@@ -157,11 +157,7 @@ S9sContainer::name(
     if (columns <= 0)
         return retval;
 
-    if ((int)retval.length() > columns)
-    {
-        retval.resize(columns);
-        retval += "…";
-    }
+    retval.ellipsize(columns + 1);
 
     return retval;
 }
@@ -19,10 +19,25 @@
  */
 #include "s9scontroller.h"
 
+#include <cmath>
+
 //#define DEBUG
 //#define WARNING
 #include "s9sdebug.h"
 
+/*
+ * A controller that could not be connected is not tried again for this many
+ * seconds, doubled on every consecutive failure up to the maximum.
+ */
+#define BACKOFF_MIN 10
+#define BACKOFF_MAX 600
+
+/*
+ * Round trip time changes smaller than this (in milliseconds) are considered
+ * to be jitter, no matter how fast the controller is.
+ */
+#define RTT_MIN_CHANGE 5.0
+
 S9sController::S9sController() :
     S9sServer()
 {
@@ -75,4 +90,127 @@ S9sController::setConnectFailed(
         bool value) 
 {
     setProperty("connect_tried", value);
+
+    if (value)
+    {
+        m_properties["failures"]  = nFailures() + 1;
+        m_properties["failed_at"] = (ulonglong) time(NULL);
+    }
+}
+
+/**
+ * \param rtt The time the connect took in milliseconds.
+ *
+ * Clears the failures of the controller and updates the smoothed round trip
+ * time measured while connecting.
+ */
+void
+S9sController::setConnectSucceeded(
+        const double rtt)
+{
+    double oldRtt = this->rtt();
+
+    m_properties["connect_tried"] = false;
+    m_properties["failures"]      = 0;
+    m_properties["failed_at"]     = 0ull;
+    m_properties["rtt"]           = 
+        oldRtt > 0.0 ? 0.7 * oldRtt + 0.3 * rtt : rtt;
+}
+
+/**
+ * \param rtt The time the connect took in milliseconds.
+ * \returns true if the given round trip time is significantly different from
+ *   the one we have for this controller: the change is more than the half of
+ *   the old value and more than a few milliseconds.
+ */
+bool
+S9sController::isRttChanged(
+        const double rtt) const
+{
+    double oldRtt = this->rtt();
+    double change = fabs(rtt - oldRtt);
+
+    if (oldRtt <= 0.0)
+        return true;
+
+    return change > RTT_MIN_CHANGE && change > oldRtt / 2.0;
+}
+
+/**
+ * \returns true if this controller was the leader the last time the CLI
+ *   received a reply.
+ */
+bool
+S9sController::isLeader() const
+{
+    return property("leader").toBoolean();
+}
+
+void
+S9sController::setLeader(
+        bool value)
+{
+    setProperty("leader", value);
+}
+
+/**
+ * \returns How many times the connect failed since the last successful
+ *   connect.
+ */
+int
+S9sController::nFailures() const
+{
+    return property("failures").toInt();
+}
+
+/**
+ * \returns When the last connect failed, 0 if it did not.
+ */
+time_t
+S9sController::failedAt() const
+{
+    return property("failed_at").toTimeT();
+}
+
+/**
+ * \returns The time until the controller should not be tried again after the
+ *   failed connects, the back off time is doubled on every failure.
+ */
+time_t
+S9sController::retryAfter() const
+{
+    int failures = nFailures();
+    int backoff  = BACKOFF_MIN;
+
+    if (failures <= 0)
+        return 0;
+
+    for (int idx = 1; idx < failures && backoff < BACKOFF_MAX; ++idx)
+        backoff *= 2;
+
+    if (backoff > BACKOFF_MAX)
+        backoff = BACKOFF_MAX;
+
+    return failedAt() + backoff;
+}
+
+/**
+ * \returns true if the controller was not tried in this process and it is not
+ *   in the back off period of the earlier failures.
+ */
+bool
+S9sController::isAvailable(
+        const time_t now) const
+{
+    return !connectFailed() && now >= retryAfter();
+}
+
+/**
+ * \returns The smoothed round trip time of the connects in milliseconds, 0.0
+ *   if it is not measured yet.
+ */
+double
+S9sController::rtt() const
+{
+    return property("rtt").toDouble();
 }
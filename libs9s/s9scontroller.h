@@ -21,6 +21,8 @@
 
 #include "S9sServer"
 
+#include <ctime>
+
 /**
  * A class that represents a Cmon Controller, a class that is used since the
  * Cmon HA is introduced.
@@ -38,6 +40,17 @@ class S9sController : public S9sServer
        
         bool connectFailed() const;
         void setConnectFailed(bool value = true);
+        void setConnectSucceeded(const double rtt);
+        bool isRttChanged(const double rtt) const;
+
+        bool isLeader() const;
+        void setLeader(bool value = true);
+
+        int nFailures() const;
+        time_t failedAt() const;
+        time_t retryAfter() const;
+        bool isAvailable(const time_t now) const;
+        double rtt() const;
 };
 
 
@@ -0,0 +1,676 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9sdaemon.h"
+
+#include "S9sOptions"
+#include "S9sRpcClient"
+#include "S9sFile"
+
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <getopt.h>
+#include <signal.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+/*
+ * How often (in seconds) the daemon authenticates again so that the session
+ * the workers inherit does not expire.
+ */
+#define SESSION_REFRESH 300
+
+/*
+ * The largest request (command line and environment) we accept.
+ */
+#define MAX_REQUEST_SIZE (1024 * 1024)
+
+extern char **environ;
+
+static bool
+readAll(
+        int     fd,
+        void   *buffer,
+        size_t  size)
+{
+    char *ptr = (char *) buffer;
+
+    while (size > 0)
+    {
+        ssize_t nRead = ::read(fd, ptr, size);
+
+        if (nRead < 0 && errno == EINTR)
+            continue;
+
+        if (nRead <= 0)
+            return false;
+
+        ptr  += nRead;
+        size -= nRead;
+    }
+
+    return true;
+}
+
+static bool
+writeAll(
+        int         fd,
+        const void *buffer,
+        size_t      size)
+{
+    const char *ptr = (const char *) buffer;
+
+    while (size > 0)
+    {
+        ssize_t nWritten = ::write(fd, ptr, size);
+
+        if (nWritten < 0 && errno == EINTR)
+            continue;
+
+        if (nWritten <= 0)
+            return false;
+
+        ptr  += nWritten;
+        size -= nWritten;
+    }
+
+    return true;
+}
+
+static bool
+socketAddress(
+        struct sockaddr_un &address)
+{
+    S9sString path = S9sDaemon::socketPath();
+
+    if (path.length() >= sizeof(address.sun_path))
+        return false;
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, STR(path), sizeof(address.sun_path) - 1);
+
+    return true;
+}
+
+S9sDaemon::S9sDaemon() :
+    m_listenFd(-1),
+    m_lastAuthentication(0),
+    m_argv(NULL),
+    m_argc(0)
+{
+}
+
+S9sDaemon::~S9sDaemon()
+{
+    if (m_listenFd >= 0)
+        ::close(m_listenFd);
+}
+
+/**
+ * \returns The path of the Unix domain socket where the daemon listens.
+ */
+S9sString
+S9sDaemon::socketPath()
+{
+    S9sFile file("~/.s9s/s9s.sock");
+
+    return file.path();
+}
+
+/**
+ * \returns The number of command line arguments the worker should execute.
+ */
+int
+S9sDaemon::argc() const
+{
+    return m_argc;
+}
+
+/**
+ * \returns The command line arguments the worker should execute.
+ */
+char **
+S9sDaemon::argv() const
+{
+    return m_argv;
+}
+
+S9sString
+S9sDaemon::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * \returns true in the worker processes after the request is received, false
+ *   if the daemon could not be started.
+ *
+ * The main loop of the daemon. This method returns only in the forked worker
+ * processes, the argc() and argv() methods then return the command line that
+ * should be executed. The worker is already set up to run as the s9s process
+ * that forwarded the command: the working directory, the environment and the
+ * standard file descriptors are all taken from the request.
+ */
+bool
+S9sDaemon::exec()
+{
+    if (!listen())
+        return false;
+
+    // The connection managers are not waited for.
+    signal(SIGCHLD, SIG_IGN);
+    signal(SIGPIPE, SIG_IGN);
+
+    authenticate();
+    PRINT_VERBOSE("Listening on %s.", STR(socketPath()));
+    PRINT_LOG("Daemon listening on %s.", STR(socketPath()));
+
+    for (;;)
+    {
+        struct pollfd pollFd;
+        int           nReady;
+        int           connectionFd;
+        pid_t         pid;
+
+        pollFd.fd      = m_listenFd;
+        pollFd.events  = POLLIN;
+        pollFd.revents = 0;
+
+        nReady = poll(&pollFd, 1, 10000);
+        if (nReady < 0 && errno != EINTR)
+        {
+            m_errorString.sprintf("poll(): %m");
+            return false;
+        }
+
+        if (time(NULL) - m_lastAuthentication >= SESSION_REFRESH)
+            authenticate();
+
+        if (nReady <= 0)
+            continue;
+
+        connectionFd = accept(m_listenFd, NULL, NULL);
+        if (connectionFd < 0)
+            continue;
+
+        // Nothing should be printed twice after the fork.
+        fflush(NULL);
+
+        pid = fork();
+        if (pid == 0)
+        {
+            ::close(m_listenFd);
+            m_listenFd = -1;
+
+            if (serveConnection(connectionFd))
+                return true;
+
+            // The _exit() does not call the atexit() handlers.
+            s9s_log_flush();
+            _exit(0);
+        } else if (pid < 0)
+        {
+            PRINT_LOG("fork(): %m");
+        }
+
+        ::close(connectionFd);
+    }
+
+    return false;
+}
+
+/**
+ * Creates the socket where the daemon receives the commands. A socket file
+ * left behind by a daemon that is not running any more is removed, but two
+ * daemons will not listen at the same time.
+ */
+bool
+S9sDaemon::listen()
+{
+    struct sockaddr_un address;
+    mode_t             oldMask;
+    int                fd;
+
+    if (!socketAddress(address))
+    {
+        m_errorString.sprintf(
+                "The socket path '%s' is too long.", STR(socketPath()));
+        return false;
+    }
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        m_errorString.sprintf("socket(): %m");
+        return false;
+    }
+
+    if (connect(fd, (struct sockaddr *) &address, sizeof(address)) == 0)
+    {
+        m_errorString.sprintf(
+                "An other daemon is already listening on %s.", 
+                STR(socketPath()));
+
+        ::close(fd);
+        return false;
+    }
+
+    ::unlink(address.sun_path);
+
+    // Only the user can connect to the socket.
+    oldMask = umask(0077);
+    if (bind(fd, (struct sockaddr *) &address, sizeof(address)) != 0)
+    {
+        m_errorString.sprintf("bind(): %m");
+        umask(oldMask);
+        ::close(fd);
+        return false;
+    }
+
+    umask(oldMask);
+
+    if (::listen(fd, 32) != 0)
+    {
+        m_errorString.sprintf("listen(): %m");
+        ::close(fd);
+        return false;
+    }
+
+    m_listenFd = fd;
+    return true;
+}
+
+/**
+ * Authenticates with the controller. The session is remembered by the
+ * S9sRpcClient class and it is inherited by the forked worker processes, so
+ * they will not have to authenticate.
+ */
+void
+S9sDaemon::authenticate()
+{
+    S9sOptions   *options = S9sOptions::instance();
+    S9sRpcClient  client(
+            options->controllerHostName(), options->controllerPort(),
+            options->controllerPath(), options->useTls());
+
+    S9sRpcClient::forgetSessions();
+    m_lastAuthentication = time(NULL);
+
+    if (!client.maybeAuthenticate())
+    {
+        PRINT_LOG("Daemon failed to authenticate: %s", 
+                STR(client.errorString()));
+    }
+}
+
+/**
+ * \returns true in the worker process, false in the connection manager
+ *   process after the worker finished.
+ *
+ * Runs in the process forked for the connection. This process receives the
+ * request, forks the worker and waits for it to finish, then sends the exit
+ * code of the worker to the client. If the client goes away before the worker
+ * is finished the worker gets a SIGINT, just as if the user pressed Ctrl-C.
+ */
+bool
+S9sDaemon::serveConnection(
+        int connectionFd)
+{
+    S9sVariantMap request;
+    int           fds[3] = { -1, -1, -1 };
+    int           exitPipe[2];
+    int32_t       exitStatus = S9sOptions::Failed;
+    pid_t         pid;
+
+    signal(SIGCHLD, SIG_DFL);
+
+    if (!receiveRequest(connectionFd, request, fds))
+    {
+        PRINT_LOG("Invalid request received.");
+        ::close(connectionFd);
+        return false;
+    }
+
+    /*
+     * The worker holds the write end of this pipe, so the read end shows the
+     * end of the worker without polling with timeouts.
+     */
+    if (pipe(exitPipe) != 0)
+    {
+        PRINT_LOG("pipe(): %m");
+        exitPipe[0] = exitPipe[1] = -1;
+    }
+
+    pid = fork();
+    if (pid == 0)
+    {
+        ::close(connectionFd);
+
+        if (exitPipe[0] >= 0)
+            ::close(exitPipe[0]);
+
+        setupWorker(request, fds);
+        return true;
+    }
+
+    for (int idx = 0; idx < 3; ++idx)
+        ::close(fds[idx]);
+
+    if (exitPipe[1] >= 0)
+        ::close(exitPipe[1]);
+
+    if (pid > 0)
+        exitStatus = waitWorker(pid, exitPipe[0], connectionFd);
+    else 
+        PRINT_LOG("fork(): %m");
+
+    if (exitPipe[0] >= 0)
+        ::close(exitPipe[0]);
+
+    writeAll(connectionFd, &exitStatus, sizeof(exitStatus));
+    ::close(connectionFd);
+
+    return false;
+}
+
+/**
+ * \param connectionFd the connection the request is read from.
+ * \param request the request (command line, environment and working directory)
+ *   will be returned here.
+ * \param fds the standard input, output and error of the client will be
+ *   returned here.
+ *
+ * The request is a 32 bit length with the three file descriptors attached
+ * followed by the JSon string of the request.
+ */
+bool
+S9sDaemon::receiveRequest(
+        int            connectionFd,
+        S9sVariantMap &request,
+        int           *fds)
+{
+    uint32_t       length = 0;
+    struct msghdr  message;
+    struct iovec   iov;
+    char           control[CMSG_SPACE(3 * sizeof(int))];
+    struct cmsghdr *cmsg;
+    ssize_t        nRead;
+    char          *buffer;
+    bool           retval;
+
+    memset(&message, 0, sizeof(message));
+    memset(control, 0, sizeof(control));
+
+    iov.iov_base           = &length;
+    iov.iov_len            = sizeof(length);
+    message.msg_iov        = &iov;
+    message.msg_iovlen     = 1;
+    message.msg_control    = control;
+    message.msg_controllen = sizeof(control);
+
+    do {
+        nRead = recvmsg(connectionFd, &message, 0);
+    } while (nRead < 0 && errno == EINTR);
+
+    if (nRead != (ssize_t) sizeof(length))
+        return false;
+
+    cmsg = CMSG_FIRSTHDR(&message);
+    if (cmsg == NULL || 
+            cmsg->cmsg_level != SOL_SOCKET ||
+            cmsg->cmsg_type != SCM_RIGHTS ||
+            cmsg->cmsg_len != CMSG_LEN(3 * sizeof(int)))
+    {
+        return false;
+    }
+
+    memcpy(fds, CMSG_DATA(cmsg), 3 * sizeof(int));
+
+    if (length == 0 || length > MAX_REQUEST_SIZE)
+        return false;
+
+    buffer = new char[length + 1];
+    retval = readAll(connectionFd, buffer, length);
+    buffer[length] = '\0';
+
+    if (retval)
+        retval = request.parse(buffer);
+
+    delete[] buffer;
+    return retval;
+}
+
+/**
+ * \returns The exit code of the worker process in the same form as the shell
+ *   shows it.
+ */
+int
+S9sDaemon::waitWorker(
+        pid_t   pid,
+        int     exitFd,
+        int     connectionFd)
+{
+    struct pollfd pollFds[2];
+    bool          interrupted = false;
+    int           status;
+
+    while (exitFd >= 0)
+    {
+        int nReady;
+
+        pollFds[0].fd      = exitFd;
+        pollFds[0].events  = POLLIN;
+        pollFds[0].revents = 0;
+        pollFds[1].fd      = interrupted ? -1 : connectionFd;
+        pollFds[1].events  = POLLIN;
+        pollFds[1].revents = 0;
+
+        nReady = poll(pollFds, 2, -1);
+        if (nReady < 0 && errno == EINTR)
+            continue;
+        else if (nReady < 0)
+            break;
+
+        // The worker is gone.
+        if (pollFds[0].revents != 0)
+            break;
+
+        // The client sends nothing after the request, so this is a hangup.
+        if (pollFds[1].revents != 0)
+        {
+            PRINT_LOG("Client went away, interrupting worker %d.", pid);
+            kill(pid, SIGINT);
+            interrupted = true;
+        }
+    }
+
+    while (waitpid(pid, &status, 0) < 0)
+    {
+        if (errno != EINTR)
+            return S9sOptions::Failed;
+    }
+
+    if (WIFEXITED(status))
+        return WEXITSTATUS(status);
+    else if (WIFSIGNALED(status))
+        return 128 + WTERMSIG(status);
+
+    return S9sOptions::Failed;
+}
+
+/**
+ * Sets up the freshly forked worker process so that it will look like the s9s
+ * process that sent the request.
+ */
+void
+S9sDaemon::setupWorker(
+        const S9sVariantMap &request,
+        int                 *fds)
+{
+    S9sVariantList arguments;
+    S9sVariantList environment;
+    S9sString      cwd;
+
+    arguments   = request.valueByPath("arguments").toVariantList();
+    environment = request.valueByPath("environment").toVariantList();
+    cwd         = request.valueByPath("cwd").toString();
+
+    signal(SIGPIPE, SIG_DFL);
+
+    for (int idx = 0; idx < 3; ++idx)
+    {
+        dup2(fds[idx], idx);
+        ::close(fds[idx]);
+    }
+
+    if (!cwd.empty() && chdir(STR(cwd)) != 0)
+        PRINT_LOG("chdir(): %m");
+
+    clearenv();
+    for (uint idx = 0u; idx < environment.size(); ++idx)
+        putenv(strdup(STR(environment[idx].toString())));
+
+    m_argc = arguments.size();
+    m_argv = new char *[m_argc + 1];
+    for (int idx = 0; idx < m_argc; ++idx)
+        m_argv[idx] = strdup(STR(arguments[idx].toString()));
+
+    m_argv[m_argc] = NULL;
+
+    // The daemon parsed its own command line in this process before, the
+    // forwarded command line has to be parsed from the beginning.
+    optind = 0;
+}
+
+/**
+ * \param argc the number of the command line arguments.
+ * \param argv the command line arguments.
+ * \param exitStatus the exit code of the command executed by the daemon is
+ *   returned here.
+ * \returns true if the command was executed by the daemon, false if there is
+ *   no daemon running and the command should be executed by this process.
+ *
+ * Sends the command line, the environment and the standard file descriptors of
+ * this process to the daemon and waits for the command to be finished. The
+ * output of the command is written by the daemon directly into our standard
+ * output and error.
+ */
+bool
+S9sDaemon::forwardCommand(
+        int     argc, 
+        char  **argv,
+        int    &exitStatus)
+{
+    struct sockaddr_un address;
+    S9sVariantMap      request;
+    S9sVariantList     arguments;
+    S9sVariantList     environment;
+    S9sString          payload;
+    uint32_t           length;
+    int                fds[3] = { 0, 1, 2 };
+    struct msghdr      message;
+    struct iovec       iov;
+    char               control[CMSG_SPACE(3 * sizeof(int))];
+    struct cmsghdr    *cmsg;
+    int32_t            status;
+    int                fd;
+
+    if (getenv("S9S_NO_DAEMON") != NULL)
+        return false;
+
+    for (int idx = 0; idx < argc; ++idx)
+    {
+        if (strcmp(argv[idx], "--daemon") == 0 ||
+                strcmp(argv[idx], "--event-relay") == 0)
+        {
+            return false;
+        }
+
+        arguments << argv[idx];
+    }
+
+    if (!socketAddress(address))
+        return false;
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return false;
+
+    if (connect(fd, (struct sockaddr *) &address, sizeof(address)) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    for (char **env = environ; env != NULL && *env != NULL; ++env)
+        environment << *env;
+
+    request["arguments"]   = arguments;
+    request["environment"] = environment;
+    request["cwd"]         = S9sFile::currentWorkingDirectory();
+
+    payload = request.toString();
+    length  = payload.length();
+
+    memset(&message, 0, sizeof(message));
+    memset(control, 0, sizeof(control));
+
+    iov.iov_base           = &length;
+    iov.iov_len            = sizeof(length);
+    message.msg_iov        = &iov;
+    message.msg_iovlen     = 1;
+    message.msg_control    = control;
+    message.msg_controllen = sizeof(control);
+
+    cmsg             = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type  = SCM_RIGHTS;
+    cmsg->cmsg_len   = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    if (sendmsg(fd, &message, MSG_NOSIGNAL) != (ssize_t) sizeof(length) ||
+            !writeAll(fd, STR(payload), length))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    if (!readAll(fd, &status, sizeof(status)))
+    {
+        PRINT_ERROR("Lost the connection to the s9s daemon.");
+        status = S9sOptions::Failed;
+    }
+
+    ::close(fd);
+    exitStatus = status;
+
+    return true;
+}
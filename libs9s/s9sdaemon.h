@@ -0,0 +1,73 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sString"
+#include "S9sVariantMap"
+
+/**
+ * A class that implements the resident s9s process (s9s --daemon). The daemon
+ * authenticates with the controller once and listens on a Unix domain socket.
+ * The other s9s processes forward their command line, environment and standard
+ * file descriptors to the daemon, the daemon forks a worker process that
+ * executes the command with the warm session and sends back the exit code.
+ */
+class S9sDaemon
+{
+    public:
+        S9sDaemon();
+        virtual ~S9sDaemon();
+
+        bool exec();
+
+        int argc() const;
+        char **argv() const;
+
+        S9sString errorString() const;
+
+        static S9sString socketPath();
+
+        static bool 
+            forwardCommand(
+                int     argc, 
+                char  **argv,
+                int    &exitStatus);
+
+    private:
+        bool listen();
+        void authenticate();
+        bool serveConnection(int connectionFd);
+
+        bool 
+            receiveRequest(
+                int            connectionFd,
+                S9sVariantMap &request,
+                int           *fds);
+
+        int waitWorker(pid_t pid, int exitFd, int connectionFd);
+        void setupWorker(const S9sVariantMap &request, int *fds);
+
+    private:
+        int             m_listenFd;
+        time_t          m_lastAuthentication;
+        char          **m_argv;
+        int             m_argc;
+        S9sString       m_errorString;
+};
@@ -285,7 +285,8 @@ S9sDateTime::ellapsedSeconds() const
 int
 S9sDateTime::second() const
 {
-    struct tm *lt = ::localtime(&m_timeSpec.tv_sec);
+    struct tm  tmBuffer;
+    struct tm *lt = ::localtime_r(&m_timeSpec.tv_sec, &tmBuffer);
 
     return lt->tm_sec;
 }
@@ -293,7 +294,8 @@ S9sDateTime::second() const
 int
 S9sDateTime::minute() const
 {
-    struct tm *lt = ::localtime(&m_timeSpec.tv_sec);
+    struct tm  tmBuffer;
+    struct tm *lt = ::localtime_r(&m_timeSpec.tv_sec, &tmBuffer);
 
     return lt->tm_min;
 }
@@ -304,11 +306,13 @@ S9sDateTime::hour(
 {
     if (GMT)
     {
-        struct tm *gmtTime = ::gmtime(&m_timeSpec.tv_sec);
+        struct tm  tmBuffer;
+        struct tm *gmtTime = ::gmtime_r(&m_timeSpec.tv_sec, &tmBuffer);
         return gmtTime->tm_hour;
     }
 
-    struct tm *lt = ::localtime(&m_timeSpec.tv_sec);
+    struct tm  tmBuffer;
+    struct tm *lt = ::localtime_r(&m_timeSpec.tv_sec, &tmBuffer);
     return lt->tm_hour;
 }
 
@@ -319,7 +323,8 @@ S9sDateTime::hour(
 int
 S9sDateTime::weekNumber() const
 {
-    struct tm    *lt = ::localtime(&m_timeSpec.tv_sec);
+    struct tm     tmBuffer;
+    struct tm    *lt = ::localtime_r(&m_timeSpec.tv_sec, &tmBuffer);
     char          buffer[80];
     S9sString     tmp;
 
@@ -335,7 +340,8 @@ S9sDateTime::weekNumber() const
 int
 S9sDateTime::month() const
 {
-    struct tm *lt = ::localtime(&m_timeSpec.tv_sec);
+    struct tm  tmBuffer;
+    struct tm *lt = ::localtime_r(&m_timeSpec.tv_sec, &tmBuffer);
 
     return lt->tm_mon + 1;
 }
@@ -347,7 +353,8 @@ S9sDateTime::month() const
 int
 S9sDateTime::day() const
 {
-    struct tm *lt = ::localtime(&m_timeSpec.tv_sec);
+    struct tm  tmBuffer;
+    struct tm *lt = ::localtime_r(&m_timeSpec.tv_sec, &tmBuffer);
 
     return lt->tm_mday;
 }
@@ -359,7 +366,8 @@ S9sDateTime::day() const
 int
 S9sDateTime::year() const
 {
-    struct tm *lt = ::localtime(&m_timeSpec.tv_sec);
+    struct tm  tmBuffer;
+    struct tm *lt = ::localtime_r(&m_timeSpec.tv_sec, &tmBuffer);
 
     return 1900 + lt->tm_year;
 }
@@ -370,7 +378,8 @@ S9sDateTime::year() const
 int
 S9sDateTime::weekday() const
 {
-    struct tm *lt = ::localtime(&m_timeSpec.tv_sec);
+    struct tm  tmBuffer;
+    struct tm *lt = ::localtime_r(&m_timeSpec.tv_sec, &tmBuffer);
 
     // tm_wday: Sunday = 0, Monday = 1... Saturday = 6
     return lt->tm_wday + 1;
@@ -382,7 +391,8 @@ S9sDateTime::weekday() const
 int
 S9sDateTime::yearday() const
 {
-    struct tm *lt = ::localtime(&m_timeSpec.tv_sec);
+    struct tm  tmBuffer;
+    struct tm *lt = ::localtime_r(&m_timeSpec.tv_sec, &tmBuffer);
     
     // tm_wday: Sunday = 0, Monday = 1... Saturday = 6
     return lt->tm_yday + 1;
@@ -392,7 +402,8 @@ int
 S9sDateTime::currentWeekNumber()
 {
     S9sDateTime  dt = currentDateTime();
-    struct tm    *lt = ::localtime(&dt.m_timeSpec.tv_sec);
+    struct tm     tmBuffer;
+    struct tm    *lt = ::localtime_r(&dt.m_timeSpec.tv_sec, &tmBuffer);
     char          buffer[80];
     S9sString    tmp;
 
@@ -406,7 +417,8 @@ int
 S9sDateTime::previousWeekNumber()
 {
     S9sDateTime  dt = time(NULL) - WEEKS_TO_SECONDS(1);
-    struct tm    *lt = ::localtime(&dt.m_timeSpec.tv_sec);
+    struct tm     tmBuffer;
+    struct tm    *lt = ::localtime_r(&dt.m_timeSpec.tv_sec, &tmBuffer);
     char          buffer[80];
     S9sString    tmp;
 
@@ -465,7 +477,8 @@ S9sString
 S9sDateTime::toString(
         S9sDateTime::DateTimeFormat format) const
 {
-    struct tm *lt = ::localtime(&m_timeSpec.tv_sec);
+    struct tm  tmBuffer;
+    struct tm *lt = ::localtime_r(&m_timeSpec.tv_sec, &tmBuffer);
     S9sString retval;
 
     switch (format)
@@ -578,7 +591,8 @@ S9sDateTime::toString(
                 // 
                 // Here we change to GTMT and format that.
                 // 
-                struct tm *lt = ::gmtime(&m_timeSpec.tv_sec);
+                struct tm  gmtBuffer;
+                struct tm *lt = ::gmtime_r(&m_timeSpec.tv_sec, &gmtBuffer);
                     
                 strftime(buffer, size, "%Y-%m-%dT%H:%M:%S", lt);
                 millisecs.sprintf(".%03d", m_timeSpec.tv_nsec / 1000000);
@@ -605,7 +619,8 @@ S9sDateTime::toString(
     // FIXME: finite buffer size!
     size_t     bufferSize = 1024;
     char       buffer[bufferSize];
-    struct tm *lt = ::localtime(&m_timeSpec.tv_sec);
+    struct tm  tmBuffer;
+    struct tm *lt = ::localtime_r(&m_timeSpec.tv_sec, &tmBuffer);
 
     ::strftime(buffer, bufferSize, STR(formatString), lt);
     return S9sString(buffer);
@@ -2,9 +2,349 @@
 
 #include "S9sOptions"
 #include "S9sDateTime"
+#include "S9sThread"
+#include "S9sMutex"
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <atomic>
+
+/*
+ * The log lines are collected in a buffer and a background thread writes them
+ * into the file when the buffer is at least LOG_FLUSH_SIZE bytes or the last
+ * write was at least LOG_FLUSH_MILLISECONDS ago. If the buffer grows to
+ * LOG_MAX_SIZE the thread that logs writes it so the buffer is bounded.
+ */
+#define LOG_FLUSH_SIZE          (64 * 1024)
+#define LOG_FLUSH_MILLISECONDS  200
+#define LOG_MAX_SIZE            (1024 * 1024)
+
+/*
+ * The cached state of the logging. It is LogUnknown until the first log line
+ * and after s9s_log_reset().
+ */
+enum S9sLogState
+{
+    LogUnknown,
+    LogDisabled,
+    LogEnabled
+};
+
+/**
+ * The thread that writes the log file in the background. 
+ */
+class S9sLogWriter : public S9sThread
+{
+    public:
+        S9sLogWriter();
+        virtual ~S9sLogWriter() {};
+
+        bool open(const S9sString &fileName);
+        void append(const S9sString &line);
+        void flush();
+        void flushInSignalHandler();
+        void stop();
+
+        static void prepareFork();
+        static void parentAfterFork();
+        static void childAfterFork();
+        static void stopAtExit();
+
+    protected:
+        virtual int exec();
+        virtual bool shouldStop() const;
+
+    private:
+        void writeBuffer();
+
+    private:
+        S9sMutex            m_bufferMutex;
+        S9sMutex            m_writeMutex;
+        S9sString           m_buffer;
+        S9sString           m_fileName;
+        int                 m_fd;
+        bool                m_running;
+        std::atomic<bool>   m_stopRequested;
+        std::atomic<bool>   m_inSignalHandler;
+};
+
+static S9sLogWriter     sm_logWriter;
+static std::atomic<int> sm_logState(LogUnknown);
+
+S9sLogWriter::S9sLogWriter() :
+    m_fd(-1),
+    m_running(false),
+    m_stopRequested(false),
+    m_inSignalHandler(false)
+{
+}
+
+/**
+ * \param fileName The name of the log file.
+ * \returns true if the file is open for writing.
+ *
+ * Opens the log file if it is not yet open. The file is kept open, the lines
+ * are appended to it without re-opening.
+ */
+bool
+S9sLogWriter::open(
+        const S9sString &fileName)
+{
+    static bool handlersRegistered = false;
+    int         fd;
+
+    // The writer thread might use the file while we check and replace it.
+    m_writeMutex.lock();
+    if (m_fd >= 0 && fileName == m_fileName)
+    {
+        m_writeMutex.unlock();
+        return true;
+    }
+
+    fd = ::open(STR(fileName), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        m_writeMutex.unlock();
+        return false;
+    }
+
+    // The lines that are waiting go into the old file.
+    writeBuffer();
+
+    if (m_fd >= 0)
+        ::close(m_fd);
+
+    m_fd       = fd;
+    m_fileName = fileName;
+
+    if (!handlersRegistered)
+    {
+        pthread_atfork(prepareFork, parentAfterFork, childAfterFork);
+        atexit(stopAtExit);
+        handlersRegistered = true;
+    }
+
+    m_writeMutex.unlock();
+    return true;
+}
+
+/**
+ * Puts one line into the buffer and starts the background thread if it is
+ * not running yet.
+ */
+void
+S9sLogWriter::append(
+        const S9sString &line)
+{
+    size_t size;
+    bool   running;
+
+    m_bufferMutex.lock();
+    m_buffer += line;
+    size = m_buffer.size();
+
+    if (!m_running && !m_stopRequested)
+        m_running = S9sThread::start();
+
+    running = m_running;
+    m_bufferMutex.unlock();
+
+    if (size >= LOG_MAX_SIZE || !running)
+        flush();
+}
+
+/**
+ * Writes the buffer into the file. The write mutex is held while the lines are
+ * written so the pieces of the buffer are written in order.
+ */
+void
+S9sLogWriter::flush()
+{
+    m_writeMutex.lock();
+    writeBuffer();
+    m_writeMutex.unlock();
+}
+
+/**
+ * Writes the lines from the buffer into the file, the caller has to hold the
+ * write mutex.
+ */
+void
+S9sLogWriter::writeBuffer()
+{
+    S9sString   toWrite;
+    const char *data;
+    size_t      remaining;
+
+    m_bufferMutex.lock();
+    toWrite.swap(m_buffer);
+    m_bufferMutex.unlock();
+
+    data      = toWrite.c_str();
+    remaining = toWrite.size();
+
+    while (m_fd >= 0 && remaining > 0)
+    {
+        ssize_t nWritten = ::write(m_fd, data, remaining);
+
+        if (nWritten < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            break;
+        }
+
+        data      += nWritten;
+        remaining -= nWritten;
+    }
+}
+
+/**
+ * Writes the buffer from a signal handler that is going to exit the program.
+ * The mutexes are only tried so the handler never waits for the code it
+ * interrupted, and the writer is not stopped at exit after this.
+ */
+void
+S9sLogWriter::flushInSignalHandler()
+{
+    const char *data;
+    size_t      remaining;
+
+    m_inSignalHandler = true;
+
+    if (!m_writeMutex.tryLock())
+        return;
+
+    if (m_bufferMutex.tryLock())
+    {
+        data      = m_buffer.c_str();
+        remaining = m_buffer.size();
+
+        while (m_fd >= 0 && remaining > 0)
+        {
+            ssize_t nWritten = ::write(m_fd, data, remaining);
+
+            if (nWritten < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                break;
+            }
+
+            data      += nWritten;
+            remaining -= nWritten;
+        }
+
+        m_buffer.clear();
+        m_bufferMutex.unlock();
+    }
+
+    m_writeMutex.unlock();
+}
+
+/**
+ * Stops the background thread after the buffer is written.
+ */
+void
+S9sLogWriter::stop()
+{
+    bool running;
+
+    m_bufferMutex.lock();
+    m_stopRequested = true;
+    running         = m_running;
+    m_bufferMutex.unlock();
+
+    if (running)
+        join();
+
+    m_running = false;
+    flush();
+}
+
+bool
+S9sLogWriter::shouldStop() const
+{
+    return m_stopRequested.load();
+}
+
+int
+S9sLogWriter::exec()
+{
+    int nWaits = 0;
+
+    while (!shouldStop())
+    {
+        usleep(10000);
+        ++nWaits;
+
+        m_bufferMutex.lock();
+        bool shouldFlush = 
+            m_buffer.size() >= LOG_FLUSH_SIZE ||
+            (!m_buffer.empty() && nWaits * 10 >= LOG_FLUSH_MILLISECONDS);
+        m_bufferMutex.unlock();
+
+        if (shouldFlush)
+        {
+            flush();
+            nWaits = 0;
+        }
+    }
+
+    flush();
+    return 0;
+}
+
+/*
+ * The mutexes are locked while the process forks so the child gets the buffer
+ * in a consistent state. The child does not have the background thread, the
+ * lines already in the buffer will be written by the parent.
+ */
+void
+S9sLogWriter::prepareFork()
+{
+    sm_logWriter.m_writeMutex.lock();
+    sm_logWriter.m_bufferMutex.lock();
+}
+
+void
+S9sLogWriter::parentAfterFork()
+{
+    sm_logWriter.m_bufferMutex.unlock();
+    sm_logWriter.m_writeMutex.unlock();
+}
+
+void
+S9sLogWriter::childAfterFork()
+{
+    sm_logWriter.m_buffer.clear();
+    sm_logWriter.m_running = false;
+
+    sm_logWriter.m_bufferMutex.unlock();
+    sm_logWriter.m_writeMutex.unlock();
+}
+
+/*
+ * Registered with atexit() so the lines in the buffer are written even if the
+ * program exits by calling exit(). When exit() is called from a signal handler
+ * the handler already wrote what it could and waiting for the mutexes here
+ * could block forever.
+ */
+void
+S9sLogWriter::stopAtExit()
+{
+    if (sm_logWriter.m_inSignalHandler)
+        return;
+
+    sm_logWriter.stop();
+}
 
 /**
  * This function is for printing debug messages that are used only by
@@ -45,6 +385,71 @@ s9s_print_message (
     fflush(stream);
 }
 
+/**
+ * \returns true if the log file is set and it could be opened.
+ *
+ * The result is cached, so this function is cheap enough to be called before
+ * every log line. The cache is invalidated by s9s_log_reset().
+ */
+bool
+s9s_log_enabled()
+{
+    int state = sm_logState.load(std::memory_order_relaxed);
+
+    if (state == LogUnknown)
+    {
+        // The log lines may print the errno using %m.
+        int         savedErrno = errno;
+        S9sOptions *options    = S9sOptions::instance();
+        S9sString   fileName   = options->logFile();
+
+        if (!fileName.empty() && sm_logWriter.open(fileName))
+            state = LogEnabled;
+        else
+            state = LogDisabled;
+
+        sm_logState = state;
+        errno       = savedErrno;
+    }
+
+    return state == LogEnabled;
+}
+
+/**
+ * Forgets the cached state of the logging. This should be called when the
+ * options that control the logging change (e.g. the command line options or
+ * the configuration files are loaded).
+ */
+void
+s9s_log_reset()
+{
+    sm_logState = LogUnknown;
+}
+
+/**
+ * Writes the log lines that are waiting in the buffer into the file.
+ */
+void
+s9s_log_flush()
+{
+    sm_logWriter.flush();
+}
+
+/**
+ * Writes the buffered log lines from a signal handler before the handler exits
+ * the program. Nothing is written if the interrupted code holds the buffer,
+ * this never blocks.
+ */
+void
+s9s_log_flush_in_signal_handler()
+{
+    sm_logWriter.flushInSignalHandler();
+}
+
+/**
+ * Formats one line and puts it into the buffer of the log. The PRINT_LOG macro
+ * calls this only if s9s_log_enabled() returns true.
+ */
 void
 s9s_log(
         const char    *file,
@@ -52,28 +457,20 @@ s9s_log(
         const char    *formatstring,
         ...)
 {
-    S9sOptions *options = S9sOptions::instance();
-    S9sString   fileName = options->logFile();
+    S9sString   message;
     S9sString   logLine;
     time_t      now = time(NULL);
+    va_list     args;
 
-    if (!fileName.empty())
-    {
-        FILE    *stream;
-        va_list  args;
-
-        stream = fopen(STR(fileName), "a");
-        if (stream == NULL)
-            return;
-
-        va_start(args, formatstring);
-        logLine.vsprintf(formatstring, args);
-        fprintf(stream, "%s %20s:%5d DEBUG %s\n", 
-                S9S_TIME_T(now), file, line, STR(logLine));
-        fflush(stream);
-        va_end(args);
-        
-        fclose(stream);
-    }
-}
+    if (!s9s_log_enabled())
+        return;
+
+    va_start(args, formatstring);
+    message.vsprintf(formatstring, args);
+    va_end(args);
 
+    logLine.sprintf("%s %20s:%5d DEBUG %s\n", 
+            S9S_TIME_T(now), file, line, STR(message));
+
+    sm_logWriter.append(logLine);
+}
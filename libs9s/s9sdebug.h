@@ -194,8 +194,16 @@ s9s_print_message (
         const char       *formatstring,
         ...);
 
+/**
+ * Prints a line into the s9s log file. The arguments are evaluated only if
+ * the logging is enabled, so the call sites can build expensive strings for
+ * the log without slowing down the program when there is no log file.
+ */
 #define PRINT_LOG(...) \
-    s9s_log(__FILE__, __LINE__, __VA_ARGS__)
+    do { \
+        if (s9s_log_enabled()) \
+            s9s_log(__FILE__, __LINE__, __VA_ARGS__); \
+    } while (false)
 
 /**
  * Printf messages to the s9s log file. This file is for debugging the s9s
@@ -208,6 +216,18 @@ s9s_log(
         const char    *formatstring,
         ...);
 
+bool
+s9s_log_enabled();
+
+void
+s9s_log_reset();
+
+void
+s9s_log_flush();
+
+void
+s9s_log_flush_in_signal_handler();
+
 
 /**
  * A macro to print booleans.
@@ -126,6 +126,18 @@ S9sDialog::processKey(
     }
 }
 
+/**
+ * \param output The stream where the dialog and its buttons are printed.
+ */
+void
+S9sDialog::setOutput(
+        FILE *output)
+{
+    S9sWidget::setOutput(output);
+    m_okButton.setOutput(output);
+    m_cancelButton.setOutput(output);
+}
+
 void
 S9sDialog::refreshScreen()
 {
@@ -133,11 +145,11 @@ S9sDialog::refreshScreen()
 
     for (int row = y(); row < y() + height(); ++row)
     {
-        S9sDisplay::gotoXy(x(), row);
+        gotoXy(x(), row);
         printLine(row - y());
     }
 
-    fflush(stdout);
+    fflush(m_output);
 }
 
 void
@@ -147,7 +159,7 @@ S9sDialog::printLine(
     const char *normal     = m_normalColor; 
 
     m_nChars = 0;
-    ::printf("%s", normal);
+    ::fprintf(m_output, "%s", normal);
 
     if (lineIndex == 0)
     {
@@ -217,14 +229,14 @@ S9sDialog::printLine(
         printChar("║");
     }
     
-    ::printf("%s", TERM_NORMAL);
+    ::fprintf(m_output, "%s", TERM_NORMAL);
 }
 
 void
 S9sDialog::printChar(
         const char *c)
 {
-    ::printf("%s", c);
+    ::fprintf(m_output, "%s", c);
     ++m_nChars;
 ;}
 
@@ -235,7 +247,7 @@ S9sDialog::printChar(
 {
     while (m_nChars < lastColumn)
     {
-        ::printf("%s", c);
+        ::fprintf(m_output, "%s", c);
         ++m_nChars;
     }
 }
@@ -253,7 +265,7 @@ S9sDialog::printString(
     if ((int)theString.length() > availableChars)
         myString.resize(availableChars);
 
-    ::printf("%s", STR(myString));
+    ::fprintf(m_output, "%s", STR(myString));
     m_nChars += myString.length();
 }
 
@@ -47,6 +47,7 @@ class S9sDialog : public S9sWidget
 
         virtual void refreshScreen();
         virtual void printLine(int lineIndex);
+        virtual void setOutput(FILE *output);
 
     protected:
         void printChar(const char *c);
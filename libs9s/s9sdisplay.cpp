@@ -25,6 +25,7 @@
 #include "S9sRpcReply"
 #include "S9sMutexLocker"
 #include "S9sDateTime"
+#include "S9sRpcStats"
 
 #define DEBUG
 //#define WARNING
@@ -34,8 +35,10 @@
 #include <sys/select.h>
 #include <termios.h>
 #include <string.h>
+#include <errno.h>
 #include <sys/ioctl.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 struct termios orig_termios1;
 
@@ -158,17 +161,6 @@ S9sDisplay::rotatingCharacter() const
     return charset[m_refreshCounter % 3];
 }
 
-void 
-S9sDisplay::gotoXy(
-        int x,
-        int y)
-{
-    S9sString sequence;
-
-    sequence.sprintf("\033[%d;%dH", y, x);
-    ::printf("%s", STR(sequence));
-}
-
 int 
 S9sDisplay::exec()
 {
@@ -200,10 +192,11 @@ S9sDisplay::exec()
                 uint y   = m_lastKeyCode.inputBuffer[5] - 32;
                 processButton(btn, x, y);
                 #if 0
-                ::printf ("\n\rbutton:%u\n\rx:%u\n\ry:%u\n\n\r", btn, x, y);
+                ::fprintf(m_output, 
+                        "\n\rbutton:%u\n\rx:%u\n\ry:%u\n\n\r", btn, x, y);
                 for (int idx = 0; idx < 6; ++idx)
                 {
-                    printf("[%d] 0x%x\n\r", 
+                    ::fprintf(m_output, "[%d] 0x%x\n\r", 
                             idx,
                             (int)m_lastKeyCode.inputBuffer[idx]);
                 }
@@ -214,7 +207,7 @@ S9sDisplay::exec()
                 processKey(m_lastKeyCode.lastKeyCode);
             }
 
-            refreshOk = refreshScreen();
+            refreshOk = updateScreen();
             refreshed = true;
             m_mutex.unlock();
         }
@@ -223,9 +216,12 @@ S9sDisplay::exec()
         if (!refreshed)
         {
             m_mutex.lock();
-            refreshOk = refreshScreen();
+            refreshOk = updateScreen();
             m_mutex.unlock();
         }
+
+        // The replies received by this thread are on the screen now.
+        S9sRpcStats::printingFinished();
             
         for (int idx = 0; idx < 100; ++idx)
         {
@@ -239,6 +235,66 @@ S9sDisplay::exec()
     return 0;
 }
 
+/**
+ * \returns The return value of refreshScreen().
+ *
+ * Paints the screen once. In interactive mode refreshScreen() prints into a
+ * memory stream set as the output of the display (the widgets printed by the
+ * display should print to output() too), the frame is fed into the screen
+ * buffer, then only the changed characters are sent to the terminal in one
+ * write.
+ */
+bool
+S9sDisplay::updateScreen()
+{
+#ifdef __GLIBC__
+    struct winsize  w;
+    FILE           *terminal = m_output;
+    FILE           *frame;
+    char           *buffer   = NULL;
+    size_t          size     = 0;
+    S9sString       output;
+    size_t          written  = 0;
+    bool            retval;
+
+    if (!m_interactive || ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) != 0)
+        return refreshScreen();
+    
+    frame = open_memstream(&buffer, &size);
+    if (frame == NULL)
+        return refreshScreen();
+
+    ::fflush(terminal);
+    setOutput(frame);
+    retval = refreshScreen();
+    setOutput(terminal);
+    fclose(frame);
+
+    m_screenBuffer.resize(w.ws_col, w.ws_row);
+    m_screenBuffer.write(buffer, size);
+    free(buffer);
+
+    output = m_screenBuffer.render();
+    while (written < output.length())
+    {
+        ssize_t n = ::write(
+                STDOUT_FILENO, output.c_str() + written, 
+                output.length() - written);
+
+        if (n < 0 && errno == EINTR)
+            continue;
+        else if (n <= 0)
+            break;
+
+        written += n;
+    }
+
+    return retval;
+#else
+    return refreshScreen();
+#endif
+}
+
 /**
  * \returns True if the program should continue refreshing the screen, false to
  *   exit.
@@ -264,8 +320,8 @@ S9sDisplay::printHeader()
 
     title = "S9S                ";
 
-    ::printf("%s%s%s ", bold, STR(title), normal);
-    ::printf("%s ", STR(dt.toString(S9sDateTime::LongTimeFormat)));
+    ::fprintf(m_output, "%s%s%s ", bold, STR(title), normal);
+    ::fprintf(m_output, "%s ", STR(dt.toString(S9sDateTime::LongTimeFormat)));
     printNewLine();
 }
 
@@ -280,16 +336,16 @@ S9sDisplay::printFooter()
 
     for (;m_lineCounter < height() - 1; ++m_lineCounter)
     {
-        ::printf("%s", TERM_ERASE_EOL);
-        ::printf("\n\r");
-        ::printf("%s", TERM_ERASE_EOL);
+        ::fprintf(m_output, "%s", TERM_ERASE_EOL);
+        ::fprintf(m_output, "\n\r");
+        ::fprintf(m_output, "%s", TERM_ERASE_EOL);
     } 
 
-    ::printf("%sQ%s-Quit ", bold, normal);
+    ::fprintf(m_output, "%sQ%s-Quit ", bold, normal);
 
-    ::printf("%s", TERM_ERASE_EOL);
-    ::printf("%s", TERM_NORMAL);
-    ::fflush(stdout);
+    ::fprintf(m_output, "%s", TERM_ERASE_EOL);
+    ::fprintf(m_output, "%s", TERM_NORMAL);
+    ::fflush(m_output);
 }
 
 void
@@ -372,7 +428,7 @@ S9sDisplay::startScreen()
 
     m_lineCounter = 0;
         
-    ::printf("%s", TERM_HOME);
+    ::fprintf(m_output, "%s", TERM_HOME);
 }
 
 /**
@@ -386,18 +442,18 @@ S9sDisplay::printMiddle(
 
     for (;m_lineCounter < height() / 2;)
     {
-        ::printf("%s", TERM_ERASE_EOL);
-        ::printf("\r\n");
+        ::fprintf(m_output, "%s", TERM_ERASE_EOL);
+        ::fprintf(m_output, "\r\n");
         ++m_lineCounter;
     }
 
     nSpaces = (width() - text.length()) / 2;
     for (;nSpaces > 0; --nSpaces)
-        ::printf(" ");
+        ::fprintf(m_output, " ");
 
-    ::printf("%s", STR(text));
-    ::printf("%s", TERM_ERASE_EOL);
-    ::printf("\r\n");
+    ::fprintf(m_output, "%s", STR(text));
+    ::fprintf(m_output, "%s", TERM_ERASE_EOL);
+    ::fprintf(m_output, "\r\n");
     ++m_lineCounter;
 }
 
@@ -406,11 +462,11 @@ S9sDisplay::printNewLine()
 {
     if (m_rawTerminal)
     {
-        ::printf("%s", TERM_ERASE_EOL);
-        ::printf("\n\r");
-        ::printf("%s", TERM_NORMAL);
+        ::fprintf(m_output, "%s", TERM_ERASE_EOL);
+        ::fprintf(m_output, "\n\r");
+        ::fprintf(m_output, "%s", TERM_NORMAL);
     } else {
-        ::printf("\n");
+        ::fprintf(m_output, "\n");
     }
 
     ++m_lineCounter;
@@ -440,14 +496,14 @@ S9sDisplay::setConioTerminalMode(
 
     if (interactive)
     {
-        ::printf("%s", TERM_CURSOR_OFF);
-        ::printf("%s", TERM_AUTOWRAP_OFF);
+        ::fprintf(m_output, "%s", TERM_CURSOR_OFF);
+        ::fprintf(m_output, "%s", TERM_AUTOWRAP_OFF);
     
         // Switch to the alternate buffer screen
-        ::printf("%s", "\e[?47h");
+        ::fprintf(m_output, "%s", "\e[?47h");
 
         // Enable mouse tracking
-        ::printf("%s", "\e[?9h");
+        ::fprintf(m_output, "%s", "\e[?9h");
     }
 }
 
@@ -30,6 +30,7 @@
 #include "S9sThread"
 #include "S9sWidget"
 #include "S9sFile"
+#include "S9sScreenBuffer"
 
 #define S9S_KEY_DOWN      0x425b1b
 #define S9S_KEY_UP        0x415b1b
@@ -77,11 +78,10 @@ class S9sDisplay :
 
         int lastKeyCode() const;
 
-        static void gotoXy(int x, int y);
-
     protected:
         virtual int exec();
                 
+        bool updateScreen();
         virtual bool refreshScreen();
         virtual void printHeader();
         virtual void printFooter();
@@ -122,6 +122,7 @@ class S9sDisplay :
         int                          m_lastX;
         int                          m_lastY;
         bool                         m_isStopped;
+        S9sScreenBuffer              m_screenBuffer;
 };
 
 void reset_terminal_mode();
@@ -135,12 +135,12 @@ S9sDisplayEntry::print() const
     
     nChars = m_content.size();
 
-    ::printf("%s", selection);
-    ::printf("%s", STR(m_content));
+    ::fprintf(m_output, "%s", selection);
+    ::fprintf(m_output, "%s", STR(m_content));
 
     while (nChars < width())
     {
-        ::printf(" ");
+        ::fprintf(m_output, " ");
         ++nChars;
     }
 }
@@ -156,9 +156,9 @@ S9sDisplayEntry::showCursor()
         return;
 
     sequence.sprintf("\033[%d;%dH", row, col);
-    ::printf("%s", STR(sequence));
-    ::printf("%s", TERM_CURSOR_ON);
+    ::fprintf(m_output, "%s", STR(sequence));
+    ::fprintf(m_output, "%s", TERM_CURSOR_ON);
 
-    fflush(stdout);
+    fflush(m_output);
 }
 
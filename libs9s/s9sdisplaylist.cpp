@@ -172,7 +172,7 @@ S9sDisplayList::processKey(
             break;
 
         default:
-            ::printf(" %x ", key);
+            ::fprintf(m_output, " %x ", key);
             //sleep(5);
     }
 }
@@ -54,15 +54,7 @@ S9sEditor::path() const
 S9sString 
 S9sEditor::content() const
 {
-    S9sString retval;
-
-    for (uint idx = 0u; idx < m_lines.size(); ++idx)
-    {
-        retval += m_lines[idx].toString();
-        retval += "\n";
-    }
-
-    return retval;
+    return m_lines.text();
 }
 
 void
@@ -81,7 +73,7 @@ S9sEditor::isReadonly() const
 int
 S9sEditor::numberOfLines() const
 {
-    return (int) m_lines.size();
+    return m_lines.nLines();
 }
 
 bool
@@ -124,8 +116,8 @@ S9sEditor::processKey(
                 PRINT_LOG(" m_lineOffset: %d", m_lineOffset);
             } else {
                 ++m_cursorY;
-                if (m_cursorY >= 0 && m_cursorY > (int)m_lines.size() - 1)
-                    m_cursorY = m_lines.size() - 1;
+                if (m_cursorY >= 0 && m_cursorY > m_lines.nLines() - 1)
+                    m_cursorY = m_lines.nLines() - 1;
             
                 if (m_cursorX > (int) lineAt(m_cursorY).length())
                     m_cursorX = lineAt(m_cursorY).length();
@@ -175,16 +167,13 @@ S9sEditor::processKey(
             thisLine = lineAt(m_cursorY);
 
             subString = thisLine.substr(m_cursorX);
-            m_lines[m_cursorY] = thisLine.erase(m_cursorX);
+            m_lines.setLine(m_cursorY, thisLine.erase(m_cursorX));
 
             ++m_cursorY;
-            if ((int)m_lines.size() <= m_cursorY)
-            {
-                m_lines << subString;
-            } else {
-                m_lines.insert(
-                        m_lines.begin() + m_cursorY, subString);
-            }
+            if (m_lines.nLines() <= m_cursorY)
+                m_lines.appendLine(subString);
+            else
+                m_lines.insertLine(m_cursorY, subString);
 
             m_cursorX = 0;
             break;
@@ -195,7 +184,7 @@ S9sEditor::processKey(
             if ((int)thisLine.length() >= m_cursorX)
             {
                 thisLine.erase(m_cursorX, 1);
-                m_lines[m_cursorY] = thisLine;
+                m_lines.setLine(m_cursorY, thisLine);
 
                 if (m_cursorX > (int) thisLine.length())
                     m_cursorX = thisLine.length();
@@ -215,14 +204,15 @@ S9sEditor::processKey(
                 {
                     thisLine.erase(m_cursorX - 1, 1);
                     m_cursorX--;
-                    m_lines[m_cursorY] = thisLine;
+                    m_lines.setLine(m_cursorY, thisLine);
                 }
             } else if (m_cursorY > 0) 
             {
                 m_cursorY--;
                 m_cursorX = lineAt(m_cursorY).length();
-                m_lines[m_cursorY] = lineAt(m_cursorY) + lineAt(m_cursorY + 1);
-                m_lines.erase(m_lines.begin() + (m_cursorY + 1));
+                m_lines.setLine(
+                        m_cursorY, lineAt(m_cursorY) + lineAt(m_cursorY + 1));
+                m_lines.removeLine(m_cursorY + 1);
             }
 
             return;
@@ -273,18 +263,15 @@ S9sEditor::processKey(
     if (m_lineOffset < 0)
         m_lineOffset = 0;
 
-    if (m_lineOffset > (int) m_lines.size() - height() + 8)
-        m_lineOffset = (int) m_lines.size() - height() + 8;
+    if (m_lineOffset > m_lines.nLines() - height() + 8)
+        m_lineOffset = m_lines.nLines() - height() + 8;
     #endif
 
     if (doInsert)
     {
         S9sString line;
 
-        while (m_lines.size() <= (uint) m_cursorY)
-            m_lines << "";
-
-        line = m_lines[m_cursorY].toString();
+        line = m_lines.line(m_cursorY);
         
         if (m_cursorX > (int) line.size())
             line += key;
@@ -292,7 +279,7 @@ S9sEditor::processKey(
             line.insert((size_t) m_cursorX, (size_t) 1, key);
 
         PRINT_LOG("line: '%s'", STR(line));
-        m_lines[m_cursorY] = line;
+        m_lines.setLine(m_cursorY, line);
 
         ++m_cursorX;
     }
@@ -323,9 +310,7 @@ S9sEditor::setObject(
 
     if (m_object.contains("content"))
     {
-        S9sString text = m_object["content"].toString();
-        
-        m_lines = text.split("\n", true);
+        m_lines.setText(m_object["content"].toString());
         m_cursorX = 0;
         m_cursorY = 0;
     }
@@ -352,7 +337,7 @@ S9sEditor::printLine(
     //const char *selection = "\033[1m\033[48;5;51m" "\033[2m\033[38;5;237m";
 
     m_nChars = 0;
-    ::printf("%s", normal);
+    ::fprintf(m_output, "%s", normal);
     if (lineIndex == 0)
     {
         // The top frame line.
@@ -372,9 +357,9 @@ S9sEditor::printLine(
         lineIndex -= 1;
         lineIndex += m_lineOffset;
             
-        if (lineIndex >= 0 && lineIndex < (int)m_lines.size())
+        if (lineIndex >= 0 && lineIndex < m_lines.nLines())
         {
-            printString(m_lines[lineIndex].toString());
+            printString(m_lines.line(lineIndex));
         }
 
         printChar(" ", width() - 1);
@@ -404,10 +389,10 @@ S9sEditor::printString(
     if ((int)asciiString.length() > availableChars)
     {
         asciiString.resize(availableChars);
-        ::printf("%s", STR(asciiString));
+        ::fprintf(m_output, "%s", STR(asciiString));
     } else {
-        ::printf("%s", STR(colorString));
-        ::printf("%s", normal);
+        ::fprintf(m_output, "%s", STR(colorString));
+        ::fprintf(m_output, "%s", normal);
     }
 
     m_nChars += asciiString.length();
@@ -417,7 +402,7 @@ void
 S9sEditor::printChar(
         int c)
 {
-    ::printf("%c", c);
+    ::fprintf(m_output, "%c", c);
     ++m_nChars;
 }
 
@@ -425,7 +410,7 @@ void
 S9sEditor::printChar(
         const char *c)
 {
-    ::printf("%s", c);
+    ::fprintf(m_output, "%s", c);
     ++m_nChars;
 }
 
@@ -436,7 +421,7 @@ S9sEditor::printChar(
 {
     while (m_nChars < lastColumn)
     {
-        ::printf("%s", c);
+        ::fprintf(m_output, "%s", c);
         ++m_nChars;
     }
 }
@@ -445,10 +430,7 @@ S9sString
 S9sEditor::lineAt(
         int index)
 {
-    if (index >= 0 && index < (int) m_lines.size())
-        return m_lines[index].toString();
-
-    return S9sString("");
+    return m_lines.line(index);
 }
 
 void
@@ -462,9 +444,9 @@ S9sEditor::showCursor()
         return;
 
     sequence.sprintf("\033[%d;%dH", row, col);
-    ::printf("%s", STR(sequence));
-    ::printf("%s", TERM_CURSOR_ON);
+    ::fprintf(m_output, "%s", STR(sequence));
+    ::fprintf(m_output, "%s", TERM_CURSOR_ON);
 
-    fflush(stdout);
+    fflush(m_output);
 }
 
@@ -21,6 +21,7 @@
 
 #include "S9sWidget"
 #include "S9sRpcReply"
+#include "S9sTextBuffer"
 
 class S9sEditor :
     public S9sWidget
@@ -73,7 +74,7 @@ class S9sEditor :
         S9sVariantMap    m_object;
         time_t           m_objectSetTime;
 
-        S9sVariantList   m_lines;
+        S9sTextBuffer    m_lines;
         int              m_lineOffset;
         int              m_cursorX;
         int              m_cursorY;
@@ -48,6 +48,14 @@ S9sEntryDialog::setText(
     m_entry.setText(value);
 }
 
+void
+S9sEntryDialog::setOutput(
+        FILE *output)
+{
+    S9sDialog::setOutput(output);
+    m_entry.setOutput(output);
+}
+
 void
 S9sEntryDialog::refreshScreen()
 {
@@ -63,13 +71,13 @@ S9sEntryDialog::refreshScreen()
 
     for (int row = y(); row < y() + height(); ++row)
     {
-        S9sDisplay::gotoXy(x(), row);
+        gotoXy(x(), row);
         printLine(row - y());
     }
 
     m_entry.setHasFocus(true);
     m_entry.showCursor();
-    fflush(stdout);
+    fflush(m_output);
 }
 
 void
@@ -99,18 +107,18 @@ S9sEntryDialog::printLine(
     const char *normal     = m_normalColor; 
 
     m_nChars = 0;
-    ::printf("%s", normal);
+    ::fprintf(m_output, "%s", normal);
 
     if (lineIndex == 2)
     {
         printChar("║");
         m_entry.print();
-        ::printf("%s", normal);
+        ::fprintf(m_output, "%s", normal);
         printChar("║");
     } else {
         S9sDialog::printLine(lineIndex);
     }
     
-    ::printf("%s", TERM_NORMAL);
+    ::fprintf(m_output, "%s", TERM_NORMAL);
 }
 
@@ -34,6 +34,7 @@ class S9sEntryDialog : public S9sDialog
         virtual void processKey(int key);
         virtual void refreshScreen();
         virtual void printLine(int lineIndex);
+        virtual void setOutput(FILE *output);
 
     private:
         S9sDisplayEntry  m_entry;
@@ -30,16 +30,97 @@
 //#define WARNING
 #include "s9sdebug.h"
 
+/*
+ * The names of the event types and event subclasses indexed by the enum values.
+ */
+static const char *eventTypeNames[] =
+{
+    "NoEvent", "EventExit", "EventStart", "EventCluster", "EventJob",
+    "EventHost", "EventMaintenance", "EventAlarm", "EventFile", "EventDebug",
+    "EventLog", NULL
+};
+
+static const char *eventSubClassNames[] =
+{
+    "NoSubClass", "Created", "Destroyed", "Changed", "Started", "Ended",
+    "StateChanged", "UserMessage", "LogMessage", "Measurements", NULL
+};
+
+/*
+ * The size of the hash tables we use to convert the names to enum values. The
+ * eventNameHash() function has no collisions for the names in the
+ * eventTypeNames and eventSubClassNames arrays with this size, so converting a
+ * name needs only one string compare. Please check this when adding new names.
+ */
+#define EVENT_NAME_HASH_SIZE 32
+
+static uint
+eventNameHash(
+        const S9sString &name)
+{
+    uint retval = 0u;
+
+    for (uint idx = 0u; idx < name.length(); ++idx)
+        retval = retval * 3u + (unsigned char) name[idx];
+
+    return retval % EVENT_NAME_HASH_SIZE;
+}
+
+/**
+ * A perfect hash table that maps the names from one of the name arrays above
+ * to the index in the array (which is the enum value).
+ */
+class S9sEventNameTable
+{
+    public:
+        S9sEventNameTable(
+                const char **names) :
+            m_names(names)
+        {
+            for (uint idx = 0u; idx < EVENT_NAME_HASH_SIZE; ++idx)
+                m_slots[idx] = -1;
+
+            for (int idx = 0; names[idx] != NULL; ++idx)
+                m_slots[eventNameHash(names[idx])] = idx;
+        }
+
+        int 
+            find(
+                const S9sString &name) const
+        {
+            int index = m_slots[eventNameHash(name)];
+            
+            if (index < 0 || name != m_names[index])
+                return -1;
+
+            return index;
+        }
+
+    private:
+        const char  **m_names;
+        int           m_slots[EVENT_NAME_HASH_SIZE];
+};
+
 S9sEvent::S9sEvent() :
-    S9sObject()
+    S9sObject(),
+    m_eventType(NoEvent),
+    m_eventSubClass(NoSubClass)
 {
     m_properties["class_name"] = "CmonContainer";
 }
 
+/**
+ * The event type, the subclass and the creation time are decoded here, when
+ * the event is created, so the frequently called eventType(), eventSubClass()
+ * and created() methods do not need to process the properties again.
+ */
 S9sEvent::S9sEvent(
         const S9sVariantMap &properties) :
-    S9sObject(properties)
+    S9sObject(properties),
+    m_eventType(NoEvent),
+    m_eventSubClass(NoSubClass)
 {
+    decodeProperties();
 }
 
 S9sEvent::~S9sEvent()
@@ -159,7 +240,7 @@ S9sEvent::eventTypeString() const
 S9sEvent::EventType 
 S9sEvent::eventType() const
 {
-    return stringToEventType(property("event_class").toString());
+    return m_eventType;
 }
 
 S9sString
@@ -171,75 +252,77 @@ S9sEvent::eventName() const
 S9sEvent::EventSubClass
 S9sEvent::eventSubClass() const
 {
-    return stringToEventSubClass(property("event_name").toString());
+    return m_eventSubClass;
 }
 
-S9sDateTime
+const S9sDateTime &
 S9sEvent::created() const
 {
-    S9sVariantMap theMap = property("event_origins").toVariantMap();
-    S9sDateTime   retval;
+    return m_created;
+}
 
-    retval.setFromVariantMap(theMap);
-    return retval;
+void
+S9sEvent::decodeProperties()
+{
+    if (m_properties.contains("event_class"))
+    {
+        m_eventType = stringToEventType(
+                m_properties.at("event_class").toString());
+    }
+
+    if (m_properties.contains("event_name"))
+    {
+        m_eventSubClass = stringToEventSubClass(
+                m_properties.at("event_name").toString());
+    }
+
+    if (m_properties.contains("event_origins"))
+    {
+        m_created.setFromVariantMap(
+                m_properties.at("event_origins").toVariantMap());
+    }
 }
 
 S9sEvent::EventType
 S9sEvent::stringToEventType(
         const S9sString &eventTypeString)
 {
-    if (eventTypeString == "NoEvent")
-        return NoEvent;
-    else if (eventTypeString == "EventExit")
-        return EventExit;
-    else if (eventTypeString == "EventStart")
-        return EventStart;
-    else if (eventTypeString == "EventCluster")
-        return EventCluster;
-    else if (eventTypeString == "EventJob")
-        return EventJob;
-    else if (eventTypeString == "EventHost")
-        return EventHost;
-    else if (eventTypeString == "EventMaintenance")
-        return EventMaintenance;
-    else if (eventTypeString == "EventAlarm")
-        return EventAlarm;
-    else if (eventTypeString == "EventFile")
-        return EventFile;
-    else if (eventTypeString == "EventDebug")
-        return EventDebug;
-    else if (eventTypeString == "EventLog")
-        return EventLog;
-        
-    return NoEvent;
+    static const S9sEventNameTable table(eventTypeNames);
+    int index = table.find(eventTypeString);
+
+    return index < 0 ? NoEvent : (EventType) index;
 }
 
 S9sEvent::EventSubClass
 S9sEvent::stringToEventSubClass(
         const S9sString &subClassString)
 {
-    if (subClassString == "NoSubClass")
-        return NoSubClass;
-    else if (subClassString == "Created")
-        return Created;
-    else if (subClassString == "Destroyed")
-        return Destroyed;
-    else if (subClassString == "Changed")
-        return Changed;
-    else if (subClassString == "Started")
-        return Started;
-    else if (subClassString == "Ended")
-        return Ended;
-    else if (subClassString == "StateChanged")
-        return StateChanged;
-    else if (subClassString == "UserMessage")
-        return UserMessage;
-    else if (subClassString == "LogMessage")
-        return LogMessage;
-    else if (subClassString == "Measurements")
-        return Measurements;
-        
-    return NoSubClass;
+    static const S9sEventNameTable table(eventSubClassNames);
+    int index = table.find(subClassString);
+
+    return index < 0 ? NoSubClass : (EventSubClass) index;
+}
+
+/**
+ * \returns The name of the event type as the controller sends it in the
+ *   "event_class" property.
+ */
+const char *
+S9sEvent::eventTypeToString(
+        EventType eventType)
+{
+    return eventTypeNames[eventType];
+}
+
+/**
+ * \returns The name of the event subclass as the controller sends it in the
+ *   "event_name" property.
+ */
+const char *
+S9sEvent::eventSubClassToString(
+        EventSubClass subClass)
+{
+    return eventSubClassNames[subClass];
 }
 
 
@@ -21,12 +21,12 @@
 
 #include "S9sObject"
 #include "S9sFormatter"
+#include "S9sDateTime"
 
 class S9sNode;
 class S9sServer;
 class S9sCluster;
 class S9sJob;
-class S9sDateTime;
 
 /**
  * A class that represents an event sent by the controller. 
@@ -94,7 +94,7 @@ class S9sEvent : public S9sObject
         S9sEvent::EventType eventType() const;
         S9sString eventName() const;
         S9sEvent::EventSubClass eventSubClass() const;
-        S9sDateTime created() const;
+        const S9sDateTime &created() const;
 
         S9sString 
             cmonDiskInfoToOneLiner(
@@ -120,6 +120,9 @@ class S9sEvent : public S9sObject
             stringToEventSubClass(
                     const S9sString &subClassString);
 
+        static const char *eventTypeToString(EventType eventType);
+        static const char *eventSubClassToString(EventSubClass subClass);
+
         bool hasHost() const;
         S9sNode host() const;
         
@@ -149,6 +152,15 @@ class S9sEvent : public S9sObject
         int getInt(const S9sString &path) const;
 
     private:
-        S9sFormatter m_formatter;
+        void decodeProperties();
+
+    private:
+        S9sFormatter   m_formatter;
+        /** The decoded "event_class" property. */
+        EventType      m_eventType;
+        /** The decoded "event_name" property. */
+        EventSubClass  m_eventSubClass;
+        /** The decoded "event_origins" property. */
+        S9sDateTime    m_created;
 };
 
@@ -0,0 +1,288 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9seventrecorder.h"
+
+#include "S9sEvent"
+#include "S9sVector"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+/*
+ * The number of the events that can be in the queue waiting to be written. If
+ * the queue is full the thread that records the events waits.
+ */
+#define RING_SIZE       16384
+
+/*
+ * The buffer is written into the file when it is at least this big or when the
+ * last write was at least FLUSH_SECONDS seconds ago.
+ */
+#define FLUSH_SIZE      (256 * 1024)
+#define FLUSH_SECONDS   1
+
+static S9sVector<S9sEventRecorder *> sm_recorders;
+
+/**
+ * This function is registered with atexit() so that the events already
+ * received are written into the file even if the program exits by calling
+ * exit() (e.g. the user pressed ctrl-c or 'q').
+ */
+static void
+stopRecorders()
+{
+    S9sEventRecorder::stopAll();
+}
+
+S9sEventRecorder::S9sEventRecorder() :
+    m_ring(new S9sVariantMap *[RING_SIZE]),
+    m_head(0u),
+    m_tail(0u),
+    m_stopRequested(false),
+    m_failed(false),
+    m_running(false),
+    m_lastFlush(0)
+{
+}
+
+S9sEventRecorder::~S9sEventRecorder()
+{
+    stop();
+
+    while (m_tail != m_head)
+    {
+        delete m_ring[m_tail];
+        m_tail = (m_tail + 1) % RING_SIZE;
+    }
+
+    delete[] m_ring;
+}
+
+/**
+ * \param file The file where the events will be appended.
+ * \returns true if the background thread was started.
+ */
+bool
+S9sEventRecorder::start(
+        const S9sFile &file)
+{
+    static bool atExitRegistered = false;
+
+    if (m_running)
+        return true;
+
+    m_file          = file;
+    m_stopRequested = false;
+    m_lastFlush     = time(NULL);
+    m_running       = S9sThread::start();
+
+    if (m_running)
+    {
+        sm_recorders << this;
+        if (!atExitRegistered)
+        {
+            atexit(stopRecorders);
+            atExitRegistered = true;
+        }
+    }
+
+    return m_running;
+}
+
+/**
+ * Stops the background thread after all the events in the queue are written
+ * into the file.
+ */
+void
+S9sEventRecorder::stop()
+{
+    if (!m_running)
+        return;
+
+    m_stopRequested = true;
+    join();
+    m_running = false;
+
+    for (uint idx = 0u; idx < sm_recorders.size(); ++idx)
+    {
+        if (sm_recorders[idx] == this)
+        {
+            sm_recorders.erase(sm_recorders.begin() + idx);
+            break;
+        }
+    }
+}
+
+/**
+ * Stops all the event recorders that are running.
+ */
+void
+S9sEventRecorder::stopAll()
+{
+    while (!sm_recorders.empty())
+        sm_recorders.back()->stop();
+}
+
+/**
+ * \param event The event to be written into the file.
+ * \returns false if the recorder failed to write the file.
+ *
+ * This method is called by the thread that receives the events. It only puts
+ * a copy of the event properties into the queue, the background thread will
+ * format and write it. 
+ */
+bool
+S9sEventRecorder::record(
+        const S9sEvent &event)
+{
+    uint head = m_head.load(std::memory_order_relaxed);
+    uint next = (head + 1) % RING_SIZE;
+
+    if (m_failed.load(std::memory_order_acquire))
+        return false;
+
+    // If the queue is full we wait for the writer.
+    while (next == m_tail.load(std::memory_order_acquire))
+    {
+        if (m_failed.load(std::memory_order_acquire))
+            return false;
+
+        usleep(1000);
+    }
+
+    m_ring[head] = new S9sVariantMap(event.toVariantMap());
+    m_head.store(next, std::memory_order_release);
+
+    return true;
+}
+
+bool
+S9sEventRecorder::hasError() const
+{
+    return m_failed.load(std::memory_order_acquire);
+}
+
+/**
+ * \returns The error message when hasError() returns true.
+ */
+S9sString
+S9sEventRecorder::errorString() const
+{
+    if (!hasError())
+        return S9sString();
+
+    return m_errorString;
+}
+
+bool
+S9sEventRecorder::shouldStop() const
+{
+    return m_stopRequested.load(std::memory_order_acquire);
+}
+
+/**
+ * The main loop of the background thread. 
+ */
+int
+S9sEventRecorder::exec()
+{
+    int nRecords = 0;
+
+    for (;;)
+    {
+        uint   nTaken = takeRecords();
+        time_t now    = time(NULL);
+
+        nRecords += nTaken;
+        if (m_buffer.size() >= FLUSH_SIZE || 
+                (!m_buffer.empty() && now - m_lastFlush >= FLUSH_SECONDS))
+        {
+            if (!writeBuffer())
+                break;
+        }
+
+        if (nTaken == 0u)
+        {
+            if (shouldStop())
+            {
+                writeBuffer();
+                break;
+            }
+
+            usleep(10000);
+        }
+    }
+
+    m_file.close();
+    return nRecords;
+}
+
+/**
+ * Takes the records from the queue and formats them into the buffer. Stops
+ * when the buffer is big enough to be written.
+ */
+uint
+S9sEventRecorder::takeRecords()
+{
+    uint retval = 0u;
+    uint tail   = m_tail.load(std::memory_order_relaxed);
+
+    while (tail != m_head.load(std::memory_order_acquire) &&
+            m_buffer.size() < FLUSH_SIZE)
+    {
+        S9sVariantMap *record = m_ring[tail];
+
+        m_buffer += record->toString();
+        m_buffer += "\n\n";
+        delete record;
+
+        tail = (tail + 1) % RING_SIZE;
+        m_tail.store(tail, std::memory_order_release);
+        ++retval;
+    }
+
+    return retval;
+}
+
+/**
+ * Writes the buffer into the file with one write and flush.
+ */
+bool
+S9sEventRecorder::writeBuffer()
+{
+    m_lastFlush = time(NULL);
+    if (m_buffer.empty())
+        return true;
+
+    if (!m_file.fprintf("%s", STR(m_buffer)))
+    {
+        m_errorString = m_file.errorString();
+        m_failed.store(true, std::memory_order_release);
+        return false;
+    }
+
+    m_file.flush();
+    m_buffer.clear();
+    return true;
+}
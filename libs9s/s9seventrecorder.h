@@ -0,0 +1,74 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sThread"
+#include "S9sFile"
+#include "S9sVariantMap"
+
+#include <atomic>
+
+class S9sEvent;
+
+/**
+ * A class that writes the received events into a file from a background
+ * thread. The thread that receives the events only puts the raw event records
+ * into a single producer, single consumer ring buffer, the formatting and the
+ * disk writes are done by the background thread in batches, so a slow disk
+ * will not stall the processing of the events.
+ */
+class S9sEventRecorder : public S9sThread
+{
+    public:
+        S9sEventRecorder();
+        virtual ~S9sEventRecorder();
+
+        bool start(const S9sFile &file);
+        void stop();
+
+        bool record(const S9sEvent &event);
+
+        bool hasError() const;
+        S9sString errorString() const;
+
+        static void stopAll();
+
+    protected:
+        virtual int exec();
+        virtual bool shouldStop() const;
+
+    private:
+        uint takeRecords();
+        bool writeBuffer();
+
+    private:
+        S9sFile                     m_file;
+        S9sVariantMap             **m_ring;
+        /** Where the producer puts the next record. */
+        std::atomic<uint>           m_head;
+        /** Where the consumer takes the next record from. */
+        std::atomic<uint>           m_tail;
+        std::atomic<bool>           m_stopRequested;
+        std::atomic<bool>           m_failed;
+        bool                        m_running;
+        S9sString                   m_buffer;
+        time_t                      m_lastFlush;
+        S9sString                   m_errorString;
+};
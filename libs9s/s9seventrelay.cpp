@@ -0,0 +1,716 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9seventrelay.h"
+
+#include "S9sOptions"
+
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+#define RELAY_MAGIC      0x53394552u
+#define RELAY_VERSION    1u
+
+/*
+ * The default size of the ring buffer, a few thousand events.
+ */
+#define RELAY_CAPACITY   (8 * 1024 * 1024)
+
+/*
+ * The length field that marks the unused space at the end of the ring, the
+ * next record is at the beginning.
+ */
+#define WRAP_MARKER      0xffffffffu
+
+/*
+ * The records are aligned to this many bytes and every record starts with a
+ * header of this size holding the length of the record.
+ */
+#define RECORD_ALIGN     8u
+
+/*
+ * How long (in microseconds) the readers sleep when there are no new records.
+ */
+#define POLL_INTERVAL    10000
+
+/**
+ * The header at the beginning of the shared memory, followed by the ring
+ * itself. The positions are counted in bytes from the creation of the ring,
+ * they only grow, the offset in the ring is the position modulo the capacity.
+ */
+struct S9sEventRelayHeader
+{
+    std::atomic<uint32_t>   magic;
+    uint32_t                version;
+    int32_t                 pid;
+    uint32_t                reserved;
+    ulonglong               capacity;
+    /** The end of the last published record. */
+    std::atomic<ulonglong>  head;
+    /** The start of the oldest record that is still in the ring. */
+    std::atomic<ulonglong>  tail;
+};
+
+/*
+ * The name of the shared memory of the relay this process created, used in
+ * the signal handler.
+ */
+static char relayName[256];
+
+static void
+relaySignalHandler(
+        int signal)
+{
+    if (relayName[0] != '\0')
+        shm_unlink(relayName);
+
+    s9s_log_flush_in_signal_handler();
+    _exit(0);
+}
+
+static inline ulonglong
+alignedSize(
+        const uint32_t length)
+{
+    return RECORD_ALIGN + 
+        (length + RECORD_ALIGN - 1) / RECORD_ALIGN * RECORD_ALIGN;
+}
+
+/*
+ * Replaces the characters that should not be in the name of the shared memory
+ * with an underscore and the hexadecimal code of the character. The underscore
+ * itself is also escaped, so different names never give the same result.
+ */
+static S9sString
+safeName(
+        const S9sString &name)
+{
+    S9sString retval;
+
+    for (uint idx = 0u; idx < name.size(); ++idx)
+    {
+        unsigned char c = name[idx];
+
+        if (isalnum(c) || c == '.' || c == '-')
+        {
+            retval += (char) c;
+        } else {
+            S9sString escaped;
+
+            escaped.sprintf("_%02x", (int) c);
+            retval += escaped;
+        }
+    }
+
+    return retval;
+}
+
+S9sEventRelay::S9sEventRelay() :
+    m_fd(-1),
+    m_owner(false),
+    m_memory(NULL),
+    m_size(0),
+    m_header(NULL),
+    m_data(NULL),
+    m_position(0ull),
+    m_nLost(0ull),
+    m_stopRequested(false)
+{
+}
+
+/**
+ * \param name The name of the shared memory object to use instead of the one
+ *   shmName() returns.
+ */
+S9sEventRelay::S9sEventRelay(
+        const S9sString &name) :
+    m_name(name),
+    m_fd(-1),
+    m_owner(false),
+    m_memory(NULL),
+    m_size(0),
+    m_header(NULL),
+    m_data(NULL),
+    m_position(0ull),
+    m_nLost(0ull),
+    m_stopRequested(false)
+{
+}
+
+S9sEventRelay::~S9sEventRelay()
+{
+    if (m_owner && !m_name.empty())
+        shm_unlink(STR(m_name));
+
+    unmap();
+}
+
+/**
+ * \returns The name of the shared memory object for the controller and the
+ *   Cmon user the program uses. Every user has their own relay, the events are
+ *   not shared between the users (the controller sends the events the Cmon
+ *   user is allowed to see).
+ */
+S9sString
+S9sEventRelay::shmName()
+{
+    S9sOptions *options  = S9sOptions::instance();
+    S9sString   hostName = options->controllerHostName();
+    S9sString   userName = options->userName();
+    S9sString   retval;
+
+    if (hostName.empty())
+        hostName = "localhost";
+
+    if (userName.empty())
+        userName = "-";
+
+    retval.sprintf("/s9s-events-%d-%s-%s-%d", 
+            (int) geteuid(), STR(safeName(userName)), STR(safeName(hostName)), 
+            options->controllerPort());
+
+    return retval;
+}
+
+/**
+ * \returns false if the user disabled the reading of the events from the
+ *   relay by setting the S9S_NO_EVENT_RELAY environment variable.
+ */
+bool
+S9sEventRelay::isEnabled()
+{
+    return getenv("S9S_NO_EVENT_RELAY") == NULL;
+}
+
+/**
+ * \returns false if the relay could not be started, true never, the relay runs
+ *   until it is killed.
+ *
+ * This is the main function of the s9s --event-relay. Creates the ring, then
+ * authenticates and subscribes to the events, re-subscribing if the event
+ * stream is closed.
+ */
+bool
+S9sEventRelay::exec()
+{
+    S9sOptions   *options = S9sOptions::instance();
+    S9sRpcClient  client(
+            options->controllerHostName(), options->controllerPort(),
+            options->controllerPath(), options->useTls());
+
+    if (!create(RELAY_CAPACITY))
+        return false;
+
+    strncpy(relayName, STR(m_name), sizeof(relayName) - 1);
+    signal(SIGINT,  relaySignalHandler);
+    signal(SIGTERM, relaySignalHandler);
+    signal(SIGHUP,  relaySignalHandler);
+
+    PRINT_LOG("Event relay started on %s.", STR(m_name));
+    for (;;)
+    {
+        if (!client.isAuthenticated())
+        {
+            client.maybeAuthenticate();
+
+            if (!client.isAuthenticated())
+            {
+                PRINT_LOG("Relay failed to authenticate: %s",
+                        STR(client.errorString()));
+
+                sleep(3);
+                continue;
+            }
+        }
+
+        // This does not return while the controller sends the events.
+        client.subscribeEvents(S9sEventRelay::eventHandler, (void *) this);
+
+        PRINT_LOG("Event stream closed: %s", STR(client.errorString()));
+        sleep(1);
+    }
+
+    return true;
+}
+
+/**
+ * Static callback that publishes the events received by the relay.
+ */
+void
+S9sEventRelay::eventHandler(
+        const S9sVariantMap &jsonMessage,
+        void                *userData)
+{
+    S9sEventRelay *relay = (S9sEventRelay *) userData;
+
+    if (relay == NULL)
+        return;
+
+    if (!jsonMessage.contains("class_name") ||
+            jsonMessage.at("class_name").toString() != "CmonEvent")
+    {
+        return;
+    }
+
+    relay->publish(jsonMessage.toJsonString(S9sFormatNormal));
+}
+
+/**
+ * \param capacity The size of the ring in bytes.
+ * \returns true if the shared memory was created.
+ *
+ * Creates the shared memory of the relay. If a shared memory exists for the
+ * same controller it is re-used, unless the relay that created it is still
+ * running.
+ */
+bool
+S9sEventRelay::create(
+        const size_t capacity)
+{
+    size_t size = sizeof(S9sEventRelayHeader) + capacity;
+
+    if (capacity < RECORD_ALIGN)
+    {
+        m_errorString.sprintf("The capacity %zu is too small.", capacity);
+        return false;
+    }
+
+    if (m_name.empty())
+        m_name = shmName();
+    
+    if (attach())
+    {
+        m_errorString.sprintf(
+                "An event relay is already running (pid %d).", 
+                m_header->pid);
+
+        detach();
+        return false;
+    }
+
+    // The readers that are still attached to the ring of a relay that is gone
+    // keep their own copy until they notice the relay is not running.
+    if (shm_unlink(STR(m_name)) != 0 && errno != ENOENT)
+    {
+        m_errorString.sprintf(
+                "Error removing shared memory '%s': %m", STR(m_name));
+        return false;
+    }
+
+    m_fd = shm_open(STR(m_name), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (m_fd < 0)
+    {
+        m_errorString.sprintf(
+                "Error creating shared memory '%s': %m", STR(m_name));
+        return false;
+    }
+
+    if (ftruncate(m_fd, size) != 0)
+    {
+        m_errorString.sprintf(
+                "Error resizing shared memory '%s': %m", STR(m_name));
+        unmap();
+        return false;
+    }
+
+    if (!map(size, true))
+    {
+        unmap();
+        return false;
+    }
+
+    m_owner             = true;
+    m_header->version   = RELAY_VERSION;
+    m_header->pid       = getpid();
+    m_header->capacity  = capacity / RECORD_ALIGN * RECORD_ALIGN;
+    m_header->head.store(0ull, std::memory_order_relaxed);
+    m_header->tail.store(0ull, std::memory_order_relaxed);
+
+    // The readers only accept the ring after this.
+    m_header->magic.store(RELAY_MAGIC, std::memory_order_release);
+    return true;
+}
+
+/**
+ * \param record The event record to publish.
+ * \returns true if the record was published, false if it is too big.
+ *
+ * Puts one record into the ring, overwriting the oldest records if
+ * necessary. Only the relay calls this.
+ */
+bool
+S9sEventRelay::publish(
+        const S9sString &record)
+{
+    ulonglong  capacity = m_header->capacity;
+    ulonglong  head     = m_header->head.load(std::memory_order_relaxed);
+    ulonglong  size     = alignedSize(record.length());
+    ulonglong  offset   = head % capacity;
+    uint32_t   length   = record.length();
+
+    if (!m_owner || size > capacity / 2)
+        return false;
+
+    // If the record does not fit at the end we skip to the beginning.
+    if (offset + size > capacity)
+    {
+        uint32_t marker = WRAP_MARKER;
+
+        reserve(head + capacity - offset);
+        memcpy(m_data + offset, &marker, sizeof(marker));
+
+        head  += capacity - offset;
+        offset = 0ull;
+    }
+
+    reserve(head + size);
+    memcpy(m_data + offset, &length, sizeof(length));
+    memcpy(m_data + offset + RECORD_ALIGN, record.data(), length);
+
+    m_header->head.store(head + size, std::memory_order_release);
+    return true;
+}
+
+/**
+ * \param end The position up to which the writer needs the space.
+ *
+ * Moves the tail over the oldest records so that the writer can overwrite
+ * them. The tail is moved before the records are overwritten, this is how
+ * the readers know a record they copied might be damaged.
+ */
+void
+S9sEventRelay::reserve(
+        const ulonglong end)
+{
+    ulonglong capacity = m_header->capacity;
+    ulonglong tail     = m_header->tail.load(std::memory_order_relaxed);
+    ulonglong head     = m_header->head.load(std::memory_order_relaxed);
+
+    if (end - tail <= capacity)
+        return;
+
+    while (end - tail > capacity && tail < head)
+        tail += recordSize(tail);
+
+    if (tail > head)
+        tail = head;
+
+    m_header->tail.store(tail, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+/**
+ * \returns The number of bytes the record at the given position occupies.
+ */
+ulonglong
+S9sEventRelay::recordSize(
+        const ulonglong position) const
+{
+    ulonglong capacity = m_header->capacity;
+    ulonglong offset   = position % capacity;
+    uint32_t  length;
+
+    memcpy(&length, m_data + offset, sizeof(length));
+    if (length == WRAP_MARKER)
+        return capacity - offset;
+
+    return alignedSize(length);
+}
+
+/**
+ * \returns true if a running relay was found and the ring is attached.
+ *
+ * Attaches to the ring of the relay as a reader. The reader starts with the
+ * oldest record in the ring.
+ */
+bool
+S9sEventRelay::attach()
+{
+    struct stat  info;
+
+    if (isAttached())
+        return true;
+
+    if (m_name.empty())
+        m_name = shmName();
+
+    m_fd = shm_open(STR(m_name), O_RDONLY, 0600);
+    if (m_fd < 0)
+        return false;
+
+    // The shared memory can be created by anyone, we only accept the ring
+    // that is created by the same user and can not be written by others.
+    if (fstat(m_fd, &info) != 0 || 
+            info.st_uid != geteuid() ||
+            (info.st_mode & 077) != 0 ||
+            (size_t) info.st_size < sizeof(S9sEventRelayHeader) ||
+            !map(info.st_size, false))
+    {
+        unmap();
+        return false;
+    }
+
+    if (m_header->magic.load(std::memory_order_acquire) != RELAY_MAGIC ||
+            m_header->version != RELAY_VERSION ||
+            m_header->capacity == 0ull ||
+            m_header->capacity % RECORD_ALIGN != 0ull ||
+            m_header->capacity + sizeof(S9sEventRelayHeader) > m_size ||
+            !isAlive())
+    {
+        unmap();
+        return false;
+    }
+
+    m_position = m_header->tail.load(std::memory_order_acquire);
+    m_nLost    = 0ull;
+
+    return true;
+}
+
+void
+S9sEventRelay::detach()
+{
+    unmap();
+}
+
+bool
+S9sEventRelay::isAttached() const
+{
+    return m_header != NULL;
+}
+
+/**
+ * \returns true if the relay process that writes the ring is still running.
+ */
+bool
+S9sEventRelay::isAlive() const
+{
+    if (m_header == NULL || m_header->pid <= 0)
+        return false;
+
+    if (m_owner)
+        return true;
+
+    return kill(m_header->pid, 0) == 0 || errno == EPERM;
+}
+
+/**
+ * \param record The next record will be placed here.
+ * \returns true if a record was read, false if there are no new records.
+ *
+ * Reads the next record from the ring without locking. If the writer
+ * overwrote the records the reader did not read yet the reader continues with
+ * the oldest record still in the ring.
+ */
+bool
+S9sEventRelay::read(
+        S9sString &record)
+{
+    ulonglong capacity;
+
+    if (m_header == NULL)
+        return false;
+
+    capacity = m_header->capacity;
+    for (;;)
+    {
+        ulonglong head   = m_header->head.load(std::memory_order_acquire);
+        ulonglong tail   = m_header->tail.load(std::memory_order_acquire);
+        ulonglong offset = m_position % capacity;
+        uint32_t  length;
+
+        if (m_position < tail)
+        {
+            // The writer lapped us.
+            ++m_nLost;
+            m_position = tail;
+            continue;
+        }
+
+        if (m_position >= head)
+            return false;
+
+        memcpy(&length, m_data + offset, sizeof(length));
+        if (length != WRAP_MARKER)
+        {
+            if (offset + alignedSize(length) > capacity)
+                length = 0u;
+
+            record.assign(m_data + offset + RECORD_ALIGN, length);
+        }
+
+        // If the tail moved over the record while we copied it, it might be
+        // damaged.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        tail = m_header->tail.load(std::memory_order_relaxed);
+        if (m_position < tail)
+        {
+            ++m_nLost;
+            m_position = tail;
+            continue;
+        }
+
+        if (length == WRAP_MARKER)
+        {
+            m_position += capacity - offset;
+            continue;
+        }
+
+        m_position += alignedSize(length);
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * \param callbackFunction The function that is called for every event.
+ * \param userData The pointer passed to the callback function.
+ * \returns false when the relay is gone.
+ *
+ * Reads the events from the ring and passes them to the callback function the
+ * same way the S9sRpcClient::subscribeEvents() does. Returns only when the
+ * relay stops, then the caller should subscribe to the events itself.
+ */
+bool
+S9sEventRelay::consume(
+        S9sJSonHandler  callbackFunction,
+        void           *userData)
+{
+    S9sString      record;
+    S9sVariantMap  jsonMessage;
+    time_t         lastCheck = time(NULL);
+
+    while (isAttached() && !m_stopRequested)
+    {
+        while (!m_stopRequested && read(record))
+        {
+            jsonMessage.clear();
+            if (!jsonMessage.parse(STR(record)))
+                continue;
+
+            callbackFunction(jsonMessage, userData);
+        }
+
+        if (time(NULL) != lastCheck)
+        {
+            lastCheck = time(NULL);
+
+            if (!isAlive())
+                break;
+        }
+
+        usleep(POLL_INTERVAL);
+    }
+
+    detach();
+    return false;
+}
+
+/**
+ * Makes the consume() return. This can be called from an other thread, the
+ * reader does not read from the ring after this.
+ */
+void
+S9sEventRelay::stop()
+{
+    m_stopRequested = true;
+}
+
+/**
+ * \returns How many times the reader had to skip records because the writer
+ *   overwrote them.
+ */
+ulonglong
+S9sEventRelay::nLost() const
+{
+    return m_nLost;
+}
+
+/**
+ * \returns The name of the shared memory object the relay uses.
+ */
+S9sString
+S9sEventRelay::name() const
+{
+    return m_name;
+}
+
+S9sString
+S9sEventRelay::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * \param size The size of the shared memory.
+ * \param writable True for the relay, false for the readers.
+ */
+bool
+S9sEventRelay::map(
+        const size_t size,
+        const bool   writable)
+{
+    int   protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    void *memory;
+
+    memory = mmap(NULL, size, protection, MAP_SHARED, m_fd, 0);
+    if (memory == MAP_FAILED)
+    {
+        m_errorString.sprintf(
+                "Error mapping shared memory '%s': %m", STR(m_name));
+        return false;
+    }
+
+    m_memory = (char *) memory;
+    m_size   = size;
+    m_header = (S9sEventRelayHeader *) m_memory;
+    m_data   = m_memory + sizeof(S9sEventRelayHeader);
+
+    return true;
+}
+
+void
+S9sEventRelay::unmap()
+{
+    if (m_memory != NULL)
+        munmap(m_memory, m_size);
+
+    if (m_fd >= 0)
+        ::close(m_fd);
+
+    m_fd     = -1;
+    m_memory = NULL;
+    m_size   = 0;
+    m_header = NULL;
+    m_data   = NULL;
+}
@@ -0,0 +1,92 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sString"
+#include "S9sVariantMap"
+#include "S9sRpcClient"
+
+#include <atomic>
+
+struct S9sEventRelayHeader;
+
+/**
+ * A class that shares one event subscription between the local s9s processes.
+ * The relay (s9s --event-relay) subscribes to the events of the controller and
+ * publishes the event records into a ring buffer in a POSIX shared memory
+ * object. The monitors (e.g. s9s event --watch) of the same user and the same
+ * controller attach to the ring and read the records without locking, so the
+ * controller has to serve only one event stream. There is only one writer, the
+ * readers never modify the ring; a reader that starts late replays the events
+ * that are still in the ring and a reader that is too slow skips the records
+ * the writer overwrote.
+ */
+class S9sEventRelay
+{
+    public:
+        S9sEventRelay();
+        S9sEventRelay(const S9sString &name);
+        virtual ~S9sEventRelay();
+
+        bool exec();
+
+        bool create(const size_t capacity);
+        bool publish(const S9sString &record);
+
+        bool attach();
+        void detach();
+        bool isAttached() const;
+        bool isAlive() const;
+        bool read(S9sString &record);
+        bool consume(S9sJSonHandler callbackFunction, void *userData);
+        void stop();
+
+        ulonglong nLost() const;
+        S9sString name() const;
+        S9sString errorString() const;
+
+        static S9sString shmName();
+        static bool isEnabled();
+
+        static void 
+            eventHandler(
+                const S9sVariantMap &jsonMessage,
+                void                *userData);
+
+    private:
+        bool map(const size_t size, const bool writable);
+        void unmap();
+        ulonglong recordSize(const ulonglong position) const;
+        void reserve(const ulonglong end);
+
+    private:
+        S9sString              m_name;
+        int                    m_fd;
+        bool                   m_owner;
+        char                  *m_memory;
+        size_t                 m_size;
+        S9sEventRelayHeader   *m_header;
+        char                  *m_data;
+        /** Where the reader is going to read the next record. */
+        ulonglong              m_position;
+        ulonglong              m_nLost;
+        std::atomic<bool>      m_stopRequested;
+        S9sString              m_errorString;
+};
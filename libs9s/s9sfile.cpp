@@ -21,9 +21,11 @@
 #include "s9sfile_p.h"
 
 #include "S9sVariantList"
+#include "S9sVariantMap"
 #include "S9sEvent"
 
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -233,6 +235,15 @@ S9sFile::close()
     m_priv->close();
 }
 
+/**
+ * \param event The event read from the file.
+ * \returns true if an event was read.
+ *
+ * Reads the next event from a file holding events separated by empty lines
+ * (like the files the event recorder creates). If the file can be mapped the
+ * events are parsed one by one directly from the mapped memory, so replaying
+ * even very large files does not need to read them into the memory.
+ */
 bool
 S9sFile::readEvent(
         S9sEvent &event)
@@ -241,6 +252,12 @@ S9sFile::readEvent(
     S9sString     jsonString;
     S9sString     line;
 
+    if (m_priv->m_inputStream == NULL && !m_priv->m_mapped)
+        mapForRead();
+
+    if (m_priv->m_mapped)
+        return readMappedEvent(event);
+
     event = S9sEvent();
     for (;;)
     {
@@ -264,6 +281,90 @@ S9sFile::readEvent(
     return true;
 }
 
+/**
+ * Reads the next event from the mapped file. The empty lines before the event
+ * are skipped, the event ends with an empty line or at the end of the file.
+ */
+bool
+S9sFile::readMappedEvent(
+        S9sEvent &event)
+{
+    const char    *data   = m_priv->m_mapData;
+    size_t         size   = m_priv->m_mapSize;
+    size_t        &cursor = m_priv->m_mapCursor;
+    size_t         start  = 0;
+    size_t         end    = 0;
+    bool           found  = false;
+    S9sVariantMap  theMap;
+    struct stat    statBuffer;
+
+    event = S9sEvent();
+    
+    /*
+     * Reading the pages that were cut from the file would kill us with a
+     * SIGBUS. This does not protect against truncating while the event is
+     * parsed, but a recording that is replayed is not truncated normally.
+     */
+    if (m_priv->m_mapFd >= 0 && fstat(m_priv->m_mapFd, &statBuffer) == 0 &&
+            (size_t) statBuffer.st_size < size)
+    {
+        m_priv->m_errorString.sprintf(
+                "The file '%s' was truncated while it was read.", 
+                STR(m_priv->m_path));
+
+        PRINT_LOG("%s", STR(m_priv->m_errorString));
+        return false;
+    }
+
+    while (cursor < size)
+    {
+        const char *newLine = (const char *) 
+            memchr(data + cursor, '\n', size - cursor);
+        size_t      lineEnd = newLine ? newLine - data + 1 : size;
+        bool        isEmpty = true;
+
+        for (size_t idx = cursor; idx < lineEnd; ++idx)
+        {
+            if (data[idx] != ' ' && data[idx] != '\n' && data[idx] != '\r')
+            {
+                isEmpty = false;
+                break;
+            }
+        }
+
+        if (newLine)
+            ++m_priv->m_lineNumber;
+
+        if (!isEmpty)
+        {
+            if (!found)
+                start = cursor;
+
+            found = true;
+            end   = lineEnd;
+        }
+        
+        cursor = lineEnd;
+
+        if (isEmpty && found)
+            break;
+    }
+
+    if (!found)
+        return false;
+
+    if (!theMap.parse(data + start, end - start))
+    {
+        S9S_WARNING("Error parsing: \n%s", 
+                STR(std::string(data + start, end - start)));
+
+        return false;
+    }
+
+    event = theMap;
+    return true;
+}
+
 /**
  * \returns The current line number, the number of the line where the readline
  * function works.
@@ -339,6 +440,14 @@ S9sFile::readTxtFile(
     // content should be empty
     content.clear();
 
+    // Reserving the memory in one step if we know the size.
+    struct stat statBuffer;
+    if (fstat(fileDescriptor, &statBuffer) == 0 && 
+            S_ISREG(statBuffer.st_mode))
+    {
+        content.reserve((size_t) statBuffer.st_size);
+    }
+
     char *buffer = new char[READ_BUFFER_SIZE];
     if (buffer == 0) 
     {
@@ -370,17 +479,207 @@ S9sFile::readTxtFile(
     return retval;
 }
 
+/**
+ * \param content The parsed content of the file.
+ * \returns true if the file was read and parsed.
+ *
+ * Reads and parses a JSON file. The file is parsed directly from the mapped
+ * memory if possible, so it is not copied into a string first. The file should
+ * not be truncated while it is being parsed, so this should be used for files
+ * that are replaced by renaming or only appended.
+ */
+bool
+S9sFile::readJsonFile(
+        S9sVariantMap &content)
+{
+    bool wasMapped = m_priv->m_mapped;
+    bool success;
+
+    content.clear();
+
+    if (!wasMapped && !mapForRead())
+    {
+        S9sString text;
+
+        // Maybe a pipe or some special file.
+        if (!readTxtFile(text))
+            return false;
+
+        success = content.parse(STR(text));
+    } else {
+        success = content.parse(
+                m_priv->m_mapData != NULL ? m_priv->m_mapData : "",
+                m_priv->m_mapSize);
+
+        if (!wasMapped)
+            m_priv->unmap();
+    }
+
+    if (!success)
+    {
+        m_priv->m_errorString.sprintf(
+                "Error parsing '%s'.", STR(m_priv->m_path));
+
+        content.clear();
+    }
+
+    return success;
+}
+
+/**
+ * \returns true if the file was mapped into the memory.
+ *
+ * Maps the whole file into the memory read-only, the content is then available
+ * through the mappedData() and mappedSize() methods until the file is closed.
+ * An empty file is mapped too, then the mappedData() is NULL and the
+ * mappedSize() is 0.
+ *
+ * Only regular files are mapped, the pipes and the other special files are not
+ * even opened here, so nothing is read from them. Truncating a mapped file
+ * makes the process receive a SIGBUS when it touches the missing pages, so
+ * this should be used for files that are replaced by renaming or only
+ * appended.
+ */
+bool
+S9sFile::mapForRead()
+{
+    struct stat  statBuffer;
+    int          fileDescriptor;
+    void        *data = NULL;
+
+    close();
+
+    if (::stat(STR(m_priv->m_path), &statBuffer) != 0)
+    {
+        m_priv->m_errorString.sprintf(
+                "Error getting the size of '%s': %m", 
+                STR(m_priv->m_path));
+
+        return false;
+    } else if (!S_ISREG(statBuffer.st_mode))
+    {
+        m_priv->m_errorString.sprintf(
+                "Can not map '%s', it is not a regular file.", 
+                STR(m_priv->m_path));
+
+        return false;
+    }
+
+    // Not blocking if the file was replaced by a pipe since the stat().
+    fileDescriptor = open(STR(m_priv->m_path), O_RDONLY | O_NONBLOCK); 
+    if (fileDescriptor < 0)
+    {
+        m_priv->m_errorString.sprintf(
+                "Error opening '%s' for reading: %m", 
+                STR(m_priv->m_path));
+
+        return false;
+    }
+
+    if (fstat(fileDescriptor, &statBuffer) != 0)
+    {
+        m_priv->m_errorString.sprintf(
+                "Error getting the size of '%s': %m", 
+                STR(m_priv->m_path));
+
+        ::close(fileDescriptor);
+        return false;
+    } else if (!S_ISREG(statBuffer.st_mode))
+    {
+        m_priv->m_errorString.sprintf(
+                "Can not map '%s', it is not a regular file.", 
+                STR(m_priv->m_path));
+
+        ::close(fileDescriptor);
+        return false;
+    }
+
+    // An empty file can not be mapped, but it is not an error.
+    if (statBuffer.st_size > 0)
+    {
+        data = mmap(NULL, (size_t) statBuffer.st_size, PROT_READ, MAP_PRIVATE,
+                fileDescriptor, 0);
+
+        if (data == MAP_FAILED)
+        {
+            m_priv->m_errorString.sprintf(
+                    "Error mapping '%s': %m", STR(m_priv->m_path));
+
+            ::close(fileDescriptor);
+            return false;
+        }
+
+        madvise(data, (size_t) statBuffer.st_size, MADV_SEQUENTIAL);
+    }
+
+    // The file is kept open, readMappedEvent() checks its size.
+    m_priv->m_mapFd      = fileDescriptor;
+    m_priv->m_mapped     = true;
+    m_priv->m_mapData    = (const char *) data;
+    m_priv->m_mapSize    = data != NULL ? (size_t) statBuffer.st_size : 0;
+    m_priv->m_mapCursor  = 0;
+    m_priv->m_lineNumber = 0ull;
+
+    return true;
+}
+
+bool
+S9sFile::isMapped() const
+{
+    return m_priv->m_mapped;
+}
+
+/**
+ * \returns The content of the mapped file, NULL if the file is not mapped or
+ *   it is empty. The content is not null terminated.
+ */
+const char *
+S9sFile::mappedData() const
+{
+    return m_priv->m_mapData;
+}
+
+size_t
+S9sFile::mappedSize() const
+{
+    return m_priv->m_mapSize;
+}
+
 bool
 S9sFile::writeTxtFile(
         const S9sString   &content)
 {
-	mode_t   mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
+    return writeFile(content, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH, false);
+}
+
+/**
+ * \param content The new content of the file.
+ * \param mode The permissions of the file.
+ *
+ * Same as writeTxtFile() but the file gets the given permissions before the
+ * content is written, even if the file already existed. Use this for files
+ * that the other users should never be able to read.
+ */
+bool
+S9sFile::writeTxtFile(
+        const S9sString   &content,
+        const int          mode)
+{
+    return writeFile(content, mode, true);
+}
+
+bool
+S9sFile::writeFile(
+        const S9sString   &content,
+        const int          mode,
+        const bool         setMode)
+{
 	int      fileDescriptor;
 	ssize_t  nBytes;
 	int      errorCode;
 
 	fileDescriptor = open(STR(m_priv->m_path),
-			O_WRONLY | O_CREAT | O_TRUNC, mode);
+			O_WRONLY | O_CREAT | O_TRUNC, (mode_t) mode);
 	if (fileDescriptor < 0)
 	{
 		m_priv->m_errorString.sprintf(
@@ -389,6 +688,16 @@ S9sFile::writeTxtFile(
 		return false;
 	}
 
+	// The mode of open() is only used if the file is created.
+	if (setMode && ::fchmod(fileDescriptor, (mode_t) mode) != 0)
+	{
+		m_priv->m_errorString.sprintf(
+				"Error changing the mode of '%s': %m",
+				STR(m_priv->m_path));
+		::close(fileDescriptor);
+		return false;
+	}
+
 	nBytes = safeWrite(fileDescriptor,
 		(void*) STR(content), content.size());
 	if (nBytes < (ssize_t) content.size())
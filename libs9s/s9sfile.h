@@ -24,6 +24,7 @@
 
 class S9sFilePrivate;
 class S9sEvent;
+class S9sVariantMap;
 
 class S9sFile
 {
@@ -47,11 +48,18 @@ class S9sFile
         void flush();
         void close();
         bool readTxtFile(S9sString &content);
+        bool readJsonFile(S9sVariantMap &content);
         bool readLine(S9sString &line);
         bool readEvent(S9sEvent &event);
+
+        bool mapForRead();
+        bool isMapped() const;
+        const char *mappedData() const;
+        size_t mappedSize() const;
         ulonglong lineNumber() const;
         
         bool writeTxtFile(const S9sString &content);
+        bool writeTxtFile(const S9sString &content, const int mode);
         bool fprintf(const char *formatString, ...);
 
         S9sString errorString() const;
@@ -77,6 +85,13 @@ class S9sFile
 
         
     private:
+        bool readMappedEvent(S9sEvent &event);
+
+        bool writeFile(
+                const S9sString &content,
+                const int        mode,
+                const bool       setMode);
+
         ssize_t safeRead(
                 int     fileDescriptor, 
                 void   *buffer, 
@@ -21,12 +21,19 @@
 #include "s9sfile_p.h"
 
 #include <stdio.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 S9sFilePrivate::S9sFilePrivate() :
     m_referenceCounter(1),
     m_outputStream(0),
     m_inputStream(0),
-    m_lineNumber(0ull)
+    m_lineNumber(0ull),
+    m_mapped(false),
+    m_mapData(0),
+    m_mapSize(0),
+    m_mapCursor(0),
+    m_mapFd(-1)
 {
 }
 
@@ -41,7 +48,12 @@ S9sFilePrivate::S9sFilePrivate(
     m_errorString(orig.m_path),
     m_outputStream(0),
     m_inputStream(0),
-    m_lineNumber(0ull)
+    m_lineNumber(0ull),
+    m_mapped(false),
+    m_mapData(0),
+    m_mapSize(0),
+    m_mapCursor(0),
+    m_mapFd(-1)
 {
 }
 
@@ -76,4 +88,22 @@ S9sFilePrivate::close()
         fclose(m_inputStream);
         m_inputStream = 0;
     }
+
+    unmap();
+}
+
+void
+S9sFilePrivate::unmap()
+{
+    if (m_mapData != NULL)
+        munmap((void *) m_mapData, m_mapSize);
+
+    if (m_mapFd >= 0)
+        ::close(m_mapFd);
+
+    m_mapFd     = -1;
+    m_mapped    = false;
+    m_mapData   = 0;
+    m_mapSize   = 0;
+    m_mapCursor = 0;
 }
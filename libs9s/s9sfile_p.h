@@ -32,6 +32,7 @@ class S9sFilePrivate
         int unRef();
 
         void close();
+        void unmap();
 
     private:
         int                     m_referenceCounter;
@@ -41,6 +42,12 @@ class S9sFilePrivate
         FILE                   *m_outputStream;
         FILE                   *m_inputStream;
         ulonglong               m_lineNumber;
+        bool                    m_mapped;
+        const char             *m_mapData;
+        size_t                  m_mapSize;
+        size_t                  m_mapCursor;
+        /** The mapped file is kept open to see if it was truncated. */
+        int                     m_mapFd;
         
         friend class S9sFile;
 };
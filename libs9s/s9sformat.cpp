@@ -20,6 +20,7 @@
 #include "s9sformat.h"
 
 #include <stdio.h>
+#include <stdarg.h>
 #include "S9sOptions"
 
 //#define DEBUG
@@ -40,13 +41,40 @@ S9sFormat::S9sFormat() :
     m_colorStart(0),
     m_colorEnd(0),
     m_alignment(AlignLeft),
-    m_ellipsize(false)
+    m_ellipsize(false),
+    m_output(0),
+    m_outputFile(0)
 {
 }
 
+/**
+ * \param output The stream where the printf() methods print.
+ */
+S9sFormat::S9sFormat(
+        FILE *output) :
+    m_unit(UnitUnknown),
+    m_humanreadable(false),
+    m_width(0),
+    m_withFieldSeparator(true),
+    m_colorStart(0),
+    m_colorEnd(0),
+    m_alignment(AlignLeft),
+    m_ellipsize(false),
+    m_output(0),
+    m_outputFile(output)
+{
+}
+
+/**
+ * \param colorStart The escape sequence printed before the values.
+ * \param colorEnd The escape sequence printed after the values.
+ * \param output The stream where the printf() methods print or NULL for the
+ *   standard output.
+ */
 S9sFormat::S9sFormat(
         const char *colorStart,
-        const char *colorEnd) :
+        const char *colorEnd,
+        FILE       *output) :
     m_unit(UnitUnknown),
     m_humanreadable(false),
     m_width(0),
@@ -54,7 +82,9 @@ S9sFormat::S9sFormat(
     m_colorStart(colorStart),
     m_colorEnd(colorEnd),
     m_alignment(AlignLeft),
-    m_ellipsize(false)
+    m_ellipsize(false),
+    m_output(0),
+    m_outputFile(output)
 {
 }
 
@@ -146,6 +176,31 @@ S9sFormat::setEllipsize(
     m_ellipsize = ellipsize;
 }
 
+/**
+ * \param output The string where the printf() methods append their output or
+ *   NULL to print to the standard output.
+ *
+ * Redirecting the output makes it possible to render the rows of a table in
+ * separate threads and print the pieces later in the proper order.
+ */
+void
+S9sFormat::setOutput(
+        S9sString *output)
+{
+    m_output = output;
+}
+
+/**
+ * \param output The stream where the printf() methods print or NULL to print
+ *   to the standard output.
+ */
+void
+S9sFormat::setOutput(
+        FILE *output)
+{
+    m_outputFile = output;
+}
+
 /**
  * If necessary makes the format wider to accomodate the given value.
  */
@@ -153,8 +208,10 @@ void
 S9sFormat::widen(
         const S9sString &value)
 {
-    if ((int)value.terminalLength() > m_width)
-        m_width = (int) value.terminalLength();
+    int width = value.displayWidth();
+
+    if (width > m_width)
+        m_width = width;
 }
 
 /**
@@ -187,10 +244,7 @@ void
 S9sFormat::widen(
         const double value)
 {
-    S9sString tmp = toString(value);
-    
-    if ((int)tmp.terminalLength() > m_width)
-        m_width = (int) tmp.terminalLength();
+    widen(toString(value));
 }
 
 /**
@@ -200,6 +254,19 @@ S9sFormat::widen(
  * Converts the double to string. Does not consider the width and the color of
  * the column, but considers the unit and the human readable flag.
  */
+/**
+ * If necessary makes the format wider so that it is at least as wide as the
+ * other format. This is how the widths measured on separate parts of a list
+ * are merged.
+ */
+void
+S9sFormat::widen(
+        const S9sFormat &other)
+{
+    if (other.m_width > m_width)
+        m_width = other.m_width;
+}
+
 S9sString
 S9sFormat::toString(
         const double value) const
@@ -263,7 +330,7 @@ S9sFormat::printf(
     if (m_withFieldSeparator)
         formatString += " ";
 
-    ::printf(STR(formatString), value);
+    print(STR(formatString), value);
 }
 
 
@@ -285,7 +352,7 @@ S9sFormat::printf(
     if (m_withFieldSeparator)
         formatString += " ";
 
-    ::printf(STR(formatString), value);
+    print(STR(formatString), value);
 }
 
 void
@@ -305,12 +372,12 @@ S9sFormat::printf(
         formatString += " ";
     
     if (color && m_colorStart != NULL)
-        ::printf("%s", m_colorStart);
+        print("%s", m_colorStart);
 
-    ::printf(STR(formatString), STR(myValue));
+    print(STR(formatString), STR(myValue));
 
     if (color && m_colorEnd != NULL)
-        ::printf("%s", m_colorEnd);
+        print("%s", m_colorEnd);
 }
 
 /**
@@ -321,61 +388,52 @@ S9sFormat::printf(
         const S9sString &value,
         bool             color) const
 {
-    S9sString formatString;
-    S9sString myValue = value;
-
+    S9sString  myValue = value;
+    int        before  = 0;
+    int        after   = 0;
+
+    /*
+     * The padding is calculated from the display width, printf() would count
+     * the bytes of the escape sequences and the UTF-8 characters.
+     */
     if (m_width > 0)
     {
+        int padding;
+
         if (m_ellipsize)
-        {
-            if ((int) myValue.length() > m_width)
-            {
-                myValue.resize(m_width - 1);
-                myValue += "…";
-            }
-        }
+            myValue.ellipsize(m_width);
+
+        padding = m_width - myValue.displayWidth();
+        if (padding < 0)
+            padding = 0;
 
         switch (m_alignment)
         {
             case AlignRight:
-                formatString.sprintf("%%%ds", m_width);
+                before = padding;
                 break;
             
             case AlignLeft:
-                formatString.sprintf("%%-%ds", m_width);
+                after  = padding;
                 break;
             
             case AlignCenter:
-                {
-                    S9sString alignString;
-
-                    if (m_width > (int) myValue.terminalLength())
-                    {
-                        alignString = 
-                            S9sString(" ") * 
-                            ((m_width - myValue.terminalLength()) / 2);
-                    }
-               
-                    myValue = alignString + myValue;
-
-                    formatString.sprintf("%%-%ds", m_width);
-                }
+                before = padding / 2;
+                after  = padding - before;
                 break;
         }
-    } else {
-        formatString = "%s";
     }
 
-    if (m_withFieldSeparator)
-        formatString += " ";
-
     if (color && m_colorStart != NULL)
-        ::printf("%s", m_colorStart);
+        print("%s", m_colorStart);
+
+    print("%*s%s%*s", before, "", STR(myValue), after, "");
 
-    ::printf(STR(formatString), STR(myValue));
+    if (m_withFieldSeparator)
+        print(" ");
 
     if (color && m_colorEnd != NULL)
-        ::printf("%s", m_colorEnd);
+        print("%s", m_colorEnd);
 }
 
 void
@@ -458,3 +516,31 @@ S9sFormat::toSizeString(
 
     return retval;
 }
+
+/**
+ * Prints to the standard output (or the stream set by setOutput()) or appends
+ * to the output string if one was set using setOutput().
+ */
+void
+S9sFormat::print(
+        const char *formatString, 
+        ...) const
+{
+    va_list arguments;
+
+    va_start(arguments, formatString);
+    
+    if (m_output != NULL)
+    {
+        S9sString tmp;
+
+        tmp.vsprintf(formatString, arguments);
+        *m_output += tmp;
+    } else {
+        ::vfprintf(
+                m_outputFile != NULL ? m_outputFile : stdout, 
+                formatString, arguments);
+    }
+
+    va_end(arguments);
+}
@@ -21,6 +21,8 @@
 
 #include "S9sString"
 
+#include <stdio.h>
+
 /**
  * A helper class to produce uniform but variable width column tables on the
  * terminal and/or standard output.
@@ -46,7 +48,11 @@ class S9sFormat
         };
 
         S9sFormat();
-        S9sFormat(const char *colorStart, const char *colorEnd);
+        S9sFormat(FILE *output);
+        S9sFormat(
+                const char *colorStart, 
+                const char *colorEnd, 
+                FILE       *output = NULL);
        
         S9sFormat operator+(const S9sFormat &rhs);
         
@@ -60,6 +66,8 @@ class S9sFormat
 
         void setWidth(int width);
         void setEllipsize(bool ellipsize = true);
+        void setOutput(S9sString *output);
+        void setOutput(FILE *output);
 
         S9sString toString(const double value) const;
 
@@ -67,6 +75,7 @@ class S9sFormat
         void widen(const int value);
         void widen(const ulonglong value);
         void widen(const double value);
+        void widen(const S9sFormat &other);
 
         void printf(const int value) const;
         void printf(const ulonglong value) const;
@@ -77,6 +86,9 @@ class S9sFormat
 
         static S9sString toSizeString(const ulonglong value);
 
+    private:
+        void print(const char *formatString, ...) const;
+
     private:
         Unit        m_unit;
         bool        m_humanreadable;
@@ -86,4 +98,6 @@ class S9sFormat
         const char *m_colorEnd;
         Alignment   m_alignment;
         bool        m_ellipsize;
+        S9sString  *m_output;
+        FILE       *m_outputFile;
 };
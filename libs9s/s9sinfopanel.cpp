@@ -208,7 +208,7 @@ S9sInfoPanel::printLine(
     const char *selection = "\033[1m\033[48;5;51m" "\033[2m\033[38;5;237m";
 
     m_nChars = 0;
-    ::printf("%s", normal);
+    ::fprintf(m_output, "%s", normal);
     if (lineIndex == 0)
     {
         // The top frame line.
@@ -307,12 +307,12 @@ S9sInfoPanel::printLine(
             printChar("─", titleStart);
             
             if (hasFocus())
-                ::printf("%s", selection);
+                ::fprintf(m_output, "%s", selection);
 
             printString(title);
             
             if (hasFocus())
-                ::printf("%s%s", TERM_NORMAL, normal);
+                ::fprintf(m_output, "%s%s", TERM_NORMAL, normal);
         }
 
         printChar("─", width() - 1);
@@ -620,10 +620,10 @@ S9sInfoPanel::printString(
     if ((int)asciiString.length() > availableChars)
     {
         asciiString.resize(availableChars);
-        ::printf("%s", STR(asciiString));
+        ::fprintf(m_output, "%s", STR(asciiString));
     } else {
-        ::printf("%s", STR(colorString));
-        ::printf("%s", normal);
+        ::fprintf(m_output, "%s", STR(colorString));
+        ::fprintf(m_output, "%s", normal);
     }
 
     m_nChars += asciiString.length();
@@ -639,12 +639,12 @@ S9sInfoPanel::printNameValue(
     S9sString   tmp;
 
     tmp.sprintf("%11s: ", STR(name));
-    ::printf("%s", STR(tmp));
+    ::fprintf(m_output, "%s", STR(tmp));
     m_nChars += tmp.length();
    
-    ::printf("%s", header);
-    ::printf("%s", STR(value));
-    ::printf("%s", normal);
+    ::fprintf(m_output, "%s", header);
+    ::fprintf(m_output, "%s", STR(value));
+    ::fprintf(m_output, "%s", normal);
     m_nChars += value.length();
 }
 
@@ -652,7 +652,7 @@ void
 S9sInfoPanel::printChar(
         int c)
 {
-    ::printf("%c", c);
+    ::fprintf(m_output, "%c", c);
     ++m_nChars;
 }
 
@@ -660,7 +660,7 @@ void
 S9sInfoPanel::printChar(
         const char *c)
 {
-    ::printf("%s", c);
+    ::fprintf(m_output, "%s", c);
     ++m_nChars;
 }
 
@@ -671,7 +671,7 @@ S9sInfoPanel::printChar(
 {
     while (m_nChars < lastColumn)
     {
-        ::printf("%s", c);
+        ::fprintf(m_output, "%s", c);
         ++m_nChars;
     }
 }
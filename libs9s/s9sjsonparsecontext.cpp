@@ -12,15 +12,25 @@ S9sJsonParseContext::S9sJsonParseContext(
 {
 }
 
+/**
+ * Parses the input in place, the input is not copied.
+ */
+S9sJsonParseContext::S9sJsonParseContext(
+        const char   *input,
+        const size_t  length) :
+    S9sParseContext(input, length)
+{
+}
+
+/**
+ * Takes over the values the parser found, the map passed as argument is left
+ * empty, so nothing is copied here.
+ */
 void
 S9sJsonParseContext::setValues(
         S9sVariantMap *values)
 {
     clear();
-
-    std::vector<S9sString> newKeys = values->keys();
-
-    for (uint idx = 0; idx < newKeys.size(); ++idx)
-        (*this)[newKeys[idx]] = (*values)[newKeys[idx]];
+    swap(*values);
 }
 
@@ -5,6 +5,7 @@
 
 #include "S9sVariantMap"
 #include "S9sParseContext"
+#include "S9sArena"
 
 class S9sJsonParseContext :
     public S9sVariantMap,
@@ -12,7 +13,15 @@ class S9sJsonParseContext :
 {
     public:
         S9sJsonParseContext(const char *input);
+        S9sJsonParseContext(const char *input, const size_t length);
         void setValues(S9sVariantMap *values);
+
+    public:
+        /** 
+         * The parser and the lexer are allocating their temporary values 
+         * here, they are all released together when the parsing is done.
+         */
+        S9sArena   m_arena;
 };
 
 extern int json_parse(S9sJsonParseContext &context);
@@ -0,0 +1,131 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9slogpagereader.h"
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+/**
+ * \param client the client that is connected to the controller, the reader
+ *   will open a new connection with the same session.
+ * \param jobId the ID of the job if the job messages should be read, 0 if the
+ *   cmon log is read.
+ */
+S9sLogPageReader::S9sLogPageReader(
+        const S9sRpcClient &client,
+        const int           jobId) :
+    m_client(client.newConnection()),
+    m_jobId(jobId),
+    m_offset(0),
+    m_limit(0),
+    m_success(false),
+    m_running(false)
+{
+}
+
+S9sLogPageReader::~S9sLogPageReader()
+{
+    waitRead();
+}
+
+/**
+ * \param offset the number of log entries to skip.
+ * \param limit the maximum number of log entries to read.
+ * \returns true if the thread that reads the page is started.
+ *
+ * Starts reading a page of log entries in the background. The waitRead()
+ * method should be called before the reply is processed.
+ */
+bool
+S9sLogPageReader::startRead(
+        const int offset,
+        const int limit)
+{
+    waitRead();
+
+    m_offset  = offset;
+    m_limit   = limit;
+    m_success = false;
+    m_reply   = S9sRpcReply();
+    m_running = start();
+
+    return m_running;
+}
+
+/**
+ * \returns true if the page was received from the controller (even if the
+ *   reply is an error reply).
+ *
+ * Waits until the page requested in startRead() is received.
+ */
+bool
+S9sLogPageReader::waitRead()
+{
+    if (m_running)
+    {
+        join();
+        m_running = false;
+    }
+
+    return m_success;
+}
+
+const S9sRpcReply &
+S9sLogPageReader::reply() const
+{
+    return m_reply;
+}
+
+S9sString
+S9sLogPageReader::errorString() const
+{
+    return m_client.errorString();
+}
+
+/**
+ * \returns How many log entries are in the page.
+ */
+int
+S9sLogPageReader::nEntries() const
+{
+    S9sString key = m_jobId > 0 ? "messages" : "log_entries";
+
+    if (!m_reply.contains(key))
+        return 0;
+
+    return m_reply.at(key).toVariantList().size();
+}
+
+int
+S9sLogPageReader::exec()
+{
+    S9S_DEBUG("Reading %d log entries from offset %d.", m_limit, m_offset);
+
+    if (m_jobId > 0)
+        m_success = m_client.getJobLog(m_jobId, m_limit, m_offset);
+    else
+        m_success = m_client.getLogEntries(m_limit, m_offset, true);
+
+    if (m_success)
+        m_reply = m_client.reply();
+
+    return 0;
+}
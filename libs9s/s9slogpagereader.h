@@ -0,0 +1,62 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sThread"
+#include "S9sRpcClient"
+#include "S9sRpcReply"
+
+/**
+ * A class that reads one page of log entries (the cmon log or the messages of
+ * a job) in a background thread. The reader has its own connection to the
+ * controller, so the next page can be downloaded while the previous one is
+ * being printed.
+ */
+class S9sLogPageReader : public S9sThread
+{
+    public:
+        S9sLogPageReader(
+                const S9sRpcClient &client,
+                const int           jobId = 0);
+
+        virtual ~S9sLogPageReader();
+
+        bool startRead(
+                const int offset,
+                const int limit);
+
+        bool waitRead();
+
+        const S9sRpcReply &reply() const;
+        S9sString errorString() const;
+        int nEntries() const;
+
+    protected:
+        virtual int exec();
+
+    private:
+        S9sRpcClient    m_client;
+        int             m_jobId;
+        int             m_offset;
+        int             m_limit;
+        bool            m_success;
+        bool            m_running;
+        S9sRpcReply     m_reply;
+};
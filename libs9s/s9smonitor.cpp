@@ -34,6 +34,39 @@
 //#define WARNING
 #include "s9sdebug.h"
 
+/*
+ * The cells of the cached lines in the cluster and the node list.
+ */
+enum ClusterCell
+{
+    ClusterVersion = 0,
+    ClusterId,
+    ClusterType,
+    ClusterState,
+    ClusterName,
+    ClusterMessage,
+    ClusterAcl,
+    ClusterOwner,
+    ClusterGroup,
+    ClusterPath
+};
+
+enum NodeCell
+{
+    NodeFlags = 0,
+    NodeVersion,
+    NodeClusterId,
+    NodeClusterName,
+    NodeHostName,
+    NodeHostStatus,
+    NodePort,
+    NodeMessage,
+    NodeAcl,
+    NodeOwner,
+    NodeGroup,
+    NodePath
+};
+
 S9sMonitor::S9sMonitor(
         S9sRpcClient            &client,
         S9sMonitor::DisplayMode  mode) : 
@@ -56,6 +89,7 @@ S9sMonitor::S9sMonitor(
     m_eventViewWidget.setHasFocus(false);
 
     setDisplayMode(mode);
+    setupEventFilter();
 }
 
 S9sMonitor::~S9sMonitor()
@@ -135,6 +169,68 @@ S9sMonitor::setDisplayMode(
     } 
 }
 
+/**
+ * Evaluates the event filter set in the command line once for every event type
+ * and event subclass, so that the events can be filtered without processing
+ * strings.
+ */
+void
+S9sMonitor::setupEventFilter()
+{
+    S9sOptions *options = S9sOptions::instance();
+    int         idx;
+
+    m_eventTypeEnabled.clear();
+    for (idx = S9sEvent::NoEvent; idx <= S9sEvent::EventLog; ++idx)
+    {
+        m_eventTypeEnabled << options->eventTypeEnabled(
+                S9sEvent::eventTypeToString((S9sEvent::EventType) idx));
+    }
+
+    m_eventSubClassEnabled.clear();
+    for (idx = S9sEvent::NoSubClass; idx <= S9sEvent::Measurements; ++idx)
+    {
+        m_eventSubClassEnabled << options->eventNameEnabled(
+                S9sEvent::eventSubClassToString(
+                    (S9sEvent::EventSubClass) idx));
+    }
+}
+
+/**
+ * \returns True if the event passes the event type and event name filter set
+ *   in the command line.
+ */
+bool
+S9sMonitor::isEventEnabled(
+        const S9sEvent &event) const
+{
+    S9sOptions *options = S9sOptions::instance();
+    
+    /*
+     * The events with names we do not know are decoded as NoEvent/NoSubClass,
+     * these are checked by their names.
+     */
+    if (event.eventType() == S9sEvent::NoEvent)
+    {
+        if (!options->eventTypeEnabled(event.eventTypeString()))
+            return false;
+    } else if (!m_eventTypeEnabled[event.eventType()])
+    {
+        return false;
+    }
+
+    if (event.eventSubClass() == S9sEvent::NoSubClass)
+    {
+        if (!options->eventNameEnabled(event.eventName()))
+            return false;
+    } else if (!m_eventSubClassEnabled[event.eventSubClass()])
+    {
+        return false;
+    }
+
+    return true;
+}
+
 /**
  * Starts the screen preiodic refresh that will keep updating the terminal from
  * a secondary thread. This method will authenticate if necessary,
@@ -154,6 +250,12 @@ S9sMonitor::main()
 
     start();
 
+    if (!m_outputFileName.empty() && !m_recorder.start(m_outputFile))
+    {
+        PRINT_ERROR("Failed to start writing '%s'.", STR(m_outputFileName));
+        exit(1);
+    }
+
     if (hasInputFile())
     {
         S9sDateTime  prevCreated;
@@ -207,7 +309,7 @@ S9sMonitor::main()
                 } while (thisCreated.toTimeT() < target);
                 
                 m_rightKeyPresses = 0;
-                refreshScreen();
+                updateScreen();
             }
 
             while (m_isStopped && m_rightKeyPresses == 0)
@@ -221,6 +323,14 @@ S9sMonitor::main()
     } else {
         while (true)
         {
+            // If an event relay is running we read the events it shares
+            // instead of opening an other event stream.
+            if (S9sEventRelay::isEnabled() && m_relay.attach())
+            {
+                m_relay.consume(S9sMonitor::eventHandler, (void *) this);
+                continue;
+            }
+
             while (!m_client.isAuthenticated())
             {
                 m_client.maybeAuthenticate();
@@ -329,7 +439,7 @@ S9sMonitor::refreshScreen()
             break;
 
         default:
-            ::printf("error");
+            ::fprintf(m_output, "error");
     }
 
     //if (m_viewHelp)
@@ -379,7 +489,7 @@ S9sMonitor::printHelp()
         S9sString line = lines[n].toString();
         
         gotoXy(indent, n + 3);
-        ::printf("%s", STR(line));
+        ::fprintf(m_output, "%s", STR(line));
     }
 }
 
@@ -390,12 +500,12 @@ void
 S9sMonitor::printContainers()
 {
     S9sVector<S9sServer> theServers = servers();
-    S9sFormat  typeFormat;
-    S9sFormat  templateFormat;
-    S9sFormat  stateFormat;
-    S9sFormat  ipFormat;
-    S9sFormat  serverFormat;
-    S9sFormat  aliasFormat;
+    S9sFormat  typeFormat(m_output);
+    S9sFormat  templateFormat(m_output);
+    S9sFormat  stateFormat(m_output);
+    S9sFormat  ipFormat(m_output);
+    S9sFormat  serverFormat(m_output);
+    S9sFormat  aliasFormat(m_output);
     int        totalIndex;
 
 
@@ -431,7 +541,7 @@ S9sMonitor::printContainers()
         serverFormat.widen("SERVER");
         aliasFormat.widen("NAME");
         
-        printf("%s", TERM_SCREEN_HEADER);
+        ::fprintf(m_output, "%s", TERM_SCREEN_HEADER);
         typeFormat.printf("CLOUD");
         templateFormat.printf("TEMPLATE");
         stateFormat.printf("STATE");
@@ -482,20 +592,20 @@ S9sMonitor::printContainers()
                 templateFormat.printf(container.templateName("-", true));
                 stateFormat.printf(STR(container.state()));
 
-                ::printf("%s", ipColorBegin(ipAddress));
+                ::fprintf(m_output, "%s", ipColorBegin(ipAddress));
                 ipFormat.printf(STR(ipAddress));
-                ::printf("%s", ipColorEnd(ipAddress));
+                ::fprintf(m_output, "%s", ipColorEnd(ipAddress));
 
-                ::printf("%s", serverColorBegin());
+                ::fprintf(m_output, "%s", serverColorBegin());
                 serverFormat.printf(container.parentServerName());
-                ::printf("%s", serverColorEnd());
+                ::fprintf(m_output, "%s", serverColorEnd());
 
-                ::printf("%s", containerColorBegin(stateAsChar));
+                ::fprintf(m_output, "%s", containerColorBegin(stateAsChar));
                 aliasFormat.printf(container.alias());
-                ::printf("%s", containerColorEnd());
+                ::fprintf(m_output, "%s", containerColorEnd());
             } else {
                 // The line is selected, we use a highlight color.
-                ::printf("%s", XTERM_COLOR_SELECTION);
+                ::fprintf(m_output, "%s", XTERM_COLOR_SELECTION);
                 typeFormat.printf(STR(container.provider()));
                 templateFormat.printf(container.templateName("-"));
                 stateFormat.printf(STR(container.state()));
@@ -525,17 +635,17 @@ void
 S9sMonitor::printServers()
 {
     S9sVector<S9sServer> theServers = servers();
-    S9sFormat   sourceFileFormat(XTERM_COLOR_BLUE, TERM_NORMAL);
-    S9sFormat   sourceLineFormat;
-    S9sFormat   idFormat;
-    S9sFormat   typeFormat;
-    S9sFormat   versionFormat;
-    S9sFormat   nContainersFormat;
-    S9sFormat   ownerFormat(userColorBegin(), userColorEnd());
-    S9sFormat   groupFormat(groupColorBegin(), groupColorEnd());
-    S9sFormat   nameFormat;
-    S9sFormat   ipFormat(ipColorBegin(), ipColorEnd());
-    S9sFormat   commentsFormat;
+    S9sFormat   sourceFileFormat(XTERM_COLOR_BLUE, TERM_NORMAL, m_output);
+    S9sFormat   sourceLineFormat(m_output);
+    S9sFormat   idFormat(m_output);
+    S9sFormat   typeFormat(m_output);
+    S9sFormat   versionFormat(m_output);
+    S9sFormat   nContainersFormat(m_output);
+    S9sFormat   ownerFormat(userColorBegin(), userColorEnd(), m_output);
+    S9sFormat   groupFormat(groupColorBegin(), groupColorEnd(), m_output);
+    S9sFormat   nameFormat(m_output);
+    S9sFormat   ipFormat(ipColorBegin(), ipColorEnd(), m_output);
+    S9sFormat   commentsFormat(m_output);
 
     startScreen();
     printHeader();
@@ -577,7 +687,7 @@ S9sMonitor::printServers()
         ipFormat.widen("IPADDRESS");
         commentsFormat.widen("COMMENT");
 
-        printf("%s", TERM_SCREEN_HEADER);
+        ::fprintf(m_output, "%s", TERM_SCREEN_HEADER);
         
         if (m_viewDebug)
         {
@@ -630,7 +740,7 @@ S9sMonitor::printServers()
 
         if (isSelected)
         {
-            ::printf("%s", XTERM_COLOR_SELECTION);
+            ::fprintf(m_output, "%s", XTERM_COLOR_SELECTION);
 
             if (m_viewDebug)
             {
@@ -685,16 +795,16 @@ S9sMonitor::printServers()
 void
 S9sMonitor::printClusters()
 {
-    S9sFormat versionFormat;
-    S9sFormat idFormat;
-    S9sFormat typeFormat;
-    S9sFormat stateFormat;
-    S9sFormat nameFormat;
-    S9sFormat messageFormat;
-    S9sFormat aclFormat;
-    S9sFormat ownerFormat(userColorBegin(), userColorEnd());
-    S9sFormat groupFormat(groupColorBegin(), groupColorEnd());
-    S9sFormat pathFormat(ipColorBegin(), ipColorEnd());
+    S9sFormat versionFormat(m_output);
+    S9sFormat idFormat(m_output);
+    S9sFormat typeFormat(m_output);
+    S9sFormat stateFormat(m_output);
+    S9sFormat nameFormat(m_output);
+    S9sFormat messageFormat(m_output);
+    S9sFormat aclFormat(m_output);
+    S9sFormat ownerFormat(userColorBegin(), userColorEnd(), m_output);
+    S9sFormat groupFormat(groupColorBegin(), groupColorEnd(), m_output);
+    S9sFormat pathFormat(ipColorBegin(), ipColorEnd(), m_output);
 
     startScreen();
     printHeader();
@@ -702,19 +812,23 @@ S9sMonitor::printClusters()
     /*
      * Collecting some information.
      */
-    foreach (const S9sCluster &cluster, m_clusters)
+    S9sVector<S9sVariant> clusterIds = m_clusters.ids();
+
+    for (uint idx = 0u; idx < clusterIds.size(); ++idx)
     {
-        versionFormat.widen(cluster.vendorAndVersion());
-        idFormat.widen(cluster.clusterId());
-        typeFormat.widen(cluster.clusterType());
-        stateFormat.widen(cluster.state());
-        nameFormat.widen(cluster.name());
-        messageFormat.widen(cluster.statusText());
+        const S9sVariantList &row = clusterRow(clusterIds[idx]);
+
+        versionFormat.widen(row[ClusterVersion].toString());
+        idFormat.widen(row[ClusterId].toInt());
+        typeFormat.widen(row[ClusterType].toString());
+        stateFormat.widen(row[ClusterState].toString());
+        nameFormat.widen(row[ClusterName].toString());
+        messageFormat.widen(row[ClusterMessage].toString());
         
-        aclFormat.widen("c" + cluster.aclShortString());
-        ownerFormat.widen(cluster.ownerName());
-        groupFormat.widen(cluster.groupOwnerName());
-        pathFormat.widen(cluster.fullCdtPath());
+        aclFormat.widen("c" + row[ClusterAcl].toString());
+        ownerFormat.widen(row[ClusterOwner].toString());
+        groupFormat.widen(row[ClusterGroup].toString());
+        pathFormat.widen(row[ClusterPath].toString());
     }
 
     if (!m_clusters.empty())
@@ -731,7 +845,7 @@ S9sMonitor::printClusters()
         groupFormat.widen("GROUP");
         pathFormat.widen("PATH");
 
-        printf("%s", TERM_SCREEN_HEADER);
+        ::fprintf(m_output, "%s", TERM_SCREEN_HEADER);
         
         if (m_viewObjects)
         {
@@ -756,29 +870,32 @@ S9sMonitor::printClusters()
     /*
      * Printing.
      */
-    foreach (const S9sCluster &cluster, m_clusters)
+    for (uint idx = 0u; idx < clusterIds.size(); ++idx)
     {
+        const S9sVariantList &row   = clusterRow(clusterIds[idx]);
+        S9sString             state = row[ClusterState].toString();
+
         if (m_viewObjects)
         {
-            aclFormat.printf("n" + cluster.aclShortString());
-            ownerFormat.printf(cluster.ownerName());
-            groupFormat.printf(cluster.groupOwnerName());
-            pathFormat.printf(cluster.fullCdtPath());
+            aclFormat.printf("n" + row[ClusterAcl].toString());
+            ownerFormat.printf(row[ClusterOwner].toString());
+            groupFormat.printf(row[ClusterGroup].toString());
+            pathFormat.printf(row[ClusterPath].toString());
         } else {
-            versionFormat.printf(cluster.vendorAndVersion());
-            idFormat.printf(cluster.clusterId());
+            versionFormat.printf(row[ClusterVersion].toString());
+            idFormat.printf(row[ClusterId].toInt());
         
-            printf("%s", clusterStateColorBegin(cluster.state()));
-            stateFormat.printf(cluster.state());
-            printf("%s", clusterStateColorEnd());
+            ::fprintf(m_output, "%s", clusterStateColorBegin(state));
+            stateFormat.printf(state);
+            ::fprintf(m_output, "%s", clusterStateColorEnd());
 
-            typeFormat.printf(cluster.clusterType());
+            typeFormat.printf(row[ClusterType].toString());
     
-            printf("%s", clusterColorBegin());
-            nameFormat.printf(cluster.name());
-            printf("%s", clusterColorEnd());
+            ::fprintf(m_output, "%s", clusterColorBegin());
+            nameFormat.printf(row[ClusterName].toString());
+            ::fprintf(m_output, "%s", clusterColorEnd());
         
-            messageFormat.printf(cluster.statusText());
+            messageFormat.printf(row[ClusterMessage].toString());
         }
 
         printNewLine();
@@ -796,11 +913,11 @@ S9sMonitor::printClusters()
 void
 S9sMonitor::printJobs()
 {
-    S9sFormat idFormat;
-    S9sFormat stateFormat;
-    S9sFormat progressFormat;
-    S9sFormat titleFormat;
-    S9sFormat statusTextFormat;
+    S9sFormat idFormat(m_output);
+    S9sFormat stateFormat(m_output);
+    S9sFormat progressFormat(m_output);
+    S9sFormat titleFormat(m_output);
+    S9sFormat statusTextFormat(m_output);
 
     startScreen();
     printHeader();
@@ -824,7 +941,8 @@ S9sMonitor::printJobs()
         titleFormat.widen("TITLE");
         titleFormat.widen("STATUS");
 
-        printf("%s", TERM_SCREEN_HEADER /*m_formatter.headerColorBegin()*/);
+        ::fprintf(m_output, "%s", 
+                TERM_SCREEN_HEADER /*m_formatter.headerColorBegin()*/);
         idFormat.printf("ID");
         stateFormat.printf("STATE");
         progressFormat.printf("PROGRESS");
@@ -878,7 +996,7 @@ S9sMonitor::printJobs()
         idFormat.printf(job.id());
         stateFormat.printf(job.status());
 
-        ::printf("%s", STR(progressBar));
+        ::fprintf(m_output, "%s", STR(progressBar));
 
         titleFormat.printf(job.title());
         statusTextFormat.printf(statusText);
@@ -899,17 +1017,17 @@ void
 S9sMonitor::printNodes()
 {
     S9sFormatter formatter;
-    S9sFormat   sourceFileFormat(XTERM_COLOR_BLUE, TERM_NORMAL);
-    S9sFormat   sourceLineFormat;
-    S9sFormat   versionFormat;
-    S9sFormat   clusterNameFormat;
-    S9sFormat   clusterIdFormat;
-    S9sFormat   hostNameFormat;
-    S9sFormat   portFormat;
-    S9sFormat   aclFormat;
-    S9sFormat   ownerFormat(userColorBegin(), userColorEnd());
-    S9sFormat   groupFormat(groupColorBegin(), groupColorEnd());
-    S9sFormat   pathFormat(ipColorBegin(), ipColorEnd());
+    S9sFormat   sourceFileFormat(XTERM_COLOR_BLUE, TERM_NORMAL, m_output);
+    S9sFormat   sourceLineFormat(m_output);
+    S9sFormat   versionFormat(m_output);
+    S9sFormat   clusterNameFormat(m_output);
+    S9sFormat   clusterIdFormat(m_output);
+    S9sFormat   hostNameFormat(m_output);
+    S9sFormat   portFormat(m_output);
+    S9sFormat   aclFormat(m_output);
+    S9sFormat   ownerFormat(userColorBegin(), userColorEnd(), m_output);
+    S9sFormat   groupFormat(groupColorBegin(), groupColorEnd(), m_output);
+    S9sFormat   pathFormat(ipColorBegin(), ipColorEnd(), m_output);
     const char *beginColor, *endColor;
 
     startScreen();
@@ -918,26 +1036,30 @@ S9sMonitor::printNodes()
     /*
      * Collecting information for formatting.
      */
-    foreach (const S9sNode &node, m_nodes)
+    S9sVector<S9sVariant> nodeIds = m_nodes.ids();
+
+    for (uint idx = 0u; idx < nodeIds.size(); ++idx)
     {
-        S9sEvent       event = m_eventsForNodes[node.id()];
-        S9sString      clusterName = "-";
+        const S9sVariantList &row   = nodeRow(nodeIds[idx]);
 
-        if (m_clusters.contains(node.clusterId()))
-            clusterName = m_clusters[node.clusterId()].name();
+        if (m_viewDebug)
+        {
+            const S9sEvent &event = m_eventsForNodes[nodeIds[idx].toInt()];
 
-        sourceFileFormat.widen(event.senderFile());
-        sourceLineFormat.widen(event.senderLine());
-        versionFormat.widen(node.version());
-        clusterIdFormat.widen(node.clusterId());
-        clusterNameFormat.widen(clusterName);
-        hostNameFormat.widen(node.hostName());
-        portFormat.widen(node.port());
+            sourceFileFormat.widen(event.senderFile());
+            sourceLineFormat.widen(event.senderLine());
+        }
+
+        versionFormat.widen(row[NodeVersion].toString());
+        clusterIdFormat.widen(row[NodeClusterId].toInt());
+        clusterNameFormat.widen(row[NodeClusterName].toString());
+        hostNameFormat.widen(row[NodeHostName].toString());
+        portFormat.widen(row[NodePort].toInt());
             
-        aclFormat.widen("n" + node.aclShortString());
-        ownerFormat.widen(node.ownerName());
-        groupFormat.widen(node.groupOwnerName());
-        pathFormat.widen(node.fullCdtPath());
+        aclFormat.widen("n" + row[NodeAcl].toString());
+        ownerFormat.widen(row[NodeOwner].toString());
+        groupFormat.widen(row[NodeGroup].toString());
+        pathFormat.widen(row[NodePath].toString());
     }
 
     /*
@@ -959,7 +1081,7 @@ S9sMonitor::printNodes()
         groupFormat.widen("GROUP");
         pathFormat.widen("PATH");
 
-        printf("%s", TERM_SCREEN_HEADER);
+        ::fprintf(m_output, "%s", TERM_SCREEN_HEADER);
        
         if (m_viewDebug)
         {
@@ -974,13 +1096,13 @@ S9sMonitor::printNodes()
             groupFormat.printf("GROUP", false);
             pathFormat.printf("PATH", false);
         } else {
-            printf("STAT ");
+            ::fprintf(m_output, "STAT ");
             versionFormat.printf("VERSION");
             clusterIdFormat.printf("CID");
             clusterNameFormat.printf("CLUSTER");
             hostNameFormat.printf("HOST");
             portFormat.printf("PORT");
-            printf("COMMENT");
+            ::fprintf(m_output, "COMMENT");
         }
 
         printNewLine();
@@ -988,47 +1110,43 @@ S9sMonitor::printNodes()
         printMiddle("*** No nodes. ***");
     }
 
-    foreach (const S9sNode &node, m_nodes)
+    for (uint idx = 0u; idx < nodeIds.size(); ++idx)
     {
-        S9sEvent       event = m_eventsForNodes[node.id()];
-        S9sString      clusterName = "-";
+        const S9sVariantList &row = nodeRow(nodeIds[idx]);
 
-        if (m_clusters.contains(node.clusterId()))
-            clusterName = m_clusters[node.clusterId()].name();
-
-        beginColor = formatter.hostStateColorBegin(node.hostStatus());
+        beginColor = formatter.hostStateColorBegin(
+                row[NodeHostStatus].toString());
         endColor   = formatter.hostStateColorEnd();
         hostNameFormat.setColor(beginColor, endColor);
 
         if (m_viewDebug)
         {
+            const S9sEvent &event = m_eventsForNodes[nodeIds[idx].toInt()];
+
             sourceFileFormat.printf(event.senderFile());
             sourceLineFormat.printf(event.senderLine());
         }
 
         if (m_viewObjects)
         {
-            aclFormat.printf("n" + node.aclShortString());
-            ownerFormat.printf(node.ownerName());
-            groupFormat.printf(node.groupOwnerName());
-            pathFormat.printf(node.fullCdtPath());
+            aclFormat.printf("n" + row[NodeAcl].toString());
+            ownerFormat.printf(row[NodeOwner].toString());
+            groupFormat.printf(row[NodeGroup].toString());
+            pathFormat.printf(row[NodePath].toString());
         } else {
-            ::printf("%c", node.nodeTypeFlag());
-            ::printf("%c", node.stateAsChar());
-            ::printf("%c", node.roleFlag());
-            ::printf("%c ", node.maintenanceFlag());
+            ::fprintf(m_output, "%s ", STR(row[NodeFlags].toString()));
 
-            versionFormat.printf(node.version());
-            clusterIdFormat.printf(node.clusterId());
+            versionFormat.printf(row[NodeVersion].toString());
+            clusterIdFormat.printf(row[NodeClusterId].toInt());
 
-            printf("%s", clusterColorBegin());
-            clusterNameFormat.printf(clusterName);
-            printf("%s", clusterColorEnd());
+            ::fprintf(m_output, "%s", clusterColorBegin());
+            clusterNameFormat.printf(row[NodeClusterName].toString());
+            ::fprintf(m_output, "%s", clusterColorEnd());
 
-            hostNameFormat.printf(node.hostName());
-            portFormat.printf(node.port());
+            hostNameFormat.printf(row[NodeHostName].toString());
+            portFormat.printf(row[NodePort].toInt());
 
-            ::printf("%s ", STR(node.message()));
+            ::fprintf(m_output, "%s ", STR(row[NodeMessage].toString()));
         }
 
         printNewLine();
@@ -1111,11 +1229,11 @@ S9sMonitor::printEventList()
        
         if (isSelected)
         {
-            ::printf("%s", XTERM_COLOR_SELECTION);
-            ::printf("%s ", STR(line));
+            ::fprintf(m_output, "%s", XTERM_COLOR_SELECTION);
+            ::fprintf(m_output, "%s ", STR(line));
             printNewLine();
         } else {
-            ::printf("%s ", STR(line));
+            ::fprintf(m_output, "%s ", STR(line));
             printNewLine();
         }
     }
@@ -1137,16 +1255,16 @@ S9sMonitor::printEventView()
     S9sString title = " Event JSon";
 
     // The title bar.
-    ::printf("%s", TERM_INVERSE);
-    ::printf("%s", STR(title));
+    ::fprintf(m_output, "%s", TERM_INVERSE);
+    ::fprintf(m_output, "%s", STR(title));
 
 #if 1
     for (int n = title.length(); n < width() - 2; ++n)
-        ::printf(" ");
+        ::fprintf(m_output, " ");
 
-    ::printf("x ");
+    ::fprintf(m_output, "x ");
 #else
-    ::printf("  %d, %d %dx%d %d - %d", 
+    ::fprintf(m_output, "  %d, %d %dx%d %d - %d", 
             m_eventViewWidget.x(), m_eventViewWidget.y(),
             m_eventViewWidget.height(), m_eventViewWidget.width(),
             m_eventViewWidget.firstVisibleIndex(),
@@ -1172,12 +1290,152 @@ S9sMonitor::printEventView()
 
         line.replace("\n", "\\n");
         line.replace("\r", "\\r");
-        ::printf("%s", STR(line));
+        ::fprintf(m_output, "%s", STR(line));
         printNewLine();
 
     }
 }
 
+/**
+ * \param clusterId The ID of the cluster that was deleted.
+ *
+ * Removes the cluster together with the nodes that belong to it.
+ */
+void
+S9sMonitor::removeCluster(
+        const int clusterId)
+{
+    S9sVector<S9sVariant> nodeIds = m_nodes.ids();
+
+    m_clusters.remove(clusterId);
+    m_clusterRows.erase(clusterId);
+
+    for (uint idx = 0u; idx < nodeIds.size(); ++idx)
+    {
+        if (nodeClusterId(nodeIds[idx]) == clusterId)
+            removeNode(nodeIds[idx].toInt());
+    }
+}
+
+/**
+ * \param nodeId The ID of the node that was deleted.
+ */
+void
+S9sMonitor::removeNode(
+        const int nodeId)
+{
+    m_nodes.remove(nodeId);
+    m_nodeRows.erase(nodeId);
+    m_eventsForNodes.erase(nodeId);
+}
+
+/**
+ * \param clusterId The ID of the cluster.
+ * \returns The cells of the line of the cluster in the cluster list.
+ *
+ * The cells are computed only if the cluster changed since the last time they
+ * were computed.
+ */
+const S9sVariantList &
+S9sMonitor::clusterRow(
+        const S9sVariant &clusterId)
+{
+    ulonglong  version = m_clusters.version(clusterId);
+    RowCache  &row     = m_clusterRows[clusterId.toInt()];
+
+    if (row.version != version)
+    {
+        S9sCluster cluster = m_clusters.properties(clusterId);
+
+        row.version = version;
+        row.cells.clear();
+        row.cells << cluster.vendorAndVersion();
+        row.cells << cluster.clusterId();
+        row.cells << cluster.clusterType();
+        row.cells << cluster.state();
+        row.cells << cluster.name();
+        row.cells << cluster.statusText();
+        row.cells << cluster.aclShortString();
+        row.cells << cluster.ownerName();
+        row.cells << cluster.groupOwnerName();
+        row.cells << cluster.fullCdtPath();
+    }
+
+    return row.cells;
+}
+
+/**
+ * \param nodeId The ID of the node.
+ * \returns The ID of the cluster the node belongs to.
+ *
+ * This is read straight from the stored properties, this way we don't need to
+ * construct an S9sNode just to find the cluster.
+ */
+int
+S9sMonitor::nodeClusterId(
+        const S9sVariant &nodeId) const
+{
+    const S9sVariantMap &properties = m_nodes.properties(nodeId);
+
+    if (properties.contains("clusterid"))
+        return properties.at("clusterid").toInt();
+
+    return 0;
+}
+
+/**
+ * \param nodeId The ID of the node.
+ * \returns The cells of the line of the node in the node list.
+ *
+ * The cells are computed only if the node or the cluster of the node (we show
+ * the cluster name) changed since the last time they were computed.
+ */
+const S9sVariantList &
+S9sMonitor::nodeRow(
+        const S9sVariant &nodeId)
+{
+    int        clusterId      = nodeClusterId(nodeId);
+    ulonglong  version        = m_nodes.version(nodeId);
+    ulonglong  clusterVersion = m_clusters.version(clusterId);
+    RowCache  &row            = m_nodeRows[nodeId.toInt()];
+
+    if (row.version != version || row.clusterVersion != clusterVersion)
+    {
+        S9sNode    node(m_nodes.properties(nodeId));
+        S9sString  clusterName = "-";
+        S9sString  flags;
+
+        if (m_clusters.contains(clusterId))
+        {
+            S9sCluster cluster = m_clusters.properties(clusterId);
+
+            clusterName = cluster.name();
+        }
+
+        flags.sprintf("%c%c%c%c",
+                node.nodeTypeFlag(), node.stateAsChar(),
+                node.roleFlag(), node.maintenanceFlag());
+
+        row.version        = version;
+        row.clusterVersion = clusterVersion;
+        row.cells.clear();
+        row.cells << flags;
+        row.cells << node.version();
+        row.cells << node.clusterId();
+        row.cells << clusterName;
+        row.cells << node.hostName();
+        row.cells << node.hostStatus();
+        row.cells << node.port();
+        row.cells << node.message();
+        row.cells << node.aclShortString();
+        row.cells << node.ownerName();
+        row.cells << node.groupOwnerName();
+        row.cells << node.fullCdtPath();
+    }
+
+    return row.cells;
+}
+
 /**
  * \param event The event that arrived and shall be processed.
  */
@@ -1194,12 +1452,21 @@ S9sMonitor::processEvent(
         m_events.takeFirst();
 
     // The clusters.
-    if (event.hasCluster())
+    if (event.eventType() == S9sEvent::EventCluster &&
+            event.eventSubClass() == S9sEvent::Destroyed)
+    {
+        int clusterId = event.clusterId();
+
+        if (event.hasCluster() && event.cluster().clusterId() != 0)
+            clusterId = event.cluster().clusterId();
+
+        removeCluster(clusterId);
+    } else if (event.hasCluster())
     {
         S9sCluster cluster = event.cluster();
-        // FIXME: what about cluster delete events?
+
         if (cluster.clusterId() != 0)
-            m_clusters[cluster.clusterId()] = cluster;
+            m_clusters.apply(cluster.clusterId(), cluster.toVariantMap());
     }
 
     // The jobs.
@@ -1218,8 +1485,13 @@ S9sMonitor::processEvent(
 
         node = event.host();
 
-        m_nodes[node.id()] = node;
-        m_eventsForNodes[node.id()] = event;
+        if (event.eventSubClass() == S9sEvent::Destroyed)
+        {
+            removeNode(node.id());
+        } else {
+            m_nodes.apply(node.id(), node.toVariantMap());
+            m_eventsForNodes[node.id()] = event;
+        }
     }
     
     // The servers (together with the containers).
@@ -1306,7 +1578,7 @@ S9sMonitor::processEventList(
 
     output.replace("\n", "\n\r");
     if (!output.empty())
-        ::printf("\n\r%s", STR(output));
+        ::fprintf(m_output, "\n\r%s", STR(output));
 }
 
 /**
@@ -1380,39 +1652,39 @@ S9sMonitor::printHeader()
             break;
     }
 
-    ::printf("%s%s%s ", bold, STR(title), normal);
-    ::printf("%c ", rotatingCharacter());
+    ::fprintf(m_output, "%s%s%s ", bold, STR(title), normal);
+    ::fprintf(m_output, "%c ", rotatingCharacter());
     
     if (hasInputFile())
     {
         if (m_isStopped)
         {
             if (m_fastMode)
-                ::printf(" ⏩ ");
+                ::fprintf(m_output, " ⏩ ");
             else
-                ::printf(" ▶️ ");
+                ::fprintf(m_output, " ▶️ ");
         } else {
-            ::printf(" ⏸️ ");
+            ::fprintf(m_output, " ⏸️ ");
         }
     } else {
-        ::printf("   ");
+        ::fprintf(m_output, "   ");
     }
 
-    //::printf("⏺ ⏹ ⏸ ⏵ ⏩");
+    //::fprintf(m_output, "⏺ ⏹ ⏸ ⏵ ⏩");
 
-    ::printf("%s ", STR(dt.toString(S9sDateTime::LongTimeFormat)));
+    ::fprintf(m_output, "%s ", STR(dt.toString(S9sDateTime::LongTimeFormat)));
     
-    ::printf("%s%4zu%s event(s) ", bold, m_events.size(), normal);
-    ::printf("%s%zu%s node(s) ",   bold, m_nodes.size(), normal);
-    ::printf("%s%d%s VM(s) ",      bold, nContainers(), normal);
-    ::printf("%s%zu%s cluster(s) ", bold, m_clusters.size(), normal);
-    ::printf("%s%zu%s jobs(s) ",   bold, m_jobs.size(), normal);
+    ::fprintf(m_output, "%s%4zu%s event(s) ", bold, m_events.size(), normal);
+    ::fprintf(m_output, "%s%u%s node(s) ",    bold, m_nodes.size(), normal);
+    ::fprintf(m_output, "%s%d%s VM(s) ",      bold, nContainers(), normal);
+    ::fprintf(m_output, "%s%u%s cluster(s) ", bold, m_clusters.size(), normal);
+    ::fprintf(m_output, "%s%zu%s jobs(s) ",   bold, m_jobs.size(), normal);
 
     if (m_viewDebug)
     {
-        ::printf("0x%08x ",      lastKeyCode());
-        ::printf("%02dx%02d ",   width(), height());
-        ::printf("%02d:%03d,%03d ", m_lastButton, m_lastX, m_lastY);
+        ::fprintf(m_output, "0x%08x ",      lastKeyCode());
+        ::fprintf(m_output, "%02dx%02d ",   width(), height());
+        ::fprintf(m_output, "%02d:%03d,%03d ", m_lastButton, m_lastX, m_lastY);
     }
 
     printNewLine();
@@ -1427,38 +1699,39 @@ S9sMonitor::printFooter()
     const char *bold   = TERM_SCREEN_TITLE_BOLD;
     const char *normal = TERM_SCREEN_TITLE;
 
-    //::printf("%s", TERM_ERASE_EOL);
+    //::fprintf(m_output, "%s", TERM_ERASE_EOL);
     for (;m_lineCounter < height() - 1; ++m_lineCounter)
     {
-        ::printf("%s", TERM_ERASE_EOL);
-        ::printf("\n\r");
-        ::printf("%s", TERM_ERASE_EOL);
+        ::fprintf(m_output, "%s", TERM_ERASE_EOL);
+        ::fprintf(m_output, "\n\r");
+        ::fprintf(m_output, "%s", TERM_ERASE_EOL);
     } 
 
-    ::printf("%s ", normal);
-    ::printf("%sN%s-Nodes ", bold, normal);
-    ::printf("%sC%s-Clusters ", bold, normal);
-    ::printf("%sJ%s-Jobs ", bold, normal);
-    ::printf("%sV%s-Containers ", bold, normal);
-    ::printf("%sE%s-Events ", bold, normal);
-    ::printf("%sD%s-Debug mode ", bold, normal);
-    ::printf("%sH%s-Help ", bold, normal);
-    ::printf("%sQ%s-Quit", bold, normal);
+    ::fprintf(m_output, "%s ", normal);
+    ::fprintf(m_output, "%sN%s-Nodes ", bold, normal);
+    ::fprintf(m_output, "%sC%s-Clusters ", bold, normal);
+    ::fprintf(m_output, "%sJ%s-Jobs ", bold, normal);
+    ::fprintf(m_output, "%sV%s-Containers ", bold, normal);
+    ::fprintf(m_output, "%sE%s-Events ", bold, normal);
+    ::fprintf(m_output, "%sD%s-Debug mode ", bold, normal);
+    ::fprintf(m_output, "%sH%s-Help ", bold, normal);
+    ::fprintf(m_output, "%sQ%s-Quit", bold, normal);
    
     //if (!m_outputFileName.empty())
-    //    ::printf("    [%s]", STR(m_outputFileName));
-    //    ::printf("    {%s}", STR(m_inputFileName));
+    //    ::fprintf(m_output, "    [%s]", STR(m_outputFileName));
+    //    ::fprintf(m_output, "    {%s}", STR(m_inputFileName));
 
     // Just for debugging now.
-    //::printf("'%s'", STR(m_client.reply().requestStatusAsString()));
+    //::fprintf(m_output, "'%s'", 
+    //        STR(m_client.reply().requestStatusAsString()));
     // No new-line at the end, this is the last line.
-    ::printf("%s", TERM_ERASE_EOL);
-    ::printf("%s", TERM_NORMAL);
+    ::fprintf(m_output, "%s", TERM_ERASE_EOL);
+    ::fprintf(m_output, "%s", TERM_NORMAL);
 
     if (m_viewHelp)
         printHelp();
     
-    fflush(stdout);
+    fflush(m_output);
 }
 
 /**
@@ -1667,24 +1940,19 @@ S9sMonitor::eventCallback(
     {
         bool success;
 
-        success = m_outputFile.fprintf("%s\n\n", STR(event.toString()));
+        success = m_recorder.record(event);
         if (!success)
         {
-            PRINT_ERROR("%s", STR(m_outputFile.errorString()));
+            PRINT_ERROR("%s", STR(m_recorder.errorString()));
             exit(1);
         }
-
-        m_outputFile.flush();
     }
 
     switch (m_displayMode)
     {
         case PrintEvents:
             // Filtration by event class and subclass (event-name).
-            if (!options->eventTypeEnabled(event.eventTypeString()))
-                return;
-    
-            if (!options->eventNameEnabled(event.eventName()))
+            if (!isEventEnabled(event))
                 return;
 
             break;
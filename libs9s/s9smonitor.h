@@ -24,6 +24,9 @@
 #include "S9sRpcClient"
 #include "S9sRpcReply"
 #include "S9sDisplayList"
+#include "S9sEventRecorder"
+#include "S9sEventRelay"
+#include "S9sStateStore"
 
 /**
  * Implements a view that can be used to monitor objects through events.
@@ -88,15 +91,42 @@ class S9sMonitor :
         void printClusters();
         void printJobs();
 
+        void setupEventFilter();
+        bool isEventEnabled(const S9sEvent &event) const;
+
+        void removeCluster(const int clusterId);
+        void removeNode(const int nodeId);
+        const S9sVariantList &clusterRow(const S9sVariant &clusterId);
+        int nodeClusterId(const S9sVariant &nodeId) const;
+        const S9sVariantList &nodeRow(const S9sVariant &nodeId);
+
+    private:
+        /**
+         * The cells of one line in the cluster/node list, computed from the
+         * object with the given version. The cells are re-computed only when
+         * the object (or for the nodes the cluster of the node) changes.
+         */
+        class RowCache
+        {
+            public:
+                RowCache() : version(0ull), clusterVersion(0ull) {};
+
+                ulonglong       version;
+                ulonglong       clusterVersion;
+                S9sVariantList  cells;
+        };
+
     private:
         S9sRpcClient                &m_client;
         S9sRpcReply                  m_lastReply;
         DisplayMode                  m_displayMode;
-        S9sMap<int, S9sNode>         m_nodes;
+        S9sStateStore                m_nodes;
+        S9sMap<int, RowCache>        m_nodeRows;
         S9sMap<int, S9sEvent>        m_eventsForNodes;
         S9sMap<S9sString, S9sServer> m_servers;
         S9sMap<S9sString, S9sEvent>  m_serverEvents;
-        S9sMap<int, S9sCluster>      m_clusters;
+        S9sStateStore                m_clusters;
+        S9sMap<int, RowCache>        m_clusterRows;
         S9sMap<int, S9sJob>          m_jobs;
         S9sMap<int, time_t>          m_jobActivity;
         S9sVector<S9sEvent>          m_events;
@@ -122,5 +152,13 @@ class S9sMonitor :
         S9sDisplayList               m_eventViewWidget;
 
         S9sEvent                     m_selectedEvent;
+        /** Writes the events into the output file. */
+        S9sEventRecorder             m_recorder;
+        /** Reads the events shared by the s9s --event-relay. */
+        S9sEventRelay                m_relay;
+        /** The event filter indexed by S9sEvent::EventType. */
+        S9sVector<bool>              m_eventTypeEnabled;
+        /** The event filter indexed by S9sEvent::EventSubClass. */
+        S9sVector<bool>              m_eventSubClassEnabled;
 };
 
@@ -9,6 +9,20 @@ S9sMutex::S9sMutex()
     pthread_mutexattr_init(&m_attrs);
     pthread_mutex_init(&m_mutex, &m_attrs);
 }
+
+/**
+ * \param recursive If true the same thread can lock the mutex more than once.
+ */
+S9sMutex::S9sMutex(
+        const bool recursive)
+{
+    pthread_mutexattr_init(&m_attrs);
+
+    if (recursive)
+        pthread_mutexattr_settype(&m_attrs, PTHREAD_MUTEX_RECURSIVE);
+
+    pthread_mutex_init(&m_mutex, &m_attrs);
+}
  
 S9sMutex::~S9sMutex()
 {
@@ -28,3 +42,12 @@ S9sMutex::unlock()
     pthread_mutex_unlock(&m_mutex);
 }
 
+/**
+ * \returns true if the mutex was locked, false if it is locked by someone else.
+ */
+bool
+S9sMutex::tryLock()
+{
+    return pthread_mutex_trylock(&m_mutex) == 0;
+}
+
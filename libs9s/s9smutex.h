@@ -8,10 +8,12 @@ class S9sMutex
 {
     public:
         S9sMutex();
+        S9sMutex(const bool recursive);
         ~S9sMutex();
 
         void lock();
         void unlock();
+        bool tryLock();
 
     private:
         pthread_mutex_t     m_mutex;
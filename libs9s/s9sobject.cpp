@@ -233,11 +233,7 @@ S9sObject::name(
     if (columns <= 0)
         return retval;
 
-    if ((int)retval.length() > columns)
-    {
-        retval.resize(columns);
-        retval += "…";
-    }
+    retval.ellipsize(columns + 1);
 
     return retval;
 }
@@ -25,6 +25,7 @@
 #include "S9sFile"
 #include "S9sRegExp"
 #include "S9sDir"
+#include "S9sStateFile"
 #include "s9srsakey.h"
 #include "S9sDateTime"
 #include "S9sContainer"
@@ -217,6 +218,14 @@ enum S9sOptionType
     OptionMinutes,
     OptionOnlyAscii,
     OptionDensity,
+    OptionStatCache,
+    OptionCache,
+    OptionCacheTtl,
+    OptionStats,
+    OptionStatsFile,
+    OptionStream,
+    OptionDaemon,
+    OptionEventRelay,
     OptionRollingRestart,
     OptionDisableRecovery,
     OptionEnableRecovery,
@@ -564,55 +573,61 @@ S9sOptions::userStateFilename() const
 bool
 S9sOptions::loadStateFile()
 {
-    S9sString fileName = userStateFilename();
-    S9sFile   file(fileName);
-    S9sString content;
+    S9sStateFile stateFile(userStateFilename());
 
-    if (!file.exists())
+    if (!S9sFile::fileExists(stateFile.path()))
         return false;
 
-    PRINT_LOG("Loading state file '%s'.", STR(fileName));
-    if (!file.readTxtFile(content))
+    PRINT_LOG("Loading state file '%s'.", STR(stateFile.path()));
+    if (!stateFile.load(m_state))
     {
-        PRINT_LOG("%s.", STR(file.errorString()));
-        return false;
-    }
-
-    PRINT_LOG("State file: %s", STR(content));
-    if (!m_state.parse(STR(content)))
-    {
-        PRINT_LOG("Error parsing state file.");
+        PRINT_LOG("%s", STR(stateFile.errorString()));
         return false;
     }
 
+    PRINT_LOG("State file: %s", STR(m_state.toString()));
     return true;
 }
 
+/**
+ * Writes the state file. The file is replaced atomically and only if its
+ * content is changed.
+ */
 bool
 S9sOptions::writeStateFile()
 {
-    S9sString fileName = userStateFilename();
-    S9sFile   file(fileName);
-    S9sString content = m_state.toString();
-    bool      success;
+    S9sStateFile stateFile(userStateFilename());
+    bool         success;
 
-    PRINT_LOG("Writing state file '%s'.", STR(fileName));
-    success = file.writeTxtFile(content);
+    success = stateFile.save(m_state);
     if (!success)
     {
-        PRINT_LOG("ERROR: %s", STR(file.errorString()));
+        PRINT_LOG("ERROR: %s", STR(stateFile.errorString()));
     }
 
     return success;
 }
 
+/**
+ * Sets one value in the state and in the state file. The state file is read
+ * again before it is written, so the values set by the other s9s processes in
+ * the meantime are kept.
+ */
 bool
 S9sOptions::setState(
         const S9sString    &key,
         const S9sVariant   &value)
 {
-    m_state[key] = value;
-    return writeStateFile();
+    S9sStateFile stateFile(userStateFilename());
+    bool         success;
+
+    success = stateFile.setValue(key, value, m_state);
+    if (!success)
+    {
+        PRINT_LOG("ERROR: %s", STR(stateFile.errorString()));
+    }
+
+    return success;
 }
 
 S9sVariant
@@ -636,6 +651,9 @@ S9sOptions::loadConfigFiles()
     S9sFile systemConfig(defaultSystemConfigFileName());
     bool    success;
 
+    // The log file might be set in the configuration files.
+    s9s_log_reset();
+
     m_userConfig   = S9sConfigFile();
     m_systemConfig = S9sConfigFile();
 
@@ -1046,6 +1064,123 @@ S9sOptions::density() const
     return getBool("density");
 }
 
+/**
+ * \returns True if the statistical samples should be cached on the local
+ *   disk, either because the --stat-cache command line option was provided or
+ *   the "stat_cache" is set in the configuration file.
+ */
+bool
+S9sOptions::useStatCache() const
+{
+    const char *key = "stat_cache";
+    S9sString   retval;
+
+    if (m_options.contains(key))
+    {
+        retval = m_options.at(key).toString();
+    } else {
+        retval = m_userConfig.variableValue(key);
+
+        if (retval.empty())
+            retval = m_systemConfig.variableValue(key);
+    }
+
+    return retval.toBoolean();
+}
+
+/**
+ * \returns True if the replies of the read-only requests should be cached,
+ *   either because the --cache command line option was provided or the
+ *   "reply_cache" is set in the configuration file.
+ */
+bool
+S9sOptions::useReplyCache() const
+{
+    const char *key = "reply_cache";
+    S9sString   retval;
+
+    if (m_options.contains(key))
+    {
+        retval = m_options.at(key).toString();
+    } else {
+        retval = m_userConfig.variableValue(key);
+
+        if (retval.empty())
+            retval = m_systemConfig.variableValue(key);
+    }
+
+    return retval.toBoolean();
+}
+
+/**
+ * \returns True if the statistics of the RPC requests should be printed when
+ *   the program exits (the --stats command line option).
+ */
+bool
+S9sOptions::isRpcStatsRequested() const
+{
+    return !rpcStatsFormat().empty();
+}
+
+/**
+ * \returns The format of the RPC statistics, "human" or "json" as it was set
+ *   by the --stats command line option or the empty string if the statistics
+ *   are not requested.
+ */
+S9sString
+S9sOptions::rpcStatsFormat() const
+{
+    return getString("rpc_stats");
+}
+
+/**
+ * \returns The file where the RPC statistics are written in the Prometheus
+ *   text format set by the --stats-file command line option or the
+ *   "rpc_stats_file" configuration variable.
+ */
+S9sString
+S9sOptions::rpcStatsFile() const
+{
+    const char *key = "rpc_stats_file";
+    S9sString   retval;
+
+    if (m_options.contains(key))
+    {
+        retval = m_options.at(key).toString();
+    } else {
+        retval = m_userConfig.variableValue(key);
+
+        if (retval.empty())
+            retval = m_systemConfig.variableValue(key);
+    }
+
+    return retval;
+}
+
+/**
+ * \returns The time to live of the cached replies in seconds set by the
+ *   --cache-ttl command line option or the "reply_cache_ttl" configuration
+ *   variable, 0 if the defaults of the operations should be used.
+ */
+int
+S9sOptions::replyCacheTimeToLive() const
+{
+    const char *key = "reply_cache_ttl";
+    S9sString   stringVal;
+
+    if (m_options.contains(key))
+    {
+        stringVal = m_options.at(key).toString();
+    } else {
+        stringVal = m_userConfig.variableValue(key);
+
+        if (stringVal.empty())
+            stringVal = m_systemConfig.variableValue(key);
+    }
+
+    return stringVal.toInt();
+}
+
 int
 S9sOptions::clientConnectionTimeout() const
 {
@@ -5257,6 +5392,38 @@ S9sOptions::isWarning() const
     return getBool("warning");
 }
 
+/**
+ * \returns true if the --stream command line option was provided, the log
+ *   messages should be downloaded and printed page by page.
+ */
+bool
+S9sOptions::isStreamRequested() const
+{
+    return getBool("stream");
+}
+
+/**
+ * \returns true if the --daemon command line option was provided, the program
+ *   should stay resident and execute the commands forwarded by the other s9s
+ *   processes.
+ */
+bool
+S9sOptions::isDaemonRequested() const
+{
+    return getBool("daemon");
+}
+
+/**
+ * \returns true if the --event-relay command line option was provided, the
+ *   program should subscribe to the events and share them with the other s9s
+ *   processes of the same user.
+ */
+bool
+S9sOptions::isEventRelayRequested() const
+{
+    return getBool("event_relay");
+}
+
 /**
  * \returns true if client must use TLS for controller RPC connections
  */
@@ -5355,6 +5522,13 @@ S9sOptions::readOptions(
 {
     bool retval = true;
 
+    // The getopt state is global, it has to be reset because the batch scripts
+    // and the daemon are parsing more than one command line in one process.
+    optind = 0;
+
+    // The log file might be set in the command line.
+    s9s_log_reset();
+
     // Reconstructing the command line from argv[]. This is used for debugging.
     m_allOptions = "";
     for (int idx = 0; argv[idx] != NULL; ++idx)
@@ -5777,11 +5951,16 @@ S9sOptions::printHelpGeneric()
 "Generic options:\n"
 "  -c, --controller=URL       The URL where the controller is found.\n"
 "  --config-file=PATH         Specify the configuration file for the program.\n"
+"  --daemon                   Stay resident and run the commands of others.\n"
+"  --event-relay              Share one event subscription with local monitors.\n"
 "  --help                     Show help message and exit.\n" 
 "  -P, --controller-port INT  The port of the controller.\n"
 "  -p, --password=PASSWORD    The password for the Cmon user.\n"
 "  --private-key-file=FILE    The name of the file for authentication.\n"
 "  --rpc-tls                  Use TLS encryption to controller.\n"
+"  --script=FILE              Execute the commands of a file in one process.\n"
+"  --stats[=human|json]       Print the timing of the RPC requests at exit.\n"
+"  --stats-file=PATH          Write the RPC statistics in Prometheus format.\n"
 "  -u, --cmon-user=USERNAME   The username on the Cmon system.\n"
 "  -v, --verbose              Print more messages than normally.\n"
 "  -V, --version              Print version information and exit.\n"
@@ -5830,6 +6009,7 @@ S9sOptions::printHelpJob()
 "  --job-id=ID                The ID of the job.\n"
 "  --limit=NUMBER             Controls how many jobs are printed max.\n"
 "  --offset=NUMBER            Controls the index of the first item printed.\n"
+"  --stream                   Print the job messages page by page.\n"
 "  --until=DATE&TIME          The end of the interval to be printed.\n"
 "\n"
 "  --show-aborted             Show aborted jobs while printing job list.\n"
@@ -5962,6 +6142,8 @@ S9sOptions::printHelpMetaType()
 "  --list-cluster-types       Lists the supported cluster types.\n"
 "  --list-properties          List the properties of a certain type.\n"
 "\n"
+"  --cache                    Cache the replies of the read-only requests.\n"
+"  --cache-ttl=SECONDS        How long the cached replies are valid.\n"
 "  --type=NAME                The name of the type.\n"
 "\n"
     );
@@ -6099,6 +6281,8 @@ S9sOptions::printHelpCluster()
 
 "\n"
 "  --account=NAME[:PASSWD][@HOST] Account to be created on the cluster.\n"
+"  --cache                    Cache the replies of the read-only requests.\n"
+"  --cache-ttl=SECONDS        How long the cached replies are valid.\n"
 "  --cloud=PROVIDER           The name of the cloud provider.\n"
 "  --cluster-format=FORMAT    The format string used to print clusters.\n"
 "  --cluster-id=ID            The ID of the cluster to manipulate.\n"
@@ -6226,6 +6410,7 @@ S9sOptions::printHelpNode()
 "  --opt-value=VALUE          The value of the configuration option.\n"
 "  --output-dir=DIR           The directory where the files are created.\n"
 "  --properties=ASSIGNMENTS   Names and values of the properties to change.\n"
+"  --stat-cache               Cache the statistical samples on the local disk.\n"
 "\n");
 }
 
@@ -6343,6 +6528,8 @@ S9sOptions::printHelpTree()
 "\n"
 "  --acl=ACL                  One ACL entry to be added or removed.\n"
 "  --all                      Print also the hidden entries.\n"
+"  --cache                    Cache the replies of the read-only requests.\n"
+"  --cache-ttl=SECONDS        How long the cached replies are valid.\n"
 "  --owner=USER[:GROUP]       Owner and group of the CDT entry.\n"
 "  --recursive                Print/process also the tree sub-entries.\n"
 "  --refresh                  Recollect the data.\n"
@@ -6370,6 +6557,7 @@ S9sOptions::printHelpLog()
 "  --log-format=FORMATSTRING  The format of log messages printed.\n"
 "  --message-id=ID            The ID of the log message.\n"
 "  --offset=NUMBER            Controls the index of the first item printed.\n"
+"  --stream                   Print the messages page by page as received.\n"
 "  --until=DATE&TIME          The end of the interval to be printed.\n"
 "  --warning                  Print warning and more severe messages.\n"
 "\n"
@@ -6451,6 +6639,8 @@ S9sOptions::printHelpReport()
 "  --list                     List the reports.\n"
 "  --list-templates           Prints the available report templates.\n"
 "\n"
+"  --cache                    Cache the replies of the read-only requests.\n"
+"  --cache-ttl=SECONDS        How long the cached replies are valid.\n"
 "  --cluster-id=ID            The ID of the cluster.\n"
 "  --cluster-name=NAME        The name of the cluster (instead the ID).\n"
 "  --report-id=ID             The unique numerical ID of the report.\n"
@@ -6474,6 +6664,7 @@ S9sOptions::printHelpReplication()
 "  --stop                     Make the slave stop replicating.\n"
 "  --reset                    Reset the slave functionality.\n"
 "  --toggle-sync              Toggle PostgreSQL synchronous replication.\n" 
+"  --watch                    Watch the replication lag of the links.\n"
 "\n"
 "  --link-format=FORMATSTRING Sets the format of the printed lines.\n"
 "  --master=NODE              The replication master.\n"
@@ -6481,6 +6672,7 @@ S9sOptions::printHelpReplication()
 "  --replication-slave=NODE   The same as --slave.\n"
 "  --slave=NODE               The replication slave.\n"
 "  --synchronous=BOOL         Option for stage/rebuild for PostgreSQL.\n"
+"  --update-freq=SECONDS      The refresh interval of the --watch view.\n"
 "\n"
     );
 }
@@ -6509,6 +6701,8 @@ S9sOptions::readOptionsNode(
         { "rpc-tls",          no_argument,       0, OptionRpcTls          },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0, OptionPrintRequest    },
         { "color",            optional_argument, 0, OptionColor           },
         { "config-file",      required_argument, 0,  4                    },
@@ -6565,6 +6759,7 @@ S9sOptions::readOptionsNode(
         { "graph",            required_argument, 0, OptionGraph           }, 
         { "begin",            required_argument, 0, OptionBegin           },
         { "end",              required_argument, 0, OptionEnd             },
+        { "stat-cache",       no_argument,       0, OptionStatCache       },
         
         { "virtual-ip",          required_argument, 0, OptionVirtualIp     },
         { "eth-interface",       required_argument, 0, OptionEthInterface  },
@@ -6755,6 +6950,11 @@ S9sOptions::readOptionsNode(
                 // --density
                 m_options["density"] = true;
                 break;
+
+            case OptionStatCache:
+                // --stat-cache
+                m_options["stat_cache"] = true;
+                break;
            
             case OptionSchedule:
                 // --schedule=DATETIME
@@ -6789,6 +6989,25 @@ S9sOptions::readOptionsNode(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -6927,6 +7146,8 @@ S9sOptions::readOptionsBackup(
         { "long",             no_argument,       0, 'l'                   },
         { "password",         required_argument, 0, 'p'                   }, 
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0, OptionPrintRequest    },
         { "private-key-file", required_argument, 0, OptionPrivateKeyFile  }, 
         { "rpc-tls",          no_argument,       0, OptionRpcTls          },
@@ -7199,6 +7420,25 @@ S9sOptions::readOptionsBackup(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -7629,6 +7869,9 @@ S9sOptions::checkOptionsReplication()
     if (isResetRequested())
         countOptions++;
     
+    if (isWatchRequested())
+        countOptions++;
+    
     if (countOptions > 1)
     {
         m_errorMessage = "The main options are mutually exclusive.";
@@ -7669,6 +7912,8 @@ S9sOptions::readOptionsLog(
         { "rpc-tls",          no_argument,       0, OptionRpcTls          },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0, OptionPrintRequest    },
         { "color",            optional_argument, 0, OptionColor           },
         { "config-file",      required_argument, 0,  4                    },
@@ -7695,6 +7940,7 @@ S9sOptions::readOptionsLog(
         { "log-format",       required_argument, 0, OptionLogFormat       },
         { "message-id",       required_argument, 0, OptionMessageId       },
         { "offset",           required_argument, 0, OptionOffset          },
+        { "stream",           no_argument,       0, OptionStream          },
         { "until",            required_argument, 0, OptionUntil           },
 
         { 0, 0, 0, 0 }
@@ -7807,6 +8053,25 @@ S9sOptions::readOptionsLog(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -7847,6 +8112,11 @@ S9sOptions::readOptionsLog(
                 m_options["offset"] = optarg;
                 break;
             
+            case OptionStream:
+                // --stream
+                m_options["stream"] = true;
+                break;
+            
             case OptionLogFormatFile:
                 // --log-format-file=FORMAT
                 m_options["log_format_file"] = optarg;
@@ -7913,6 +8183,8 @@ S9sOptions::readOptionsEvent(
         { "rpc-tls",          no_argument,       0, OptionRpcTls          },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0, OptionPrintRequest    },
         { "color",            optional_argument, 0, OptionColor           },
         { "config-file",      required_argument, 0,  4                    },
@@ -8084,6 +8356,25 @@ S9sOptions::readOptionsEvent(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -8296,6 +8587,8 @@ S9sOptions::readOptionsAlarm(
         { "no-header",        no_argument,       0, OptionNoHeader        },
         { "password",         required_argument, 0, 'p'                   }, 
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0, OptionPrintRequest    },
         { "private-key-file", required_argument, 0, OptionPrivateKeyFile  }, 
         { "rpc-tls",          no_argument,       0, OptionRpcTls          },
@@ -8417,6 +8710,25 @@ S9sOptions::readOptionsAlarm(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -8514,8 +8826,12 @@ S9sOptions::readOptionsReport(
         { "rpc-tls",          no_argument,       0, OptionRpcTls          },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0, OptionPrintRequest    },
         { "color",            optional_argument, 0, OptionColor           },
+        { "cache",            no_argument,       0, OptionCache           },
+        { "cache-ttl",        required_argument, 0, OptionCacheTtl        },
         { "config-file",      required_argument, 0,  4                    },
         { "no-header",        no_argument,       0, OptionNoHeader        },
         { "human-readable",   no_argument,       0, 'h'                   },
@@ -8625,6 +8941,24 @@ S9sOptions::readOptionsReport(
                 else
                     m_options["color"] = "always";
                 break;
+
+            case OptionCache:
+                // --cache
+                m_options["reply_cache"] = true;
+                break;
+
+            case OptionCacheTtl:
+                // --cache-ttl=SECONDS
+                m_options["reply_cache_ttl"] = atoi(optarg);
+                if (m_options["reply_cache_ttl"].toInt() < 1)
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --cache-ttl option.";
+                
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
             
             case 'h':
                 // -h, --human-readable
@@ -8636,6 +8970,25 @@ S9sOptions::readOptionsReport(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -8745,6 +9098,8 @@ S9sOptions::readOptionsReplication(
         { "rpc-tls",          no_argument,       0, OptionRpcTls          },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0, OptionPrintRequest    },
         { "color",            optional_argument, 0, OptionColor           },
         { "config-file",      required_argument, 0,  4                    },
@@ -8772,6 +9127,7 @@ S9sOptions::readOptionsReplication(
         { "start",            no_argument,       0, OptionStart           },
         { "stop",             no_argument,       0, OptionStop            },
         { "toggle-sync",      no_argument,       0, OptionToggleSync      },
+        { "watch",            no_argument,       0, OptionWatch           },
         
         // Cluster information
         { "cluster-id",       required_argument, 0, 'i'                   },
@@ -8783,6 +9139,7 @@ S9sOptions::readOptionsReplication(
         { "replication-master",required_argument, 0, OptionMaster         },
         { "replication-slave",required_argument, 0, OptionSlave           },
         { "slave",            required_argument, 0, OptionSlave           },
+        { "update-freq",      required_argument, 0, OptionUpdateFreq      },
 
         { 0, 0, 0, 0 }
     };
@@ -8884,6 +9241,25 @@ S9sOptions::readOptionsReplication(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -8927,6 +9303,24 @@ S9sOptions::readOptionsReplication(
                 m_options["list"] = true;
                 break;
             
+            case OptionWatch:
+                // --watch
+                m_options["watch"] = true;
+                break;
+            
+            case OptionUpdateFreq:
+                // --update-freq
+                m_options["update_freq"] = atoi(optarg);
+                if (m_options["update_freq"].toInt() < 1)
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --update-freq option.";
+                
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+            
             case OptionPromoteSlave:
                 // --promote
                 m_options["promote_slave"] = true;
@@ -9845,6 +10239,8 @@ S9sOptions::readOptionsProcess(
         { "offset",           required_argument, 0, OptionOffset          },
         { "password",         required_argument, 0, 'p'                   }, 
         { "print-json",       no_argument,       0,  OptionPrintJson      },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0, OptionPrintRequest    },
         { "private-key-file", required_argument, 0, OptionPrivateKeyFile  }, 
         { "rpc-tls",          no_argument,       0, OptionRpcTls          },
@@ -10000,6 +10396,25 @@ S9sOptions::readOptionsProcess(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -10108,6 +10523,8 @@ S9sOptions::readOptionsUser(
         { "rpc-tls",          no_argument,       0, OptionRpcTls          },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0, OptionPrintRequest    },
         { "color",            optional_argument, 0, OptionColor           },
         { "config-file",      required_argument, 0, OptionConfigFile      },
@@ -10230,6 +10647,25 @@ S9sOptions::readOptionsUser(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -10463,6 +10899,8 @@ S9sOptions::readOptionsGroup(
         { "rpc-tls",          no_argument,       0, OptionRpcTls          },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0, OptionPrintRequest    },
         { "color",            optional_argument, 0, OptionColor           },
         { "config-file",      required_argument, 0, OptionConfigFile      },
@@ -10555,6 +10993,25 @@ S9sOptions::readOptionsGroup(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -10651,6 +11108,8 @@ S9sOptions::readOptionsAccount(
         { "rpc-tls",          no_argument,       0, OptionRpcTls          },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0, OptionPrintRequest    },
         { "color",            optional_argument, 0, OptionColor           },
         { "config-file",      required_argument, 0, OptionConfigFile      },
@@ -10757,6 +11216,25 @@ S9sOptions::readOptionsAccount(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -10947,6 +11425,8 @@ S9sOptions::readOptionsMaintenance(
         { "rpc-tls",          no_argument,       0, OptionRpcTls          },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0, OptionPrintRequest    },
         { "color",            optional_argument, 0, OptionColor           },
         { "config-file",      required_argument, 0, OptionConfigFile      },
@@ -11086,6 +11566,25 @@ S9sOptions::readOptionsMaintenance(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -11247,8 +11746,12 @@ S9sOptions::readOptionsMetaType(
         { "rpc-tls",          no_argument,       0, OptionRpcTls          },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0, OptionPrintRequest    },
         { "color",            optional_argument, 0, OptionColor           },
+        { "cache",            no_argument,       0, OptionCache           },
+        { "cache-ttl",        required_argument, 0, OptionCacheTtl        },
         { "config-file",      required_argument, 0, OptionConfigFile      },
         { "batch",            no_argument,       0, OptionBatch           },
         { "no-header",        no_argument,       0, OptionNoHeader        },
@@ -11359,11 +11862,48 @@ S9sOptions::readOptionsMetaType(
                     m_options["color"] = "always";
                 break;
 
+            case OptionCache:
+                // --cache
+                m_options["reply_cache"] = true;
+                break;
+
+            case OptionCacheTtl:
+                // --cache-ttl=SECONDS
+                m_options["reply_cache_ttl"] = atoi(optarg);
+                if (m_options["reply_cache_ttl"].toInt() < 1)
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --cache-ttl option.";
+                
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
             case OptionPrintJson:
                 // --print-json
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -11484,8 +12024,12 @@ S9sOptions::readOptionsCluster(
         { "rpc-tls",          no_argument,       0,  OptionRpcTls         },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0, OptionPrintRequest    },
         { "color",            optional_argument, 0, OptionColor           },
+        { "cache",            no_argument,       0, OptionCache           },
+        { "cache-ttl",        required_argument, 0, OptionCacheTtl        },
         { "human-readable",   no_argument,       0, 'h'                   },
         { "config-file",      required_argument, 0, OptionConfigFile      },
         { "force",            no_argument,       0, OptionForce           },
@@ -11889,11 +12433,48 @@ S9sOptions::readOptionsCluster(
                     m_options["color"] = "always";
                 break;
 
+            case OptionCache:
+                // --cache
+                m_options["reply_cache"] = true;
+                break;
+
+            case OptionCacheTtl:
+                // --cache-ttl=SECONDS
+                m_options["reply_cache_ttl"] = atoi(optarg);
+                if (m_options["reply_cache_ttl"].toInt() < 1)
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --cache-ttl option.";
+                
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
             case OptionPrintJson:
                 // --print-json
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -12347,6 +12928,8 @@ S9sOptions::readOptionsContainer(
         { "rpc-tls",          no_argument,       0,  OptionRpcTls         },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0, OptionPrintRequest    },
         { "color",            optional_argument, 0, OptionColor           },
         { "human-readable",   no_argument,       0, 'h'                   },
@@ -12480,6 +13063,25 @@ S9sOptions::readOptionsContainer(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -12713,6 +13315,8 @@ S9sOptions::readOptionsJob(
         { "rpc-tls",          no_argument,       0,  6                    },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0,  OptionPrintJson      },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0,  OptionPrintRequest   },
         { "config-file",      required_argument, 0,  OptionConfigFile     },
         { "color",            optional_argument, 0,  OptionColor          },
@@ -12741,6 +13345,7 @@ S9sOptions::readOptionsJob(
         { "recurrence",       required_argument, 0, OptionRecurrence      },
         { "timeout",          required_argument, 0, OptionTimeout         },
         { "schedule",         required_argument, 0, OptionSchedule        },
+        { "stream",           no_argument,       0, OptionStream          },
         
         { "no-wrap",          no_argument,       0, OptionNoWrap          },
         
@@ -12884,6 +13489,25 @@ S9sOptions::readOptionsJob(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -12944,6 +13568,11 @@ S9sOptions::readOptionsJob(
                 m_options["offset"] = optarg;
                 break;
             
+            case OptionStream:
+                // --stream
+                m_options["stream"] = true;
+                break;
+            
             case OptionSchedule:
                 // --schedule=DATETIME
                 m_options["schedule"] = optarg;
@@ -13041,6 +13670,8 @@ S9sOptions::readOptionsScript(
         { "controller-port",  required_argument, 0, 'P'                   },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0, OptionPrintRequest    },
         { "color",            optional_argument, 0, OptionColor           },
         { "config-file",      required_argument, 0, OptionConfigFile      },
@@ -13163,6 +13794,25 @@ S9sOptions::readOptionsScript(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -13311,6 +13961,8 @@ S9sOptions::readOptionsSheet(
         { "controller-port",  required_argument, 0, 'P'                   },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0, OptionPrintRequest    },
         { "color",            optional_argument, 0, OptionColor           },
         { "config-file",      required_argument, 0, OptionConfigFile      },
@@ -13432,6 +14084,25 @@ S9sOptions::readOptionsSheet(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -13569,6 +14240,8 @@ S9sOptions::readOptionsServer(
         { "controller-port",  required_argument, 0, 'P'                   },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0, OptionPrintRequest    },
         { "color",            optional_argument, 0, OptionColor           },
         { "human-readable",   no_argument,       0, 'h'                   },
@@ -13725,6 +14398,25 @@ S9sOptions::readOptionsServer(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -13969,6 +14661,8 @@ S9sOptions::readOptionsController(
         { "controller-port",  required_argument, 0, 'P'                   },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0, OptionPrintRequest    },
         { "color",            optional_argument, 0, OptionColor           },
         { "human-readable",   no_argument,       0, 'h'                   },
@@ -14119,6 +14813,25 @@ S9sOptions::readOptionsController(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -14253,8 +14966,12 @@ S9sOptions::readOptionsTree(
         { "controller-port",  required_argument, 0, 'P'                   },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "stats",            optional_argument, 0, OptionStats           },
+        { "stats-file",       required_argument, 0, OptionStatsFile       },
         { "print-request",    no_argument,       0, OptionPrintRequest    },
         { "color",            optional_argument, 0, OptionColor           },
+        { "cache",            no_argument,       0, OptionCache           },
+        { "cache-ttl",        required_argument, 0, OptionCacheTtl        },
         { "human-readable",   no_argument,       0, 'h'                   },
         { "config-file",      required_argument, 0, OptionConfigFile      },
         { "batch",            no_argument,       0, OptionBatch           },
@@ -14390,6 +15107,24 @@ S9sOptions::readOptionsTree(
                     m_options["color"] = "always";
                 break;
 
+            case OptionCache:
+                // --cache
+                m_options["reply_cache"] = true;
+                break;
+
+            case OptionCacheTtl:
+                // --cache-ttl=SECONDS
+                m_options["reply_cache_ttl"] = atoi(optarg);
+                if (m_options["reply_cache_ttl"].toInt() < 1)
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --cache-ttl option.";
+                
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
             case 'h':
                 // -h, --human-readable
                 m_options["human_readable"] = true;
@@ -14400,6 +15135,25 @@ S9sOptions::readOptionsTree(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionStats:
+                // --stats[=human|json]
+                m_options["rpc_stats"] = optarg ? optarg : "human";
+                if (m_options["rpc_stats"] != "human" && 
+                        m_options["rpc_stats"] != "json")
+                {
+                    m_errorMessage = 
+                        "Invalid value for the --stats option.";
+
+                    m_exitStatus = BadOptions;
+                    return false;
+                }
+                break;
+
+            case OptionStatsFile:
+                // --stats-file=PATH
+                m_options["rpc_stats_file"] = optarg;
+                break;
+
             case OptionPrintRequest:
                 // --print-request
                 m_options["print_request"] = true;
@@ -14936,15 +15690,24 @@ S9sOptions::readOptionsNoMode(
         { "help",             no_argument,       0, OptionHelp               },
         { "verbose",          no_argument,       0, 'v'                      },
         { "version",          no_argument,       0, 'V'                      },
+        { "daemon",           no_argument,       0, OptionDaemon             },
+        { "event-relay",      no_argument,       0, OptionEventRelay         },
+        { "controller",       required_argument, 0, 'c'                      },
+        { "controller-port",  required_argument, 0, 'P'                      },
+        { "cmon-user",        required_argument, 0, 'u'                      },
+        { "password",         required_argument, 0, 'p'                      },
+        { "private-key-file", required_argument, 0, OptionPrivateKeyFile     },
+        { "rpc-tls",          no_argument,       0, OptionRpcTls             },
         
         { "color",            optional_argument, 0, OptionColor              },
         { 0, 0, 0, 0 }
     };
 
+    optind = 0;
     for (;;)
     {
         int option_index = 0;
-        c = getopt_long(argc, argv, "hvc:V", long_options, &option_index);
+        c = getopt_long(argc, argv, "hvc:P:u:p:V", long_options, &option_index);
 
         if (c == -1)
             break;
@@ -14963,6 +15726,46 @@ S9sOptions::readOptionsNoMode(
                 m_options["print-version"] = true;
                 break;
             
+            case OptionDaemon:
+                // --daemon
+                m_options["daemon"] = true;
+                break;
+            
+            case OptionEventRelay:
+                // --event-relay
+                m_options["event_relay"] = true;
+                break;
+            
+            case 'c':
+                // -c, --controller
+                setController(optarg);
+                break;
+
+            case 'P':
+                // -P, --controller-port=PORT
+                m_options["controller_port"] = atoi(optarg);
+                break;
+            
+            case 'u':
+                // --cmon-user=USERNAME
+                m_options["cmon_user"] = optarg;
+                break;
+            
+            case 'p':
+                // --password=PASSWORD
+                m_options["password"] = optarg;
+                break;
+            
+            case OptionPrivateKeyFile:
+                // --private-key-file=FILE
+                m_options["private_key_file"] = optarg;
+                break;
+
+            case OptionRpcTls:
+                // --rpc-tls
+                m_options["rpc_tls"] = true;
+                break;
+            
             case OptionColor:
                 // --color=COLOR
                 if (optarg)
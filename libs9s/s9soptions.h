@@ -119,6 +119,12 @@ class S9sOptions
         int clientConnectionTimeout() const;
         
         bool density() const;
+        bool useStatCache() const;
+        bool useReplyCache() const;
+        int replyCacheTimeToLive() const;
+        bool isRpcStatsRequested() const;
+        S9sString rpcStatsFormat() const;
+        S9sString rpcStatsFile() const;
         bool setPropertiesOption(const S9sString &assignments);
         S9sVariantMap propertiesOption() const;
 
@@ -608,6 +614,9 @@ class S9sOptions
 
         bool isDebug() const;
         bool isWarning() const;
+        bool isStreamRequested() const;
+        bool isDaemonRequested() const;
+        bool isEventRelayRequested() const;
 
         static void printVerbose(const char *formatString, ...);
         static void printError(const char *formatString, ...);
@@ -20,6 +20,26 @@ S9sParseContext::S9sParseContext(
     m_currentToken = 0;
 }
 
+/**
+ * \param input The input that will be parsed.
+ * \param length The number of bytes in the input.
+ *
+ * This constructor does not copy the input, it must be kept available while
+ * the parsing is in progress. This is how we parse directly from a mapped file
+ * without copying it into a string.
+ */
+S9sParseContext::S9sParseContext(
+        const char   *input,
+        const size_t  length) :
+    m_flex_scanner(0)
+{
+    m_states.push(S9sParseContextState());
+    m_states.top().m_inputData   = input;
+    m_states.top().m_inputLength = length;
+
+    m_currentToken = 0;
+}
+
 S9sParseContext::S9sParseContext(
         const S9sParseContext &orig) :
     m_flex_scanner(0)
@@ -44,6 +64,26 @@ S9sParseContext::setInput(
         m_states.push(S9sParseContextState());
 
     m_states.top().m_inputString  = input;
+    m_states.top().m_inputData    = 0;
+    m_states.top().m_inputLength  = 0;
+    m_states.top().m_parserCursor = 0;
+}
+
+/**
+ * Sets the input without copying it, the input must be kept available while
+ * the parsing is in progress.
+ */
+void
+S9sParseContext::setInput(
+        const char   *input,
+        const size_t  length)
+{
+    if (m_states.empty())
+        m_states.push(S9sParseContextState());
+
+    m_states.top().m_inputString.clear();
+    m_states.top().m_inputData    = input;
+    m_states.top().m_inputLength  = length;
     m_states.top().m_parserCursor = 0;
 }
 
@@ -54,10 +94,13 @@ S9sParseContext::setInput(
 S9sString 
 S9sParseContext::input() const
 {
-    if (m_states.empty())
-        return m_lastState.m_inputString;
+    const S9sParseContextState &state = 
+        m_states.empty() ? m_lastState : m_states.top();
+
+    if (state.m_inputData != NULL)
+        return std::string(state.m_inputData, state.m_inputLength);
 
-    return m_states.top().m_inputString;
+    return state.m_inputString;
 }
 
 /**
@@ -255,23 +298,32 @@ S9sParseContext::yyinput(
         return 0;
     }
 
-    const char *data = STR(m_states.top().m_inputString);
-    int         dataLength = m_states.top().m_inputString.length();
+    S9sParseContextState &state = m_states.top();
+    const char *data;
+    size_t      dataLength;
+    size_t      numBytes = maxsize > 0 ? (size_t) maxsize : 0;
 
-    int numBytes = maxsize;
-    if (numBytes > dataLength - m_states.top().m_parserCursor)
-        numBytes = dataLength - m_states.top().m_parserCursor;
+    if (state.m_inputData != NULL)
+    {
+        data       = state.m_inputData;
+        dataLength = state.m_inputLength;
+    } else {
+        data       = STR(state.m_inputString);
+        dataLength = state.m_inputString.length();
+    }
 
-    if (numBytes < 0)
+    if (state.m_parserCursor >= dataLength)
         numBytes = 0;
+    else if (numBytes > dataLength - state.m_parserCursor)
+        numBytes = dataLength - state.m_parserCursor;
 
     if (numBytes > 0)
     {
-        memcpy(buffer, data + m_states.top().m_parserCursor, numBytes);
-        m_states.top().m_parserCursor += numBytes;
+        memcpy(buffer, data + state.m_parserCursor, numBytes);
+        state.m_parserCursor += numBytes;
     }
 
-    return numBytes;
+    return (int) numBytes;
 }
 
 /**
@@ -13,10 +13,12 @@ class S9sParseContext
 {
     public:
         S9sParseContext(const char *input);
+        S9sParseContext(const char *input, const size_t length);
         S9sParseContext(const S9sParseContext &orig);
         virtual ~S9sParseContext();
 
         void setInput(const S9sString &input);
+        void setInput(const char *input, const size_t length);
         S9sString input() const;
         int yyinput(char *buffer, int maxsize);
         
@@ -4,6 +4,8 @@
 #include "s9sparsecontextstate.h"
 
 S9sParseContextState::S9sParseContextState() :
+    m_inputData(0),
+    m_inputLength(0),
     m_parserCursor(0),
     m_currentLineNumber(1),
     m_scannerBuffer(0)
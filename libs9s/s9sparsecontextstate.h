@@ -16,7 +16,10 @@ class S9sParseContextState
         S9sParseContextState();
 
         S9sString    m_inputString;
-        int          m_parserCursor;
+        /** Input that is not owned (e.g. a mapped file), used if not NULL. */
+        const char  *m_inputData;
+        size_t       m_inputLength;
+        size_t       m_parserCursor;
         int          m_currentLineNumber;
         S9sString    m_fileName;
         void        *m_scannerBuffer;
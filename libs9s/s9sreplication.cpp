@@ -6,8 +6,28 @@
 #define WARNING
 #include "s9sdebug.h"
 
+/**
+ * \returns The value in the map with the given key without copying the map or
+ *   inserting a new value into it.
+ */
+static const S9sVariant &
+mapValue(
+        const S9sVariantMap &map,
+        const char          *key)
+{
+    static const S9sVariant       invalid;
+    S9sVariantMap::const_iterator it = map.find(key);
+
+    if (it == map.end())
+        return invalid;
+
+    return it->second;
+}
+
 S9sReplication::S9sReplication() :
-    S9sObject()
+    S9sObject(),
+    m_hasMaster(false),
+    m_clusterId(0)
 {
     m_properties["class_name"] = "S9sReplication";
 }
@@ -18,12 +38,36 @@ S9sReplication::S9sReplication() :
  */
 S9sReplication::S9sReplication(
         const S9sCluster &cluster,
-        const S9sNode    &slave)
+        const S9sNode    &slave) :
+    m_hasMaster(false)
 {
     m_properties["class_name"] = "S9sReplication";
 
-    m_cluster = cluster;
-    m_slave   = slave;
+    m_cluster   = cluster;
+    m_slave     = slave;
+    m_clusterId = cluster.clusterId();
+}
+
+/**
+ * \param clusterId The ID of the cluster that holds the slave.
+ * \param slave The slave node of a replication link.
+ * \param master The master node of the link, an empty node if the master is
+ *   not known.
+ *
+ * This constructor is used by the S9sReplicationTopology that has already
+ * found the master, so the object will not have to search the cluster for it.
+ */
+S9sReplication::S9sReplication(
+        const int         clusterId,
+        const S9sNode    &slave,
+        const S9sNode    &master) :
+    m_hasMaster(true),
+    m_clusterId(clusterId)
+{
+    m_properties["class_name"] = "S9sReplication";
+
+    m_slave     = slave;
+    m_master    = master;
 }
 
 /**
@@ -42,6 +86,31 @@ S9sReplication::isValid() const
 
 }
 
+/**
+ * \returns The ID of the cluster where the slave is.
+ */
+int
+S9sReplication::clusterId() const
+{
+    return m_clusterId;
+}
+
+/**
+ * \returns True if the slave knows the ID of the cluster of its master (e.g.
+ *   in case of a cluster to cluster replication).
+ */
+bool
+S9sReplication::hasMasterClusterId() const
+{
+    return m_slave.hasMasterClusterId();
+}
+
+int
+S9sReplication::masterClusterId() const
+{
+    return m_slave.masterClusterId();
+}
+
 /**
  * \returns The name of the slave host.
  */
@@ -119,15 +188,13 @@ S9sReplication::slaveStatusShort() const
 S9sString
 S9sReplication::slaveMessage() const
 {
-    S9sVariantMap map = slaveInfo();
-    return map["slave_io_state"].toString();
+    return mapValue(slaveInfo(), "slave_io_state").toString();
 }
 
 int
 S9sReplication::secondsBehindMaster() const
 {
-    S9sVariantMap map = slaveInfo();
-    return map["seconds_behind_master"].toInt();
+    return mapValue(slaveInfo(), "seconds_behind_master").toInt();
 }
 
 /**
@@ -137,7 +204,7 @@ S9sReplication::secondsBehindMaster() const
 S9sString
 S9sReplication::slavePosition() const
 {
-    S9sVariantMap map = slaveInfo();
+    const S9sVariantMap &map = slaveInfo();
 
     // This is for mysql.
     if (map.contains("executed_gtid_set"))
@@ -157,8 +224,7 @@ S9sReplication::slavePosition() const
 S9sString
 S9sReplication::masterPosition() const
 {
-    S9sVariantMap map = masterInfo();
-    return map["position"].toString();
+    return mapValue(masterInfo(), "position").toString();
 }
 
 /**
@@ -240,7 +306,7 @@ S9sReplication::toString(
                 case 'c':
                     // The cluster ID of the slave.
                     partFormat += 'd';
-                    tmp.sprintf(STR(partFormat), m_cluster.clusterId());
+                    tmp.sprintf(STR(partFormat), m_clusterId);
                     retval += tmp;
                     break;
                 
@@ -444,15 +510,10 @@ S9sReplication::matchMaster(
  * }
  * \endcode
  */
-S9sVariantMap
+const S9sVariantMap &
 S9sReplication::slaveInfo() const
 {
-    S9sVariantMap retval;
-    S9sVariantMap tmp;
-
-    tmp = m_slave.toVariantMap();
-    retval = tmp["replication_slave"].toVariantMap();
-    return retval;
+    return mapValue(m_slave.toVariantMap(), "replication_slave").toVariantMap();
 }
 
 /**
@@ -468,16 +529,18 @@ S9sReplication::slaveInfo() const
  * }
  * \endcode
  */
-S9sVariantMap
+const S9sVariantMap &
 S9sReplication::masterInfo() const
 {
-    S9sNode       master = node(masterHostName(), masterPort());
-    S9sVariantMap retval;
-    S9sVariantMap tmp;
+    // The master is found only once.
+    if (!m_hasMaster)
+    {
+        m_master    = node(masterHostName(), masterPort());
+        m_hasMaster = true;
+    }
 
-    tmp = master.toVariantMap();
-    retval = tmp["replication_master"].toVariantMap();
-    return retval;
+    return mapValue(
+            m_master.toVariantMap(), "replication_master").toVariantMap();
 }
 
 S9sNode
@@ -485,16 +548,18 @@ S9sReplication::node(
         const S9sString &hostName,
         const int        port) const
 {
-    S9sVector<S9sNode> nodes = m_cluster.nodes();
+    int nNodes = m_cluster.nNodes();
 
-    for (uint idx = 0u; idx < nodes.size(); ++idx)
+    for (int idx = 0; idx < nNodes; ++idx)
     {
-        const S9sNode &node = nodes[idx];
+        const S9sVariantMap &properties = m_cluster.nodeProperties(idx);
 
-        if (node.hostName() == hostName && node.port() == port)
-            return node;
+        if (mapValue(properties, "hostname").toString() == hostName && 
+                mapValue(properties, "port").toInt() == port)
+        {
+            return S9sNode(properties);
+        }
     }
 
     return S9sNode();
 }
-
@@ -38,8 +38,17 @@ class S9sReplication : public S9sObject
                 const S9sCluster &cluster,
                 const S9sNode    &slave);
 
+        S9sReplication(
+                const int         clusterId,
+                const S9sNode    &slave,
+                const S9sNode    &master);
+
         bool isValid() const;
 
+        int clusterId() const;
+        bool hasMasterClusterId() const;
+        int masterClusterId() const;
+
         S9sString slaveHostName() const;
         S9sString masterHostName() const;
 
@@ -65,8 +74,8 @@ class S9sReplication : public S9sObject
         bool matchMaster(const S9sNode &master);
 
     private:
-        S9sVariantMap slaveInfo() const;
-        S9sVariantMap masterInfo() const;
+        const S9sVariantMap &slaveInfo() const;
+        const S9sVariantMap &masterInfo() const;
 
         S9sNode node(
                 const S9sString &hostName,
@@ -74,8 +83,13 @@ class S9sReplication : public S9sObject
 
     private:
         /** The cluster in which the slave can be found. */
-        S9sCluster   m_cluster;
+        S9sCluster       m_cluster;
         /** It is the slave that knows most of the master and not the master
          * that knows the slave best.*/
-        S9sNode      m_slave;
+        S9sNode          m_slave;
+        /** The master if it was already found, found on demand in const
+         * methods. */
+        mutable S9sNode  m_master;
+        mutable bool     m_hasMaster;
+        int              m_clusterId;
 };
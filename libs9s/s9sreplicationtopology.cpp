@@ -0,0 +1,315 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9sreplicationtopology.h"
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+/*
+ * The number of lag samples kept for every link.
+ */
+#define LAG_HISTORY_SIZE 60
+
+S9sReplicationTopology::S9sReplicationTopology()
+{
+}
+
+S9sReplicationTopology::~S9sReplicationTopology()
+{
+}
+
+/**
+ * \param clusterList The list of clusters with the hosts as the controller
+ *   sends them in the getAllClusterInfo reply.
+ *
+ * Builds the index, finds the masters of the slaves and records the current
+ * lag of the links.
+ */
+void
+S9sReplicationTopology::build(
+        const S9sVariantList &clusterList)
+{
+    S9sVector<int> clusterIds;
+
+    m_nodes.clear();
+    m_links.clear();
+    m_nodeIndex.clear();
+    m_slaveLinks.clear();
+    m_cycleNodes.clear();
+
+    for (uint idx = 0u; idx < clusterList.size(); ++idx)
+    {
+        const S9sVariantMap  &clusterMap = clusterList[idx].toVariantMap();
+        S9sVariantList        hosts;
+        int                   clusterId = 0;
+        
+        if (clusterMap.contains("cluster_id"))
+            clusterId = clusterMap.at("cluster_id").toInt();
+
+        if (clusterMap.contains("hosts"))
+            hosts = clusterMap.at("hosts").toVariantList();
+
+        for (uint idx1 = 0u; idx1 < hosts.size(); ++idx1)
+        {
+            S9sNode     node = hosts[idx1].toVariantMap();
+            std::string name = nodeName(node.hostName(), node.port());
+
+            // The same node may be listed in more clusters.
+            if (m_nodeIndex.find(name) == m_nodeIndex.end())
+                m_nodeIndex[name] = m_nodes.size();
+
+            m_nodes    << node;
+            clusterIds << clusterId;
+        }
+    }
+
+    for (uint idx = 0u; idx < m_nodes.size(); ++idx)
+    {
+        const S9sNode  &slave = m_nodes[idx];
+        S9sString       masterName;
+        S9sString       role = slave.role();
+
+        if (role == "controller" || role == "master" || 
+                slave.masterHost().empty())
+        {
+            continue;
+        }
+
+        S9sReplication replication(
+                clusterIds[idx], slave, 
+                node(slave.masterHost(), slave.masterPort()));
+
+        if (!replication.isValid())
+            continue;
+
+        masterName = replication.masterName();
+        m_slaveLinks[masterName] << m_links.size();
+        m_links << replication;
+    }
+
+    findCycles();
+    recordLag();
+}
+
+/**
+ * \returns How many replication links are in the topology.
+ */
+uint
+S9sReplicationTopology::nLinks() const
+{
+    return m_links.size();
+}
+
+const S9sReplication &
+S9sReplicationTopology::link(
+        const uint index) const
+{
+    return m_links[index];
+}
+
+bool
+S9sReplicationTopology::hasNode(
+        const S9sString &hostName, 
+        const int        port) const
+{
+    return m_nodeIndex.find(nodeName(hostName, port)) != m_nodeIndex.end();
+}
+
+/**
+ * \returns The node with the given host name and port or an empty node if it
+ *   is not found.
+ */
+const S9sNode &
+S9sReplicationTopology::node(
+        const S9sString &hostName, 
+        const int        port) const
+{
+    static const S9sNode empty;
+    std::unordered_map<std::string, uint>::const_iterator it;
+
+    it = m_nodeIndex.find(nodeName(hostName, port));
+    if (it == m_nodeIndex.end())
+        return empty;
+
+    return m_nodes[it->second];
+}
+
+/**
+ * \param masterName The "host:port" name of the master.
+ * \returns The indexes of the links that replicate from the given master.
+ */
+S9sVector<uint>
+S9sReplicationTopology::slaveLinks(
+        const S9sString &masterName) const
+{
+    std::unordered_map<std::string, S9sVector<uint> >::const_iterator it;
+
+    it = m_slaveLinks.find(masterName);
+    if (it == m_slaveLinks.end())
+        return S9sVector<uint>();
+
+    return it->second;
+}
+
+/**
+ * \returns True if there is at least one circular replication in the topology
+ *   (e.g. a master-master pair).
+ */
+bool
+S9sReplicationTopology::hasCycle() const
+{
+    return !m_cycleNodes.empty();
+}
+
+bool
+S9sReplicationTopology::isInCycle(
+        const S9sString &nodeName) const
+{
+    return m_cycleNodes.find(nodeName) != m_cycleNodes.end();
+}
+
+/**
+ * \returns The lag samples of the link in the order they were recorded.
+ */
+S9sVector<int>
+S9sReplicationTopology::lagHistory(
+        const uint index) const
+{
+    S9sVector<int> retval;
+    S9sString      key;
+
+    if (index >= m_links.size())
+        return retval;
+
+    key = m_links[index].slaveName() + "->" + m_links[index].masterName();
+    if (!m_lagHistory.contains(key))
+        return retval;
+
+    const LagHistory &history = m_lagHistory.at(key);
+    uint              size    = history.samples.size();
+
+    for (uint idx = 0u; idx < size; ++idx)
+        retval << history.samples[(history.next + idx) % size];
+
+    return retval;
+}
+
+S9sString 
+S9sReplicationTopology::nodeName(
+        const S9sString &hostName, 
+        const int        port)
+{
+    S9sString retval;
+
+    retval.sprintf("%s:%d", STR(hostName), port);
+    return retval;
+}
+
+/**
+ * Every slave has at most one master, so following the masters from any node
+ * either ends or runs into a cycle. Every node is visited once.
+ */
+void
+S9sReplicationTopology::findCycles()
+{
+    std::unordered_map<std::string, std::string> masterOf;
+    std::unordered_map<std::string, int>         state;
+    
+    for (uint idx = 0u; idx < m_links.size(); ++idx)
+        masterOf[m_links[idx].slaveName()] = m_links[idx].masterName();
+
+    for (uint idx = 0u; idx < m_links.size(); ++idx)
+    {
+        std::string name = m_links[idx].slaveName();
+        std::string start;
+
+        // 1: on the current path, 2: already processed.
+        while (state[name] == 0)
+        {
+            state[name] = 1;
+            
+            if (masterOf.find(name) == masterOf.end())
+                break;
+
+            name = masterOf[name];
+        }
+
+        if (state[name] == 1 && masterOf.find(name) != masterOf.end())
+        {
+            start = name;
+            do {
+                m_cycleNodes.insert(name);
+                name = masterOf[name];
+            } while (name != start);
+        }
+
+        name = m_links[idx].slaveName();
+        while (state[name] == 1)
+        {
+            state[name] = 2;
+
+            if (masterOf.find(name) == masterOf.end())
+                break;
+
+            name = masterOf[name];
+        }
+    }
+}
+
+/**
+ * Adds the current lag of every link to its ring buffer and drops the history
+ * of the links that are not there any more.
+ */
+void
+S9sReplicationTopology::recordLag()
+{
+    S9sMap<S9sString, LagHistory>::iterator it;
+
+    for (it = m_lagHistory.begin(); it != m_lagHistory.end(); ++it)
+        it->second.seen = false;
+
+    for (uint idx = 0u; idx < m_links.size(); ++idx)
+    {
+        const S9sReplication &link = m_links[idx];
+        S9sString   key = link.slaveName() + "->" + link.masterName();
+        LagHistory &history = m_lagHistory[key];
+        int         lag = link.secondsBehindMaster();
+
+        if (history.samples.size() < LAG_HISTORY_SIZE)
+        {
+            history.samples << lag;
+            history.next = 0u;
+        } else {
+            history.samples[history.next] = lag;
+            history.next = (history.next + 1) % LAG_HISTORY_SIZE;
+        }
+
+        history.seen = true;
+    }
+
+    for (it = m_lagHistory.begin(); it != m_lagHistory.end(); )
+    {
+        if (it->second.seen)
+            ++it;
+        else
+            m_lagHistory.erase(it++);
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sReplication"
+#include "S9sVariantList"
+#include "S9sVector"
+#include "S9sMap"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <string>
+
+/**
+ * An index of the replication links found in the clusters of one reply. The
+ * nodes are hashed by their "host:port" names, the links are indexed by their
+ * masters (so the slaves of a master are found without a scan) and the nodes
+ * that are part of circular replications are marked.
+ *
+ * The topology can be built again and again (e.g. in the s9s replication
+ * --watch view), it then keeps a ring buffer of the replication lag samples
+ * for every link.
+ */
+class S9sReplicationTopology
+{
+    public:
+        S9sReplicationTopology();
+        virtual ~S9sReplicationTopology();
+
+        void build(const S9sVariantList &clusterList);
+
+        uint nLinks() const;
+        const S9sReplication &link(const uint index) const;
+
+        bool hasNode(const S9sString &hostName, const int port) const;
+        
+        const S9sNode &
+            node(
+                const S9sString &hostName, 
+                const int        port) const;
+
+        S9sVector<uint> slaveLinks(const S9sString &masterName) const;
+
+        bool hasCycle() const;
+        bool isInCycle(const S9sString &nodeName) const;
+
+        S9sVector<int> lagHistory(const uint index) const;
+
+        static S9sString 
+            nodeName(
+                const S9sString &hostName, 
+                const int        port);
+
+    private:
+        void findCycles();
+        void recordLag();
+
+    private:
+        /** A ring buffer of the lag samples of one link. */
+        struct LagHistory
+        {
+            LagHistory() : next(0u), seen(false) {};
+
+            S9sVector<int>  samples;
+            uint            next;
+            bool            seen;
+        };
+
+        S9sVector<S9sNode>          m_nodes;
+        S9sVector<S9sReplication>   m_links;
+
+        /** The index of the nodes in m_nodes by name. */
+        std::unordered_map<std::string, uint> m_nodeIndex;
+        /** The indexes of the links in m_links by master name. */
+        std::unordered_map<std::string, S9sVector<uint> > m_slaveLinks;
+        /** The names of the nodes that are in a replication cycle. */
+        std::unordered_set<std::string> m_cycleNodes;
+
+        S9sMap<S9sString, LagHistory> m_lagHistory;
+};
@@ -0,0 +1,462 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9sreplycache.h"
+
+#include "S9sFile"
+#include "S9sDir"
+#include "S9sEvent"
+#include "S9sMutexLocker"
+
+#include <functional>
+#include <sys/stat.h>
+#include <string>
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+/*
+ * If the in-memory cache grows above this many entries the expired entries
+ * are dropped, and if that is not enough the whole cache is cleared. The long
+ * running UIs send the same few requests again and again, so this limit is
+ * only a protection.
+ */
+#define REPLY_CACHE_MAX_ENTRIES 256
+
+/*
+ * The name of the file in the cache directory that holds the time of the last
+ * invalidation. The entries created before this time are not used.
+ */
+#define REPLY_CACHE_INVALIDATED "invalidated"
+
+S9sVariantMap S9sReplyCache::sm_entries;
+ulonglong     S9sReplyCache::sm_invalidated = 0ull;
+
+/*
+ * Protects the in-memory cache, the event reader threads are invalidating it
+ * while the UI thread is using it.
+ */
+static S9sMutex entriesMutex;
+
+static S9sVariant
+entryValue(
+        const S9sVariantMap &entry,
+        const char          *key)
+{
+    return entry.contains(key) ? entry.at(key) : S9sVariant();
+}
+
+/**
+ * \param controllerName The name of the controller the replies come from.
+ * \param controllerPort The port of the controller.
+ * \param userName The name of the user, different users might get different
+ *   replies for the same request.
+ */
+S9sReplyCache::S9sReplyCache(
+        const S9sString &controllerName,
+        const int        controllerPort,
+        const S9sString &userName) :
+    m_timeToLive(0)
+{
+    m_prefix.sprintf("%s@%s:%d", 
+            STR(userName), STR(controllerName), controllerPort);
+}
+
+S9sReplyCache::~S9sReplyCache()
+{
+}
+
+/**
+ * \param seconds The time to live for the new entries, overriding the default
+ *   of the operation. Zero means the default of the operation is used.
+ */
+void
+S9sReplyCache::setTimeToLive(
+        const int seconds)
+{
+    m_timeToLive = seconds;
+}
+
+/**
+ * \returns The directory where the shared cache files are stored.
+ */
+S9sString
+S9sReplyCache::cacheDirectory()
+{
+    return "~/.s9s/reply_cache";
+}
+
+/**
+ * \returns The current time in microseconds. The entries stored right after an
+ *   invalidation must be distinguished from the ones stored before it, so
+ *   seconds are not enough here.
+ */
+ulonglong
+S9sReplyCache::timeStamp()
+{
+    struct timespec now;
+
+    ::clock_gettime(CLOCK_REALTIME, &now);
+    return (ulonglong) now.tv_sec * 1000000ull + now.tv_nsec / 1000;
+}
+
+/**
+ * \param request The request that is about to be sent.
+ * \returns True if the reply for the request can be taken from the cache.
+ */
+bool
+S9sReplyCache::isCacheable(
+        const S9sVariantMap &request)
+{
+    S9sString operation = entryValue(request, "operation").toString();
+
+    if (entryValue(request, "refresh_now").toBoolean())
+        return false;
+
+    return timeToLive(operation) > 0;
+}
+
+/**
+ * \param operation The name of the operation in the request.
+ * \returns The default time to live of the cached replies for the given
+ *   operation in seconds, 0 if the operation is not cacheable.
+ *
+ * The meta types and the templates change only when the controller is
+ * upgraded, the clusters and the tree change more often.
+ */
+int
+S9sReplyCache::timeToLive(
+        const S9sString &operation)
+{
+    if (operation == "getMetaTypes" || 
+            operation == "getMetaTypeInfo" ||
+            operation == "getReportTemplates" ||
+            operation == "getSupportedClusterTypes")
+    {
+        return 3600;
+    }
+
+    if (operation == "getAllClusterInfo" ||
+            operation == "getClusterInfo" ||
+            operation == "getTree")
+    {
+        return 10;
+    }
+
+    return 0;
+}
+
+/**
+ * \param operation The name of the operation in the request.
+ * \returns True if the operation does not change anything on the controller,
+ *   so sending it does not invalidate the cache.
+ */
+bool
+S9sReplyCache::isReadOnly(
+        const S9sString &operation)
+{
+    if (operation.startsWith("get") || operation.startsWith("authenticate"))
+        return true;
+
+    return 
+        operation == "availableUpgrades" || 
+        operation == "canCreateUser"     ||
+        operation == "cat"               ||
+        operation == "checkAccess"       ||
+        operation == "checkClusterName"  ||
+        operation == "checkHosts"        ||
+        operation == "dirTree"           ||
+        operation == "noOperation"       ||
+        operation == "ping"              ||
+        operation == "response"          ||
+        operation == "statByName"        ||
+        operation == "subscribe"         ||
+        operation == "whoAmI";
+}
+
+/**
+ * \param event An event received from the controller.
+ * \returns True if the event shows that the clusters, the hosts or the tree
+ *   has been changed, so the cached replies are probably outdated.
+ */
+bool
+S9sReplyCache::isRelevantEvent(
+        const S9sVariantMap &event)
+{
+    S9sEvent::EventType     type;
+    S9sEvent::EventSubClass subClass;
+
+    type     = S9sEvent::stringToEventType(
+            entryValue(event, "event_class").toString());
+    subClass = S9sEvent::stringToEventSubClass(
+            entryValue(event, "event_name").toString());
+
+    switch (type)
+    {
+        case S9sEvent::EventCluster:
+        case S9sEvent::EventHost:
+        case S9sEvent::EventMaintenance:
+            return subClass == S9sEvent::Created ||
+                subClass == S9sEvent::Destroyed ||
+                subClass == S9sEvent::Changed ||
+                subClass == S9sEvent::StateChanged;
+
+        case S9sEvent::EventJob:
+            return subClass == S9sEvent::Ended;
+
+        case S9sEvent::EventFile:
+            return true;
+
+        default:
+            break;
+    }
+
+    return false;
+}
+
+/**
+ * \param shared If this is true the shared on-disk store is invalidated too,
+ *   so the other s9s processes will not use the outdated replies either.
+ *
+ * Drops every cached reply. Called when a request that might change something
+ * on the controller is sent or when an event shows that something changed.
+ */
+void
+S9sReplyCache::invalidate(
+        const bool shared)
+{
+    ulonglong invalidatedAt = timeStamp();
+
+    entriesMutex.lock();
+    sm_entries.clear();
+    sm_invalidated = invalidatedAt;
+    entriesMutex.unlock();
+
+    if (shared && S9sDir(cacheDirectory()).exists())
+    {
+        S9sFile   file(S9sFile::buildPath(
+                    cacheDirectory(), REPLY_CACHE_INVALIDATED));
+        S9sString content;
+
+        content.sprintf("%llu", invalidatedAt);
+        if (!file.writeTxtFile(content))
+            PRINT_LOG("%s", STR(file.errorString()));
+    }
+}
+
+/**
+ * \returns The time of the last invalidation in microseconds either by this
+ *   process or by an other process using the shared store.
+ */
+ulonglong
+S9sReplyCache::invalidated()
+{
+    S9sFile   file(S9sFile::buildPath(
+                cacheDirectory(), REPLY_CACHE_INVALIDATED));
+    S9sString content;
+    ulonglong retval;
+
+    entriesMutex.lock();
+    retval = sm_invalidated;
+    entriesMutex.unlock();
+
+    if (file.exists() && file.readTxtFile(content))
+    {
+        ulonglong shared = content.toULongLong();
+
+        if (shared > retval)
+            retval = shared;
+    }
+
+    return retval;
+}
+
+/**
+ * \param uri The URI the request is sent to.
+ * \param request The request that is about to be sent.
+ * \param reply The place where the cached reply is returned.
+ * \returns True if a valid reply was found in the cache.
+ */
+bool
+S9sReplyCache::find(
+        const S9sString     &uri,
+        const S9sVariantMap &request,
+        S9sVariantMap       &reply) const
+{
+    S9sString     theKey = key(uri, request);
+    time_t        now = time(NULL);
+    ulonglong     invalidatedAt = invalidated();
+    S9sVariantMap entry;
+    bool          found;
+
+    entriesMutex.lock();
+    found = sm_entries.contains(theKey);
+    if (found)
+        entry = sm_entries.at(theKey).toVariantMap();
+    entriesMutex.unlock();
+
+    if (!found)
+    {
+        S9sFile   file(path(theKey));
+        S9sString content;
+
+        if (!file.exists() || !file.readTxtFile(content))
+            return false;
+
+        if (!entry.parse(STR(content)) || 
+                entryValue(entry, "key").toString() != theKey)
+        {
+            return false;
+        }
+    }
+
+    if (entryValue(entry, "created").toULongLong() <= invalidatedAt ||
+            entryValue(entry, "expires").toTimeT() < now)
+    {
+        S9sMutexLocker locker(entriesMutex);
+
+        sm_entries.erase(theKey);
+        return false;
+    }
+
+    reply = entryValue(entry, "reply").toVariantMap();
+    
+    entriesMutex.lock();
+    sm_entries[theKey] = entry;
+    entriesMutex.unlock();
+
+    PRINT_LOG("Reply of '%s' taken from the cache.", 
+            STR(entryValue(request, "operation").toString()));
+
+    return true;
+}
+
+/**
+ * \param uri The URI the request was sent to.
+ * \param request The request that was sent.
+ * \param reply The reply received from the controller.
+ * \param sent The timeStamp() taken before the request was sent.
+ *
+ * Stores the reply both in the memory and in the shared on-disk store. The
+ * entry is as old as the request: if the cache was invalidated while the
+ * request was in progress the reply might already be stale, then it is not
+ * stored.
+ */
+void
+S9sReplyCache::store(
+        const S9sString     &uri,
+        const S9sVariantMap &request,
+        const S9sVariantMap &reply,
+        const ulonglong      sent)
+{
+    S9sString     operation = entryValue(request, "operation").toString();
+    S9sString     theKey = key(uri, request);
+    time_t        now = time(NULL);
+    int           ttl = m_timeToLive > 0 ? m_timeToLive : timeToLive(operation);
+    S9sDir        dir(cacheDirectory());
+    S9sFile       file(path(theKey));
+    S9sVariantMap entry;
+
+    if (sent <= invalidated())
+    {
+        PRINT_LOG("Cache invalidated while '%s' was sent.", STR(operation));
+        return;
+    }
+
+    entry["key"]     = theKey;
+    entry["created"] = sent;
+    entry["expires"] = (ulonglong) now + ttl;
+    entry["reply"]   = reply;
+
+    entriesMutex.lock();
+    if (sm_entries.size() >= REPLY_CACHE_MAX_ENTRIES)
+    {
+        S9sVector<S9sString> keys = sm_entries.keys();
+
+        for (uint idx = 0u; idx < keys.size(); ++idx)
+        {
+            const S9sVariantMap &old = sm_entries.at(keys[idx]).toVariantMap();
+
+            if (entryValue(old, "expires").toTimeT() < now)
+                sm_entries.erase(keys[idx]);
+        }
+
+        if (sm_entries.size() >= REPLY_CACHE_MAX_ENTRIES)
+            sm_entries.clear();
+    }
+
+    sm_entries[theKey] = entry;
+    entriesMutex.unlock();
+
+    /*
+     * The replies might hold information the other users should not see, so
+     * the files are only readable by the owner.
+     */
+    if (!dir.exists())
+    {
+        if (!dir.mkdir())
+        {
+            PRINT_LOG("%s", STR(dir.errorString()));
+            return;
+        }
+
+        ::chmod(STR(dir.path()), 0700);
+    }
+
+    if (!file.writeTxtFile(entry.toString(), 0600))
+        PRINT_LOG("%s", STR(file.errorString()));
+}
+
+/**
+ * \returns The string that identifies the request: the user, the controller,
+ *   the URI and the request without the fields that change on every request.
+ */
+S9sString
+S9sReplyCache::key(
+        const S9sString     &uri,
+        const S9sVariantMap &request) const
+{
+    S9sVariantMap theRequest = request;
+    S9sString     retval;
+
+    theRequest.erase("request_created");
+    theRequest.erase("request_id");
+
+    retval.sprintf("%s%s %s", 
+            STR(m_prefix), STR(uri), STR(theRequest.toString()));
+
+    return retval;
+}
+
+/**
+ * \returns The path of the file that holds the entry with the given key. The
+ *   key is stored in the file too, so the hash collisions are detected.
+ */
+S9sString
+S9sReplyCache::path(
+        const S9sString &key)
+{
+    S9sString fileName;
+
+    fileName.sprintf("%016llx.json", 
+            (ulonglong) std::hash<std::string>()(key));
+
+    return S9sFile::buildPath(cacheDirectory(), fileName);
+}
@@ -0,0 +1,82 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sVariantMap"
+
+/**
+ * A cache for the replies of the read-only RPC requests. The replies are kept
+ * in the memory of the process and in a shared on-disk store under
+ * ~/.s9s/reply_cache, so consecutive s9s invocations (completion scripts,
+ * dashboards calling "s9s cluster --list" in a loop) can use them as well.
+ *
+ * The entries are keyed by the controller, the user, the URI and the request
+ * itself. Every cacheable operation has its own time to live and every request
+ * that might change something on the controller invalidates the whole cache.
+ */
+class S9sReplyCache
+{
+    public:
+        S9sReplyCache(
+                const S9sString &controllerName,
+                const int        controllerPort,
+                const S9sString &userName);
+
+        virtual ~S9sReplyCache();
+
+        void setTimeToLive(const int seconds);
+
+        bool
+            find(
+                const S9sString     &uri,
+                const S9sVariantMap &request,
+                S9sVariantMap       &reply) const;
+
+        void
+            store(
+                const S9sString     &uri,
+                const S9sVariantMap &request,
+                const S9sVariantMap &reply,
+                const ulonglong      sent);
+
+        static bool isCacheable(const S9sVariantMap &request);
+        static bool isReadOnly(const S9sString &operation);
+        static bool isRelevantEvent(const S9sVariantMap &event);
+        static int timeToLive(const S9sString &operation);
+
+        static void invalidate(const bool shared = true);
+        static S9sString cacheDirectory();
+        static ulonglong timeStamp();
+
+    private:
+        S9sString key(
+                const S9sString     &uri,
+                const S9sVariantMap &request) const;
+
+        static S9sString path(const S9sString &key);
+        static ulonglong invalidated();
+
+    private:
+        S9sString            m_prefix;
+        int                  m_timeToLive;
+
+        static S9sVariantMap sm_entries;
+        static ulonglong     sm_invalidated;
+};
@@ -0,0 +1,273 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9srowrenderer.h"
+
+#include "S9sThread"
+
+#include <unistd.h>
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+/*
+ * More threads than this would not make the printing any faster, the output
+ * has to be written by one thread anyway.
+ */
+#define MAX_THREADS          8
+
+/*
+ * Starting a thread for only a few rows is more expensive than processing
+ * them.
+ */
+#define MIN_ROWS_PER_THREAD  256
+
+/**
+ * The thread that processes one slice of the rows.
+ */
+class S9sRowRendererWorker : public S9sThread
+{
+    public:
+        S9sRowRendererWorker(
+                const S9sVariantList                 &rows,
+                const uint                            first,
+                const uint                            last,
+                void                                 *userData,
+                S9sRowRenderer::WidenFunction         widenFunction,
+                S9sRowRenderer::RenderFunction        renderFunction,
+                const S9sVector<S9sFormat>           &columns);
+
+        virtual ~S9sRowRendererWorker() {};
+
+        void process();
+
+        S9sVector<S9sFormat>  m_columns;
+        S9sString             m_output;
+        bool                  m_started;
+
+    protected:
+        virtual int exec();
+
+    private:
+        const S9sVariantList           &m_rows;
+        uint                            m_first;
+        uint                            m_last;
+        void                           *m_userData;
+        S9sRowRenderer::WidenFunction   m_widenFunction;
+        S9sRowRenderer::RenderFunction  m_renderFunction;
+};
+
+S9sRowRendererWorker::S9sRowRendererWorker(
+        const S9sVariantList                 &rows,
+        const uint                            first,
+        const uint                            last,
+        void                                 *userData,
+        S9sRowRenderer::WidenFunction         widenFunction,
+        S9sRowRenderer::RenderFunction        renderFunction,
+        const S9sVector<S9sFormat>           &columns) :
+    m_columns(columns),
+    m_started(false),
+    m_rows(rows),
+    m_first(first),
+    m_last(last),
+    m_userData(userData),
+    m_widenFunction(widenFunction),
+    m_renderFunction(renderFunction)
+{
+}
+
+/**
+ * Processes the rows of the slice in the thread that calls this method.
+ */
+void
+S9sRowRendererWorker::process()
+{
+    if (m_widenFunction != NULL)
+    {
+        for (uint idx = m_first; idx < m_last; ++idx)
+            m_widenFunction(m_userData, m_rows[idx], m_columns);
+    }
+
+    if (m_renderFunction != NULL)
+    {
+        for (uint idx = 0u; idx < m_columns.size(); ++idx)
+            m_columns[idx].setOutput(&m_output);
+
+        for (uint idx = m_first; idx < m_last; ++idx)
+            m_renderFunction(m_userData, m_rows[idx], m_columns, m_output);
+    }
+}
+
+int
+S9sRowRendererWorker::exec()
+{
+    process();
+    return 0;
+}
+
+/**
+ * \param rows The rows to process. The list is not copied, it has to exist
+ *   while the renderer is used.
+ * \param userData The pointer that is passed to the row functions.
+ */
+S9sRowRenderer::S9sRowRenderer(
+        const S9sVariantList &rows,
+        void                 *userData) :
+    m_rows(rows),
+    m_userData(userData),
+    m_maxThreads(MAX_THREADS),
+    m_rowsPerThread(MIN_ROWS_PER_THREAD)
+{
+    long nProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (nProcessors > 0 && nProcessors < m_maxThreads)
+        m_maxThreads = nProcessors;
+}
+
+void
+S9sRowRenderer::setMaxThreads(
+        const int value)
+{
+    m_maxThreads = value > 0 ? value : 1;
+}
+
+void
+S9sRowRenderer::setRowsPerThread(
+        const int value)
+{
+    m_rowsPerThread = value > 0 ? value : 1;
+}
+
+/**
+ * \returns How many threads will be used to process the rows: one thread for
+ *   every MIN_ROWS_PER_THREAD rows, but not more than the maximum, which is by
+ *   default the number of the processors.
+ */
+int
+S9sRowRenderer::nThreads() const
+{
+    int  retval;
+
+    retval = (m_rows.size() + m_rowsPerThread - 1) / m_rowsPerThread;
+
+    if (retval > m_maxThreads)
+        retval = m_maxThreads;
+
+    if (retval < 1)
+        retval = 1;
+
+    return retval;
+}
+
+/**
+ * \param function The function that widens the formats for one row.
+ * \param columns The formats of the columns, they will be widened to
+ *   accomodate all the rows.
+ */
+void
+S9sRowRenderer::widen(
+        WidenFunction         function, 
+        S9sVector<S9sFormat> &columns)
+{
+    run(function, NULL, columns, NULL);
+}
+
+/**
+ * \param function The function that renders one row.
+ * \param columns The formats of the columns already widened.
+ * \returns The rendered rows in their original order.
+ */
+S9sString
+S9sRowRenderer::render(
+        RenderFunction              function, 
+        const S9sVector<S9sFormat> &columns)
+{
+    S9sVector<S9sFormat> myColumns = columns;
+    S9sString            retval;
+
+    run(NULL, function, myColumns, &retval);
+    return retval;
+}
+
+void
+S9sRowRenderer::run(
+        WidenFunction         widenFunction, 
+        RenderFunction        renderFunction, 
+        S9sVector<S9sFormat> &columns,
+        S9sString            *output)
+{
+    S9sVector<S9sRowRendererWorker *> workers;
+    int  nWorkers = nThreads();
+    uint sliceSize = (m_rows.size() + nWorkers - 1) / nWorkers;
+
+    S9S_DEBUG("%u rows, %d threads", m_rows.size(), nWorkers);
+
+    for (int idx = 0; idx < nWorkers; ++idx)
+    {
+        uint first = idx * sliceSize;
+        uint last  = first + sliceSize;
+
+        if (first > m_rows.size())
+            first = m_rows.size();
+
+        if (last > m_rows.size())
+            last = m_rows.size();
+
+        workers << new S9sRowRendererWorker(
+                m_rows, first, last, m_userData, 
+                widenFunction, renderFunction, columns);
+    }
+
+    /*
+     * The first slice is processed by the calling thread, if a thread can not
+     * be started we process its slice here too.
+     */
+    for (uint idx = 1u; idx < workers.size(); ++idx)
+        workers[idx]->m_started = workers[idx]->start();
+
+    for (uint idx = 0u; idx < workers.size(); ++idx)
+    {
+        if (!workers[idx]->m_started)
+            workers[idx]->process();
+    }
+
+    for (uint idx = 0u; idx < workers.size(); ++idx)
+    {
+        if (workers[idx]->m_started)
+            workers[idx]->join();
+    }
+
+    /*
+     * Merging the results in the original order of the rows.
+     */
+    for (uint idx = 0u; idx < workers.size(); ++idx)
+    {
+        if (widenFunction != NULL)
+        {
+            for (uint col = 0u; col < columns.size(); ++col)
+                columns[col].widen(workers[idx]->m_columns[col]);
+        }
+
+        if (output != NULL)
+            *output += workers[idx]->m_output;
+
+        delete workers[idx];
+    }
+}
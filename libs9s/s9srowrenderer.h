@@ -0,0 +1,79 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sFormat"
+#include "S9sVariantList"
+#include "S9sVector"
+
+/**
+ * A class that prints the rows of the long lists in parallel. The list is cut
+ * into contiguous slices and every slice is processed by its own thread. In
+ * the first run the threads measure the column widths on their own copy of
+ * the formats and the widths are merged when all the threads are finished. In
+ * the second run the rows are rendered into strings using the merged widths
+ * and the strings are concatenated in the order of the slices, so the output
+ * is the same as if the rows were printed one by one.
+ *
+ * The row functions are called from several threads at the same time, so they
+ * should not modify anything but the formats and the output string they
+ * receive as arguments.
+ */
+class S9sRowRenderer
+{
+    public:
+        typedef void (*WidenFunction)(
+                void                 *userData, 
+                const S9sVariant     &row, 
+                S9sVector<S9sFormat> &columns);
+
+        typedef void (*RenderFunction)(
+                void                 *userData, 
+                const S9sVariant     &row, 
+                S9sVector<S9sFormat> &columns,
+                S9sString            &output);
+
+        S9sRowRenderer(const S9sVariantList &rows, void *userData);
+
+        void setMaxThreads(const int value);
+        void setRowsPerThread(const int value);
+        int nThreads() const;
+
+        void widen(
+                WidenFunction         function, 
+                S9sVector<S9sFormat> &columns);
+
+        S9sString render(
+                RenderFunction              function, 
+                const S9sVector<S9sFormat> &columns);
+
+    private:
+        void run(
+                WidenFunction         widenFunction, 
+                RenderFunction        renderFunction, 
+                S9sVector<S9sFormat> &columns,
+                S9sString            *output);
+
+    private:
+        const S9sVariantList &m_rows;
+        void                 *m_userData;
+        int                   m_maxThreads;
+        int                   m_rowsPerThread;
+};
@@ -29,10 +29,16 @@
 #include "S9sFile"
 #include "S9sSshCredentials"
 #include "S9sContainer"
+#include "S9sStatCache"
+#include "S9sReplyCache"
+#include "S9sArena"
+#include "S9sMutexLocker"
 
 #include <cstring>
 #include <cstdio>
+#include <sys/socket.h>
 #include <iostream> 
+#include <openssl/evp.h>
 
 //#define DEBUG
 #define WARNING
@@ -41,6 +47,20 @@
 #define READ_SIZE 10240
 //#define SEND_NODES
 
+/*
+ * The sessions (cookies) of the successful authentications of this process
+ * indexed by the user and the controller. A process that runs multiple
+ * commands (e.g. the s9s --daemon and the processes forked from it) will
+ * authenticate only once.
+ */
+S9sVariantMap S9sRpcClient::sm_sessions;
+
+/*
+ * The sessions are shared by the clients of the process, some of them are used
+ * in threads (e.g. the event readers).
+ */
+static S9sMutex sessionsMutex;
+
 /**
  * Default constructor.
  */
@@ -119,6 +139,45 @@ S9sRpcClient::operator= (
     return *this;
 }
 
+/**
+ * \returns A new client that is not sharing the connection with this one, but
+ *   talks to the same controller with the same session.
+ *
+ * The normal copy constructor creates a shallow copy, the copies share the
+ * connection. The client returned by this method can be used from an other
+ * thread while this client is also used to send requests.
+ */
+S9sRpcClient
+S9sRpcClient::newConnection() const
+{
+    S9sRpcClient retval(
+            m_priv->m_hostName, m_priv->m_port, m_priv->m_path,
+            m_priv->m_useTls);
+
+    retval.m_priv->m_cookies       = m_priv->m_cookies;
+    retval.m_priv->m_authenticated = m_priv->m_authenticated;
+    retval.m_priv->m_controllers   = m_priv->m_controllers;
+    retval.m_priv->m_servers       = m_priv->m_servers;
+    retval.m_priv->m_controllerSelected = true;
+
+    return retval;
+}
+
+/**
+ * Shuts down the connection of the client, so the request that is in progress
+ * in an other thread (e.g. the event subscription) returns. The socket itself
+ * is closed by the thread that uses the client, the mutex makes sure it is not
+ * closed while we shut it down here.
+ */
+void
+S9sRpcClient::interrupt()
+{
+    S9sMutexLocker locker(m_priv->m_socketMutex);
+
+    if (m_priv->m_socketFd >= 0)
+        ::shutdown(m_priv->m_socketFd, SHUT_RDWR);
+}
+
 S9sString
 S9sRpcClient::hostName() const
 {
@@ -406,6 +465,12 @@ S9sRpcClient::authenticate()
     bool           retval = false;
 
     PRINT_LOG("Authenticating...");
+    if (reuseSession())
+    {
+        PRINT_LOG("Reusing the session of %s.", STR(options->userName()));
+        return true;
+    }
+
     if (options->hasPassword())
         retval = authenticateWithPassword();
     else if (!options->password().empty())
@@ -414,13 +479,149 @@ S9sRpcClient::authenticate()
         retval = authenticateWithKey();
 
     if (retval)
+    {
         PRINT_LOG("Authenticated.");
-    else
+        rememberSession();
+    } else {
         PRINT_LOG("Authentication failed.");
+    }
 
     return retval;
 }
 
+/**
+ * Drops all the sessions this process remembers, so the next authenticate()
+ * call will send the authentication requests to the controller again.
+ */
+void
+S9sRpcClient::forgetSessions()
+{
+    S9sMutexLocker locker(sessionsMutex);
+
+    sm_sessions.clear();
+}
+
+/**
+ * \returns The SHA-256 digest of the credentials the current user would
+ *   authenticate with: the password or the content of the private key file.
+ */
+static S9sString
+credentialsDigest()
+{
+    S9sOptions    *options = S9sOptions::instance();
+    S9sString      credentials;
+    S9sString      retval;
+    unsigned char  digest[EVP_MAX_MD_SIZE];
+    unsigned int   digestLength = 0;
+
+    if (options->hasPassword() || !options->password().empty())
+    {
+        credentials = "password:" + options->password();
+    } else {
+        S9sFile   keyFile(options->privateKeyPath());
+        S9sString content;
+
+        // If the key can not be read the authentication fails anyway.
+        keyFile.readTxtFile(content);
+        credentials = "key:" + options->privateKeyPath() + ":" + content;
+    }
+
+    if (EVP_Digest(STR(credentials), credentials.length(), 
+                digest, &digestLength, EVP_sha256(), NULL) != 1)
+    {
+        return retval;
+    }
+
+    for (unsigned int idx = 0u; idx < digestLength; ++idx)
+    {
+        S9sString hex;
+
+        hex.sprintf("%02x", digest[idx]);
+        retval += hex;
+    }
+
+    return retval;
+}
+
+/**
+ * \returns The key under which the session of the current user with the
+ *   current controller is remembered.
+ *
+ * The key holds the digest of the credentials, so a session is never reused by
+ * a command that has an other password or key (e.g. a command forwarded to the
+ * s9s --daemon with a wrong password).
+ */
+S9sString
+S9sRpcClient::sessionKey() const
+{
+    S9sOptions *options = S9sOptions::instance();
+    S9sString   digest  = credentialsDigest();
+    S9sString   retval;
+
+    if (digest.empty())
+        return retval;
+
+    retval.sprintf("%s@%s:%d/%s", 
+            STR(options->userName()), 
+            STR(m_priv->m_hostName), m_priv->m_port,
+            STR(digest));
+
+    return retval;
+}
+
+/**
+ * \returns True if this process already authenticated the user with the
+ *   controller and the session cookies are set from that authentication.
+ */
+bool
+S9sRpcClient::reuseSession()
+{
+    S9sString     key = sessionKey();
+    S9sVariantMap session;
+
+    if (key.empty())
+        return false;
+
+    sessionsMutex.lock();
+    if (sm_sessions.contains(key))
+        session = sm_sessions.at(key).toVariantMap();
+    sessionsMutex.unlock();
+
+    if (session.empty())
+        return false;
+
+    m_priv->m_cookies       = session["cookies"].toVariantMap();
+    m_priv->m_serverHeader  = session["server"].toString();
+    m_priv->m_authenticated = true;
+    m_priv->m_sessionReused = true;
+    m_priv->m_errorString.clear();
+
+    return true;
+}
+
+/**
+ * Remembers the session cookies of a successful authentication so that other
+ * clients of the same process can reuse them.
+ */
+void
+S9sRpcClient::rememberSession()
+{
+    S9sString     key = sessionKey();
+    S9sVariantMap session;
+
+    if (m_priv->m_cookies.empty() || key.empty())
+        return;
+
+    session["cookies"] = m_priv->m_cookies;
+    session["server"]  = m_priv->m_serverHeader;
+
+    sessionsMutex.lock();
+    sm_sessions[key] = session;
+    sessionsMutex.unlock();
+
+    m_priv->m_sessionReused = false;
+}
+
 bool 
 S9sRpcClient::authenticateWithPassword()
 {
@@ -1741,39 +1942,68 @@ bool
 S9sRpcClient::getLog()
 {
     S9sOptions    *options   = S9sOptions::instance();
-    int            limit     = options->limit();
-    int            offset    = options->offset();
     S9sString      uri       = "/v2/log/";
     S9sVariantMap  request   = composeRequest();
     bool           retval;
 
-    // Building the request.
     if (!options->hasMessageId())
-    {
-        request["operation"]  = "getLogEntries";
-        request["ascending"]  = false;
+        return getLogEntries(options->limit(), options->offset(), false);
+
+    // Building the request.
+    request["operation"]  = "getLogEntry";
+    request["message_id"] = options->messageId();
+    request["cluster_id"] = options->clusterId();
     
-        if (options->isDebug())
-            request["severity"] = "LOG_DEBUG";
+    if (options->hasClusterNameOption())
+        request["cluster_name"] = options->clusterName();
 
-        else if (options->isWarning())
-            request["severity"] = "LOG_WARNING";
+    retval = executeRequest(uri, request);
+
+    return retval;
+}
+
+/**
+ * \param limit the maximum number of log entries to get, 0 means no limit.
+ * \param offset the number of log entries to skip.
+ * \param ascending if the log entries should be sent from the oldest to the
+ *   newest.
+ * \returns true if the operation was successful, a reply is received from the
+ *   controller (even if the reply is an error reply).
+ *
+ * Gets one page of the log entries, the severity, the time interval and the
+ * cluster are taken from the command line options.
+ */
+bool
+S9sRpcClient::getLogEntries(
+        const int  limit,
+        const int  offset,
+        const bool ascending)
+{
+    S9sOptions    *options   = S9sOptions::instance();
+    S9sString      uri       = "/v2/log/";
+    S9sVariantMap  request   = composeRequest();
+    bool           retval;
 
-        if (!options->from().empty())
-            request["created_after"] = options->from();
+    // Building the request.
+    request["operation"]  = "getLogEntries";
+    request["ascending"]  = ascending;
 
-        if (!options->until().empty())
-            request["created_before"] = options->until();
+    if (options->isDebug())
+        request["severity"] = "LOG_DEBUG";
+    else if (options->isWarning())
+        request["severity"] = "LOG_WARNING";
 
-        if (limit > 0)
-            request["limit"]  = limit;
+    if (!options->from().empty())
+        request["created_after"] = options->from();
 
-        if (offset > 0)
-            request["offset"] = offset;
-    } else {
-        request["operation"]  = "getLogEntry";
-        request["message_id"] = options->messageId();
-    }
+    if (!options->until().empty())
+        request["created_before"] = options->until();
+
+    if (limit > 0)
+        request["limit"]  = limit;
+
+    if (offset > 0)
+        request["offset"] = offset;
 
     request["cluster_id"] = options->clusterId();
     
@@ -3178,6 +3408,9 @@ S9sRpcClient::getStats(
 
     if (begin.empty() && end.empty())
     {
+        if (options->useStatCache())
+            return getStatsCached(clusterId, statName, request);
+
         request["startdate"]  = (ulonglong) now - 60 * 60;
         request["enddate"]    = (ulonglong) now;
     }
@@ -3187,6 +3420,64 @@ S9sRpcClient::getStats(
     return retval;
 }
 
+/**
+ * \param clusterId The ID of the cluster.
+ * \param statName The name of the statistics to get.
+ * \param request The request prepared by the getStats() method, only the time
+ *   interval is missing.
+ *
+ * A version of the getStats() that uses the local stat cache: only the samples
+ * that are not yet in the cache are requested from the controller, then the
+ * reply is changed to hold all the samples of the requested interval.
+ */
+bool
+S9sRpcClient::getStatsCached(
+        const int        clusterId,
+        const S9sString &statName,
+        S9sVariantMap   &request)
+{
+    S9sOptions    *options = S9sOptions::instance();
+    S9sString      uri = "/v2/stat";
+    S9sString      clusterKey;
+    time_t         now = time(NULL);
+    time_t         startDate = now - 60 * 60;
+    bool           retval;
+
+    if (options->hasClusterNameOption())
+        clusterKey = options->clusterName();
+    else
+        clusterKey.sprintf("%d", clusterId);
+
+    S9sStatCache cache(hostName(), port(), clusterKey, statName);
+
+    cache.load();
+    cache.expire(startDate);
+
+    request["startdate"]  = (ulonglong) cache.missingStart(startDate);
+    request["enddate"]    = (ulonglong) now;
+
+    PRINT_VERBOSE(
+            "Stat cache has %u sample(s), requesting %llu seconds.",
+            cache.nSamples(), 
+            (ulonglong) now - request["startdate"].toULongLong());
+
+    retval = executeRequest(uri, request);
+    if (retval && m_priv->m_reply.isOk())
+    {
+        cache.merge(
+                m_priv->m_reply["data"].toVariantList(),
+                m_priv->m_reply["hosts"].toVariantList(),
+                now);
+
+        cache.save();
+
+        m_priv->m_reply["data"]  = cache.samples(startDate);
+        m_priv->m_reply["hosts"] = cache.hosts();
+    }
+
+    return retval;
+}
+
 
 /**
  * \param hosts the hosts that will be the member of the cluster (variant list
@@ -9510,12 +9801,35 @@ S9sRpcClient::executeRequest(
         S9sVariantMap   &request,
         bool             important)
 {
+    S9sOptions    *options = S9sOptions::instance();
     S9sDateTime    now = S9sDateTime::currentDateTime();
     S9sString      timeString = now.toString(S9sDateTime::TzDateTimeFormat);
+    S9sString      operation = request["operation"].toString();
+    S9sReplyCache  cache(hostName(), port(), options->userName());
+    ulonglong      sent = S9sReplyCache::timeStamp();
+    bool           useCache;
+    bool           readOnly;
     bool           retval;
     int            nTry = 0;
     S9sVariantMap  triedKeys;
    
+    /*
+     * The replies of the read-only requests might be in the cache, every other
+     * request might change something, so it invalidates the cache.
+     */
+    useCache = 
+        options->useReplyCache() && S9sReplyCache::isCacheable(request);
+    readOnly = S9sReplyCache::isReadOnly(operation);
+
+    if (useCache && cache.find(uri, request, m_priv->m_reply))
+    {
+        PRINT_VERBOSE("Reply for '%s' found in the cache.", STR(operation));
+        return true;
+    } else if (!readOnly)
+    {
+        S9sReplyCache::invalidate();
+    }
+
     request["request_created"] = timeString;
     request["request_id"]      = ++m_priv->m_requestId;
     
@@ -9528,6 +9842,29 @@ S9sRpcClient::executeRequest(
         int            port = 0;
 
         retval = doExecuteRequest(uri, request);
+        m_priv->m_stats.finish(retval);
+
+        /*
+         * A session we took over from an earlier authentication might have
+         * expired on the controller. Then we authenticate again and repeat the
+         * request once.
+         */
+        if (retval && m_priv->m_sessionReused &&
+                m_priv->m_reply.requestStatus() == S9sRpcReply::AuthRequired)
+        {
+            PRINT_LOG("The reused session is expired.");
+            m_priv->m_sessionReused = false;
+
+            sessionsMutex.lock();
+            sm_sessions.erase(sessionKey());
+            sessionsMutex.unlock();
+
+            if (authenticate())
+            {
+                retval = doExecuteRequest(uri, request);
+                m_priv->m_stats.finish(retval);
+            }
+        }
             
         if (retval && m_priv->m_reply.isRedirect())
             m_priv->rememberRedirect();
@@ -9536,6 +9873,7 @@ S9sRpcClient::executeRequest(
         {
             S9sVariantMap        controllers;
             S9sVariantMap        controller;
+            S9sVariantMap        leader;
             S9sVector<S9sString> keys;
 
             PRINT_LOG("Redirect notification received.");
@@ -9547,6 +9885,20 @@ S9sRpcClient::executeRequest(
                     controllers.size());
 
             keys = controllers.keys();
+
+            // If the reply tells who the leader is we go there first.
+            leader = m_priv->m_reply["leader_controller"].toVariantMap();
+            if (!leader.empty())
+            {
+                S9sString key;
+
+                key.sprintf("%s:%d", 
+                        STR(leader["hostname"].toString()),
+                        leader["port"].toInt());
+
+                controllers[key] = leader;
+                keys.insert(keys.begin(), key);
+            }
             for (uint idx = 0u; idx < keys.size(); ++idx)
             {
                 S9sString key = keys[idx];
@@ -9601,6 +9953,26 @@ S9sRpcClient::executeRequest(
         }
     }
 
+    /*
+     * The controller that replied without redirecting us is the leader, the
+     * next s9s processes can connect to it directly.
+     */
+    if (retval && !m_priv->m_reply.isRedirect())
+        m_priv->setLeader(m_priv->m_hostName, m_priv->m_port);
+
+    if (retval && useCache && m_priv->m_reply.isOk())
+    {
+        cache.setTimeToLive(options->replyCacheTimeToLive());
+        cache.store(uri, request, m_priv->m_reply, sent);
+    }
+
+    /*
+     * The read-only requests that were sent while this one was executed might
+     * have stored the state before the change, so we invalidate again.
+     */
+    if (!readOnly)
+        S9sReplyCache::invalidate();
+
     return retval;
 }
 
@@ -9629,6 +10001,9 @@ S9sRpcClient::doExecuteRequest(
     size_t       dataSize;
     size_t       payloadSize = 0;
     bool         isJSonStream = false;
+    bool         gotFirstByte = false;
+    ulonglong    nAllocations;
+    bool         success;
 
     PRINT_LOG("Sending request to '%s'.", STR(uri));
     PRINT_VERBOSE("Preparing to send request.");
@@ -9643,6 +10018,11 @@ S9sRpcClient::doExecuteRequest(
     m_priv->m_jsonReply.clear();
     m_priv->m_reply.clear();
 
+    if (request.contains("operation"))
+        m_priv->m_stats.start(request.at("operation").toString());
+    else
+        m_priv->m_stats.start(uri);
+
     if (!m_priv->connect())
     {
         PRINT_LOG("%s", STR(m_priv->m_errorString));
@@ -9687,6 +10067,10 @@ S9sRpcClient::doExecuteRequest(
     
     PRINT_VERBOSE("Sending: \n%s\n", STR(dataToSend));
     writtenLength = m_priv->write(STR(dataToSend), dataSize);
+    m_priv->m_stats.phaseFinished("send");
+
+    if (writtenLength > 0)
+        m_priv->m_stats.addBytesSent(writtenLength);
 
 
     S9S_DEBUG("%s: Size: %zd, written: %zd", 
@@ -9727,6 +10111,13 @@ S9sRpcClient::doExecuteRequest(
 
         if (readLength > 0)
         {
+            if (!gotFirstByte)
+            {
+                m_priv->m_stats.phaseFinished("first_byte");
+                gotFirstByte = true;
+            }
+
+            m_priv->m_stats.addBytesReceived(readLength);
             m_priv->m_dataSize += readLength;
 
             // read may got interrupted due to too small buffer
@@ -9785,6 +10176,12 @@ S9sRpcClient::doExecuteRequest(
                 return false;
             }
 
+            if (options->useReplyCache() && 
+                    S9sReplyCache::isRelevantEvent(jsonRecord))
+            {
+                S9sReplyCache::invalidate(false);
+            }
+
             (*m_priv->m_callbackFunction)(
                         jsonRecord, m_priv->m_callbackUserData);
 
@@ -9796,7 +10193,10 @@ S9sRpcClient::doExecuteRequest(
             // If we read no data in streaming mode that simply means the
             // connection ended by the server.
             if (readLength == 0)
+            {
+                m_priv->m_stats.phaseFinished("transfer");
                 return true;
+            }
 
             // We continue reading the connection.
             continue;
@@ -9818,6 +10218,7 @@ S9sRpcClient::doExecuteRequest(
 
     // Closing the socket.
     m_priv->close();
+    m_priv->m_stats.phaseFinished("transfer");
    
     S9S_DEBUG("%s: total received: %zd bytes", 
             STR(timeStampString()), m_priv->m_dataSize);
@@ -9851,7 +10252,14 @@ S9sRpcClient::doExecuteRequest(
     }
 
     replyReceived = S9sDateTime::currentDateTime();
-    if (!m_priv->m_reply.parse(STR(m_priv->m_jsonReply)))
+    nAllocations  = S9sArena::totalAllocations();
+    success       = m_priv->m_reply.parse(STR(m_priv->m_jsonReply));
+
+    m_priv->m_stats.phaseFinished("parse");
+    m_priv->m_stats.addAllocations(
+            S9sArena::totalAllocations() - nAllocations);
+
+    if (!success)
     {
         PRINT_VERBOSE("Error in reply: \n%s\n", STR(m_priv->m_jsonReply));
 
@@ -44,6 +44,9 @@ class S9sRpcClient
 
         S9sRpcClient &operator=(const S9sRpcClient &rhs);
 
+        S9sRpcClient newConnection() const;
+        void interrupt();
+
         S9sString hostName() const;
         int port() const;
         bool useTls() const;
@@ -71,6 +74,8 @@ class S9sRpcClient
         bool authenticateWithKey();
         bool authenticateWithPassword();
 
+        static void forgetSessions();
+
         /*
          * The executers that send an RPC request and receive an RPC reply from
          * the server.
@@ -172,6 +177,11 @@ class S9sRpcClient
                 const int        clusterId,
                 const S9sString &statName);
 
+        bool getStatsCached(
+                const int        clusterId,
+                const S9sString &statName,
+                S9sVariantMap   &request);
+
         bool getCpuStats(const int clusterId);
         bool getSqlStats(const int clusterId);
         bool getMemStats(const int clusterId);
@@ -328,6 +338,12 @@ class S9sRpcClient
                 const bool isImportant = true);
 
         bool getLog();
+        
+        bool getLogEntries(
+                const int  limit,
+                const int  offset,
+                const bool ascending);
+
         bool getLogStatistics();
         bool getAlarms();
         bool getAlarm();
@@ -597,8 +613,13 @@ class S9sRpcClient
 
         static S9sString timeStampString();
 
+        S9sString sessionKey() const;
+        bool reuseSession();
+        void rememberSession();
+
     private:
         S9sRpcClientPrivate *m_priv;
+        static S9sVariantMap sm_sessions;
 
         friend class UtS9sRpcClient;
         friend class UtS9sNode;
@@ -10,9 +10,11 @@
 #include <netdb.h>
 #include <unistd.h>
 #include <cerrno>
+#include <ctime>
 
 #include "S9sRegExp"
 #include "S9sOptions"
+#include "S9sStateFile"
 
 //#define DEBUG
 //#define WARNING
@@ -31,7 +33,9 @@ S9sRpcClientPrivate::S9sRpcClientPrivate() :
     m_ssl(0),
     m_callbackFunction(0),
     m_callbackUserData(0),
-    m_authenticated(false)
+    m_authenticated(false),
+    m_sessionReused(false),
+    m_controllerSelected(false)
 {
 }
 
@@ -97,6 +101,7 @@ S9sRpcClientPrivate::connect()
     struct hostent *hp;
     struct timeval timeout;
     struct sockaddr_in server;
+    struct timespec connectStarted, connectFinished;
     bool   success;
 
     PRINT_LOG("%p: Connecting to '%s:%d'.", this, STR(m_hostName), m_port);
@@ -119,8 +124,18 @@ S9sRpcClientPrivate::connect()
         return false;
     }
 
+    /*
+     * The first connect might go to the leader we know from earlier, skipping
+     * the redirect, or to an other controller if this one failed recently.
+     */
+    if (!m_controllerSelected)
+        selectController();
+
     PRINT_VERBOSE("\n+++ Connecting to %s:%d...", STR(m_hostName), m_port);
+    m_socketMutex.lock();
     m_socketFd = socket(AF_INET, SOCK_STREAM, 0);
+    m_socketMutex.unlock();
+
     if (m_socketFd == -1)
     {
         m_errorString.sprintf("Error creating socket: %m");
@@ -150,6 +165,7 @@ S9sRpcClientPrivate::connect()
      */
     success = true;
     hp = gethostbyname(STR(m_hostName));
+    m_stats.phaseFinished("dns");
     if (hp == NULL)
     {
         m_errorString.sprintf("Host '%s' not found.", STR(m_hostName));
@@ -164,6 +180,7 @@ S9sRpcClientPrivate::connect()
         server.sin_family = AF_INET;
         server.sin_port = htons(m_port);
 
+        clock_gettime(CLOCK_MONOTONIC, &connectStarted);
         if (::connect(m_socketFd, (struct sockaddr *) &server, sizeof server)
                 == -1)
         {
@@ -199,7 +216,14 @@ S9sRpcClientPrivate::connect()
             close();
 
             success = false;
+        } else {
+            clock_gettime(CLOCK_MONOTONIC, &connectFinished);
+            setConnectSucceeded(
+                    (connectFinished.tv_sec - connectStarted.tv_sec) * 1000.0 +
+                    (connectFinished.tv_nsec - connectStarted.tv_nsec) / 1e6);
         }
+
+        m_stats.phaseFinished("connect");
     }
        
     /*
@@ -222,6 +246,8 @@ S9sRpcClientPrivate::connect()
      */
     //PRINT_LOG("Connected.");
     PRINT_VERBOSE("Connected.");
+    m_stats.setController(m_hostName, m_port);
+
     if (m_useTls)
     {
         PRINT_VERBOSE ("Initiate TLS...");
@@ -272,6 +298,8 @@ S9sRpcClientPrivate::connect()
             return false;
         }
 
+        m_stats.phaseFinished("tls");
+
         PRINT_VERBOSE("TLS handshake finished (version: %s, cipher: %s).",
             SSL_get_version(m_ssl), SSL_get_cipher(m_ssl));
     }
@@ -279,9 +307,16 @@ S9sRpcClientPrivate::connect()
     return true;
 }
 
+/**
+ * Closes the connection. The socket is set to -1 while the mutex is held and
+ * only then closed, so S9sRpcClient::interrupt() never shuts down a file
+ * descriptor that was closed and reused meanwhile.
+ */
 void
 S9sRpcClientPrivate::close()
 {
+    int socketFd;
+
     if (m_socketFd < 0)
         return;
 
@@ -301,9 +336,13 @@ S9sRpcClientPrivate::close()
         m_sslContext = 0;
     }
 
-    ::shutdown(m_socketFd, SHUT_RDWR);
-    ::close(m_socketFd);
+    m_socketMutex.lock();
+    socketFd   = m_socketFd;
     m_socketFd = -1;
+    m_socketMutex.unlock();
+
+    ::shutdown(socketFd, SHUT_RDWR);
+    ::close(socketFd);
 }
 
 /**
@@ -510,11 +549,7 @@ void
 S9sRpcClientPrivate::rememberRedirect()
 {
     S9sVariantMap  leader;
-    S9sVariantMap  redirect;
-    S9sVariantList redirects;
-    S9sOptions    *options = S9sOptions::instance();
-    S9sString      key = "redirects";
-    bool           found = false;
+    S9sVector<S9sController> servers;
 
     PRINT_LOG("Processing redirect.");
 
@@ -525,78 +560,92 @@ S9sRpcClientPrivate::rememberRedirect()
 
     if (m_reply.contains("controllers"))
     {
-        S9sVariantMap followers = 
+        S9sVariantMap        followers = 
             m_reply["controllers"].toVariantMap();
+        S9sVector<S9sString> keys = followers.keys();
 
-        foreach(const S9sVariant &variant, followers)
-        {
-            m_controllers << variant.toVariantMap();
-        }
+        for (uint idx = 0u; idx < keys.size(); ++idx)
+            m_controllers << followers[keys[idx]].toVariantMap();
     }
 
-    redirect["url"]         = options->controllerUrl();
-    redirect["controllers"] = m_controllers;
+    PRINT_LOG("m_controllers: %s", STR(S9sVariant(m_controllers).toString()));
+
+    /*
+     * The new list of controllers keeps what we know about the health of the
+     * controllers that were already in the list.
+     */
+    if (m_servers.empty())
+        loadRedirect();
 
-    redirects = options->getState(key).toVariantList();
-    for (uint idx = 0u; idx < redirects.size(); ++idx)
+    leader = m_reply["leader_controller"].toVariantMap();
+    for (uint idx = 0u; idx < m_controllers.size(); ++idx)
     {
-        S9sVariantMap tmp = redirects[idx].toVariantMap();
+        S9sController controller = m_controllers[idx].toVariantMap();
+        int           found;
+        
+        found = findServer(controller.hostName(), controller.port());
+        if (found >= 0)
+            controller = m_servers[found];
 
-        if (tmp["url"] != options->controllerUrl())
-            continue;
+        if (!leader.empty())
+        {
+            controller.setLeader(
+                    controller.hostName() == leader["hostname"].toString() &&
+                    controller.port() == leader["port"].toInt());
+        } else if (controller.hostName() == m_hostName && 
+                controller.port() == m_port)
+        {
+            // The one that sent the redirect is not the leader.
+            controller.setLeader(false);
+        }
 
-        redirects[idx] = redirect;
-        found = true;
+        servers << controller;
     }
 
-    if (!found)
-        redirects << redirect;
-
-    // Saving the state file.
-    PRINT_LOG("Setting '%s' in state as: \n%s\n", 
-            STR(key),
-            STR(S9sVariant(redirects).toString()));
-
-    PRINT_LOG("m_controllers: %s", STR(S9sVariant(m_controllers).toString()));
-
-    options->setState(key, redirects);
+    m_servers = servers;
+    saveControllers();
 }
 
+/**
+ * Loads the controllers of the redirect received earlier for the controller
+ * URL. The redirects are read from the redirect file, the "redirects" key of
+ * the state file, that the older versions used, is checked if nothing is found
+ * there.
+ */
 bool
 S9sRpcClientPrivate::loadRedirect()
 {
     S9sOptions    *options = S9sOptions::instance();    
-    S9sVariantList redirects;
-    S9sVariantMap  redirect;
+    S9sStateFile   stateFile(options->userStateFilename());
+    S9sVariantList controllers;
     S9sString      key   = "redirects";
     bool           found = false;
 
     PRINT_LOG("Loading controllers from state file for %s.",
             STR(options->controllerUrl()));
 
-    redirects = options->getState(key).toVariantList();
-    if (!redirects.empty())
+    found = stateFile.loadRedirect(options->controllerUrl(), controllers);
+    if (!found)
     {
-        PRINT_LOG("redirects: %s", STR(options->getState(key).toString()));
-    }
+        S9sVariantList redirects = options->getState(key).toVariantList();
 
-    for (uint idx = 0u; idx < redirects.size(); ++idx)
-    {
-        S9sVariantMap tmp = redirects[idx].toVariantMap();
+        for (uint idx = 0u; idx < redirects.size(); ++idx)
+        {
+            S9sVariantMap tmp = redirects[idx].toVariantMap();
 
-        PRINT_LOG("tmp: %s", STR(tmp.toString()));
-        if (tmp["url"] != options->controllerUrl())
-            continue;
+            if (tmp["url"] != options->controllerUrl())
+                continue;
 
-        redirect = redirects[idx].toVariantMap();
-        found = true;
+            controllers = tmp["controllers"].toVariantList();
+            found = true;
+        }
     }
    
     m_servers.clear();
     if (found)
     {
-        PRINT_LOG("Loaded redirect: %s", STR(redirect.toString()));
-        S9sVariantList controllers = redirect["controllers"].toVariantList();
+        PRINT_LOG("Loaded redirect: %s", 
+                STR(S9sVariant(controllers).toString()));
 
         for (uint idx = 0u; idx < controllers.size(); ++idx)
         {
@@ -643,34 +692,220 @@ S9sRpcClientPrivate::setConnectFailed(
         }
     
         PRINT_LOG("-----------------------------------");
+
+        // The other s9s processes should not try this one for a while.
+        if (findServer(hostName, port) >= 0)
+            saveControllers();
     }
 }
 
+/**
+ * \param rtt The time the connect took in milliseconds.
+ *
+ * Registers a successful connect to the current controller. The redirect file
+ * is only written if the controller recovered from a failure or the round trip
+ * time changed a lot (see S9sController::isRttChanged()), so the successful
+ * connects usually write nothing.
+ */
+void
+S9sRpcClientPrivate::setConnectSucceeded(
+        const double rtt)
+{
+    int  idx = findServer(m_hostName, m_port);
+    bool changed;
+
+    if (idx < 0)
+        return;
+
+    S9sController &controller = m_servers[idx];
+
+    changed = controller.nFailures() > 0 || controller.isRttChanged(rtt);
+
+    controller.setConnectSucceeded(rtt);
+    PRINT_LOG("Connect to %s:%d took %.3fms.", STR(m_hostName), m_port, rtt);
+
+    if (changed)
+        saveControllers();
+}
+
+/**
+ * Registers that the given controller replied without redirecting us, so it is
+ * the leader. The next s9s processes will connect to it directly.
+ */
+void
+S9sRpcClientPrivate::setLeader(
+        const S9sString  &hostName, 
+        const int         port)
+{
+    int idx = findServer(hostName, port);
+
+    if (idx < 0 || m_servers[idx].isLeader())
+        return;
+
+    PRINT_LOG("Controller %s:%d is the leader.", STR(hostName), port);
+    for (uint idx1 = 0u; idx1 < m_servers.size(); ++idx1)
+        m_servers[idx1].setLeader((int) idx1 == idx);
+
+    saveControllers();
+}
+
+/**
+ * \returns true if an other controller was selected.
+ *
+ * Selects the controller for the first connect: the leader that we know from
+ * the earlier runs if it did not fail recently, otherwise an other controller if
+ * the current one is in the back off period of its failures.
+ */
 bool
-S9sRpcClientPrivate::tryNextHost()
+S9sRpcClientPrivate::selectController()
 {
+    time_t now = time(NULL);
+    int    current;
+
+    m_controllerSelected = true;
+
     if (m_servers.empty())
         loadRedirect();
 
     for (uint idx = 0u; idx < m_servers.size(); ++idx)
     {
-        S9sController &controller = m_servers[idx];
+        const S9sController &controller = m_servers[idx];
+
+        if (!controller.isLeader() || !controller.isAvailable(now))
+            continue;
 
-        if (!controller.connectFailed())
+        if (controller.hostName() != m_hostName || 
+                controller.port() != m_port)
         {
+            PRINT_LOG("Connecting to the leader %s:%d directly.",
+                    STR(controller.hostName()), controller.port());
+
             m_hostName = controller.hostName();
             m_port     = controller.port();
-
-            PRINT_LOG("Next controller to try %s:%d.",
-                    STR(m_hostName), m_port);
             return true;
         }
+
+        return false;
+    }
+
+    current = findServer(m_hostName, m_port);
+    if (current >= 0 && !m_servers[current].isAvailable(now))
+    {
+        PRINT_LOG("Controller %s:%d failed recently.", STR(m_hostName), m_port);
+        return tryNextHost();
+    }
+
+    return false;
+}
+
+/*
+ * \returns true if the first controller should be tried before the second: the
+ *   leader first, then the one with the shorter round trip time.
+ */
+static bool
+isBetterController(
+        const S9sController &first,
+        const S9sController &second)
+{
+    if (first.isLeader() != second.isLeader())
+        return first.isLeader();
+
+    if (first.rtt() > 0.0 && second.rtt() > 0.0)
+        return first.rtt() < second.rtt();
+
+    return first.rtt() > 0.0 && second.rtt() <= 0.0;
+}
+
+/**
+ * \returns true if there is an other controller to try.
+ *
+ * Selects the next controller to connect: the ones that were not tried in this
+ * process and are not in the back off period of their earlier failures are
+ * preferred, the leader first and then the faster ones. If all of them failed
+ * recently the one with the back off ending first is tried.
+ */
+bool
+S9sRpcClientPrivate::tryNextHost()
+{
+    time_t now  = time(NULL);
+    int    best = -1;
+
+    if (m_servers.empty())
+        loadRedirect();
+
+    for (uint idx = 0u; idx < m_servers.size(); ++idx)
+    {
+        const S9sController &controller = m_servers[idx];
+
+        if (!controller.isAvailable(now))
+            continue;
+
+        if (best < 0 || isBetterController(controller, m_servers[best]))
+            best = idx;
+    }
+
+    for (uint idx = 0u; best < 0 && idx < m_servers.size(); ++idx)
+    {
+        const S9sController &controller = m_servers[idx];
+
+        if (controller.connectFailed())
+            continue;
+
+        if (best < 0 || controller.retryAfter() < m_servers[best].retryAfter())
+            best = idx;
+    }
+
+    if (best >= 0)
+    {
+        m_hostName = m_servers[best].hostName();
+        m_port     = m_servers[best].port();
+
+        PRINT_LOG("Next controller to try %s:%d.", STR(m_hostName), m_port);
+        return true;
     }
 
     PRINT_LOG("No other controller to try.");
     return false;
 }
 
+/**
+ * \returns The index of the controller in m_servers, -1 if it is not found.
+ */
+int
+S9sRpcClientPrivate::findServer(
+        const S9sString  &hostName, 
+        const int         port) const
+{
+    for (uint idx = 0u; idx < m_servers.size(); ++idx)
+    {
+        if (m_servers[idx].hostName() == hostName && 
+                m_servers[idx].port() == port)
+        {
+            return idx;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Saves the controllers with their health into the redirect file, so the other
+ * s9s processes can use them.
+ */
+void
+S9sRpcClientPrivate::saveControllers()
+{
+    S9sOptions    *options = S9sOptions::instance();
+    S9sStateFile   stateFile(options->userStateFilename());
+    S9sVariantList controllers;
+
+    for (uint idx = 0u; idx < m_servers.size(); ++idx)
+        controllers << m_servers[idx].toVariantMap();
+
+    if (!stateFile.saveRedirect(options->controllerUrl(), controllers))
+        PRINT_LOG("ERROR: %s", STR(stateFile.errorString()));
+}
+
 /**
  * \param title Just a string to be printed.
  *
@@ -10,6 +10,8 @@
 #include "S9sRpcReply"
 #include "S9sVariantMap"
 #include "S9sController"
+#include "S9sRpcStats"
+#include "S9sMutex"
 #include "s9srpcclient.h"
 
 class S9sRpcClientPrivate
@@ -29,6 +31,10 @@ class S9sRpcClientPrivate
                 const int         port);
 
         bool tryNextHost();
+        bool selectController();
+
+        void setConnectSucceeded(const double rtt);
+        void setLeader(const S9sString &hostName, const int port);
 
         void printBuffer(const S9sString &title);
 
@@ -51,10 +57,16 @@ class S9sRpcClientPrivate
         S9sString cookieHeaders() const;
         S9sString serverVersionString() const;
 
+        int findServer(const S9sString &hostName, const int port) const;
+        void saveControllers();
+
     private:
         int             m_referenceCounter;
         ulonglong       m_requestId;
+        /** The socket, written under m_socketMutex. */
         int             m_socketFd;
+        /** Protects the socket while an other thread interrupts the client. */
+        S9sMutex        m_socketMutex;
         S9sString       m_hostName;
         int             m_port;
         S9sString       m_path;
@@ -73,9 +85,13 @@ class S9sRpcClientPrivate
         S9sJSonHandler  m_callbackFunction;
         void           *m_callbackUserData;
         bool            m_authenticated;
+        bool            m_sessionReused;
         
         S9sVariantList  m_controllers;
         S9sVector<S9sController> m_servers;
+        bool            m_controllerSelected;
+        S9sRpcStats     m_stats;
         friend class S9sRpcClient;
+        friend class UtS9sRpcClient;
 };
 
@@ -45,7 +45,11 @@
 #include "S9sContainer"
 #include "S9sStringList"
 #include "S9sReplication"
+#include "S9sStatFrame"
+#include "S9sReplicationTopology"
 #include "S9sSqlProcess"
+#include "S9sSortKeys"
+#include "S9sRowRenderer"
 
 //#define DEBUG
 //#define WARNING
@@ -546,11 +550,7 @@ S9sRpcReply::printSqlProcessesLong()
         {
             int remaining  = terminalWidth - nColumns;
             
-            if (remaining < (int) query.length())
-            {
-                query.resize(remaining - 1);
-                query += "…";
-            }
+            query.ellipsize(remaining);
         }
 
         if (!options->isStringMatchExtraArguments(query))
@@ -777,8 +777,8 @@ S9sRpcReply::printReplicationListLong()
     S9sFormatter    formatter;
     S9sNode         slaveFilter(options->slave().toVariantMap());
     S9sNode         masterFilter(options->master().toVariantMap());
-    S9sVariantList  clusterList = clusters();
-    int             nLines = 0;
+    S9sReplicationTopology topology;
+    S9sVector<uint> links;
     S9sFormat       clusterIdFormat;
     S9sFormat       slaveNameFormat;
     S9sFormat       masterNameFormat;
@@ -786,50 +786,35 @@ S9sRpcReply::printReplicationListLong()
     S9sFormat       masterClusterFormat;
     S9sFormat       lagFormat;
 
+    topology.build(clusters());
+
     // Going through once, collecting some information.
-    for (uint idx = 0; idx < clusterList.size(); ++idx)
+    for (uint idx = 0u; idx < topology.nLinks(); ++idx)
     {
-        S9sVariantMap  clusterMap  = clusterList[idx].toVariantMap();
-        S9sCluster     cluster     = clusterMap;
-        S9sVector<S9sNode> nodes = cluster.nodes();
-        int            clusterId   = cluster.clusterId();
-        
-        for (uint idx1 = 0u; idx1 < nodes.size(); ++idx1)
-        {
-            const S9sNode &node = nodes[idx1];
-            S9sReplication replication(cluster, node);
-            S9sString      masterName, slaveName;
-            S9sString      masterCluster;
-            int            lag = replication.secondsBehindMaster();
-
-            if (!replication.isValid())
-                continue;
-       
-            if (!replication.matchSlave(slaveFilter))
-                continue;
-            
-            if (!replication.matchMaster(masterFilter))
-                continue;
+        S9sReplication replication = topology.link(idx);
+        S9sString      masterCluster;
 
-            if (node.hasMasterClusterId())
-                masterCluster.sprintf("%d", node.masterClusterId());
-            else
-                masterCluster.sprintf("%s", "?");
+        if (!replication.matchSlave(slaveFilter))
+            continue;
+        
+        if (!replication.matchMaster(masterFilter))
+            continue;
 
-            masterName = replication.masterName();
-            slaveName = replication.slaveName();
+        if (replication.hasMasterClusterId())
+            masterCluster.sprintf("%d", replication.masterClusterId());
+        else
+            masterCluster.sprintf("%s", "-");
 
-            clusterIdFormat.widen(clusterId);
-            slaveNameFormat.widen(slaveName);
-            masterNameFormat.widen(masterName);
-            linkStatusFormat.widen(replication.slaveStatusShort());
-            masterClusterFormat.widen(masterCluster);
-            lagFormat.widen(lag);
-            ++nLines;
-        }
+        clusterIdFormat.widen(replication.clusterId());
+        slaveNameFormat.widen(replication.slaveName());
+        masterNameFormat.widen(replication.masterName());
+        linkStatusFormat.widen(replication.slaveStatusShort());
+        masterClusterFormat.widen(masterCluster);
+        lagFormat.widen(replication.secondsBehindMaster());
+        links << idx;
     }
 
-    if (nLines == 0)
+    if (links.empty())
         return;
 
     /*
@@ -848,57 +833,32 @@ S9sRpcReply::printReplicationListLong()
         printf("\n");
     }
     
-    
-    for (uint idx = 0; idx < clusterList.size(); ++idx)
+    for (uint idx = 0u; idx < links.size(); ++idx)
     {
-        S9sVariantMap  clusterMap  = clusterList[idx].toVariantMap();
-        S9sCluster     cluster     = clusterMap;
-        S9sVector<S9sNode> nodes = cluster.nodes();
-        int            clusterId   = cluster.clusterId();
-
-        for (uint idx1 = 0u; idx1 < nodes.size(); ++idx1)
-        {
-            const S9sNode &node           = nodes[idx1];
-            S9sReplication replication(cluster, node);
-            S9sString      masterName, slaveName;
-            S9sString      masterCluster;
-            S9sString      status = replication.slaveStatusShort();
-            int            lag = replication.secondsBehindMaster();
+        const S9sReplication &replication = topology.link(links[idx]);
+        S9sString             masterCluster;
+        S9sString             status = replication.slaveStatusShort();
 
-            if (!replication.isValid())
-                continue;
-
-            if (!replication.matchSlave(slaveFilter))
-                continue;
-            
-            if (!replication.matchMaster(masterFilter))
-                continue;
+        if (replication.hasMasterClusterId())
+            masterCluster.sprintf("%d", replication.masterClusterId());
+        else
+            masterCluster.sprintf("%s", "-");
         
-            if (node.hasMasterClusterId())
-                masterCluster.sprintf("%d", node.masterClusterId());
-            else
-                masterCluster.sprintf("%s", "-");
-            
-            masterName = replication.masterName();
-            slaveName = replication.slaveName();
+        clusterIdFormat.printf(replication.clusterId());
+        slaveNameFormat.printf(replication.slaveName());
+        masterNameFormat.printf(replication.masterName());
 
-            clusterIdFormat.printf(clusterId);
-            slaveNameFormat.printf(slaveName);
-            masterNameFormat.printf(masterName);
+        ::printf("%s", formatter.hostStateColorBegin(status));
+        linkStatusFormat.printf(status);
+        ::printf("%s", formatter.hostStateColorEnd());
 
-            ::printf("%s", formatter.hostStateColorBegin(status));
-            linkStatusFormat.printf(status);
-            ::printf("%s", formatter.hostStateColorEnd());
-
-
-            masterClusterFormat.printf(masterCluster);
-            lagFormat.printf(lag);
-            ::printf("\n");
-        }
-    }    
+        masterClusterFormat.printf(masterCluster);
+        lagFormat.printf(replication.secondsBehindMaster());
+        ::printf("\n");
+    }
     
     if (!options->isBatchRequested())
-        printf("Total: %d replication link(s)\n", nLines); 
+        printf("Total: %d replication link(s)\n", (int) links.size()); 
 }
 
 void
@@ -910,32 +870,143 @@ S9sRpcReply::printReplicationListCustom()
 
     S9sNode         slaveFilter(options->slave().toVariantMap());
     S9sNode         masterFilter(options->master().toVariantMap());
-    S9sVariantList  clusterList = clusters();
+    S9sReplicationTopology topology;
+
+    topology.build(clusters());
     
-    for (uint idx = 0; idx < clusterList.size(); ++idx)
+    for (uint idx = 0u; idx < topology.nLinks(); ++idx)
     {
-        S9sVariantMap  clusterMap  = clusterList[idx].toVariantMap();
-        S9sCluster     cluster     = clusterMap;
-        S9sVector<S9sNode> nodes = cluster.nodes();
-        
-        for (uint idx1 = 0u; idx1 < nodes.size(); ++idx1)
-        {
-            const S9sNode &node = nodes[idx1];
-            S9sReplication replication(cluster, node);
+        S9sReplication replication = topology.link(idx);
             
-            if (!replication.isValid())
-                continue;
-       
-            if (!replication.matchSlave(slaveFilter))
-                continue;
+        if (!replication.matchSlave(slaveFilter))
+            continue;
+        
+        if (!replication.matchMaster(masterFilter))
+            continue;
+
+        ::printf("%s", 
+                STR(replication.toString(syntaxHighlight, formatString)));
+    }
+}
+
+/**
+ * \param topology The replication topology that was built from the replies
+ *   received so far, it holds the lag history of the links.
+ *
+ * Prints the replication links with the lag trend, this is the view of the
+ * "s9s replication --watch" command.
+ */
+void
+S9sRpcReply::printReplicationLagList(
+        const S9sReplicationTopology &topology)
+{
+    S9sOptions     *options = S9sOptions::instance();
+    S9sFormatter    formatter;
+    S9sNode         slaveFilter(options->slave().toVariantMap());
+    S9sNode         masterFilter(options->master().toVariantMap());
+    S9sVector<uint> links;
+    S9sFormat       slaveNameFormat;
+    S9sFormat       masterNameFormat;
+    S9sFormat       linkStatusFormat;
+    S9sFormat       lagFormat;
+    S9sFormat       minFormat;
+    S9sFormat       maxFormat;
+
+    for (uint idx = 0u; idx < topology.nLinks(); ++idx)
+    {
+        S9sReplication replication = topology.link(idx);
+        S9sVector<int> history     = topology.lagHistory(idx);
             
-            if (!replication.matchMaster(masterFilter))
-                continue;
+        if (!replication.matchSlave(slaveFilter))
+            continue;
+        
+        if (!replication.matchMaster(masterFilter))
+            continue;
 
-            ::printf("%s", 
-                    STR(replication.toString(syntaxHighlight, formatString)));
-        }
+        slaveNameFormat.widen(replication.slaveName());
+        masterNameFormat.widen(replication.masterName());
+        linkStatusFormat.widen(replication.slaveStatusShort());
+        lagFormat.widen(replication.secondsBehindMaster());
+        minFormat.widen(*std::min_element(history.begin(), history.end()));
+        maxFormat.widen(*std::max_element(history.begin(), history.end()));
+        links << idx;
+    }
+
+    if (!options->isNoHeaderRequested())
+    {
+        printf("%s", headerColorBegin());
+        slaveNameFormat.printHeader("SLAVE");
+        masterNameFormat.printHeader("MASTER");
+        linkStatusFormat.printHeader("STATUS");
+        lagFormat.printHeader("LAG"); 
+        minFormat.printHeader("MIN"); 
+        maxFormat.printHeader("MAX"); 
+        printf("TREND");
+        printf("%s", headerColorEnd());
+        printf("\n");
+    }
+    
+    for (uint idx = 0u; idx < links.size(); ++idx)
+    {
+        const S9sReplication &replication = topology.link(links[idx]);
+        S9sVector<int>        history = topology.lagHistory(links[idx]);
+        S9sString             status = replication.slaveStatusShort();
+        
+        slaveNameFormat.printf(replication.slaveName());
+        masterNameFormat.printf(replication.masterName());
+
+        ::printf("%s", formatter.hostStateColorBegin(status));
+        linkStatusFormat.printf(status);
+        ::printf("%s", formatter.hostStateColorEnd());
+
+        lagFormat.printf(replication.secondsBehindMaster());
+        minFormat.printf(*std::min_element(history.begin(), history.end()));
+        maxFormat.printf(*std::max_element(history.begin(), history.end()));
+        ::printf("%s", STR(lagTrend(history)));
+
+        if (topology.isInCycle(replication.slaveName()))
+            ::printf(" (circular)");
+
+        ::printf("\n");
+    }
+    
+    if (!options->isBatchRequested())
+        printf("Total: %d replication link(s)\n", (int) links.size()); 
+}
+
+/**
+ * \returns A one line chart of the lag samples scaled to the largest sample.
+ */
+S9sString
+S9sRpcReply::lagTrend(
+        const S9sVector<int> &samples)
+{
+    static const char *asciiLevels[] = 
+        { "_", ".", ",", "-", "~", "=", "*", "#" };
+    static const char *utf8Levels[] = 
+        { "▁", "▂", "▃", "▄", "▅", "▆", "▇", "█" };
+    S9sOptions  *options = S9sOptions::instance();
+    const char **levels  = options->onlyAscii() ? asciiLevels : utf8Levels;
+    S9sString    retval;
+    int          max = 0;
+
+    for (uint idx = 0u; idx < samples.size(); ++idx)
+    {
+        if (samples[idx] > max)
+            max = samples[idx];
+    }
+
+    for (uint idx = 0u; idx < samples.size(); ++idx)
+    {
+        int level = max > 0 ? samples[idx] * 7 / max : 0;
+
+        if (level < 0)
+            level = 0;
+
+        retval += levels[level];
     }
+
+    return retval;
 }
 
 void
@@ -1637,26 +1708,30 @@ S9sRpcReply::printClusterPing(
     printf("\n");
 }
 
-bool 
-compareProcessByCpuUsage(
-        const S9sVariant &a,
-        const S9sVariant &b)
+/**
+ * \param processList The list of processes to sort.
+ * \param sortKeys The sort keys of the processes.
+ * \param nFirst The number of processes to sort or 0 to sort all.
+ *
+ * Sorts the processes by the given sort keys in descending order (the biggest
+ * CPU or memory usage first). If only the first few processes are printed the
+ * rest of the list is left unsorted.
+ */
+static void
+sortProcessList(
+        S9sVariantList       &processList,
+        S9sSortKeys<double>  &sortKeys,
+        const int             nFirst)
 {
-    S9sVariantMap aMap = a.toVariantMap();
-    S9sVariantMap bMap = b.toVariantMap();
+    S9sVariantList sorted;
 
-    return aMap["cpu_usage"].toDouble() > bMap["cpu_usage"].toDouble();
-}
+    sortKeys.sort(true, nFirst > 0 ? nFirst : 0);
 
-bool 
-compareProcessByMemoryUsage(
-        const S9sVariant &a,
-        const S9sVariant &b)
-{
-    S9sVariantMap aMap = a.toVariantMap();
-    S9sVariantMap bMap = b.toVariantMap();
+    sorted.reserve(processList.size());
+    for (uint idx = 0u; idx < sortKeys.size(); ++idx)
+        sorted << processList[sortKeys.index(idx)];
 
-    return aMap["res_mem"].toULongLong() > bMap["res_mem"].toULongLong();
+    processList = sorted;
 }
 
 void
@@ -1701,13 +1776,16 @@ S9sRpcReply::printProcessListLong(
     S9sFormat       priorityFormat;
     S9sFormat       virtFormat;
     S9sFormat       resFormat;
+    bool            sortByMemory = options->getBool("sort_by_memory");
+    S9sSortKeys<double> sortKeys;
     int             nItems   = 0;
     int             nTotal   = 0;
     int             nRunning = 0;
     int             nHosts   = 0;
 
     /*
-     * Go through the data and collect information.
+     * Go through the data and collect information. The sort keys are
+     * collected here so the sorting does not need to access the maps.
      */
     for (uint idx = 0u; idx < hostList.size(); ++idx)
     {
@@ -1723,6 +1801,17 @@ S9sRpcReply::printProcessListLong(
             ++nTotal;
             if (process["state"].toString() == "R")
                 nRunning++;
+            
+            if (!options->isStringMatchExtraArguments(
+                        process["executable"].toString()))
+            {
+                continue;
+            }
+
+            if (sortByMemory)
+                sortKeys.add(process["res_mem"].toDouble(), processList.size());
+            else
+                sortKeys.add(process["cpu_usage"].toDouble(), processList.size());
 
             processList << process;
         }
@@ -1730,18 +1819,10 @@ S9sRpcReply::printProcessListLong(
         nHosts++;
     }
     
-    /**
-     * Sorting...
+    /*
+     * Sorting, only the processes we are going to print.
      */
-    if (options->getBool("sort_by_memory"))
-    {
-        sort(processList.begin(), processList.end(), 
-                compareProcessByMemoryUsage);
-
-    } else {
-        sort(processList.begin(), processList.end(), 
-                compareProcessByCpuUsage);
-    }
+    sortProcessList(processList, sortKeys, nItemsLimit);
 
     /*
      * Again, now collecting format information.
@@ -1755,13 +1836,9 @@ S9sRpcReply::printProcessListLong(
         int           priority   = process["priority"].toInt();
         ulonglong     rss        = process["res_mem"].toULongLong();
         ulonglong     virtMem    = process["virt_mem"].toULongLong();
-        S9sString     executable = process["executable"].toString();
 
         if (maxLines > 0 && (int) idx >= maxLines)
             break;
-        
-        if (!options->isStringMatchExtraArguments(executable))
-            continue;
 
         pidFormat.widen(pid);
         userFormat.widen(user);
@@ -1824,10 +1901,6 @@ S9sRpcReply::printProcessListLong(
         rss     /= 1024;
         virtMem /= 1024;
 
-        if (!options->isStringMatchExtraArguments(executable))
-            continue;
-
-
         pidFormat.printf(pid);
 
         printf("%s", userColorBegin());        
@@ -1885,6 +1958,7 @@ S9sRpcReply::printProcessListTop(
     S9sFormat       userFormat;
     S9sFormat       pidFormat;
     S9sFormat       priorityFormat;
+    S9sSortKeys<double> sortKeys;
 
     /*
      * Go through the data and collect information.
@@ -1899,11 +1973,12 @@ S9sRpcReply::printProcessListTop(
             S9sVariantMap process = processes[idx1].toVariantMap();
 
             process["hostname"] = hostName;
+            sortKeys.add(process["cpu_usage"].toDouble(), processList.size());
             processList << process;
         }
     }
     
-    sort(processList.begin(), processList.end(), compareProcessByCpuUsage);
+    sortProcessList(processList, sortKeys, maxLines);
 
     /*
      * Again, now collecting format information.
@@ -2861,21 +2936,29 @@ S9sRpcReply::printExtendedConfigLong()
     }
 }
 
+/**
+ * \param ascending true if the log entries in the reply are sorted from the
+ *   oldest to the newest, false if they are in reverse order.
+ *
+ * Prints the log entries from the oldest to the newest.
+ */
 void 
-S9sRpcReply::printLogList()
+S9sRpcReply::printLogList(
+        bool ascending)
 {
     S9sOptions *options = S9sOptions::instance();
 
     if (options->isJsonRequested())
         printJsonFormat();
     else if (options->isLongRequested())
-        printLogLong();
+        printLogLong(ascending);
     else 
-        printLogBrief();
+        printLogBrief(ascending);
 }
 
 void
-S9sRpcReply::printLogBrief()
+S9sRpcReply::printLogBrief(
+        bool ascending)
 {
     S9sOptions     *options = S9sOptions::instance();
     bool            syntaxHighlight = options->useSyntaxHighlight();
@@ -2885,7 +2968,8 @@ S9sRpcReply::printLogBrief()
     if (variantList.empty() && contains("log_entry"))
         variantList << operator[]("log_entry").toVariantMap();
 
-    std::reverse(variantList.begin(), variantList.end());
+    if (!ascending)
+        std::reverse(variantList.begin(), variantList.end());
 
     for (uint idx = 0; idx < variantList.size(); ++idx)
     {
@@ -2905,7 +2989,8 @@ S9sRpcReply::printLogBrief()
 }
 
 void
-S9sRpcReply::printLogLong()
+S9sRpcReply::printLogLong(
+        bool ascending)
 {
     S9sOptions     *options = S9sOptions::instance();
     bool            syntaxHighlight = options->useSyntaxHighlight();
@@ -2926,7 +3011,8 @@ S9sRpcReply::printLogLong()
         theList << message;
     }
     
-    std::reverse(theList.begin(), theList.end());
+    if (!ascending)
+        std::reverse(theList.begin(), theList.end());
 
     // FIXME:
     // The implementation of the long format is just a formatstring, the same
@@ -3773,11 +3859,7 @@ S9sRpcReply::printClusterListLong()
         {
             int remaining  = terminalWidth - nColumns;
             
-            if (remaining < (int) statusText.length())
-            {
-                statusText.resize(remaining - 1);
-                statusText += "…";
-            }
+            statusText.ellipsize(remaining);
         }
         
         if (syntaxHighlight)
@@ -4999,7 +5081,7 @@ S9sRpcReply::printTemplates()
 {
     S9sOptions     *options = S9sOptions::instance();
     bool            syntaxHighlight = options->useSyntaxHighlight();
-    S9sVariantList  theList = operator[]("servers").toVariantList();
+    const S9sVariantList &theList = operator[]("servers").toVariantList();
     S9sFormat       cloudFormat;
     S9sFormat       regionFormat;
     S9sFormat       cpuFormat, memoryFormat;
@@ -5019,8 +5101,7 @@ S9sRpcReply::printTemplates()
 
     for (uint idx = 0; idx < theList.size(); ++idx)
     {
-        S9sVariantMap  theMap   = theList[idx].toVariantMap();
-        S9sServer      server   = theMap;
+        S9sServer      server   = theList[idx].toVariantMap();
         S9sString      hostName = server.hostName();
         int            nTemplates = server.nTemplates();
 
@@ -5074,8 +5155,7 @@ S9sRpcReply::printTemplates()
     
     for (uint idx = 0; idx < theList.size(); ++idx)
     {
-        S9sVariantMap  theMap   = theList[idx].toVariantMap();
-        S9sServer      server   = theMap;
+        S9sServer      server   = theList[idx].toVariantMap();
         S9sString      hostName = server.hostName();
         int            nTemplates = server.nTemplates();
 
@@ -5129,7 +5209,7 @@ S9sRpcReply::printSubnets()
 {
     S9sOptions     *options = S9sOptions::instance();
     bool            syntaxHighlight = options->useSyntaxHighlight();
-    S9sVariantList  theList = operator[]("servers").toVariantList();
+    const S9sVariantList &theList = operator[]("servers").toVariantList();
     S9sFormat       cloudFormat;
     S9sFormat       regionFormat;
     S9sFormat       hostNameFormat;
@@ -5153,8 +5233,7 @@ S9sRpcReply::printSubnets()
 
         for (uint idx = 0; idx < theList.size(); ++idx)
         {
-            S9sVariantMap  theMap   = theList[idx].toVariantMap();
-            S9sServer      server   = theMap;
+            S9sServer      server   = theList[idx].toVariantMap();
             S9sString      hostName = server.hostName();
             int            nSubnets = server.nSubnets();
 
@@ -5181,8 +5260,7 @@ S9sRpcReply::printSubnets()
      */
     for (uint idx = 0; idx < theList.size(); ++idx)
     {
-        S9sVariantMap  theMap   = theList[idx].toVariantMap();
-        S9sServer      server   = theMap;
+        S9sServer      server   = theList[idx].toVariantMap();
         S9sString      hostName = server.hostName();
         int            nSubnets = server.nSubnets();
 
@@ -5224,8 +5302,7 @@ S9sRpcReply::printSubnets()
     
     for (uint idx = 0; idx < theList.size(); ++idx)
     {
-        S9sVariantMap  theMap   = theList[idx].toVariantMap();
-        S9sServer      server   = theMap;
+        S9sServer      server   = theList[idx].toVariantMap();
         S9sString      hostName = server.hostName();
         int            nSubnets = server.nSubnets();
 
@@ -5269,7 +5346,7 @@ S9sRpcReply::printRegions()
 {
     S9sOptions     *options = S9sOptions::instance();
     bool            syntaxHighlight = options->useSyntaxHighlight();
-    S9sVariantList  theList = operator[]("servers").toVariantList();
+    const S9sVariantList &theList = operator[]("servers").toVariantList();
     S9sFormat       hasCredentialsFormat;
     S9sFormat       providerFormat;
     S9sFormat       hostNameFormat;
@@ -5290,16 +5367,16 @@ S9sRpcReply::printRegions()
      */
     for (uint idx = 0; idx < theList.size(); ++idx)
     {
-        S9sServer      server   = theList[idx].toVariantMap();
-        S9sVariantList regions  = server.regions();
-        S9sString      hostName = server.hostName();
+        S9sServer             server   = theList[idx].toVariantMap();
+        const S9sVariantList &regions  = server.regions();
+        S9sString             hostName = server.hostName();
 
         for (uint idx1 = 0u; idx1 < regions.size(); ++idx1)
         {
-            S9sVariantMap regionMap = regions[idx1].toVariantMap();
-            S9sString     name = regionMap["name"].toString();
-            S9sString     provider = regionMap["provider"].toString();
-            S9sString     hasCredentials;
+            const S9sVariantMap &regionMap = regions[idx1].toVariantMap();
+            S9sString name = regionMap.valueByPath("name").toString();
+            S9sString provider = regionMap.valueByPath("provider").toString();
+            S9sString hasCredentials;
 
             // Statistics.
             ++nRegions;
@@ -5316,7 +5393,7 @@ S9sRpcReply::printRegions()
             }
         
             hasCredentials = 
-                regionMap["has_credentials"].toBoolean() ? "Y" : "N";
+                regionMap.valueByPath("has_credentials").toBoolean() ? "Y" : "N";
         
             hasCredentialsFormat.widen(hasCredentials);
             providerFormat.widen(provider);
@@ -5342,16 +5419,16 @@ S9sRpcReply::printRegions()
      */
     for (uint idx = 0; idx < theList.size(); ++idx)
     {
-        S9sServer      server   = theList[idx].toVariantMap();
-        S9sVariantList regions  = server.regions();
-        S9sString      hostName = server.hostName();
+        S9sServer             server   = theList[idx].toVariantMap();
+        const S9sVariantList &regions  = server.regions();
+        S9sString             hostName = server.hostName();
 
         for (uint idx1 = 0u; idx1 < regions.size(); ++idx1)
         {
-            S9sVariantMap regionMap = regions[idx1].toVariantMap();
-            S9sString     name = regionMap["name"].toString();
-            S9sString     provider = regionMap["provider"].toString();
-            S9sString     hasCredentials;
+            const S9sVariantMap &regionMap = regions[idx1].toVariantMap();
+            S9sString name = regionMap.valueByPath("name").toString();
+            S9sString provider = regionMap.valueByPath("provider").toString();
+            S9sString hasCredentials;
 
             // Filtering.
             if (!options->isStringMatchExtraArguments(name))
@@ -5364,7 +5441,7 @@ S9sRpcReply::printRegions()
             }
 
             hasCredentials = 
-                regionMap["has_credentials"].toBoolean() ? "Y" : "N";
+                regionMap.valueByPath("has_credentials").toBoolean() ? "Y" : "N";
 
             hostNameFormat.setColor(
                     server.colorBegin(syntaxHighlight),
@@ -5372,7 +5449,7 @@ S9sRpcReply::printRegions()
            
             if (syntaxHighlight)
             {
-                if (regionMap["has_credentials"].toBoolean())
+                if (regionMap.valueByPath("has_credentials").toBoolean())
                 {
                     nameFormat.setColor(XTERM_COLOR_REGION_OK, TERM_NORMAL);
                 } else {
@@ -6355,6 +6432,152 @@ S9sRpcReply::printContainers()
         printContainersBrief();
 }
 
+/*
+ * The columns of the container list.
+ */
+enum ContainerListColumn
+{
+    ContainerTypeColumn,
+    ContainerTemplateColumn,
+    ContainerUserColumn,
+    ContainerGroupColumn,
+    ContainerIpColumn,
+    ContainerParentColumn,
+    NContainerListColumns
+};
+
+/*
+ * What the row functions of the container list need to know.
+ */
+struct ContainerListContext
+{
+    S9sOptions       *options;
+    S9sString         subnetId;
+    S9sString         vpcId;
+    S9sString         cloudName;
+    S9s::AddressType  addressType;
+    bool              truncate;
+    int               terminalWidth;
+    int               nColumns;
+};
+
+/**
+ * \returns True if the container should be printed in the container list.
+ */
+static bool
+isContainerListed(
+        const ContainerListContext &context,
+        const S9sContainer         &container)
+{
+    if (!context.options->isStringMatchExtraArguments(container.name()))
+        return false;
+
+    if (!context.cloudName.empty() && 
+            container.provider() != context.cloudName)
+    {
+        return false;
+    }
+        
+    if (!context.subnetId.empty() && container.subnetId() != context.subnetId)
+        return false;
+        
+    if (!context.vpcId.empty() && context.vpcId != container.subnetVpcId())
+        return false;
+
+    return true;
+}
+
+/**
+ * The row function of printContainersLong() that measures one container.
+ */
+static void
+widenContainerRow(
+        void                 *userData,
+        const S9sVariant     &row,
+        S9sVector<S9sFormat> &columns)
+{
+    ContainerListContext *context = (ContainerListContext *) userData;
+    const S9sVariantMap  &theMap  = row.toVariantMap();
+    S9sContainer          container(theMap);
+    S9sString             ip      = 
+        container.ipAddress(context->addressType, "-");
+
+    if (!isContainerListed(*context, container))
+        return;
+
+    if (ip.empty())
+        ip = "-";
+
+    columns[ContainerUserColumn].widen(
+            theMap.valueByPath("owner_user_name").toString());
+    columns[ContainerGroupColumn].widen(
+            theMap.valueByPath("owner_group_name").toString());
+    columns[ContainerIpColumn].widen(ip);
+    columns[ContainerParentColumn].widen(
+            theMap.valueByPath("parent_server").toString());
+    columns[ContainerTypeColumn].widen(container.provider("-"));
+    columns[ContainerTemplateColumn].widen(container.templateName("-", true));
+}
+
+/**
+ * The row function of printContainersLong() that prints one container.
+ */
+static void
+renderContainerRow(
+        void                 *userData,
+        const S9sVariant     &row,
+        S9sVector<S9sFormat> &columns,
+        S9sString            &output)
+{
+    ContainerListContext *context = (ContainerListContext *) userData;
+    const S9sVariantMap  &theMap  = row.toVariantMap();
+    S9sContainer          container(theMap);
+    S9sString             alias   = container.name();
+    S9sString             ip      = 
+        container.ipAddress(context->addressType, "-");
+    S9sString             group   = 
+        theMap.valueByPath("owner_group_name").toString();
+
+    if (!isContainerListed(*context, container))
+        return;
+
+    if (ip.empty())
+        ip = "-";
+
+    if (context->truncate && context->nColumns < context->terminalWidth)
+    {
+        int remaining  = context->terminalWidth - context->nColumns;
+
+        alias.ellipsize(remaining);
+    }
+       
+    output.aprintf("%c ", container.stateAsChar());
+        
+    columns[ContainerTypeColumn].printf(container.provider("-"));
+    columns[ContainerTemplateColumn].printf(container.templateName("-", true));
+
+    output += S9sRpcReply::userColorBegin();
+    columns[ContainerUserColumn].printf(
+            theMap.valueByPath("owner_user_name").toString());
+    output += S9sRpcReply::userColorEnd();
+        
+    output += S9sRpcReply::groupColorBegin(group);
+    columns[ContainerGroupColumn].printf(group);
+    output += S9sRpcReply::groupColorEnd();
+
+    columns[ContainerIpColumn].printf(ip);
+
+    output += S9sRpcReply::serverColorBegin();
+    columns[ContainerParentColumn].printf(
+            theMap.valueByPath("parent_server").toString());
+    output += S9sRpcReply::serverColorEnd();
+
+    output.aprintf("%s%s%s\n", 
+            S9sRpcReply::containerColorBegin(container.stateAsChar()), 
+            STR(alias),
+            S9sRpcReply::containerColorEnd());
+}
+
 /**
  * Prints the containers in long format.
  *
@@ -6380,22 +6603,15 @@ S9sRpcReply::printContainersLong()
     bool            syntaxHighlight = options->useSyntaxHighlight();
     S9sString       subnetId  = options->subnetId();
     S9sString       vpcId     = options->vpcId();
-    S9s::AddressType addressType = options->addressType();
-    int             terminalWidth = options->terminalWidth();
-    int             nColumns;
-    bool            truncate = options->truncate();
     S9sString       cloudName = options->cloudName();
     S9sVariantList  theList = operator[]("containers").toVariantList();
     S9sString       formatString = options->containerFormat();
     int             total   = operator[]("total").toInt();
     int             nLines = 0;
     int             totalRunning = 0;
-    S9sFormat       typeFormat;
-    S9sFormat       templateFormat;
-    S9sFormat       ipFormat(ipColorBegin(), ipColorEnd());
-    S9sFormat       userFormat(userColorBegin(), userColorEnd());
-    S9sFormat       groupFormat;
-    S9sFormat       parentFormat;
+    S9sVector<S9sFormat>  columns;
+    ContainerListContext  context;
+    S9sString             output;
 
     if (options->hasContainerFormat())
     {
@@ -6428,45 +6644,36 @@ S9sRpcReply::printContainersLong()
         return;
     }
 
+    columns.resize(NContainerListColumns);
+    columns[ContainerIpColumn].setColor(ipColorBegin(), ipColorEnd());
+    columns[ContainerUserColumn].setColor(userColorBegin(), userColorEnd());
+
+    context.options       = options;
+    context.subnetId      = subnetId;
+    context.vpcId         = vpcId;
+    context.cloudName     = cloudName;
+    context.addressType   = options->addressType();
+    context.truncate      = options->truncate();
+    context.terminalWidth = options->terminalWidth();
+
+    S9sRowRenderer renderer(theList, &context);
+
     /*
      * First run-through: collecting some information.
      */
     for (uint idx = 0; idx < theList.size(); ++idx)
     {
-        S9sVariantMap  theMap = theList[idx].toVariantMap();
-        S9sContainer   container(theMap);
-        S9sString      alias  = container.name();
-        S9sString      ip     = container.ipAddress(addressType, "-");
-        S9sString      parent = theMap["parent_server"].toString();
-        S9sString      user   = theMap["owner_user_name"].toString();
-        S9sString      group  = theMap["owner_group_name"].toString();
-        S9sString      type   = container.provider("-");
-        S9sString      templateName = container.templateName("-", true);
-
-        if (!options->isStringMatchExtraArguments(container.name()))
-            continue;
-
-        if (!cloudName.empty() && container.provider() != cloudName)
-            continue;
-        
-        if (!subnetId.empty() && container.subnetId() != subnetId)
-            continue;
-        
-        if (!vpcId.empty() && vpcId != container.subnetVpcId())
-            continue;
+        S9sContainer container(theList[idx].toVariantMap());
 
-        if (ip.empty())
-            ip = "-";
+        if (theList[idx].toVariantMap().valueByPath("status") == "RUNNING")
+            totalRunning++;
 
-        userFormat.widen(user);
-        groupFormat.widen(group);
-        ipFormat.widen(ip);
-        parentFormat.widen(parent);
-        typeFormat.widen(type);
-        templateFormat.widen(templateName);
-        ++nLines;
+        if (isContainerListed(context, container))
+            ++nLines;
     }
 
+    renderer.widen(widenContainerRow, columns);
+
     /*
      * Printing the header.
      */
@@ -6474,100 +6681,28 @@ S9sRpcReply::printContainersLong()
     {
         printf("%s", headerColorBegin());
         printf("S ");
-        typeFormat.printHeader("CLD");
-        templateFormat.printHeader("TEMPLATE");
-        userFormat.printHeader("OWNER");
-        groupFormat.printHeader("GROUP");
-        ipFormat.printHeader("IP ADDRESS");
-        parentFormat.printHeader("SERVER");
+        columns[ContainerTypeColumn].printHeader("CLD");
+        columns[ContainerTemplateColumn].printHeader("TEMPLATE");
+        columns[ContainerUserColumn].printHeader("OWNER");
+        columns[ContainerGroupColumn].printHeader("GROUP");
+        columns[ContainerIpColumn].printHeader("IP ADDRESS");
+        columns[ContainerParentColumn].printHeader("SERVER");
         ::printf("NAME");
 
         printf("%s\n", headerColorEnd());
     }
 
-    nColumns  = 0;
-    nColumns += 2;
-    nColumns += typeFormat.realWidth();
-    nColumns += templateFormat.realWidth();
-    nColumns += userFormat.realWidth();
-    nColumns += groupFormat.realWidth();
-    nColumns += ipFormat.realWidth();
-    nColumns += parentFormat.realWidth();
-    
+    context.nColumns  = 2;
+    for (uint idx = 0u; idx < columns.size(); ++idx)
+        context.nColumns += columns[idx].realWidth();
     
     /*
      * Second run: doing the actual printing.
      */    
-    for (uint idx = 0; idx < theList.size(); ++idx)
-    {
-        S9sVariantMap  theMap = theList[idx].toVariantMap();
-        S9sContainer   container(theMap);
-        S9sString      alias  = container.name();
-        S9sString      ip     = container.ipAddress(addressType, "-");
-        bool           isRunning = theMap["status"] == "RUNNING";
-        S9sString      parent = theMap["parent_server"].toString();
-        S9sString      user   = theMap["owner_user_name"].toString();
-        S9sString      group  = theMap["owner_group_name"].toString();
-        S9sString      type   = container.provider("-");
-        S9sString      templateName = container.templateName("-", true);
-
-        if (isRunning)
-            totalRunning++;
-        
-        if (!options->isStringMatchExtraArguments(alias))
-            continue;
-        
-        if (!subnetId.empty() && container.subnetId() != subnetId)
-            continue;
-        
-        if (!vpcId.empty() && vpcId != container.subnetVpcId())
-            continue;
-
-        if (!cloudName.empty() && container.provider() != cloudName)
-            continue;
-
-        if (ip.empty())
-            ip = "-";
-
-        if (truncate && nColumns < terminalWidth)
-        {
-            int remaining  = terminalWidth - nColumns;
-
-            if (remaining < (int) alias.length())
-            {
-                alias.resize(remaining - 1);
-                alias += "…";
-            }  
-        }
-       
-        printf("%c ", container.stateAsChar());
-        
-        typeFormat.printf(type);
-        templateFormat.printf(templateName);
-
-        printf("%s", userColorBegin());
-        userFormat.printf(user);
-        printf("%s", userColorEnd());
-        
-        printf("%s", groupColorBegin(group));
-        groupFormat.printf(group);
-        printf("%s", groupColorEnd());
-
-        ipFormat.printf(ip);
-
-        printf("%s", serverColorBegin());
-        parentFormat.printf(parent);
-        printf("%s", serverColorEnd());
-
-        ::printf("%s%s%s", 
-                containerColorBegin(container.stateAsChar()), 
-                STR(alias),
-                containerColorEnd());
-
-        printf("\n");
-    }
-    
-    if (!options->isBatchRequested())
+    output = renderer.render(renderContainerRow, columns);
+    printf("%s", STR(output));
+    
+    if (!options->isBatchRequested())
     {
         printf("Total: %s%d%s containers, %s%d%s running.\n", 
                 numberColorBegin(), total, numberColorEnd(),
@@ -7328,31 +7463,6 @@ S9sRpcReply::printReport()
     }
 }
 
-/**
- * \param a the first host represented as a variantmap
- * \param b the second host represented as a variantmap
- *
- * This function is used to sort the hosts before printing them in a list. First
- * the cluster IDs are compared, the second key is the host name.
- */
-bool 
-compareHostMaps(
-        const S9sVariant &a,
-        const S9sVariant &b)
-{
-    S9sVariantMap aMap       = a.toVariantMap();
-    S9sVariantMap bMap       = b.toVariantMap();
-    int           clusterId1 = aMap["clusterid"].toInt();
-    int           clusterId2 = bMap["clusterid"].toInt();
-    S9sString     hostName1  = aMap["hostname"].toString();
-    S9sString     hostName2  = bMap["hostname"].toString();
-
-    if (clusterId1 != clusterId2)
-        return clusterId1 < clusterId2;
-
-    return hostName1 < hostName2;
-}
-
 bool 
 S9sRpcReply::createGraph(
         S9sVector<S9sCmonGraph *> &graphs, 
@@ -7639,6 +7749,117 @@ S9sRpcReply::printClustersStat()
     }
 }
 
+/*
+ * The columns of the node list.
+ */
+enum NodeListColumn
+{
+    NodeVersionColumn,
+    NodeCidColumn,
+    NodeClusterNameColumn,
+    NodeHostNameColumn,
+    NodePortColumn,
+    NNodeListColumns
+};
+
+/*
+ * What the row functions of the node list need to know.
+ */
+struct NodeListContext
+{
+    S9sOptions    *options;
+    S9sVariantMap  properties;
+    bool           syntaxHighlight;
+    int            terminalWidth;
+    const char    *clusterColorBegin;
+    const char    *clusterColorEnd;
+};
+
+/**
+ * The row function of printNodeListLong() that prints one node.
+ */
+static void
+renderNodeRow(
+        void                 *userData,
+        const S9sVariant     &row,
+        S9sVector<S9sFormat> &columns,
+        S9sString            &output)
+{
+    NodeListContext     *context   = (NodeListContext *) userData;
+    const S9sVariantMap &hostMap   = row.toVariantMap();
+    S9sNode              node      = hostMap;
+    S9sString            hostName  = node.name();
+    S9sString            status    = node.hostStatus();
+    S9sString            message   = node.message();
+    S9sString            version   = node.version();
+    S9sString            clusterName = 
+        hostMap.valueByPath("cluster_name").toString();
+    bool                 maintenance = 
+        hostMap.valueByPath("maintenance_mode_active").toBoolean();
+    int                  port      = hostMap.valueByPath("port").toInt(-1);
+    int                  nColumns;
+            
+    // Filtering...
+    if (!context->properties.isSubSet(hostMap))
+        return;
+
+    if (!context->options->isStringMatchExtraArguments(hostName))
+        return;
+
+    if (message.empty())
+        message = "-";
+
+    if (version.empty())
+        version = "-";
+
+    // FIXME: I am not sure this is actually user friendly. We use the state
+    // color for name color.
+    if (context->syntaxHighlight)
+    {
+        S9sFormatter formatter;
+
+        columns[NodeHostNameColumn].setColor(
+                formatter.hostStateColorBegin(status),
+                formatter.hostStateColorEnd());
+    }
+
+    // Calculating how much space we have for the message column.
+    nColumns  = 3 + 1 + 1;
+    for (uint idx = 0u; idx < columns.size(); ++idx)
+        nColumns += columns[idx].realWidth();
+
+    if (nColumns < context->terminalWidth)
+    {
+        int remaining = context->terminalWidth - nColumns;
+            
+        message.ellipsize(remaining);
+    }
+
+    /*
+     * Printing.
+     */
+    output.aprintf("%c", node.nodeTypeFlag());
+    output.aprintf("%c", node.stateAsChar());
+    output.aprintf("%c", node.roleFlag());
+    output.aprintf("%c ", maintenance ? 'M' : '-');
+
+    columns[NodeVersionColumn].printf(version);
+    columns[NodeCidColumn].printf(node.clusterId());
+
+    output += context->clusterColorBegin;
+    columns[NodeClusterNameColumn].printf(clusterName);
+    output += context->clusterColorEnd;
+
+    columns[NodeHostNameColumn].printf(hostName);
+
+    if (port >= 0)
+        columns[NodePortColumn].printf(port);
+    else
+        columns[NodePortColumn].printf("-");
+
+    output.aprintf("%s\n", STR(message));
+}
+
 /**
  * Prints the node list in its long format (aka "node --list --long).
  */
@@ -7646,21 +7867,16 @@ void
 S9sRpcReply::printNodeListLong()
 {
     S9sOptions     *options = S9sOptions::instance();
-    S9sFormatter    formatter;
     S9sVariantMap   properties = options->propertiesOption();
     bool            syntaxHighlight = options->useSyntaxHighlight();
     S9sString       clusterNameFilter = options->clusterName();
     S9sVariantList  theList = clusters();
     S9sString       formatString = options->longNodeFormat();
     S9sVariantList  hostList;
-    S9sFormat       cidFormat;
-    S9sFormat       hostNameFormat;
-    S9sFormat       versionFormat;
-    S9sFormat       clusterNameFormat;
-    S9sFormat       portFormat;
+    S9sVector<S9sFormat> columns;
+    NodeListContext context;
+    S9sString       output;
     int             total = 0;
-    int             terminalWidth = options->terminalWidth();
-    int             nColumns;
 
     if (options->hasNodeFormat())
         formatString = options->nodeFormat();
@@ -7707,6 +7923,8 @@ S9sRpcReply::printNodeListLong()
         return;
     }
 
+    columns.resize(NNodeListColumns);
+
     /*
      * First run-through: collecting some information.
      */
@@ -7721,7 +7939,7 @@ S9sRpcReply::printNodeListLong()
         if (!clusterNameFilter.empty() && clusterNameFilter != clusterName)
             continue;
 
-        clusterNameFormat.widen(clusterName);
+        columns[NodeClusterNameColumn].widen(clusterName);
 
         for (uint idx2 = 0; idx2 < hosts.size(); ++idx2)
         {
@@ -7741,10 +7959,10 @@ S9sRpcReply::printNodeListLong()
             if (version.empty())
                 version = "-";
             
-            hostNameFormat.widen(hostName);
-            cidFormat.widen(clusterId);
-            versionFormat.widen(version);
-            portFormat.widen(port);
+            columns[NodeHostNameColumn].widen(hostName);
+            columns[NodeCidColumn].widen(clusterId);
+            columns[NodeVersionColumn].widen(version);
+            columns[NodePortColumn].widen(port);
 
             hostMap["cluster_name"] = clusterName;
             hostList << hostMap;
@@ -7752,9 +7970,28 @@ S9sRpcReply::printNodeListLong()
     }
 
     /*
-     * Sorting the hosts.
+     * Sorting the hosts, first by the cluster ID, then by the host name.
      */
-    sort(hostList.begin(), hostList.end(), compareHostMaps);
+    if (!hostList.empty())
+    {
+        S9sSortKeys< std::pair<int, S9sString> > sortKeys;
+        S9sVariantList sorted;
+
+        sortKeys.reserve(hostList.size());
+        for (uint idx = 0u; idx < hostList.size(); ++idx)
+        {
+            int       clusterId = hostList[idx]["clusterid"].toInt();
+            S9sString hostName  = hostList[idx]["hostname"].toString();
+
+            sortKeys.add(std::make_pair(clusterId, hostName), idx);
+        }
+
+        sortKeys.sort();
+        for (uint idx = 0u; idx < sortKeys.size(); ++idx)
+            sorted << hostList[sortKeys.index(idx)];
+
+        hostList = sorted;
+    }
     
     /*
      * Printing the header.
@@ -7763,11 +8000,11 @@ S9sRpcReply::printNodeListLong()
     {
         printf("%s", headerColorBegin());
         printf("STAT ");
-        versionFormat.printHeader("VERSION");
-        cidFormat.printHeader("CID");
-        clusterNameFormat.printHeader("CLUSTER");
-        hostNameFormat.printHeader("HOST");
-        portFormat.printHeader("PORT");
+        columns[NodeVersionColumn].printHeader("VERSION");
+        columns[NodeCidColumn].printHeader("CID");
+        columns[NodeClusterNameColumn].printHeader("CLUSTER");
+        columns[NodeHostNameColumn].printHeader("HOST");
+        columns[NodePortColumn].printHeader("PORT");
         printf("COMMENT");
         printf("%s\n", headerColorEnd());
     }
@@ -7775,87 +8012,17 @@ S9sRpcReply::printNodeListLong()
     /*
      * Second run: doing the actual printing.
      */
-    for (uint idx2 = 0; idx2 < hostList.size(); ++idx2)
-    {
-        S9sVariantMap hostMap   = hostList[idx2].toVariantMap();
-        S9sNode       node      = hostMap;
-        S9sString     hostName  = node.name();
-        int           clusterId = node.clusterId();
-        S9sString     status    = node.hostStatus();
-        S9sString     className = hostMap["class_name"].toString();
-        //S9sString     nodeType  = hostMap["nodetype"].toString();
-        S9sString     message   = node.message();
-        S9sString     version   = node.version();
-        S9sString     clusterName = hostMap["cluster_name"].toString();
-        bool maintenance = hostMap["maintenance_mode_active"].toBoolean();
-        int           port      = hostMap["port"].toInt(-1);
-            
-        // Filtering...
-        if (!properties.isSubSet(hostMap))
-            continue;
-
-        if (!options->isStringMatchExtraArguments(hostName))
-            continue;
-
-        if (message.empty())
-            message = "-";
+    context.options           = options;
+    context.properties        = properties;
+    context.syntaxHighlight   = syntaxHighlight;
+    context.terminalWidth     = options->terminalWidth();
+    context.clusterColorBegin = clusterColorBegin();
+    context.clusterColorEnd   = clusterColorEnd();
 
-        if (version.empty())
-            version = "-";
-
-        // FIXME: I am not sure this is actually user friendly. We use the state
-        // color for name color.
-        if (syntaxHighlight)
-        {
-            hostNameFormat.setColor(
-                    formatter.hostStateColorBegin(status),
-                    formatter.hostStateColorEnd());
-        }
-
-        // Calculating how much space we have for the message column.
-        nColumns  = 3 + 1 + 1;
-        nColumns += cidFormat.realWidth();
-        nColumns += versionFormat.realWidth();
-        nColumns += clusterNameFormat.realWidth();
-        nColumns += hostNameFormat.realWidth();
-        nColumns += portFormat.realWidth();
-
-        if (nColumns < terminalWidth)
-        {
-            int remaining = terminalWidth - nColumns;
-            
-            if (remaining < (int) message.length())
-            {
-                message.resize(remaining - 1);
-                message += "…";
-            }
-        }
-
-        /*
-         * Printing.
-         */
-        printf("%c", node.nodeTypeFlag());
-        printf("%c", node.stateAsChar());
-        printf("%c", node.roleFlag());
-        printf("%c ", maintenance ? 'M' : '-');
-
-        versionFormat.printf(version);
-        cidFormat.printf(clusterId);
+    S9sRowRenderer renderer(hostList, &context);
 
-        printf("%s", clusterColorBegin());
-        clusterNameFormat.printf(clusterName);
-        printf("%s", clusterColorEnd());
-
-        hostNameFormat.printf(hostName);
-
-        if (port >= 0)
-            portFormat.printf(port);
-        else
-            portFormat.printf("-");
-
-
-        printf("%s\n", STR(message));
-    }
+    output = renderer.render(renderNodeRow, columns);
+    printf("%s", STR(output));
 
     if (!options->isBatchRequested())
         printf("Total: %d\n", total); 
@@ -8065,6 +8232,262 @@ S9sRpcReply::printJobListBrief()
         printf("Total: %d\n", total);
 }
 
+/*
+ * What the row function of the job list needs to know.
+ */
+struct JobListContext
+{
+    S9sOptions     *options;
+    int             terminalWidth;
+    bool            syntaxHighlight;
+    S9sVariantList  requiredTags;
+    S9sVariantList  disabledTags;
+};
+
+/**
+ * The row function of printJobListLong() that prints the details of one job.
+ */
+static void
+renderJobRow(
+        void                 *userData,
+        const S9sVariant     &row,
+        S9sVector<S9sFormat> &columns,
+        S9sString            &output)
+{
+    JobListContext *context    = (JobListContext *) userData;
+    S9sOptions     *options    = context->options;
+    int             terminalWidth   = context->terminalWidth;
+    bool            syntaxHighlight = context->syntaxHighlight;
+    S9sVariantMap  theMap     = row.toVariantMap();
+    S9sJob         job        = theMap;
+    int            jobId      = job.id();
+    S9sString      status     = job.status();
+    S9sString      title      = job.title();
+    S9sString      statusText = theMap["status_text"].toString();
+    S9sString      statusTextMonochrome;
+    S9sString      user       = theMap["user_name"].toString();
+    S9sString      group      = theMap["group_name"].toString();
+    S9sString      hostName   = theMap["ip_address"].toString();
+    S9sString      created    = theMap["created"].toString();
+    S9sString      ended      = theMap["ended"].toString();
+    S9sString      started    = theMap["started"].toString();
+    S9sString      scheduled  = theMap["scheduled"].toString();
+    S9sString      recurrence = theMap["recurrence"].toString();
+    int            clusterId  = theMap["cluster_id"].toInt();
+    S9sString      bar;
+    double         percent;
+    S9sString      timeStamp;
+    const char    *stateColorStart = "";
+    const char    *stateColorEnd   = "";
+
+    // Filtering.
+    if (options->hasJobId() && options->jobId() != jobId)
+        return;
+
+    if (!context->requiredTags.empty())
+    {
+        if (!job.hasTags(context->requiredTags))
+            return;
+    }
+
+    if (!context->disabledTags.empty())
+    {
+        if (job.hasTags(context->disabledTags))
+            return;
+    }
+
+    // The title.
+    if (title.empty())
+        title = "Untitled Job";
+
+    // The host.
+    if (hostName.empty())
+        hostName = "-";
+
+    // Status text
+    statusTextMonochrome = S9sString::html2text(statusText);
+    statusText = S9sString::html2ansi(statusText);
+
+    // The user name or if it is not there the user ID.
+    if (user.empty())
+        user.sprintf("%d", theMap["user_id"].toInt());
+
+    // The progress.
+    if (theMap.contains("progress_percent"))
+    {
+        percent = theMap["progress_percent"].toDouble();
+    } else if (status == "FINISHED") 
+    {
+        percent = 100.0;
+    } else {
+        percent = 0.0;
+    }
+
+    /*
+     * The timestamps.
+     */
+    if (!created.empty())
+    {
+        S9sDateTime tmp;
+
+        tmp.parse(created);
+        created = tmp.toString(S9sDateTime::MySqlLogFileFormat);
+    }
+    
+    if (!scheduled.empty())
+    {
+        S9sDateTime tmp;
+
+        tmp.parse(scheduled);
+        scheduled = tmp.toString(S9sDateTime::MySqlLogFileFormat);
+    }
+    
+    if (!started.empty())
+    {
+        S9sDateTime tmp;
+
+        tmp.parse(started);
+        started = tmp.toString(S9sDateTime::MySqlLogFileFormat);
+    }
+    
+    if (!ended.empty())
+    {
+        S9sDateTime tmp;
+
+        tmp.parse(ended);
+        ended = tmp.toString(S9sDateTime::MySqlLogFileFormat);
+    }
+
+    //
+    if (syntaxHighlight)
+    {
+        if (status.startsWith("RUNNING"))
+        {
+            stateColorStart = XTERM_COLOR_GREEN;
+            stateColorEnd   = TERM_NORMAL;
+        } else if (status == "FINISHED")
+        {
+            stateColorStart = XTERM_COLOR_GREEN;
+            stateColorEnd   = TERM_NORMAL;
+        } else if (status == "FAILED")
+        {
+            stateColorStart = XTERM_COLOR_RED;
+            stateColorEnd   = TERM_NORMAL;
+        }
+    }
+
+    /*
+     * A line, then a title and a status text.
+     */
+    for (int n = 0; n < terminalWidth; ++n)
+        output += "-";
+
+    output += "\n";
+
+    output.aprintf("%s%s%s\n", TERM_BOLD, STR(title), TERM_NORMAL);
+    output += statusText;
+
+    for (int n = statusTextMonochrome.length(); n < terminalWidth - 13; ++n)
+        output += " ";
+
+    if (theMap.contains("progress_percent"))
+    {
+        percent = theMap["progress_percent"].toDouble();
+        bar = S9sRpcReply::progressBar(percent, syntaxHighlight);
+    } else {
+        bar = "            ";
+    }
+
+    output += bar;
+    output += "\n";
+
+    for (int n = 11; n < terminalWidth; ++n)
+        output += " ";
+
+    if (theMap.contains("progress_percent"))
+        output.aprintf("%6.2f%% ", percent);
+    else 
+        output += "        ";
+
+
+    //printf(STR(userNameFormat), STR(user));
+    //printf("%s ", STR(timeStamp));
+    //printf("%s ", STR(percent));
+    //printf("%5d ", jobId);
+    output += "\n";
+    
+    // The dates...
+    output.aprintf("%sCreated   :%s %s%19s%s    ", 
+            XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
+            XTERM_COLOR_LIGHT_GRAY, STR(created), TERM_NORMAL);
+
+    output.aprintf("%sID   :%s %s%-10d%s ", 
+            XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
+            XTERM_COLOR_BLUE, jobId, TERM_NORMAL);
+
+    output.aprintf("%sStatus :%s %s%s%s ", 
+            XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
+            stateColorStart, STR(status), stateColorEnd);
+
+    output += "\n";
+
+    // Started : 2017-02-06 11:13:04  User : system   Host   : 127.0.0.1
+    output.aprintf("%sStarted   :%s %s%19s%s    ", 
+            XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
+            XTERM_COLOR_LIGHT_GRAY, STR(started), TERM_NORMAL);
+    
+    output.aprintf("%sUser :%s %s%-10s%s ", 
+            XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
+            S9sRpcReply::userColorBegin(), STR(user), S9sRpcReply::userColorEnd());
+
+    output.aprintf("%sHost   :%s %s%s%s ", 
+            XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
+            XTERM_COLOR_BLUE, STR(hostName), TERM_NORMAL);
+    
+    output += "\n";
+
+
+
+    output.aprintf("%sEnded     :%s %s%19s%s    ", 
+            XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
+            XTERM_COLOR_LIGHT_GRAY, STR(ended), TERM_NORMAL);
+    
+    output.aprintf("%sGroup:%s %s%-10s%s ", 
+            XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
+            S9sRpcReply::groupColorBegin(group), STR(group), S9sRpcReply::groupColorEnd());
+    
+    output.aprintf("%sCluster:%s %d ", 
+            XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
+            clusterId);
+    
+    output += "\n";
+    
+    if (!scheduled.empty())
+    {
+        output.aprintf("%sScheduled :%s %s%19s%s\n", 
+                XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
+                XTERM_COLOR_LIGHT_GRAY, STR(scheduled), TERM_NORMAL);
+    }
+    else if (!recurrence.empty())
+    {
+        output.aprintf("%sRecurrence:%s %s%s%s\n", 
+                XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
+                XTERM_COLOR_LIGHT_GRAY, STR(recurrence), TERM_NORMAL);
+    }
+
+    output.aprintf("%sTags      :%s %s\n", 
+            XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
+            STR(job.tags(syntaxHighlight, "-")));
+    
+    output.aprintf("%sRPC       :%s %s\n", 
+            XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
+            STR(job.rpcVersion("-")));
+
+    S9S_UNUSED(jobId);
+    S9S_UNUSED(stateColorEnd);
+    S9S_UNUSED(stateColorStart);
+}
+
 /**
  * Prints the list of jobs in their detailed form.
  *
@@ -8127,6 +8550,9 @@ S9sRpcReply::printJobListLong()
     S9sString       userNameFormat;
     unsigned int    statusLength    = 0;
     S9sString       statusFormat;
+    S9sVector<S9sFormat> columns;
+    JobListContext  context;
+    S9sString       output;
 
     theList.reverse();
 
@@ -8167,237 +8593,16 @@ S9sRpcReply::printJobListLong()
     userNameFormat.sprintf("%%-%us ", userNameLength);
     statusFormat.sprintf("%%s%%-%ds%%s ", statusLength);
 
-    for (uint idx = 0; idx < theList.size(); ++idx)
-    {
-        S9sVariantMap  theMap     = theList[idx].toVariantMap();
-        S9sJob         job        = theList[idx].toVariantMap();
-        int            jobId      = job.id();
-        S9sString      status     = job.status();
-        S9sString      title      = job.title();
-        S9sString      statusText = theMap["status_text"].toString();
-        S9sString      statusTextMonochrome;
-        S9sString      user       = theMap["user_name"].toString();
-        S9sString      group      = theMap["group_name"].toString();
-        S9sString      hostName   = theMap["ip_address"].toString();
-        S9sString      created    = theMap["created"].toString();
-        S9sString      ended      = theMap["ended"].toString();
-        S9sString      started    = theMap["started"].toString();
-        S9sString      scheduled  = theMap["scheduled"].toString();
-        S9sString      recurrence = theMap["recurrence"].toString();
-        int            clusterId  = theMap["cluster_id"].toInt();
-        S9sString      bar;
-        double         percent;
-        S9sString      timeStamp;
-        const char    *stateColorStart = "";
-        const char    *stateColorEnd   = "";
-
-        // Filtering.
-        if (options->hasJobId() && options->jobId() != jobId)
-            continue;
-
-        if (!requiredTags.empty())
-        {
-            if (!job.hasTags(requiredTags))
-                continue;
-        }
-
-        if (!disabledTags.empty())
-        {
-            if (job.hasTags(disabledTags))
-                continue;
-        }
-
-        // The title.
-        if (title.empty())
-            title = "Untitled Job";
-
-        // The host.
-        if (hostName.empty())
-            hostName = "-";
-
-        // Status text
-        statusTextMonochrome = S9sString::html2text(statusText);
-        statusText = S9sString::html2ansi(statusText);
-
-        // The user name or if it is not there the user ID.
-        if (user.empty())
-            user.sprintf("%d", theMap["user_id"].toInt());
-
-        // The progress.
-        if (theMap.contains("progress_percent"))
-        {
-            percent = theMap["progress_percent"].toDouble();
-        } else if (status == "FINISHED") 
-        {
-            percent = 100.0;
-        } else {
-            percent = 0.0;
-        }
-
-        /*
-         * The timestamps.
-         */
-        if (!created.empty())
-        {
-            S9sDateTime tmp;
-
-            tmp.parse(created);
-            created = tmp.toString(S9sDateTime::MySqlLogFileFormat);
-        }
-        
-        if (!scheduled.empty())
-        {
-            S9sDateTime tmp;
-
-            tmp.parse(scheduled);
-            scheduled = tmp.toString(S9sDateTime::MySqlLogFileFormat);
-        }
-        
-        if (!started.empty())
-        {
-            S9sDateTime tmp;
-
-            tmp.parse(started);
-            started = tmp.toString(S9sDateTime::MySqlLogFileFormat);
-        }
-        
-        if (!ended.empty())
-        {
-            S9sDateTime tmp;
-
-            tmp.parse(ended);
-            ended = tmp.toString(S9sDateTime::MySqlLogFileFormat);
-        }
-
-        //
-        if (syntaxHighlight)
-        {
-            if (status.startsWith("RUNNING"))
-            {
-                stateColorStart = XTERM_COLOR_GREEN;
-                stateColorEnd   = TERM_NORMAL;
-            } else if (status == "FINISHED")
-            {
-                stateColorStart = XTERM_COLOR_GREEN;
-                stateColorEnd   = TERM_NORMAL;
-            } else if (status == "FAILED")
-            {
-                stateColorStart = XTERM_COLOR_RED;
-                stateColorEnd   = TERM_NORMAL;
-            }
-        }
-
-        /*
-         * A line, then a title and a status text.
-         */
-        for (int n = 0; n < terminalWidth; ++n)
-            printf("-");
-
-        printf("\n");
-
-        printf("%s%s%s\n", TERM_BOLD, STR(title), TERM_NORMAL);
-        printf("%s", STR(statusText));
-
-        for (int n = statusTextMonochrome.length(); n < terminalWidth - 13; ++n)
-            printf(" ");
-
-        if (theMap.contains("progress_percent"))
-        {
-            percent = theMap["progress_percent"].toDouble();
-            bar = progressBar(percent, syntaxHighlight);
-        } else {
-            bar = "            ";
-        }
-
-        printf("%s", STR(bar));
-        printf("\n");
-
-        for (int n = 11; n < terminalWidth; ++n)
-            printf(" ");
-
-        if (theMap.contains("progress_percent"))
-            printf("%6.2f%% ", percent);
-        else 
-            printf("        ");
-
-
-        //printf(STR(userNameFormat), STR(user));
-        //printf("%s ", STR(timeStamp));
-        //printf("%s ", STR(percent));
-        //printf("%5d ", jobId);
-        printf("\n");
-        
-        // The dates...
-        printf("%sCreated   :%s %s%19s%s    ", 
-                XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
-                XTERM_COLOR_LIGHT_GRAY, STR(created), TERM_NORMAL);
-
-        printf("%sID   :%s %s%-10d%s ", 
-                XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
-                XTERM_COLOR_BLUE, jobId, TERM_NORMAL);
-
-        printf("%sStatus :%s %s%s%s ", 
-                XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
-                stateColorStart, STR(status), stateColorEnd);
-
-        printf("\n");
-
-        // Started : 2017-02-06 11:13:04  User : system   Host   : 127.0.0.1
-        printf("%sStarted   :%s %s%19s%s    ", 
-                XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
-                XTERM_COLOR_LIGHT_GRAY, STR(started), TERM_NORMAL);
-        
-        printf("%sUser :%s %s%-10s%s ", 
-                XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
-                userColorBegin(), STR(user), userColorEnd());
-
-        printf("%sHost   :%s %s%s%s ", 
-                XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
-                XTERM_COLOR_BLUE, STR(hostName), TERM_NORMAL);
-        
-        printf("\n");
-
-
+    context.options         = options;
+    context.terminalWidth   = terminalWidth;
+    context.syntaxHighlight = syntaxHighlight;
+    context.requiredTags    = requiredTags;
+    context.disabledTags    = disabledTags;
 
-        printf("%sEnded     :%s %s%19s%s    ", 
-                XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
-                XTERM_COLOR_LIGHT_GRAY, STR(ended), TERM_NORMAL);
-        
-        printf("%sGroup:%s %s%-10s%s ", 
-                XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
-                groupColorBegin(group), STR(group), groupColorEnd());
-        
-        printf("%sCluster:%s %d ", 
-                XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
-                clusterId);
-        
-        printf("\n");
-        
-        if (!scheduled.empty())
-        {
-            printf("%sScheduled :%s %s%19s%s\n", 
-                    XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
-                    XTERM_COLOR_LIGHT_GRAY, STR(scheduled), TERM_NORMAL);
-        }
-        else if (!recurrence.empty())
-        {
-            printf("%sRecurrence:%s %s%s%s\n", 
-                    XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
-                    XTERM_COLOR_LIGHT_GRAY, STR(recurrence), TERM_NORMAL);
-        }
-
-        printf("%sTags      :%s %s\n", 
-                XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
-                STR(job.tags(syntaxHighlight, "-")));
-        
-        printf("%sRPC       :%s %s\n", 
-                XTERM_COLOR_DARK_GRAY, TERM_NORMAL,
-                STR(job.rpcVersion("-")));
-
-        S9S_UNUSED(jobId);
-        S9S_UNUSED(stateColorEnd);
-        S9S_UNUSED(stateColorStart);
-    }
+    S9sRowRenderer renderer(theList, &context);
+    
+    output = renderer.render(renderJobRow, columns);
+    printf("%s", STR(output));
         
     for (int n = 0; n < terminalWidth; ++n)
         printf("-");
@@ -8467,49 +8672,30 @@ S9sRpcReply::printCpuStat()
 {
     S9sOptions     *options = S9sOptions::instance();
     bool            syntaxHighlight = options->useSyntaxHighlight();
-    S9sVariantList  theList = operator[]("data").toVariantList();
-    S9sVariantMap   listMap;
+    S9sStatFrame    frame = statFrame();
+    const char     *numberStart = "";
+    const char     *numberEnd   = "";
 
-    for (uint idx = 0; idx < theList.size(); ++idx)
+    if (syntaxHighlight)
     {
-        S9sVariantMap theMap  = theList[idx].toVariantMap();
-        S9sString     key     = theMap["samplekey"].toString();
-        ulonglong     created = theMap["created"].toULongLong();
-
-        if (!listMap.contains(key))
-        {
-            listMap[key] = theMap;
-            continue;
-        }
-
-        if (listMap[key]["created"].toULongLong() < created)
-            listMap[key] = theMap;
+        numberStart = TERM_BOLD;
+        numberEnd   = TERM_NORMAL;
     }
 
-    foreach (const S9sVariant variant, listMap)
+    for (uint row = 0u; row < frame.nRows(); ++row)
     {
-        S9sVariantMap theMap  = variant.toVariantMap();
-        S9sString     model   = theMap["cpumodelname"].toString();
-        int           id      = theMap["cpuid"].toInt();
-        int           hostId  = theMap["hostid"].toInt();
-        S9sString     key     = theMap["samplekey"].toString();
-        double        user    = theMap["user"].toDouble() * 100.0;
-        double        sys     = theMap["sys"].toDouble()  * 100.0;
-        double        idle    = theMap["idle"].toDouble() * 100.0;
-        double        wait    = theMap["iowait"].toDouble() * 100.0;
-        double        steal   = theMap["steal"].toDouble() * 100.0;
-        const char    *numberStart = "";
-        const char    *numberEnd   = "";
+        S9sString     model   = frame.model(row);
+        int           id      = frame.cpuId(row);
+        int           hostId  = frame.hostId(row);
+        double        user    = frame.value(S9sStatFrame::User, row) * 100.0;
+        double        sys     = frame.value(S9sStatFrame::Sys, row)  * 100.0;
+        double        idle    = frame.value(S9sStatFrame::Idle, row) * 100.0;
+        double        wait    = frame.value(S9sStatFrame::IoWait, row) * 100.0;
+        double        steal   = frame.value(S9sStatFrame::Steal, row) * 100.0;
 
         while (model.contains("  "))
             model.replace("  ", " ");
 
-        if (syntaxHighlight)
-        {
-            numberStart = TERM_BOLD;
-            numberEnd   = TERM_NORMAL;
-        }
-
         printf("%%cpu%02d-%02d ", hostId, id);
         printf("%s%5.1f%s us,", numberStart, user, numberEnd);
         printf("%s%5.1f%s sy,", numberStart, sys, numberEnd);
@@ -8520,6 +8706,21 @@ S9sRpcReply::printCpuStat()
     }
 }
 
+/**
+ * \returns The "cpustat" or "memorystat" samples of the reply decoded into a
+ *   frame, only the latest sample kept for every sample key.
+ */
+S9sStatFrame
+S9sRpcReply::statFrame() const
+{
+    S9sStatFrame retval;
+
+    if (contains("data"))
+        retval.addSamples(at("data").toVariantList());
+
+    return retval;
+}
+
 void
 S9sRpcReply::printBackupListFormatString(
         const bool longFormat)
@@ -8592,49 +8793,190 @@ S9sRpcReply::printBackupListBrief()
     S9sOptions     *options = S9sOptions::instance();
     S9sVariantList  dataList;
 
-    // One is RPC 1.0, the other is 2.0.
-    if (contains("data"))
-        dataList = operator[]("data").toVariantList();
-    else if (contains("backup_records"))
-        dataList = operator[]("backup_records").toVariantList();
+    // One is RPC 1.0, the other is 2.0.
+    if (contains("data"))
+        dataList = operator[]("data").toVariantList();
+    else if (contains("backup_records"))
+        dataList = operator[]("backup_records").toVariantList();
+
+    /*
+     * We go through the data and print the titles. 
+     */
+    for (uint idx = 0; idx < dataList.size(); ++idx)
+    {
+        S9sVariantMap  theMap    = dataList[idx].toVariantMap();
+        S9sBackup      backup    = theMap;
+
+        /*
+         * Filtering.
+         */
+        if (options->hasBackupId() && options->backupId() != backup.id())
+            continue;
+
+        printf("%s\n", STR(backup.title()));
+    }
+}
+
+/*
+ * The columns of the backup list, the index of the formats in the vector the
+ * row functions use.
+ */
+enum BackupListColumn
+{
+    BackupIdColumn,
+    BackupParentIdColumn,
+    BackupCidColumn,
+    BackupVerifyColumn,
+    BackupIncrementalColumn,
+    BackupStateColumn,
+    BackupOwnerColumn,
+    BackupHostNameColumn,
+    BackupCreatedColumn,
+    BackupSizeColumn,
+    NBackupListColumns
+};
+
+/*
+ * What the row functions of the backup list need to know.
+ */
+struct BackupListContext
+{
+    S9sOptions *options;
+    bool        syntaxHighlight;
+};
+
+/**
+ * The row function of printBackupListLong() that measures one backup.
+ */
+static void
+widenBackupRow(
+        void                 *userData,
+        const S9sVariant     &row,
+        S9sVector<S9sFormat> &columns)
+{
+    BackupListContext *context    = (BackupListContext *) userData;
+    S9sOptions        *options    = context->options;
+    S9sBackup          backup     = row.toVariantMap();
+    int                id         = backup.id(); 
+    ulonglong          fullSize   = 0ull;
+
+    if (options->hasBackupId() && options->backupId() != id)
+        return;
+
+    columns[BackupCidColumn].widen(backup.clusterId());
+    columns[BackupStateColumn].widen(backup.status());
+    columns[BackupHostNameColumn].widen(backup.backupHost());
+    columns[BackupOwnerColumn].widen(backup.configOwner());
+    columns[BackupVerifyColumn].widen(backup.verificationFlag());
+    columns[BackupIncrementalColumn].widen("-");
+
+    for (int backupIdx = 0; backupIdx < backup.nBackups(); ++backupIdx)
+    {
+        columns[BackupIdColumn].widen(id);
+        columns[BackupParentIdColumn].widen(backup.parentId());
+
+        for (int fileIdx = 0; fileIdx < backup.nFiles(backupIdx); ++fileIdx)
+            fullSize += backup.fileSize(backupIdx, fileIdx).toUll();
+                
+        columns[BackupSizeColumn].widen(S9sFormat::toSizeString(fullSize));
+    }
+                
+    columns[BackupCreatedColumn].widen(backup.beginAsString());
+}
+
+/**
+ * The row function of printBackupListLong() that prints one backup.
+ */
+static void
+renderBackupRow(
+        void                 *userData,
+        const S9sVariant     &row,
+        S9sVector<S9sFormat> &columns,
+        S9sString            &output)
+{
+    BackupListContext *context    = (BackupListContext *) userData;
+    S9sOptions        *options    = context->options;
+    bool               syntaxHighlight = context->syntaxHighlight;
+    S9sBackup          backup     = row.toVariantMap();
+    int                id         = backup.id();
+    int                parentId   = backup.parentId();
+    bool               hasInc     = false;
+    bool               hasNotInc  = false;
+    ulonglong          fullSize   = 0ull;
+
+    /*
+     * Filtering.
+     */
+    if (options->hasBackupId() && options->backupId() != id)
+        return;
+
+    for (int backupIdx = 0; backupIdx < backup.nBackups(); ++backupIdx)
+    {
+        for (int fileIdx = 0; fileIdx < backup.nFiles(backupIdx); ++fileIdx)
+        {
+            ulonglong size = backup.fileSize(backupIdx, fileIdx).toUll();
+            bool      incremental = 
+                backup.incremental(backupIdx, fileIdx).toBoolean();
+
+            fullSize += size;
+            if (incremental)
+            {
+                hasInc = true;
+            } else {
+                hasNotInc = true;
+            }
+        }
+    }
+
+    columns[BackupIdColumn].printf(id);
+    if (parentId > 0)
+        columns[BackupParentIdColumn].printf(parentId);
+    else
+        columns[BackupParentIdColumn].printf("-");
 
-    /*
-     * We go through the data and print the titles. 
-     */
-    for (uint idx = 0; idx < dataList.size(); ++idx)
-    {
-        S9sVariantMap  theMap    = dataList[idx].toVariantMap();
-        S9sBackup      backup    = theMap;
+    columns[BackupCidColumn].printf(backup.clusterId());
+    columns[BackupVerifyColumn].printf(backup.verificationFlag());
+        
+    if (hasInc && hasNotInc)
+        output += "B ";
+    else if (hasInc)
+        output += "I ";
+    else if (hasNotInc)
+        output += "F ";
+    else 
+        output += "- ";
 
-        /*
-         * Filtering.
-         */
-        if (options->hasBackupId() && options->backupId() != backup.id())
-            continue;
+    output += backup.statusColorBegin(syntaxHighlight);
+    columns[BackupStateColumn].printf(backup.status());
+    output += backup.statusColorEnd(syntaxHighlight);
 
-        printf("%s\n", STR(backup.title()));
-    }
+    output += S9sRpcReply::userColorBegin();
+    columns[BackupOwnerColumn].printf(backup.configOwner());
+    output += S9sRpcReply::userColorEnd();
+
+    output += S9sRpcReply::ipColorBegin();
+    columns[BackupHostNameColumn].printf(backup.backupHost());
+    output += S9sRpcReply::ipColorEnd();
+        
+    columns[BackupCreatedColumn].printf(backup.beginAsString());
+    columns[BackupSizeColumn].printf(S9sFormat::toSizeString(fullSize));
+    output += backup.title();
+    output += "\n";
 }
 
 /**
- * This is the one that prints the detailed list of the backups.
+ * This is the one that prints the detailed list of the backups. The rows are
+ * measured and rendered by the S9sRowRenderer so a long list is processed by
+ * several threads.
  */
 void 
 S9sRpcReply::printBackupListLong()
 {
-    S9sOptions     *options = S9sOptions::instance();
-    bool            syntaxHighlight = options->useSyntaxHighlight();
-    S9sVariantList  dataList;
-    S9sFormat       sizeFormat;
-    S9sFormat       hostNameFormat;
-    S9sFormat       idFormat;
-    S9sFormat       parentIdFormat;
-    S9sFormat       cidFormat;
-    S9sFormat       verifyFormat;
-    S9sFormat       incrementalFormat;
-    S9sFormat       stateFormat;
-    S9sFormat       createdFormat;
-    S9sFormat       ownerFormat;
+    S9sOptions           *options = S9sOptions::instance();
+    S9sVariantList        dataList;
+    S9sVector<S9sFormat>  columns;
+    BackupListContext     context;
+    S9sString             output;
    
     // One is RPC 1.0, the other is 2.0.
     if (contains("data"))
@@ -8642,54 +8984,16 @@ S9sRpcReply::printBackupListLong()
     else if (contains("backup_records"))
         dataList = operator[]("backup_records").toVariantList();
 
+    columns.resize(NBackupListColumns);
+    context.options         = options;
+    context.syntaxHighlight = options->useSyntaxHighlight();
+
+    S9sRowRenderer renderer(dataList, &context);
+
     /*
      * Collecting some information.
      */
-    for (uint idx = 0; idx < dataList.size(); ++idx)
-    {
-        S9sVariantMap  theMap     = dataList[idx].toVariantMap();
-        S9sBackup      backup     = theMap;
-        S9sString      hostName   = backup.backupHost();
-        int            id         = backup.id(); 
-        int            parentId   = backup.parentId();
-        int            clusterId  = backup.clusterId(); 
-        S9sString      verifyFlag = backup.verificationFlag();
-        S9sString      owner      = backup.configOwner();
-        S9sString      status     = backup.status(); 
-        ulonglong      fullSize   = 0ull;
-        S9sString      sizeString;
-        S9sString      created;
-
-        if (options->hasBackupId() && options->backupId() != id)
-            continue;
-
-        cidFormat.widen(clusterId);
-        stateFormat.widen(status);
-        hostNameFormat.widen(hostName);
-        ownerFormat.widen(owner);
-        verifyFormat.widen(verifyFlag);
-        incrementalFormat.widen("-");
-
-        for (int backupIdx = 0; backupIdx < backup.nBackups(); ++backupIdx)
-        {
-            idFormat.widen(id);
-            parentIdFormat.widen(parentId);
-
-            for (int fileIdx = 0; 
-                    fileIdx < backup.nFiles(backupIdx); ++fileIdx)
-            {
-                ulonglong size = backup.fileSize(backupIdx, fileIdx).toUll();
-                
-                fullSize += size;
-            }
-                
-            sizeString = S9sFormat::toSizeString(fullSize);
-            sizeFormat.widen(sizeString);
-        }
-                
-        created = backup.beginAsString();
-        createdFormat.widen(created);
-    }
+    renderer.widen(widenBackupRow, columns);
 
     /*
      * Printing the header.
@@ -8697,135 +9001,30 @@ S9sRpcReply::printBackupListLong()
     if (!options->isNoHeaderRequested())
     {
         printf("%s", headerColorBegin());
-        idFormat.printHeader("ID");
-        parentIdFormat.printHeader("PI");
-        cidFormat.printHeader("CID");
-        verifyFormat.printHeader("V");
-        incrementalFormat.printHeader("I");
-        stateFormat.printHeader("STATE");
-        ownerFormat.printHeader("OWNER");
-        hostNameFormat.printHeader("HOSTNAME");
-        createdFormat.printHeader("CREATED");
-        sizeFormat.printHeader("SIZE");
+        columns[BackupIdColumn].printHeader("ID");
+        columns[BackupParentIdColumn].printHeader("PI");
+        columns[BackupCidColumn].printHeader("CID");
+        columns[BackupVerifyColumn].printHeader("V");
+        columns[BackupIncrementalColumn].printHeader("I");
+        columns[BackupStateColumn].printHeader("STATE");
+        columns[BackupOwnerColumn].printHeader("OWNER");
+        columns[BackupHostNameColumn].printHeader("HOSTNAME");
+        columns[BackupCreatedColumn].printHeader("CREATED");
+        columns[BackupSizeColumn].printHeader("SIZE");
         printf("TITLE");
  
         printf("%s", headerColorEnd());
         printf("\n");
     }
     
-    sizeFormat.setRightJustify();
-    parentIdFormat.setRightJustify();
+    columns[BackupSizeColumn].setRightJustify();
+    columns[BackupParentIdColumn].setRightJustify();
 
     /*
      * Second run, we print things here.
      */
-    for (uint idx = 0; idx < dataList.size(); ++idx)
-    {
-        S9sVariantMap  theMap     = dataList[idx].toVariantMap();
-        S9sBackup      backup     = theMap;
-        S9sString      hostName   = backup.backupHost();
-        int            clusterId  = backup.clusterId();
-        S9sString      verifyFlag = backup.verificationFlag();
-        bool           hasInc     = false;
-        bool           hasNotInc  = false;
-        S9sString      owner      = backup.configOwner();
-        int            id         = backup.id();
-        int            parentId   = backup.parentId();
-        S9sString      status     = backup.status();
-        S9sString      root       = backup.rootDir();
-        ulonglong      fullSize   = 0ull;
-        S9sString      sizeString;
-        S9sString      created;
-
-        /*
-         * Filtering.
-         */
-        if (options->hasBackupId() && options->backupId() != id)
-            continue;
-
-        /*
-         * Let's keep this for a while...
-         */
-#if 0
-        if (backups.size() == 0u)
-        {
-            S9sString     path          = "-";
-            S9sString     sizeString    = "-";
-            S9sString     createdString = "-";
-                
-            idFormat.printf(id);
-            cidFormat.printf(clusterId);
-
-            printf("%s", backup.statusColorBegin(syntaxHighlight));
-            stateFormat.printf(status);
-            printf("%s", backup.statusColorEnd(syntaxHighlight));
-
-            ownerFormat.printf(owner);
-            hostNameFormat.printf(hostName);
-            createdFormat.printf(createdString);
-            sizeFormat.printf(sizeString);
-            printf("%s", STR(path));
-            printf("\n");
-
-            continue;
-        }
-#endif
-        for (int backupIdx = 0; backupIdx < backup.nBackups(); ++backupIdx)
-        {
-            for (int fileIdx = 0; fileIdx < backup.nFiles(backupIdx); ++fileIdx)
-            {
-                ulonglong size = backup.fileSize(backupIdx, fileIdx).toUll();
-                bool      incremental = 
-                    backup.incremental(backupIdx, fileIdx).toBoolean();
-
-                fullSize += size;
-                if (incremental)
-                {
-                    hasInc = true;
-                } else {
-                    hasNotInc = true;
-                }
-            }
-        }
-
-        created = backup.beginAsString();
-        sizeString = S9sFormat::toSizeString(fullSize);
-
-        idFormat.printf(id);
-        if (parentId > 0)
-            parentIdFormat.printf(parentId);
-        else
-            parentIdFormat.printf("-");
-
-        cidFormat.printf(clusterId);
-        verifyFormat.printf(verifyFlag);
-        
-        if (hasInc && hasNotInc)
-            printf("B ");
-        else if (hasInc)
-            printf("I ");
-        else if (hasNotInc)
-            printf("F ");
-        else 
-            printf("- ");
-
-        printf("%s", backup.statusColorBegin(syntaxHighlight));
-        stateFormat.printf(status);
-        printf("%s", backup.statusColorEnd(syntaxHighlight));
-
-        printf("%s", userColorBegin());
-        ownerFormat.printf(owner);
-        printf("%s", userColorEnd());
-
-        printf("%s", ipColorBegin());
-        hostNameFormat.printf(hostName);
-        printf("%s", ipColorEnd());
-        
-        createdFormat.printf(created);
-        sizeFormat.printf(sizeString);
-        printf("%s", STR(backup.title()));
-        printf("\n");
-    }
+    output = renderer.render(renderBackupRow, columns);
+    printf("%s", STR(output));
 
     /*
      * Footer.
@@ -8911,9 +9110,8 @@ S9sRpcReply::printBackupListDatabasesLong()
      */
     for (uint idx = 0; idx < dataList.size(); ++idx)
     {
-        S9sVariantMap  theMap    = dataList[idx].toVariantMap();
-        S9sBackup      backup    = theMap;
-        S9sVariantList backups   = theMap["backup"].toVariantList();
+        S9sBackup      backup    = dataList[idx].toVariantMap();
+        int            nBackups  = backup.nBackups();
         S9sString      hostName  = backup.backupHost();
         int            clusterId = backup.clusterId(); 
         S9sString      verifyFlag = backup.verificationFlag();
@@ -8935,7 +9133,7 @@ S9sRpcReply::printBackupListDatabasesLong()
         verifyFormat.widen(verifyFlag);
         incrementalFormat.widen("-");
         
-        if (backups.size() == 0u)
+        if (nBackups == 0)
         {
             S9sString     sizeString    = "-";
             S9sString     createdString = "-";
@@ -8946,7 +9144,7 @@ S9sRpcReply::printBackupListDatabasesLong()
             continue;
         }
 
-        for (int backupIdx = 0; backupIdx < backup.nBackups(); ++backupIdx)
+        for (int backupIdx = 0; backupIdx < nBackups; ++backupIdx)
         {
             idFormat.widen(id);
             parentIdFormat.widen(parentId);
@@ -8997,9 +9195,8 @@ S9sRpcReply::printBackupListDatabasesLong()
      */
     for (uint idx = 0; idx < dataList.size(); ++idx)
     {
-        S9sVariantMap  theMap    = dataList[idx].toVariantMap();
-        S9sBackup      backup    = theMap;
-        S9sVariantList backups   = theMap["backup"].toVariantList();
+        S9sBackup      backup    = dataList[idx].toVariantMap();
+        int            nBackups  = backup.nBackups();
         S9sString      hostName  = backup.backupHost();
         int            clusterId = backup.clusterId();
         S9sString      verifyFlag = backup.verificationFlag();
@@ -9023,7 +9220,7 @@ S9sRpcReply::printBackupListDatabasesLong()
         /*
          *
          */
-        if (backups.size() == 0u)
+        if (nBackups == 0)
         {
             S9sString     database      = "-";
             S9sString     sizeString    = "-";
@@ -9061,7 +9258,7 @@ S9sRpcReply::printBackupListDatabasesLong()
             continue;
         }
 
-        for (int backupIdx = 0; backupIdx < backup.nBackups(); ++backupIdx)
+        for (int backupIdx = 0; backupIdx < nBackups; ++backupIdx)
         {
             S9sString databaseNames;
 
@@ -9159,16 +9356,14 @@ S9sRpcReply::printBackupListFilesBrief()
      */
     for (uint idx = 0; idx < dataList.size(); ++idx)
     {
-        S9sVariantMap  theMap    = dataList[idx].toVariantMap();
-        S9sVariantList backups   = theMap["backup"].toVariantList();
-        S9sString      root      = theMap["root_dir"].toString();
+        S9sBackup      theBackup = dataList[idx].toVariantMap();
+        int            nBackups  = theBackup.nBackups();
+        int            id        = theBackup.id();
+        S9sString      root      = theBackup.rootDir();
 
-        for (uint idx2 = 0; idx2 < backups.size(); ++idx2)
+        for (int idx2 = 0; idx2 < nBackups; ++idx2)
         {
-            S9sVariantMap  backup    = backups[idx2].toVariantMap();
-            S9sVariantList files     = backup["files"].toVariantList();
-            S9sBackup      theBackup = theMap;
-            int            id        = theBackup.id();
+            const S9sVariantList &files = theBackup.files(idx2);
         
             /*
              * Filtering.
@@ -9178,8 +9373,8 @@ S9sRpcReply::printBackupListFilesBrief()
 
             for (uint idx1 = 0; idx1 < files.size(); ++idx1)
             {
-                S9sVariantMap file = files[idx1].toVariantMap();
-                S9sString     path = file["path"].toString();
+                const S9sVariantMap &file = files[idx1].toVariantMap();
+                S9sString path = file.valueByPath("path").toString();
                 
                 if (options->fullPathRequested())
                 {
@@ -9237,9 +9432,8 @@ S9sRpcReply::printBackupListFilesLong()
      */
     for (uint idx = 0; idx < dataList.size(); ++idx)
     {
-        S9sVariantMap  theMap     = dataList[idx].toVariantMap();
-        S9sBackup      backup     = theMap;
-        S9sVariantList backups    = theMap["backup"].toVariantList();
+        S9sBackup      backup     = dataList[idx].toVariantMap();
+        int            nBackups   = backup.nBackups();
         S9sString      hostName   = backup.backupHost();
         int            clusterId  = backup.clusterId(); 
         S9sString      verifyFlag = backup.verificationFlag();
@@ -9265,7 +9459,7 @@ S9sRpcReply::printBackupListFilesLong()
         verifyFormat.widen(verifyFlag);
         incrementalFormat.widen("-");
         
-        if (backups.size() == 0u)
+        if (nBackups == 0)
         {
             S9sString     sizeString    = "-";
             S9sString     createdString = "-";
@@ -9276,7 +9470,7 @@ S9sRpcReply::printBackupListFilesLong()
             continue;
         }
 
-        for (int backupIdx = 0; backupIdx < backup.nBackups(); ++backupIdx)
+        for (int backupIdx = 0; backupIdx < nBackups; ++backupIdx)
         {
             idFormat.widen(id);
             parentIdFormat.widen(parentId);
@@ -9326,9 +9520,8 @@ S9sRpcReply::printBackupListFilesLong()
      */
     for (uint idx = 0; idx < dataList.size(); ++idx)
     {
-        S9sVariantMap  theMap    = dataList[idx].toVariantMap();
-        S9sBackup      backup    = theMap;
-        S9sVariantList backups   = theMap["backup"].toVariantList();
+        S9sBackup      backup    = dataList[idx].toVariantMap();
+        int            nBackups  = backup.nBackups();
         S9sString      hostName  = backup.backupHost();
         int            clusterId = backup.clusterId();
         S9sString      verifyFlag = backup.verificationFlag();
@@ -9347,7 +9540,7 @@ S9sRpcReply::printBackupListFilesLong()
         /*
          *
          */
-        if (backups.size() == 0u)
+        if (nBackups == 0)
         {
             S9sString     path          = "-";
             S9sString     sizeString    = "-";
@@ -9385,7 +9578,7 @@ S9sRpcReply::printBackupListFilesLong()
             continue;
         }
 
-        for (int backupIdx = 0; backupIdx < backup.nBackups(); ++backupIdx)
+        for (int backupIdx = 0; backupIdx < nBackups; ++backupIdx)
         {
             for (int fileIdx = 0; fileIdx < backup.nFiles(backupIdx); ++fileIdx)
             {
@@ -10140,37 +10333,28 @@ S9sRpcReply::printUserListLong()
 
 void
 S9sRpcReply::printCpuStatLine1()
+{
+    printCpuStatLine1(statFrame());
+}
+
+/**
+ * \param frame The CPU statistics.
+ *
+ * Prints the summary line of the CPU usage in the top UI.
+ */
+void
+S9sRpcReply::printCpuStatLine1(
+        const S9sStatFrame &frame)
 {
     S9sOptions      *options = S9sOptions::instance();
     bool             syntaxHighlight = options->useSyntaxHighlight();
-    S9sVariantList   theList = operator[]("data").toVariantList();
-    S9sVariantMap    listMap;
     const char      *numberStart = "";
     const char      *numberEnd   = "";
-    S9sVariantMap    keys;
-    S9sMap<int, int> hostIds;
-    double           user  = 0.0;
-    double           sys   = 0.0;
-    double           idle  = 0.0;
-    double           wait  = 0.0;
-    double           steal = 0.0;
-
-
-    for (uint idx = 0; idx < theList.size(); ++idx)
-    {
-        S9sVariantMap theMap  = theList[idx].toVariantMap();
-        S9sString     key     = theMap["samplekey"].toString();
-        ulonglong     created = theMap["created"].toULongLong();
-
-        if (!listMap.contains(key))
-        {
-            listMap[key] = theMap;
-            continue;
-        }
-
-        if (listMap[key]["created"].toULongLong() < created)
-            listMap[key] = theMap;
-    }
+    double           user  = frame.average(S9sStatFrame::User)   * 100.0;
+    double           sys   = frame.average(S9sStatFrame::Sys)    * 100.0;
+    double           idle  = frame.average(S9sStatFrame::Idle)   * 100.0;
+    double           wait  = frame.average(S9sStatFrame::IoWait) * 100.0;
+    double           steal = frame.average(S9sStatFrame::Steal)  * 100.0;
 
     if (syntaxHighlight)
     {
@@ -10178,41 +10362,8 @@ S9sRpcReply::printCpuStatLine1()
         numberEnd   = TERM_NORMAL;
     }
 
-
-    foreach (const S9sVariant variant, listMap)
-    {
-        S9sVariantMap theMap    = variant.toVariantMap();
-        int           hostId    = theMap["hostid"].toInt();
-        double        thisUser  = theMap["user"].toDouble();
-        double        thisSys   = theMap["sys"].toDouble();
-        double        thisIdle  = theMap["idle"].toDouble();
-        double        thisWait  = theMap["iowait"].toDouble();
-        double        thisSteal = theMap["steal"].toDouble();
-        
-        //printf("-> \n%s\n", STR(theMap.toString()));
-        user  += thisUser;
-        sys   += thisSys;
-        idle  += thisIdle;
-        wait  += thisWait;
-        steal += thisSteal;
-
-        hostIds[hostId] = true;
-    }
-    
-    user  /= listMap.size();
-    sys   /= listMap.size();
-    idle  /= listMap.size();
-    wait  /= listMap.size();
-    steal /= listMap.size();
-
-    user  *= 100.0;
-    sys   *= 100.0;
-    idle  *= 100.0;
-    wait  *= 100.0;
-    steal *= 100.0;
-    
-    printf("%s%d%s hosts, ", numberStart, (int)hostIds.size(), numberEnd);
-    printf("%s%d%s cores,", numberStart, (int)listMap.size(), numberEnd);
+    printf("%s%d%s hosts, ", numberStart, (int) frame.nHosts(), numberEnd);
+    printf("%s%d%s cores,", numberStart, (int) frame.nRows(), numberEnd);
     printf("%s%5.1f%s us,",  numberStart, user, numberEnd);
     printf("%s%5.1f%s sy,", numberStart, sys, numberEnd);
     printf("%s%5.1f%s id,",  numberStart, idle, numberEnd);
@@ -10249,15 +10400,25 @@ S9sRpcReply::printCpuStatLine1()
  */
 void
 S9sRpcReply::printMemoryStatLine1()
+{
+    printMemoryStatLine1(statFrame());
+}
+
+/**
+ * \param frame The memory statistics.
+ *
+ * Prints the summary line of the memory usage in the top UI.
+ */
+void
+S9sRpcReply::printMemoryStatLine1(
+        const S9sStatFrame &frame)
 {
     S9sOptions     *options = S9sOptions::instance();
     bool            syntaxHighlight = options->useSyntaxHighlight();
-    S9sVariantList  theList    = operator[]("data").toVariantList();
-    double          sumTotal   = 0.0;
-    double          sumFree    = 0.0;
-    double          sumBuffers = 0.0;
-    double          sumCached  = 0.0;
-    S9sVariantMap   listMap;
+    double          sumTotal   = frame.sum(S9sStatFrame::RamTotal);
+    double          sumFree    = frame.sum(S9sStatFrame::RamFree);
+    double          sumBuffers = frame.sum(S9sStatFrame::RamBuffers);
+    double          sumCached  = frame.sum(S9sStatFrame::RamCached);
     const char     *numberStart = "";
     const char     *numberEnd   = "";
     
@@ -10267,36 +10428,6 @@ S9sRpcReply::printMemoryStatLine1()
         numberEnd   = TERM_NORMAL;
     }
 
-    for (uint idx = 0; idx < theList.size(); ++idx)
-    {
-        S9sVariantMap theMap  = theList[idx].toVariantMap();
-        S9sString     key     = theMap["samplekey"].toString();
-        ulonglong     created = theMap["created"].toULongLong();
-
-        if (!listMap.contains(key))
-        {
-            listMap[key] = theMap;
-            continue;
-        }
-
-        if (listMap[key]["created"].toULongLong() < created)
-            listMap[key] = theMap;
-    }
-    
-    foreach (const S9sVariant variant, listMap)
-    {
-        S9sVariantMap theMap    = variant.toVariantMap();
-        ulonglong     total     = theMap["ramtotal"].toULongLong();
-        ulonglong     free      = theMap["ramfree"].toULongLong();
-        ulonglong     buffers   = theMap["rambuffers"].toULongLong();
-        ulonglong     cached    = theMap["ramcached"].toULongLong();
-
-        sumTotal   += total;
-        sumFree    += free;
-        sumBuffers += buffers;
-        sumCached  += cached;
-    }
-
     sumTotal   /= 1024 * 1024 * 1024.0;
     sumFree    /= 1024 * 1024 * 1024.0;
     sumBuffers /= 1024 * 1024 * 1024.0;
@@ -10312,13 +10443,23 @@ S9sRpcReply::printMemoryStatLine1()
 
 void
 S9sRpcReply::printMemoryStatLine2()
+{
+    printMemoryStatLine2(statFrame());
+}
+
+/**
+ * \param frame The memory statistics.
+ *
+ * Prints the summary line of the swap usage in the top UI.
+ */
+void
+S9sRpcReply::printMemoryStatLine2(
+        const S9sStatFrame &frame)
 {
     S9sOptions     *options = S9sOptions::instance();
     bool            syntaxHighlight = options->useSyntaxHighlight();
-    S9sVariantList  theList    = operator[]("data").toVariantList();
-    ulonglong       sumTotal   = 0ull;
-    ulonglong       sumFree    = 0ull;
-    S9sVariantMap   listMap;
+    ulonglong       sumTotal   = frame.sum(S9sStatFrame::SwapTotal);
+    ulonglong       sumFree    = frame.sum(S9sStatFrame::SwapFree);
     const char     *numberStart = "";
     const char     *numberEnd   = "";
         
@@ -10328,32 +10469,6 @@ S9sRpcReply::printMemoryStatLine2()
         numberEnd   = TERM_NORMAL;
     }
 
-    for (uint idx = 0; idx < theList.size(); ++idx)
-    {
-        S9sVariantMap theMap  = theList[idx].toVariantMap();
-        S9sString     key     = theMap["samplekey"].toString();
-        ulonglong     created = theMap["created"].toULongLong();
-
-        if (!listMap.contains(key))
-        {
-            listMap[key] = theMap;
-            continue;
-        }
-
-        if (listMap[key]["created"].toULongLong() < created)
-            listMap[key] = theMap;
-    }
-    
-    foreach (const S9sVariant variant, listMap)
-    {
-        S9sVariantMap theMap    = variant.toVariantMap();
-        ulonglong     total     = theMap["swaptotal"].toULongLong();
-        ulonglong     free      = theMap["swapfree"].toULongLong();
-
-        sumTotal   += total;
-        sumFree    += free;
-    }
-
     sumTotal   /= 1024 * 1024 * 1024;
     sumFree    /= 1024 * 1024 * 1024;
 
@@ -11144,11 +11259,7 @@ S9sRpcReply::printMetaTypePropertyListLong()
         {
             int remaining  = terminalWidth - nColumns;
             
-            if (remaining < (int) description.length())
-            {
-                description.resize(remaining - 1);
-                description += "…";
-            }
+            description.ellipsize(remaining);
         }
         
         statFormat.printf(stat);
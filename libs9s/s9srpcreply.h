@@ -31,6 +31,8 @@ class S9sCmonGraph;
 class S9sUser;
 class S9sServer;
 class S9sTreeNode;
+class S9sReplicationTopology;
+class S9sStatFrame;
 
 class S9sRpcReply : public S9sVariantMap
 {
@@ -101,6 +103,8 @@ class S9sRpcReply : public S9sVariantMap
         
         void printReplicationList();
         void printReplicationListCustom();
+        void printReplicationLagList(
+                const S9sReplicationTopology &topology);
 
         void printReportList();
         void printReportTemplateList();
@@ -111,7 +115,7 @@ class S9sRpcReply : public S9sVariantMap
         void printAlarmStatistics();
         void printConfigList();
         void printExtendedConfig();
-        void printLogList();
+        void printLogList(bool ascending = false);
         void printNodeList();
         void printJobList();
         void printBackupList();
@@ -194,6 +198,11 @@ class S9sRpcReply : public S9sVariantMap
         void printCpuStatLine1();
         void printMemoryStatLine1();
         void printMemoryStatLine2();
+        S9sStatFrame statFrame() const;
+
+        static void printCpuStatLine1(const S9sStatFrame &frame);
+        static void printMemoryStatLine1(const S9sStatFrame &frame);
+        static void printMemoryStatLine2(const S9sStatFrame &frame);
 
         void printScriptOutput();
         void printScriptBacktrace();
@@ -237,6 +246,7 @@ class S9sRpcReply : public S9sVariantMap
 
         static S9sString progressBar(double percent, bool syntaxHighlight);
         static S9sString progressBar(bool syntaxHighlight);
+        static S9sString lagTrend(const S9sVector<int> &samples);
 
         static bool useSyntaxHighLight() ;
 
@@ -285,8 +295,8 @@ class S9sRpcReply : public S9sVariantMap
         void printServersStat();
 
         
-        void printLogBrief();
-        void printLogLong();
+        void printLogBrief(bool ascending);
+        void printLogLong(bool ascending);
 
         void printConfigBrief();
         
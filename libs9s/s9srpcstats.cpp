@@ -0,0 +1,611 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9srpcstats.h"
+
+#include "S9sOptions"
+#include "S9sFile"
+#include "S9sArena"
+#include "S9sMutexLocker"
+
+#include <cstdio>
+#include <time.h>
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+/**
+ * We keep this many requests for the report, the long running UIs would
+ * otherwise collect them forever. The totals are not affected by this.
+ */
+#define MAX_RECORDS 1000
+
+/**
+ * The long running UIs are not writing the stats file more often than this
+ * (in microseconds).
+ */
+#define WRITE_INTERVAL 1000000ull
+
+/**
+ * The phases of the requests in the order they are happening.
+ */
+static const char *phaseNames[] = 
+{
+    "dns", "connect", "tls", "send", "first_byte", "transfer", "parse", 
+    "print", NULL
+};
+
+S9sVariantList S9sRpcStats::sm_records;
+S9sVariantMap  S9sRpcStats::sm_totals;
+ulonglong      S9sRpcStats::sm_lastId           = 0ull;
+ulonglong      S9sRpcStats::sm_lastWritten      = 0ull;
+bool           S9sRpcStats::sm_reportRequested  = false;
+S9sString      S9sRpcStats::sm_reportFormat;
+S9sString      S9sRpcStats::sm_statsFile;
+
+/*
+ * The statistics are shared by all the clients of the process and some of the
+ * clients are used in threads (e.g. the event readers). The functions using
+ * the statistics call each other, so the mutex is recursive.
+ */
+static S9sMutex statsMutex(true);
+
+/*
+ * The reply of a request is printed by the thread that sent it, these are the
+ * identifier of the last request the thread finished and the time the printing
+ * of its reply started (0 if the thread is not printing).
+ */
+static __thread ulonglong printedId    = 0ull;
+static __thread ulonglong printStarted = 0ull;
+
+static void
+addTo(
+        S9sVariant      &value,
+        const ulonglong  n)
+{
+    value = value.toULongLong() + n;
+}
+
+static S9sString
+milliseconds(
+        const S9sVariant &micros)
+{
+    S9sString retval;
+
+    retval.sprintf("%.2f", micros.toULongLong() / 1000.0);
+    return retval;
+}
+
+S9sRpcStats::S9sRpcStats() :
+    m_started(0ull),
+    m_lastMark(0ull)
+{
+}
+
+S9sRpcStats::~S9sRpcStats()
+{
+}
+
+/**
+ * \param operation The name of the operation, the statistics are summarized
+ *   by this.
+ *
+ * Starts the measuring of a new request. If the reply of the previous request
+ * was not printed by now (e.g. the thread was sleeping between two polls) the
+ * time passed is not counted as printing.
+ */
+void
+S9sRpcStats::start(
+        const S9sString &operation)
+{
+    if (!isEnabled())
+        return;
+
+    printStarted = 0ull;
+
+    m_record.clear();
+    m_record["operation"] = operation;
+    m_started  = now();
+    m_lastMark = m_started;
+}
+
+/**
+ * \param hostName The name of the controller the request is sent to.
+ * \param port The port of the controller.
+ */
+void
+S9sRpcStats::setController(
+        const S9sString &hostName,
+        const int        port)
+{
+    S9sString controller;
+
+    if (!isEnabled())
+        return;
+
+    controller.sprintf("%s:%d", STR(hostName), port);
+    m_record["controller"] = controller;
+}
+
+/**
+ * \param phaseName The name of the phase that just ended.
+ *
+ * The time passed since the previous phase ended (or the request was started)
+ * is added to the given phase. Phases that are repeated (e.g. connecting to
+ * the next controller after a failure) are summarized.
+ */
+void
+S9sRpcStats::phaseFinished(
+        const char *phaseName)
+{
+    ulonglong mark;
+
+    if (m_started == 0ull)
+        return;
+
+    mark = now();
+    addTo(m_record["phases"][phaseName], mark - m_lastMark);
+    m_lastMark = mark;
+}
+
+void
+S9sRpcStats::addBytesSent(
+        const ulonglong nBytes)
+{
+    if (m_started == 0ull)
+        return;
+
+    addTo(m_record["bytes_sent"], nBytes);
+}
+
+void
+S9sRpcStats::addBytesReceived(
+        const ulonglong nBytes)
+{
+    if (m_started == 0ull)
+        return;
+
+    addTo(m_record["bytes_received"], nBytes);
+}
+
+/**
+ * \param nAllocations The number of allocations the JSON parser made while
+ *   processing the reply.
+ */
+void
+S9sRpcStats::addAllocations(
+        const ulonglong nAllocations)
+{
+    if (m_started == 0ull)
+        return;
+
+    addTo(m_record["allocations"], nAllocations);
+}
+
+/**
+ * \param success True if the reply was received and processed.
+ *
+ * Closes the measuring of the request and stores the results. From this point
+ * on the thread is considered to be printing the reply until
+ * printingFinished() is called.
+ */
+void
+S9sRpcStats::finish(
+        const bool success)
+{
+    if (m_started == 0ull)
+        return;
+
+    m_record["success"] = success;
+    m_record["total"]   = now() - m_started;
+    m_started           = 0ull;
+
+    S9sMutexLocker locker(statsMutex);
+    storeRecord(m_record);
+    writeStatsFile(false);
+
+    printedId    = sm_lastId;
+    printStarted = now();
+}
+
+/**
+ * \returns True if the statistics should be collected, either because the
+ *   --stats or the --stats-file command line option was provided.
+ */
+bool
+S9sRpcStats::isEnabled()
+{
+    S9sOptions *options = S9sOptions::instance();
+
+    return options->isRpcStatsRequested() || !options->rpcStatsFile().empty();
+}
+
+/**
+ * \returns The requests that are measured (the last ones if there were many).
+ */
+S9sVariantList
+S9sRpcStats::records()
+{
+    S9sMutexLocker locker(statsMutex);
+
+    return sm_records;
+}
+
+/**
+ * Appends one counter with all the operations to the Prometheus text.
+ */
+static void
+appendCounter(
+        S9sString           &text,
+        const S9sVariantMap &totals,
+        const char          *metricName,
+        const char          *help,
+        const char          *key)
+{
+    S9sVector<S9sString> operations = totals.keys();
+    S9sString            line;
+
+    line.sprintf(
+            "# HELP %s %s\n"
+            "# TYPE %s counter\n",
+            metricName, help, metricName);
+
+    text += line;
+
+    for (uint idx = 0u; idx < operations.size(); ++idx)
+    {
+        const S9sVariantMap &total = 
+            totals.at(operations[idx]).toVariantMap();
+
+        line.sprintf("%s{operation=\"%s\"} %llu\n",
+                metricName, STR(operations[idx].escape()),
+                total.valueByPath(key).toULongLong());
+
+        text += line;
+    }
+}
+
+/**
+ * \returns The statistics summarized by the operations in the Prometheus text
+ *   exposition format.
+ */
+S9sString
+S9sRpcStats::prometheusText()
+{
+    S9sMutexLocker       locker(statsMutex);
+    S9sVector<S9sString> operations = sm_totals.keys();
+    S9sString            retval;
+    S9sString            line;
+
+    appendCounter(retval, sm_totals, 
+            "s9s_rpc_requests_total", 
+            "The number of RPC requests sent to the controller.",
+            "requests");
+    
+    appendCounter(retval, sm_totals, 
+            "s9s_rpc_failed_requests_total", 
+            "The number of RPC requests that failed.",
+            "failed");
+
+    retval += 
+        "# HELP s9s_rpc_phase_seconds_total "
+        "The time spent in the phases of the RPC requests.\n"
+        "# TYPE s9s_rpc_phase_seconds_total counter\n";
+
+    for (uint idx = 0u; idx < operations.size(); ++idx)
+    {
+        const S9sVariantMap &total  = 
+            sm_totals.at(operations[idx]).toVariantMap();
+        const S9sVariantMap &phases = 
+            total.valueByPath("phases").toVariantMap();
+
+        for (int phase = 0; phaseNames[phase] != NULL; ++phase)
+        {
+            const S9sVariant &micros = phases.valueByPath(phaseNames[phase]);
+
+            line.sprintf(
+                    "s9s_rpc_phase_seconds_total"
+                    "{operation=\"%s\",phase=\"%s\"} %.6f\n",
+                    STR(operations[idx].escape()), phaseNames[phase], 
+                    micros.toULongLong() / 1000000.0);
+
+            retval += line;
+        }
+    }
+
+    appendCounter(retval, sm_totals, 
+            "s9s_rpc_sent_bytes_total", 
+            "The number of bytes sent to the controller.",
+            "bytes_sent");
+    
+    appendCounter(retval, sm_totals, 
+            "s9s_rpc_received_bytes_total", 
+            "The number of bytes received from the controller.",
+            "bytes_received");
+    
+    appendCounter(retval, sm_totals, 
+            "s9s_rpc_parse_allocations_total", 
+            "The number of allocations made while parsing the replies.",
+            "allocations");
+
+    return retval;
+}
+
+/**
+ * \param path The path of the file to write.
+ * \param errorString The place to return the error message.
+ * \returns True if the file was written.
+ *
+ * Writes the statistics in the Prometheus text format. The file is written
+ * under a temporary name and then renamed, so the readers (e.g. the textfile
+ * collector of the node exporter) never see a half written file.
+ */
+bool
+S9sRpcStats::writePrometheusFile(
+        const S9sString &path,
+        S9sString       &errorString)
+{
+    S9sString tmpPath = path + ".tmp";
+    S9sFile   file(tmpPath);
+
+    if (!file.writeTxtFile(prometheusText()))
+    {
+        errorString = file.errorString();
+        return false;
+    }
+
+    if (::rename(STR(file.path()), STR(S9sFile(path).path())) != 0)
+    {
+        errorString.sprintf("Error renaming '%s': %m", STR(tmpPath));
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Should be called when the reply of the last request the thread finished is
+ * printed: the time passed since the request was finished is added to it as
+ * the time spent on printing.
+ */
+void
+S9sRpcStats::printingFinished()
+{
+    ulonglong elapsed;
+
+    if (printStarted == 0ull)
+        return;
+
+    elapsed      = now() - printStarted;
+    printStarted = 0ull;
+
+    S9sMutexLocker locker(statsMutex);
+
+    for (uint idx = sm_records.size(); idx > 0u; --idx)
+    {
+        S9sVariant &record = sm_records[idx - 1];
+        S9sString   operation;
+
+        if (record["id"].toULongLong() != printedId)
+            continue;
+
+        operation = record["operation"].toString();
+        addTo(record["phases"]["print"], elapsed);
+        addTo(sm_totals[operation]["phases"]["print"], elapsed);
+        break;
+    }
+}
+
+/**
+ * Prints the statistics of the requests to the standard error, so it does not
+ * mix with the normal output of the program. With --stats=json the records
+ * and the totals are printed as a JSon string.
+ */
+void
+S9sRpcStats::printReport()
+{
+    S9sMutexLocker locker(statsMutex);
+    S9sVariantMap  sums;
+
+    if (sm_reportFormat == "json")
+    {
+        S9sVariantMap  report;
+
+        report["requests"] = sm_records;
+        report["totals"]   = sm_totals;
+
+        ::fprintf(stderr, "%s\n", 
+                STR(report.toJsonString(S9sFormatIndent)));
+
+        return;
+    }
+
+    ::fprintf(stderr, 
+            "%-24s %-6s %8s %8s %8s %8s %8s %8s %8s %8s %9s %9s %9s %8s\n",
+            "OPERATION", "STATUS", "DNS", "CONNECT", "TLS", "SEND", 
+            "1STBYTE", "TRANSFER", "PARSE", "PRINT", "TOTAL", "SENT", 
+            "RECEIVED", "ALLOCS");
+
+    for (uint idx = 0u; idx < sm_records.size(); ++idx)
+    {
+        const S9sVariantMap &record = sm_records[idx].toVariantMap();
+        const S9sVariantMap &phases = 
+            record.valueByPath("phases").toVariantMap();
+        ulonglong            total  = 
+            record.valueByPath("total").toULongLong() + 
+            phases.valueByPath("print").toULongLong();
+
+        ::fprintf(stderr, "%-24s %-6s ", 
+                STR(record.valueByPath("operation").toString()),
+                record.valueByPath("success").toBoolean() ? "ok" : "failed");
+
+        for (int phase = 0; phaseNames[phase] != NULL; ++phase)
+        {
+            S9sVariant micros = phases.valueByPath(phaseNames[phase]);
+
+            ::fprintf(stderr, "%8s ", STR(milliseconds(micros)));
+            addTo(sums[phaseNames[phase]], micros.toULongLong());
+        }
+
+        ::fprintf(stderr, "%9s %9llu %9llu %8llu\n", 
+                STR(milliseconds(total)),
+                record.valueByPath("bytes_sent").toULongLong(),
+                record.valueByPath("bytes_received").toULongLong(),
+                record.valueByPath("allocations").toULongLong());
+    }
+
+    /*
+     * A summary on where the time went: waiting for the first byte is the
+     * controller's time, the client spends its time parsing and printing
+     * and the rest is the network.
+     */
+    ulonglong controller = sums["first_byte"].toULongLong();
+    ulonglong client     = 
+        sums["parse"].toULongLong() + sums["print"].toULongLong();
+    ulonglong network    = 
+        sums["dns"].toULongLong() + sums["connect"].toULongLong() + 
+        sums["tls"].toULongLong() + sums["send"].toULongLong() +
+        sums["transfer"].toULongLong();
+
+    ::fprintf(stderr, 
+            "Total %u request(s), controller %s ms, network %s ms, "
+            "client %s ms.\n",
+            (uint) sm_records.size(), 
+            STR(milliseconds(controller)),
+            STR(milliseconds(network)),
+            STR(milliseconds(client)));
+}
+
+/**
+ * This should be called once when the program is about to exit: prints the
+ * report if it is requested and writes the stats file for the last time. The
+ * options of the command that sent the last request are used, the options
+ * might be destroyed by now.
+ */
+void
+S9sRpcStats::finalize()
+{
+    S9sMutexLocker locker(statsMutex);
+
+    if (sm_totals.empty())
+        return;
+
+    if (sm_reportRequested)
+        printReport();
+
+    writeStatsFile(true);
+}
+
+/**
+ * Drops all the collected statistics.
+ */
+void
+S9sRpcStats::reset()
+{
+    S9sMutexLocker locker(statsMutex);
+
+    sm_records.clear();
+    sm_totals.clear();
+    sm_lastId          = 0ull;
+    sm_lastWritten     = 0ull;
+    sm_reportRequested = false;
+    sm_reportFormat.clear();
+    sm_statsFile.clear();
+}
+
+/**
+ * \returns The monotonic time in microseconds.
+ */
+ulonglong
+S9sRpcStats::now()
+{
+    struct timespec now;
+
+    ::clock_gettime(CLOCK_MONOTONIC, &now);
+    return (ulonglong) now.tv_sec * 1000000ull + now.tv_nsec / 1000;
+}
+
+/**
+ * \param record The record of the finished request, it gets an identifier
+ *   here.
+ *
+ * Stores the record and remembers how the statistics should be reported.
+ */
+void
+S9sRpcStats::storeRecord(
+        S9sVariantMap &record)
+{
+    S9sOptions *options   = S9sOptions::instance();
+    S9sString   operation = record.valueByPath("operation").toString();
+    S9sVariant &total     = sm_totals[operation];
+    const S9sVariantMap &phases = 
+        record.valueByPath("phases").toVariantMap();
+
+    addTo(total["requests"], 1ull);
+    
+    if (!record.valueByPath("success").toBoolean())
+        addTo(total["failed"], 1ull);
+
+    addTo(total["bytes_sent"], record.valueByPath("bytes_sent").toULongLong());
+    addTo(total["bytes_received"], 
+            record.valueByPath("bytes_received").toULongLong());
+    addTo(total["allocations"], 
+            record.valueByPath("allocations").toULongLong());
+
+    for (int phase = 0; phaseNames[phase] != NULL; ++phase)
+    {
+        addTo(total["phases"][phaseNames[phase]], 
+                phases.valueByPath(phaseNames[phase]).toULongLong());
+    }
+
+    record["id"]       = ++sm_lastId;
+    sm_reportRequested = options->isRpcStatsRequested();
+    sm_reportFormat    = options->rpcStatsFormat();
+    sm_statsFile       = options->rpcStatsFile();
+
+    if (sm_records.size() >= MAX_RECORDS)
+        sm_records.erase(sm_records.begin());
+
+    sm_records.push_back(record);
+}
+
+/**
+ * \param force If false the file is only written if it was not written
+ *   recently.
+ */
+void
+S9sRpcStats::writeStatsFile(
+        const bool force)
+{
+    S9sString   path = sm_statsFile;
+    S9sString   errorString;
+    ulonglong   mark;
+
+    if (path.empty())
+        return;
+
+    mark = now();
+    if (!force && mark - sm_lastWritten < WRITE_INTERVAL)
+        return;
+
+    sm_lastWritten = mark;
+    if (!writePrometheusFile(path, errorString))
+        PRINT_LOG("%s", STR(errorString));
+}
@@ -0,0 +1,86 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sVariantMap"
+#include "S9sVariantList"
+
+/**
+ * Timing and traffic statistics of the RPC requests sent to the controller.
+ * Every request is broken down to phases (DNS lookup, connect, TLS handshake,
+ * sending, waiting for the first byte, transfer, JSON parsing and printing),
+ * so it can be seen if the time is spent on the controller, on the network or
+ * in the client.
+ *
+ * The statistics are printed when the program exits if the --stats command
+ * line option was provided and they are written in the Prometheus text format
+ * into the file set by --stats-file, the long running UIs are refreshing this
+ * file as they go.
+ */
+class S9sRpcStats
+{
+    public:
+        S9sRpcStats();
+        virtual ~S9sRpcStats();
+
+        void start(const S9sString &operation);
+
+        void setController(
+                const S9sString &hostName,
+                const int        port);
+
+        void phaseFinished(const char *phaseName);
+        void addBytesSent(const ulonglong nBytes);
+        void addBytesReceived(const ulonglong nBytes);
+        void addAllocations(const ulonglong nAllocations);
+        void finish(const bool success);
+
+        const S9sVariantMap &toVariantMap() const { return m_record; };
+
+        static bool isEnabled();
+        static S9sVariantList records();
+        static S9sString prometheusText();
+        static bool writePrometheusFile(
+                const S9sString &path, 
+                S9sString       &errorString);
+
+        static void printingFinished();
+        static void printReport();
+        static void finalize();
+        static void reset();
+
+    private:
+        static ulonglong now();
+        static void storeRecord(S9sVariantMap &record);
+        static void writeStatsFile(const bool force);
+
+    private:
+        S9sVariantMap           m_record;
+        ulonglong               m_started;
+        ulonglong               m_lastMark;
+
+        static S9sVariantList   sm_records;
+        static S9sVariantMap    sm_totals;
+        static ulonglong        sm_lastId;
+        static ulonglong        sm_lastWritten;
+        static bool             sm_reportRequested;
+        static S9sString        sm_reportFormat;
+        static S9sString        sm_statsFile;
+};
@@ -0,0 +1,759 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9sscreenbuffer.h"
+
+#include <string.h>
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+/*
+ * The colors are stored in one integer: 0 is the default color, 1-8 are the
+ * basic colors, 9-16 are the bright colors, the 256 color palette and the 24
+ * bit colors are marked with the flags below.
+ */
+#define COLOR_PALETTE   0x100
+#define COLOR_RGB       0x1000000
+
+/*
+ * Cursor movements shorter than this are done by printing the unchanged
+ * characters again instead of sending an escape sequence.
+ */
+#define MAX_REPRINT     4
+
+S9sScreenBuffer::Attribute::Attribute() :
+    m_styles(0u),
+    m_foreground(0),
+    m_background(0)
+{
+}
+
+bool
+S9sScreenBuffer::Attribute::operator==(
+        const Attribute &rhs) const
+{
+    return 
+        m_styles == rhs.m_styles && 
+        m_foreground == rhs.m_foreground &&
+        m_background == rhs.m_background;
+}
+
+bool
+S9sScreenBuffer::Attribute::operator!=(
+        const Attribute &rhs) const
+{
+    return !(*this == rhs);
+}
+
+/**
+ * \param params The numerical parameters of an SGR ("ESC [ ... m") sequence.
+ *
+ * Modifies the attribute the same way the terminal would do.
+ */
+void
+S9sScreenBuffer::Attribute::setSgr(
+        const S9sVector<int> &params)
+{
+    if (params.empty())
+    {
+        *this = Attribute();
+        return;
+    }
+
+    for (uint idx = 0u; idx < params.size(); ++idx)
+    {
+        int  param = params[idx];
+        int *color = NULL;
+
+        if (param == 0)
+            *this = Attribute();
+        else if (param >= 1 && param <= 9)
+            m_styles |= 1u << param;
+        else if (param == 21)
+            m_styles &= ~(1u << 1);
+        else if (param == 22)
+            m_styles &= ~((1u << 1) | (1u << 2));
+        else if (param >= 23 && param <= 29)
+            m_styles &= ~(1u << (param - 20));
+        else if (param >= 30 && param <= 37)
+            m_foreground = param - 29;
+        else if (param == 39)
+            m_foreground = 0;
+        else if (param >= 40 && param <= 47)
+            m_background = param - 39;
+        else if (param == 49)
+            m_background = 0;
+        else if (param >= 90 && param <= 97)
+            m_foreground = param - 81;
+        else if (param >= 100 && param <= 107)
+            m_background = param - 91;
+        else if (param == 38)
+            color = &m_foreground;
+        else if (param == 48)
+            color = &m_background;
+
+        if (color == NULL)
+            continue;
+
+        // The extended colors: "38;5;N" and "38;2;R;G;B".
+        if (idx + 2 < params.size() && params[idx + 1] == 5)
+        {
+            *color = COLOR_PALETTE | (params[idx + 2] & 0xff);
+            idx += 2;
+        } else if (idx + 4 < params.size() && params[idx + 1] == 2)
+        {
+            *color = COLOR_RGB | 
+                ((params[idx + 2] & 0xff) << 16) |
+                ((params[idx + 3] & 0xff) << 8) |
+                (params[idx + 4] & 0xff);
+
+            idx += 4;
+        } else {
+            break;
+        }
+    }
+}
+
+static void
+appendColor(
+        S9sString &sequence,
+        int        base,
+        int        color)
+{
+    S9sString tmp;
+
+    if (color == 0)
+        return;
+    else if (color <= 8)
+        tmp.sprintf(";%d", base + color - 1);
+    else if (color <= 16)
+        tmp.sprintf(";%d", base + 60 + color - 9);
+    else if (color & COLOR_RGB)
+        tmp.sprintf(";%d;2;%d;%d;%d", base + 8, 
+                (color >> 16) & 0xff, (color >> 8) & 0xff, color & 0xff);
+    else 
+        tmp.sprintf(";%d;5;%d", base + 8, color & 0xff);
+
+    sequence += tmp;
+}
+
+/**
+ * \returns The SGR escape sequence that sets this attribute regardless of the
+ *   attribute the terminal had before.
+ */
+S9sString
+S9sScreenBuffer::Attribute::toSgr() const
+{
+    S9sString retval = "\033[0";
+
+    for (int style = 1; style <= 9; ++style)
+    {
+        if (m_styles & (1u << style))
+        {
+            retval += ';';
+            retval += (char) ('0' + style);
+        }
+    }
+
+    appendColor(retval, 30, m_foreground);
+    appendColor(retval, 40, m_background);
+    retval += 'm';
+
+    return retval;
+}
+
+S9sScreenBuffer::Cell::Cell()
+{
+    m_text[0] = ' ';
+    m_text[1] = '\0';
+}
+
+bool
+S9sScreenBuffer::Cell::operator==(
+        const Cell &rhs) const
+{
+    return 
+        strcmp(m_text, rhs.m_text) == 0 && 
+        m_attribute == rhs.m_attribute;
+}
+
+bool
+S9sScreenBuffer::Cell::operator!=(
+        const Cell &rhs) const
+{
+    return !(*this == rhs);
+}
+
+S9sScreenBuffer::S9sScreenBuffer() :
+    m_columns(0),
+    m_rows(0),
+    m_fullRedraw(true),
+    m_autoWrap(false),
+    m_cursorX(0),
+    m_cursorY(0),
+    m_savedX(0),
+    m_savedY(0),
+    m_terminalX(-1),
+    m_terminalY(-1)
+{
+}
+
+S9sScreenBuffer::~S9sScreenBuffer()
+{
+}
+
+/**
+ * \param columns The width of the terminal.
+ * \param rows The height of the terminal.
+ *
+ * Sets the size of the emulated screen. If the size is changed the whole
+ * screen will be repainted on the next render().
+ */
+void
+S9sScreenBuffer::resize(
+        int columns,
+        int rows)
+{
+    if (columns == m_columns && rows == m_rows)
+        return;
+
+    m_columns = columns > 0 ? columns : 0;
+    m_rows    = rows > 0 ? rows : 0;
+
+    m_back.assign(m_columns * m_rows, Cell());
+    m_front.assign(m_columns * m_rows, Cell());
+
+    if (m_cursorX >= m_columns)
+        m_cursorX = m_columns > 0 ? m_columns - 1 : 0;
+    
+    if (m_cursorY >= m_rows)
+        m_cursorY = m_rows > 0 ? m_rows - 1 : 0;
+
+    invalidate();
+}
+
+/**
+ * The content of the terminal is unknown (e.g. something else printed on it),
+ * the next render() will repaint the whole screen.
+ */
+void
+S9sScreenBuffer::invalidate()
+{
+    m_fullRedraw = true;
+}
+
+int
+S9sScreenBuffer::columns() const
+{
+    return m_columns;
+}
+
+int
+S9sScreenBuffer::rows() const
+{
+    return m_rows;
+}
+
+S9sScreenBuffer::Cell &
+S9sScreenBuffer::cell(
+        int column,
+        int row)
+{
+    return m_back[row * m_columns + column];
+}
+
+void
+S9sScreenBuffer::write(
+        const S9sString &text)
+{
+    write(text.c_str(), text.length());
+}
+
+/**
+ * \param data The characters and the escape sequences printed by the UI.
+ * \param length The number of bytes in the data.
+ *
+ * Processes the output of the UI the same way the terminal would do and
+ * updates the back buffer.
+ */
+void
+S9sScreenBuffer::write(
+        const char *data, 
+        size_t      length)
+{
+    size_t idx = 0;
+
+    if (m_columns == 0 || m_rows == 0)
+        return;
+
+    while (idx < length)
+    {
+        unsigned char c = data[idx];
+        int           charLength;
+
+        if (c == 0x1b)
+        {
+            idx = parseEscape(data, length, idx);
+            continue;
+        } else if (c == '\r')
+        {
+            m_cursorX = 0;
+        } else if (c == '\n')
+        {
+            lineFeed();
+        } else if (c == '\b')
+        {
+            if (m_cursorX > 0)
+                --m_cursorX;
+        } else if (c == '\t')
+        {
+            m_cursorX = (m_cursorX / 8 + 1) * 8;
+            if (m_cursorX >= m_columns)
+                m_cursorX = m_columns - 1;
+        } 
+        
+        if (c < 0x20 || c == 0x7f)
+        {
+            ++idx;
+            continue;
+        }
+
+        // One UTF-8 encoded character.
+        if (c >= 0xf0)
+            charLength = 4;
+        else if (c >= 0xe0)
+            charLength = 3;
+        else if (c >= 0xc0)
+            charLength = 2;
+        else
+            charLength = 1;
+
+        if (idx + charLength > length)
+            break;
+
+        putChar(data + idx, charLength);
+        idx += charLength;
+    }
+}
+
+/**
+ * Puts one character into the current cursor position of the back buffer.
+ */
+void
+S9sScreenBuffer::putChar(
+        const char *text,
+        int         length)
+{
+    if (m_cursorX >= m_columns)
+    {
+        if (m_autoWrap)
+        {
+            m_cursorX = 0;
+            lineFeed();
+        } else {
+            m_cursorX = m_columns - 1;
+        }
+    }
+
+    Cell &theCell = cell(m_cursorX, m_cursorY);
+
+    memcpy(theCell.m_text, text, length);
+    theCell.m_text[length] = '\0';
+    theCell.m_attribute    = m_attribute;
+
+    ++m_cursorX;
+}
+
+void
+S9sScreenBuffer::lineFeed()
+{
+    if (m_cursorY < m_rows - 1)
+    {
+        ++m_cursorY;
+        return;
+    }
+
+    // Scrolling up the whole screen.
+    for (int row = 1; row < m_rows; ++row)
+    {
+        for (int column = 0; column < m_columns; ++column)
+            cell(column, row - 1) = cell(column, row);
+    }
+
+    erase(m_rows - 1, 0, m_columns - 1);
+}
+
+/**
+ * Erases the cells of the given row between the two columns (inclusive). The
+ * erased cells get the current background color as the terminals do.
+ */
+void
+S9sScreenBuffer::erase(
+        int row,
+        int first,
+        int last)
+{
+    Cell blank;
+
+    blank.m_attribute.m_background = m_attribute.m_background;
+
+    if (first < 0)
+        first = 0;
+
+    if (last >= m_columns)
+        last = m_columns - 1;
+
+    for (int column = first; column <= last; ++column)
+        cell(column, row) = blank;
+}
+
+void
+S9sScreenBuffer::eraseDisplay(
+        int mode)
+{
+    int cursorX = m_cursorX < m_columns ? m_cursorX : m_columns - 1;
+
+    if (mode == 0)
+    {
+        erase(m_cursorY, cursorX, m_columns - 1);
+        for (int row = m_cursorY + 1; row < m_rows; ++row)
+            erase(row, 0, m_columns - 1);
+    } else if (mode == 1)
+    {
+        for (int row = 0; row < m_cursorY; ++row)
+            erase(row, 0, m_columns - 1);
+
+        erase(m_cursorY, 0, cursorX);
+    } else {
+        for (int row = 0; row < m_rows; ++row)
+            erase(row, 0, m_columns - 1);
+    }
+}
+
+/**
+ * \param data The output of the UI.
+ * \param length The length of the data.
+ * \param idx The index of the escape character that starts the sequence.
+ * \returns The index of the first byte after the sequence.
+ */
+size_t
+S9sScreenBuffer::parseEscape(
+        const char *data,
+        size_t      length,
+        size_t      idx)
+{
+    size_t start = idx;
+
+    if (idx + 1 >= length)
+        return length;
+
+    if (data[idx + 1] == '[')
+    {
+        // Control sequence: ESC [ [?] params final
+        S9sVector<int> params;
+        char           privateMarker = '\0';
+        int            param = 0;
+        bool           hasParam = false;
+
+        idx += 2;
+        if (idx < length && (data[idx] == '?' || data[idx] == '>'))
+            privateMarker = data[idx++];
+
+        for (; idx < length; ++idx)
+        {
+            char c = data[idx];
+
+            if (c >= '0' && c <= '9')
+            {
+                param    = param * 10 + (c - '0');
+                hasParam = true;
+            } else if (c == ';')
+            {
+                params << param;
+                param    = 0;
+                hasParam = false;
+            } else if (c >= 0x40 && c <= 0x7e)
+            {
+                if (hasParam || !params.empty())
+                    params << param;
+
+                if (privateMarker != '\0')
+                {
+                    if (privateMarker == '?' && params.size() == 1 && 
+                            params[0] == 7)
+                    {
+                        m_autoWrap = c == 'h';
+                    }
+
+                    m_passThrough.append(data + start, idx + 1 - start);
+                } else {
+                    executeCsi(params, c);
+                }
+
+                return idx + 1;
+            }
+        }
+
+        return length;
+    } else if (data[idx + 1] == ']')
+    {
+        // Operating system command, terminated by BEL or ESC '\'.
+        for (idx += 2; idx < length; ++idx)
+        {
+            if (data[idx] == '\007')
+                break;
+
+            if (data[idx] == 0x1b && idx + 1 < length && data[idx + 1] == '\\')
+            {
+                ++idx;
+                break;
+            }
+        }
+
+        if (idx >= length)
+            return length;
+
+        m_passThrough.append(data + start, idx + 1 - start);
+        return idx + 1;
+    } else if (data[idx + 1] == '(' || data[idx + 1] == ')')
+    {
+        // Character set selection.
+        if (idx + 2 >= length)
+            return length;
+
+        m_passThrough.append(data + start, 3);
+        return idx + 3;
+    } else if (data[idx + 1] == '7')
+    {
+        m_savedX = m_cursorX;
+        m_savedY = m_cursorY;
+    } else if (data[idx + 1] == '8')
+    {
+        m_cursorX = m_savedX;
+        m_cursorY = m_savedY;
+    }
+
+    return idx + 2;
+}
+
+/**
+ * Executes one control sequence on the emulated screen.
+ */
+void
+S9sScreenBuffer::executeCsi(
+        const S9sVector<int>  &params,
+        char                   command)
+{
+    int param1 = params.size() > 0 ? params[0] : 0;
+    int param2 = params.size() > 1 ? params[1] : 0;
+    int count  = param1 > 0 ? param1 : 1;
+
+    switch (command)
+    {
+        case 'm':
+            m_attribute.setSgr(params);
+            break;
+
+        case 'H':
+        case 'f':
+            m_cursorY = (param1 > 0 ? param1 : 1) - 1;
+            m_cursorX = (param2 > 0 ? param2 : 1) - 1;
+            break;
+
+        case 'A':
+            m_cursorY -= count;
+            break;
+
+        case 'B':
+            m_cursorY += count;
+            break;
+
+        case 'C':
+            m_cursorX += count;
+            break;
+
+        case 'D':
+            if (m_cursorX >= m_columns)
+                m_cursorX = m_columns - 1;
+
+            m_cursorX -= count;
+            break;
+
+        case 'G':
+            m_cursorX = count - 1;
+            break;
+
+        case 'd':
+            m_cursorY = count - 1;
+            break;
+
+        case 'K':
+            if (m_cursorX < m_columns || param1 != 0)
+            {
+                if (param1 == 0)
+                    erase(m_cursorY, m_cursorX, m_columns - 1);
+                else if (param1 == 1)
+                    erase(m_cursorY, 0, m_cursorX);
+                else
+                    erase(m_cursorY, 0, m_columns - 1);
+            }
+            break;
+
+        case 'J':
+            eraseDisplay(param1);
+            break;
+
+        case 's':
+            m_savedX = m_cursorX;
+            m_savedY = m_cursorY;
+            break;
+
+        case 'u':
+            m_cursorX = m_savedX;
+            m_cursorY = m_savedY;
+            break;
+    }
+
+    if (m_cursorX < 0)
+        m_cursorX = 0;
+    else if (m_cursorX > m_columns - 1 && command != 'm')
+        m_cursorX = m_columns - 1;
+
+    if (m_cursorY < 0)
+        m_cursorY = 0;
+    else if (m_cursorY > m_rows - 1)
+        m_cursorY = m_rows - 1;
+}
+
+/**
+ * Adds the shortest sequence we know to move the cursor of the terminal to the
+ * given position.
+ */
+void
+S9sScreenBuffer::moveTerminalCursor(
+        S9sString &output,
+        int        column,
+        int        row)
+{
+    S9sString sequence;
+
+    if (m_terminalX == column && m_terminalY == row)
+        return;
+
+    if (m_terminalY == row && m_terminalX >= 0 && column > m_terminalX &&
+            column - m_terminalX <= MAX_REPRINT)
+    {
+        bool canReprint = true;
+
+        for (int x = m_terminalX; x < column; ++x)
+        {
+            const Cell &theCell = m_front[row * m_columns + x];
+
+            if (theCell.m_attribute != m_terminalAttribute)
+            {
+                canReprint = false;
+                break;
+            }
+        }
+
+        if (canReprint)
+        {
+            for (int x = m_terminalX; x < column; ++x)
+                output += m_front[row * m_columns + x].m_text;
+
+            m_terminalX = column;
+            return;
+        }
+    }
+
+    if (m_terminalY >= 0 && row == m_terminalY + 1 && column == 0)
+    {
+        output += "\r\n";
+    } else {
+        sequence.sprintf("\033[%d;%dH", row + 1, column + 1);
+        output += sequence;
+    }
+
+    m_terminalX = column;
+    m_terminalY = row;
+}
+
+/**
+ * \returns The characters and escape sequences that should be sent to the
+ *   terminal to show the content of the back buffer.
+ *
+ * Compares the back buffer with the front buffer and returns only the changed
+ * cells, then the front buffer is updated. The returned string should be
+ * written to the terminal at once.
+ */
+S9sString
+S9sScreenBuffer::render()
+{
+    S9sString retval = m_passThrough;
+
+    m_passThrough.clear();
+    if (m_columns == 0 || m_rows == 0)
+        return retval;
+
+    if (m_fullRedraw)
+    {
+        // The terminal is cleared, all the cells are blank now.
+        retval += "\033[0m\033[2J";
+        
+        m_front.assign(m_columns * m_rows, Cell());
+        m_terminalAttribute = Attribute();
+        m_terminalX  = -1;
+        m_terminalY  = -1;
+        m_fullRedraw = false;
+    }
+
+    for (int row = 0; row < m_rows; ++row)
+    {
+        for (int column = 0; column < m_columns; ++column)
+        {
+            int         index = row * m_columns + column;
+            const Cell &back  = m_back[index];
+
+            if (back == m_front[index])
+                continue;
+
+            moveTerminalCursor(retval, column, row);
+
+            if (back.m_attribute != m_terminalAttribute)
+            {
+                retval += back.m_attribute.toSgr();
+                m_terminalAttribute = back.m_attribute;
+            }
+
+            retval         += back.m_text;
+            m_front[index]  = back;
+            ++m_terminalX;
+        }
+    }
+
+    // Leaving the cursor where the UI left it.
+    moveTerminalCursor(
+            retval, 
+            m_cursorX < m_columns ? m_cursorX : m_columns - 1, 
+            m_cursorY);
+
+    return retval;
+}
@@ -0,0 +1,117 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sString"
+#include "S9sVector"
+
+/**
+ * A class that emulates the terminal screen in memory. The screen oriented UIs
+ * print the whole screen in every refresh cycle; this class receives that
+ * output, tracks which character cells are actually changed and produces the
+ * escape sequences that update only those cells on the terminal.
+ *
+ * Two cell grids are kept: the back buffer holds the screen as the UI painted
+ * it, the front buffer holds what we know is on the terminal.
+ */
+class S9sScreenBuffer
+{
+    public:
+        S9sScreenBuffer();
+        virtual ~S9sScreenBuffer();
+
+        void resize(int columns, int rows);
+        void invalidate();
+
+        int columns() const;
+        int rows() const;
+
+        void write(const char *data, size_t length);
+        void write(const S9sString &text);
+
+        S9sString render();
+
+    private:
+        /**
+         * The text style and the colors of a character cell as set by the SGR
+         * escape sequences.
+         */
+        struct Attribute 
+        {
+            Attribute();
+
+            bool operator==(const Attribute &rhs) const;
+            bool operator!=(const Attribute &rhs) const;
+
+            void setSgr(const S9sVector<int> &params);
+            S9sString toSgr() const;
+
+            /** Bit 'n' is set if the SGR parameter 'n' (1-9) is in effect. */
+            uint   m_styles;
+            int    m_foreground;
+            int    m_background;
+        };
+
+        struct Cell
+        {
+            Cell();
+
+            bool operator==(const Cell &rhs) const;
+            bool operator!=(const Cell &rhs) const;
+
+            /** One UTF-8 encoded character. */
+            char       m_text[5];
+            Attribute  m_attribute;
+        };
+
+        Cell &cell(int column, int row);
+        void putChar(const char *text, int length);
+        void lineFeed();
+        void erase(int row, int first, int last);
+        void eraseDisplay(int mode);
+
+        size_t parseEscape(const char *data, size_t length, size_t idx);
+        void moveTerminalCursor(S9sString &output, int column, int row);
+
+        void executeCsi(const S9sVector<int> &params, char command);
+
+    private:
+        int               m_columns;
+        int               m_rows;
+        S9sVector<Cell>   m_back;
+        S9sVector<Cell>   m_front;
+        bool              m_fullRedraw;
+        bool              m_autoWrap;
+        
+        /** The cursor position and the attribute in the emulated screen. */
+        int               m_cursorX;
+        int               m_cursorY;
+        int               m_savedX;
+        int               m_savedY;
+        Attribute         m_attribute;
+
+        /** The cursor position and the attribute on the real terminal. */
+        int               m_terminalX;
+        int               m_terminalY;
+        Attribute         m_terminalAttribute;
+
+        /** Escape sequences that are sent to the terminal as they are. */
+        S9sString         m_passThrough;
+};
@@ -0,0 +1,597 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9sscript.h"
+
+#include "S9sOptions"
+#include "S9sFile"
+
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/wait.h>
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+/*
+ * The maximum number of background commands running at the same time. When
+ * there are more we wait for the oldest one before starting the next.
+ */
+#define MAX_WORKERS 8
+
+/*
+ * Copies the content of a temporary file the worker wrote into the given
+ * stream.
+ */
+static void
+copyOutput(
+        FILE *source,
+        FILE *destination)
+{
+    char   buffer[4096];
+    size_t nRead;
+
+    if (source == NULL)
+        return;
+
+    rewind(source);
+    while ((nRead = fread(buffer, 1, sizeof(buffer), source)) > 0)
+        fwrite(buffer, 1, nRead, destination);
+
+    fflush(destination);
+    fclose(source);
+}
+
+S9sScript::S9sScript()
+{
+}
+
+S9sScript::~S9sScript()
+{
+    waitWorkers();
+}
+
+/**
+ * \param argc The number of command line arguments.
+ * \param argv The command line arguments of the program.
+ * \param fileName The script file name is returned here, "-" if the script
+ *   should be read from the standard input.
+ * \param commonArguments The rest of the command line arguments are returned
+ *   here, these are added to every command in the script.
+ * \returns true if the --script command line option was provided.
+ */
+bool
+S9sScript::scriptRequested(
+        int             argc, 
+        char          **argv,
+        S9sString      &fileName,
+        S9sVariantList &commonArguments)
+{
+    bool retval = false;
+
+    fileName.clear();
+    commonArguments.clear();
+
+    for (int idx = 1; idx < argc; ++idx)
+    {
+        S9sString argument = argv[idx];
+
+        if (!retval && argument == "--script")
+        {
+            fileName = "-";
+            retval   = true;
+        } else if (!retval && argument.startsWith("--script="))
+        {
+            fileName = argument.substr(strlen("--script="));
+            retval   = true;
+        } else {
+            commonArguments << argument;
+        }
+    }
+
+    if (fileName.empty())
+        fileName = "-";
+
+    return retval;
+}
+
+/**
+ * \param fileName The name of the script file or "-" to read the script from
+ *   the standard input.
+ * \returns true if the script was read.
+ *
+ * The whole script is read before the first command is executed, so the
+ * commands and the workers can use the standard input freely. Lines ending with
+ * a backslash are continued in the next line.
+ */
+bool
+S9sScript::load(
+        const S9sString &fileName)
+{
+    S9sString content;
+    S9sString line;
+    int       lineNumber = 0;
+    int       firstLine  = 0;
+
+    m_fileName = fileName;
+    m_lines.clear();
+    m_lineNumbers.clear();
+
+    if (fileName == "-")
+    {
+        char    buffer[4096];
+        ssize_t nRead;
+
+        m_fileName = "stdin";
+        for (;;)
+        {
+            nRead = ::read(STDIN_FILENO, buffer, sizeof(buffer));
+            if (nRead < 0 && errno == EINTR)
+                continue;
+
+            if (nRead < 0)
+            {
+                m_errorString.sprintf(
+                        "Error reading the standard input: %m.");
+                return false;
+            }
+
+            if (nRead == 0)
+                break;
+
+            content.append(buffer, nRead);
+        }
+    } else {
+        S9sFile file(fileName);
+
+        if (!file.readTxtFile(content))
+        {
+            m_errorString = file.errorString();
+            return false;
+        }
+    }
+
+    for (size_t start = 0; start < content.length(); )
+    {
+        size_t    end  = content.find('\n', start);
+        S9sString text;
+
+        if (end == std::string::npos)
+            end = content.length();
+
+        text  = content.substr(start, end - start);
+        start = end + 1;
+        ++lineNumber;
+
+        if (line.empty())
+            firstLine = lineNumber;
+
+        if (text.endsWith("\\"))
+        {
+            line += text.substr(0, text.length() - 1);
+            continue;
+        }
+
+        line += text;
+        m_lines       << line;
+        m_lineNumbers.push_back(firstLine);
+        line.clear();
+    }
+
+    if (!line.empty())
+    {
+        m_lines       << line;
+        m_lineNumbers.push_back(firstLine);
+    }
+
+    S9S_DEBUG("Loaded %u commands from '%s'.", 
+            m_lines.size(), STR(m_fileName));
+
+    return true;
+}
+
+/**
+ * \param arguments The arguments that are added to the end of every command
+ *   line of the script (e.g. the controller and the user name).
+ */
+void
+S9sScript::setCommonArguments(
+        const S9sVariantList &arguments)
+{
+    m_commonArguments = arguments;
+}
+
+S9sString
+S9sScript::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * \param line One line of the script.
+ * \param arguments The command line arguments are returned here without the
+ *   program name.
+ * \param background Set to true if the line ends with an '&'.
+ * \param errorString The error message is returned here.
+ * \returns false if the line could not be parsed.
+ *
+ * Splits one line of a script into words the way a shell would do it with the
+ * basic quoting: single quotes, double quotes and backslash escapes. Comments
+ * starting with a '#' are ignored. The "s9s" program name at the beginning of
+ * the line is optional.
+ */
+bool
+S9sScript::parseLine(
+        const S9sString &line,
+        S9sVariantList  &arguments,
+        bool            &background,
+        S9sString       &errorString)
+{
+    enum { Plain, SingleQuoted, DoubleQuoted } state = Plain;
+    S9sString word;
+    bool      hasWord  = false;
+    bool      isQuoted = false;
+
+    arguments.clear();
+    background = false;
+
+    for (size_t idx = 0; idx <= line.length(); ++idx)
+    {
+        char c = idx < line.length() ? line[idx] : '\0';
+
+        if (state == SingleQuoted && c != '\0')
+        {
+            if (c == '\'')
+                state = Plain;
+            else
+                word += c;
+
+            continue;
+        } else if (state == DoubleQuoted && c != '\0')
+        {
+            if (c == '"')
+            {
+                state = Plain;
+            } else if (c == '\\' && idx + 1 < line.length() && 
+                    strchr("\"\\$`", line[idx + 1]) != NULL)
+            {
+                word += line[++idx];
+            } else {
+                word += c;
+            }
+
+            continue;
+        } else if (state != Plain)
+        {
+            errorString = "Unterminated quoted string.";
+            return false;
+        }
+
+        if (c == '\0' || c == ' ' || c == '\t' || c == '\r' || c == '#')
+        {
+            if (c == '#' && hasWord)
+            {
+                word += c;
+                continue;
+            }
+
+            if (hasWord)
+            {
+                if (background)
+                {
+                    errorString = "The '&' must be at the end of the line.";
+                    return false;
+                }
+
+                if (word == "&" && !isQuoted)
+                    background = true;
+                else
+                    arguments << word;
+            }
+
+            word.clear();
+            hasWord  = false;
+            isQuoted = false;
+
+            if (c == '#')
+                break;
+
+            continue;
+        }
+
+        hasWord = true;
+        if (c == '\'')
+        {
+            state    = SingleQuoted;
+            isQuoted = true;
+        } else if (c == '"')
+        {
+            state    = DoubleQuoted;
+            isQuoted = true;
+        } else if (c == '\\')
+        {
+            if (idx + 1 < line.length())
+                word += line[++idx];
+
+            isQuoted = true;
+        } else {
+            word += c;
+        }
+    }
+
+    if (!arguments.empty() && 
+            S9sFile::basename(arguments[0].toString()) == "s9s")
+    {
+        arguments.erase(arguments.begin());
+    }
+
+    if (background && arguments.empty())
+    {
+        errorString = "Missing command before '&'.";
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * \param function The function that executes one command line.
+ * \returns The exit code of the first command that failed or 0 if all the
+ *   commands were successful.
+ *
+ * Executes the commands of the script one by one. The execution stops at the
+ * first command that fails, but the background commands that are already
+ * running are waited for.
+ */
+int
+S9sScript::exec(
+        CommandFunction function)
+{
+    int retval = 0;
+
+    for (uint idx = 0u; idx < m_lines.size(); ++idx)
+    {
+        S9sString      line       = m_lines[idx].toString();
+        int            lineNumber = m_lineNumbers[idx];
+        S9sVariantList arguments;
+        bool           background;
+        S9sString      errorString;
+
+        if (!parseLine(line, arguments, background, errorString))
+        {
+            PRINT_ERROR("%s:%d: %s", 
+                    STR(m_fileName), lineNumber, STR(errorString));
+
+            retval = S9sOptions::BadOptions;
+            break;
+        }
+
+        if (arguments.empty())
+            continue;
+
+        for (uint idx1 = 0u; idx1 < m_commonArguments.size(); ++idx1)
+            arguments << m_commonArguments[idx1];
+
+        S9S_DEBUG("%s:%d: %s", STR(m_fileName), lineNumber, STR(line));
+
+        if (background)
+        {
+            // Keeping the number of workers limited, the oldest one is waited
+            // for, so the output is still printed in order.
+            if (m_workers.size() >= MAX_WORKERS)
+            {
+                retval = waitWorker(m_workers[0]);
+                m_workers.erase(m_workers.begin());
+
+                if (retval != 0)
+                    break;
+            }
+
+            if (startWorker(function, arguments, lineNumber))
+                continue;
+
+            // If we could not fork we execute the command in the foreground.
+            S9S_WARNING("%s", STR(m_errorString));
+        }
+
+        // The foreground commands might depend on the background commands
+        // started before and their output should come after those.
+        retval = waitWorkers();
+        if (retval != 0)
+            break;
+
+        retval = runCommand(function, arguments);
+        if (retval != 0)
+        {
+            PRINT_ERROR("%s:%d: Command failed with exit code %d.",
+                    STR(m_fileName), lineNumber, retval);
+            break;
+        }
+    }
+
+    if (retval == 0)
+        retval = waitWorkers();
+    else
+        waitWorkers();
+
+    return retval;
+}
+
+/**
+ * Executes one command line of the script in this process.
+ */
+int
+S9sScript::runCommand(
+        CommandFunction       function, 
+        const S9sVariantList &arguments)
+{
+    int    argc = arguments.size() + 1;
+    char **argv = new char *[argc + 1];
+    char **copy = new char *[argc];
+    int    retval;
+
+    argv[0] = strdup("s9s");
+    for (int idx = 1; idx < argc; ++idx)
+        argv[idx] = strdup(STR(arguments[idx - 1].toString()));
+
+    argv[argc] = NULL;
+
+    // The option parsing might permute the arguments.
+    for (int idx = 0; idx < argc; ++idx)
+        copy[idx] = argv[idx];
+
+    retval = function(argc, argv);
+
+    fflush(stdout);
+    fflush(stderr);
+
+    for (int idx = 0; idx < argc; ++idx)
+        free(copy[idx]);
+
+    delete[] copy;
+    delete[] argv;
+
+    return retval;
+}
+
+/**
+ * Forks a worker process that executes the command line in the background. The
+ * standard output and the standard error of the worker are sent into temporary
+ * files, so that the output can be printed in order later.
+ */
+bool
+S9sScript::startWorker(
+        CommandFunction       function, 
+        const S9sVariantList &arguments,
+        int                   lineNumber)
+{
+    Worker worker;
+    int    retval;
+
+    worker.lineNumber = lineNumber;
+    worker.out        = tmpfile();
+    worker.err        = tmpfile();
+
+    if (worker.out == NULL || worker.err == NULL)
+    {
+        m_errorString.sprintf("Error creating temporary file: %m.");
+
+        if (worker.out != NULL)
+            fclose(worker.out);
+
+        if (worker.err != NULL)
+            fclose(worker.err);
+
+        return false;
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+
+    worker.pid = fork();
+    if (worker.pid < 0)
+    {
+        m_errorString.sprintf("Error forking worker: %m.");
+        fclose(worker.out);
+        fclose(worker.err);
+        return false;
+    } else if (worker.pid == 0)
+    {
+        // The worker process.
+        dup2(fileno(worker.out), STDOUT_FILENO);
+        dup2(fileno(worker.err), STDERR_FILENO);
+
+        retval = runCommand(function, arguments);
+
+        // The _exit() does not call the atexit() handlers of the parent and
+        // does not flush the streams inherited from it, only our own output.
+        fflush(stdout);
+        fflush(stderr);
+        s9s_log_flush();
+        _exit(retval);
+    }
+
+    S9S_DEBUG("Started worker %d for line %d.", worker.pid, lineNumber);
+    m_workers.push_back(worker);
+
+    return true;
+}
+
+/**
+ * Waits for the worker to finish and prints its output.
+ *
+ * \returns The exit code of the command the worker executed.
+ */
+int
+S9sScript::waitWorker(
+        Worker &worker)
+{
+    int status = 0;
+    int retval = S9sOptions::Failed;
+
+    while (waitpid(worker.pid, &status, 0) < 0)
+    {
+        if (errno != EINTR)
+            break;
+    }
+
+    copyOutput(worker.out, stdout);
+    copyOutput(worker.err, stderr);
+    worker.out = NULL;
+    worker.err = NULL;
+
+    if (WIFEXITED(status))
+        retval = WEXITSTATUS(status);
+    else if (WIFSIGNALED(status))
+        retval = 128 + WTERMSIG(status);
+
+    if (retval != 0)
+    {
+        PRINT_ERROR("%s:%d: Command failed with exit code %d.",
+                STR(m_fileName), worker.lineNumber, retval);
+    }
+
+    return retval;
+}
+
+/**
+ * Waits for all the background commands in the order they were started.
+ *
+ * \returns The exit code of the first command that failed or 0.
+ */
+int
+S9sScript::waitWorkers()
+{
+    int retval = 0;
+
+    for (uint idx = 0u; idx < m_workers.size(); ++idx)
+    {
+        int exitCode = waitWorker(m_workers[idx]);
+
+        if (retval == 0)
+            retval = exitCode;
+    }
+
+    m_workers.clear();
+
+    return retval;
+}
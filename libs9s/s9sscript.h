@@ -0,0 +1,99 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sString"
+#include "S9sVariantList"
+#include "S9sVector"
+
+#include <cstdio>
+#include <sys/types.h>
+
+/**
+ * A class that executes a batch script (s9s --script=FILE). The script holds
+ * one s9s command line per line and all the commands are executed inside one
+ * process, so the commands share the authenticated session instead of logging
+ * in one by one. The options are re-created for every command.
+ *
+ * A command line that ends with an '&' is executed in a forked worker in the
+ * background. The output of the background commands is collected and printed
+ * in the order of the lines, when the next foreground command or the end of the
+ * script is reached.
+ */
+class S9sScript
+{
+    public:
+        typedef int (*CommandFunction)(int argc, char **argv);
+
+        S9sScript();
+        virtual ~S9sScript();
+
+        bool load(const S9sString &fileName);
+        int exec(CommandFunction function);
+
+        void setCommonArguments(const S9sVariantList &arguments);
+        S9sString errorString() const;
+
+        static bool 
+            scriptRequested(
+                int         argc, 
+                char      **argv,
+                S9sString  &fileName,
+                S9sVariantList &commonArguments);
+
+        static bool
+            parseLine(
+                const S9sString &line,
+                S9sVariantList  &arguments,
+                bool            &background,
+                S9sString       &errorString);
+
+    private:
+        class Worker
+        {
+            public:
+                Worker() : pid(0), lineNumber(0), out(NULL), err(NULL) {};
+
+                pid_t     pid;
+                int       lineNumber;
+                FILE     *out;
+                FILE     *err;
+        };
+
+        int runCommand(
+                CommandFunction       function, 
+                const S9sVariantList &arguments);
+
+        bool startWorker(
+                CommandFunction       function, 
+                const S9sVariantList &arguments,
+                int                   lineNumber);
+
+        int waitWorker(Worker &worker);
+        int waitWorkers();
+
+    private:
+        S9sString           m_fileName;
+        S9sVariantList      m_lines;
+        S9sVector<int>      m_lineNumbers;
+        S9sVariantList      m_commonArguments;
+        S9sVector<Worker>   m_workers;
+        S9sString           m_errorString;
+};
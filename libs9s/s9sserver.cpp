@@ -765,10 +765,14 @@ S9sServer::stateAsChar() const
     return '?';
 }
 
-S9sVariantList 
+/**
+ * \returns The list of the subnets the server has access to. The reference
+ *   points into the properties of the server, so the list is not copied.
+ */
+const S9sVariantList &
 S9sServer::subnets() const
 {
-    return property("subnets").toVariantList();
+    return m_properties.valueByPath("subnets").toVariantList();
 }
 
 /**
@@ -784,10 +788,27 @@ S9sServer::subnets() const
  * . . . 
  * \endcode
  */
-S9sVariantList
+const S9sVariantList &
 S9sServer::regions() const
 {
-    return property("regions").toVariantList();
+    return m_properties.valueByPath("regions").toVariantList();
+}
+
+/**
+ * \param idx The index of the subnet in the list of subnets.
+ * \returns The properties of the given subnet or an empty map if the index is
+ *   out of range.
+ */
+const S9sVariantMap &
+S9sServer::subnet(
+        const int idx) const
+{
+    const S9sVariantList &theList = subnets();
+
+    if (idx < 0 || idx >= (int) theList.size())
+        return S9sVariant::sm_emptyMap;
+
+    return theList[idx].toVariantMap();
 }
 
 int
@@ -800,76 +821,62 @@ S9sString
 S9sServer::subnetCidr(
         const int idx) const
 {
-    S9sVariantList theList = subnets();
-    S9sString      retval;
-
-    if (idx < 0 || idx >= (int)theList.size())
-        return retval;
-
-    retval = theList[idx]["cidr"].toString();
-    return retval;
+    return subnet(idx).valueByPath("cidr").toString();
 }
 
 S9sString
 S9sServer::subnetRegion(
         const int idx) const
 {
-    S9sVariantList theList = subnets();
-    S9sString      retval;
-
-    if (idx < 0 || idx >= (int)theList.size())
-        return retval;
-
-    retval = theList[idx]["region"].toString();
-    return retval;
+    return subnet(idx).valueByPath("region").toString();
 }
 
 S9sString
 S9sServer::subnetProvider(
         const int idx) const
 {
-    S9sVariantList theList = subnets();
-    S9sString      retval;
-
-    if (idx < 0 || idx >= (int)theList.size())
-        return retval;
-
-    retval = theList[idx]["provider"].toString();
-    return retval;
+    return subnet(idx).valueByPath("provider").toString();
 }
 
 S9sString
 S9sServer::subnetId(
         const int idx) const
 {
-    S9sVariantList theList = subnets();
-    S9sString      retval;
-
-    if (idx < 0 || idx >= (int)theList.size())
-        return retval;
-
-    retval = theList[idx]["id"].toString();
-    return retval;
+    return subnet(idx).valueByPath("id").toString();
 }
 
 S9sString
 S9sServer::subnetVpcId(
         const int idx) const
 {
-    S9sVariantList theList = subnets();
-    S9sString      retval;
-
-    if (idx < 0 || idx >= (int)theList.size())
-        return retval;
-
-    retval = theList[idx]["vpc_id"].toString();
-    return retval;
+    return subnet(idx).valueByPath("vpc_id").toString();
 }
 
-S9sVariantList 
+/**
+ * \returns The list of the templates the server offers. The reference points
+ *   into the properties of the server, so the list is not copied.
+ */
+const S9sVariantList &
 S9sServer::templates() const
 {
-    return property("templates").toVariantList();
+    return m_properties.valueByPath("templates").toVariantList();
+}
+
+/**
+ * \param idx The index of the template in the list of available templates.
+ * \returns The properties of the given template or an empty map if the index
+ *   is out of range.
+ */
+const S9sVariantMap &
+S9sServer::serverTemplate(
+        const int idx) const
+{
+    const S9sVariantList &theList = templates();
+
+    if (idx < 0 || idx >= (int) theList.size())
+        return S9sVariant::sm_emptyMap;
+
+    return theList[idx].toVariantMap();
 }
 
 int
@@ -883,14 +890,7 @@ S9sServer::templateName(
         const int idx, 
         bool      truncate) const
 {
-    S9sVariantList theList = templates();
-    S9sString      retval;
-
-    if (idx >= 0 && idx < (int)theList.size())
-    {
-        retval = theList[idx]["name"].toString();
-    }
-
+    S9sString retval = serverTemplate(idx).valueByPath("name").toString();
 
     if (truncate)
     {
@@ -920,13 +920,12 @@ S9sServer::templateRegion(
         const int       idx,
         const S9sString defaultValue) const
 {
-    S9sVariantList theList = templates();
-    S9sString      retval;
+    S9sString retval;
 
-    if (idx < 0 || idx >= (int)theList.size())
+    if (idx < 0 || idx >= nTemplates())
         return retval;
 
-    retval = theList[idx]["region"].toString();
+    retval = serverTemplate(idx).valueByPath("region").toString();
     if (retval.empty())
         retval = defaultValue;
 
@@ -975,14 +974,7 @@ S9sString
 S9sServer::templateProvider(
         const int idx) const
 {
-    S9sVariantList theList = templates();
-    S9sString      retval;
-
-    if (idx < 0 || idx >= (int)theList.size())
-        return retval;
-
-    retval = theList[idx]["provider"].toString();
-    return retval;
+    return serverTemplate(idx).valueByPath("provider").toString();
 }
 
 
@@ -62,8 +62,9 @@ class S9sServer : public S9sObject
         S9sString hostStatus() const;
         virtual int stateAsChar() const;
 
-        S9sVariantList subnets() const;
-        S9sVariantList regions() const;
+        const S9sVariantList &subnets() const;
+        const S9sVariantList &regions() const;
+        const S9sVariantMap &subnet(const int idx) const;
         int nSubnets() const;
         S9sString subnetCidr(const int idx) const;
         S9sString subnetRegion(const int idx) const;
@@ -71,7 +72,8 @@ class S9sServer : public S9sObject
         S9sString subnetId(const int idx) const;
         S9sString subnetVpcId(const int idx) const;
 
-        S9sVariantList templates() const;
+        const S9sVariantList &templates() const;
+        const S9sVariantMap &serverTemplate(const int idx) const;
         int nTemplates() const;
 
         S9sString templateName(
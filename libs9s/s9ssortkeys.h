@@ -0,0 +1,166 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sVector"
+
+#include <algorithm>
+#include <utility>
+
+/**
+ * A helper class to sort lists of maps and objects without calling the
+ * property accessors in every comparison. The sort keys are extracted once
+ * into a typed array together with the index of the item they belong to, the
+ * array is sorted and the items are then visited in the order of the indexes
+ * (decorate-sort-undecorate).
+ *
+ * \code{.cpp}
+ * S9sSortKeys<double> sortKeys;
+ *
+ * for (uint idx = 0u; idx < list.size(); ++idx)
+ *     sortKeys.add(list[idx]["cpu_usage"].toDouble(), idx);
+ *
+ * sortKeys.sort(true, 20);
+ * for (uint idx = 0u; idx < 20 && idx < sortKeys.size(); ++idx)
+ *     print(list[sortKeys.index(idx)]);
+ * \endcode
+ */
+template <typename Key>
+class S9sSortKeys
+{
+    public:
+        void reserve(const uint size);
+        void add(const Key &key, const uint index);
+        void sort(const bool descending = false, const uint nFirst = 0u);
+
+        uint size() const;
+        bool empty() const;
+        uint index(const uint position) const;
+
+    private:
+        typedef std::pair<Key, uint> Entry;
+
+        static bool ascending(const Entry &a, const Entry &b);
+        static bool descending(const Entry &a, const Entry &b);
+
+    private:
+        S9sVector<Entry>  m_entries;
+};
+
+template <typename Key>
+inline void
+S9sSortKeys<Key>::reserve(
+        const uint size)
+{
+    m_entries.reserve(size);
+}
+
+template <typename Key>
+inline void
+S9sSortKeys<Key>::add(
+        const Key  &key,
+        const uint  index)
+{
+    m_entries.push_back(Entry(key, index));
+}
+
+/**
+ * \param descending True to sort from the biggest key to the smallest.
+ * \param nFirst If this is not 0 only the first nFirst positions are sorted
+ *   (the rest is in unspecified order), this is faster if only the top of the
+ *   list is printed.
+ *
+ * Items with equal keys are kept in the order they were added.
+ */
+template <typename Key>
+void
+S9sSortKeys<Key>::sort(
+        const bool descending,
+        const uint nFirst)
+{
+    bool (*compare)(const Entry &, const Entry &);
+
+    compare = descending ? 
+        S9sSortKeys<Key>::descending : S9sSortKeys<Key>::ascending;
+
+    if (nFirst > 0u && nFirst < m_entries.size())
+    {
+        std::partial_sort(
+                m_entries.begin(), m_entries.begin() + nFirst, 
+                m_entries.end(), compare);
+    } else {
+        std::sort(m_entries.begin(), m_entries.end(), compare);
+    }
+}
+
+template <typename Key>
+inline uint
+S9sSortKeys<Key>::size() const
+{
+    return m_entries.size();
+}
+
+template <typename Key>
+inline bool
+S9sSortKeys<Key>::empty() const
+{
+    return m_entries.empty();
+}
+
+/**
+ * \param position The position in the sorted order.
+ * \returns The index of the item that was added with the key that is in the
+ *   given position after the sort.
+ */
+template <typename Key>
+inline uint
+S9sSortKeys<Key>::index(
+        const uint position) const
+{
+    return m_entries[position].second;
+}
+
+template <typename Key>
+bool
+S9sSortKeys<Key>::ascending(
+        const Entry &a, 
+        const Entry &b)
+{
+    if (a.first < b.first)
+        return true;
+    else if (b.first < a.first)
+        return false;
+
+    return a.second < b.second;
+}
+
+template <typename Key>
+bool
+S9sSortKeys<Key>::descending(
+        const Entry &a, 
+        const Entry &b)
+{
+    if (b.first < a.first)
+        return true;
+    else if (a.first < b.first)
+        return false;
+
+    return a.second < b.second;
+}
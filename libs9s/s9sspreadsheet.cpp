@@ -247,9 +247,12 @@ S9sSpreadsheet::isAlignRight(
     return false;
 }
 
-
+/**
+ * \param output The stream to print the spreadsheet to.
+ */
 void
-S9sSpreadsheet::print() const
+S9sSpreadsheet::print(
+        FILE *output) const
 {
     int thisColumn = 0;
 
@@ -259,8 +262,8 @@ S9sSpreadsheet::print() const
     /*
      * Printing the header line.
      */
-    ::printf("     ");
-    ::printf("%s", headerColorBegin());
+    ::fprintf(output, "     ");
+    ::fprintf(output, "%s", headerColorBegin());
 
     thisColumn = 5;
     for (uint col = m_firstVisibleColumn; col < 32; ++col)
@@ -275,32 +278,32 @@ S9sSpreadsheet::print() const
         label += 'A' + col;
         
         for (uint n = 0; n < (theWidth - label.length()) / 2; ++n, ++nChars)
-            ::printf(" ");
+            ::fprintf(output, " ");
 
-        ::printf("%s", STR(label));
+        ::fprintf(output, "%s", STR(label));
         nChars += label.length();
         
         for (; nChars < theWidth; ++nChars)
-            ::printf(" ");
+            ::fprintf(output, " ");
 
         thisColumn += theWidth;
     }
 
     for (;thisColumn < (int)m_screenColumns;++thisColumn)
-        ::printf(" ");
+        ::fprintf(output, " ");
 
-    //::printf("%s", TERM_ERASE_EOL);
-    ::printf("%s", headerColorEnd());
-    ::printf("\r\n");
+    //::fprintf(output, "%s", TERM_ERASE_EOL);
+    ::fprintf(output, "%s", headerColorEnd());
+    ::fprintf(output, "\r\n");
 
     /*
      *
      */
     for (uint row = m_firstVisibleRow; row <= (uint)lastVisibleRow(); ++row)
     {
-        ::printf("%s", headerColorBegin());
-        ::printf(" %3u ", row + 1);
-        ::printf("%s", headerColorEnd());
+        ::fprintf(output, "%s", headerColorBegin());
+        ::fprintf(output, " %3u ", row + 1);
+        ::fprintf(output, "%s", headerColorEnd());
 
         for (uint col = m_firstVisibleColumn; col <= (uint)lastVisibleColumn(); ++col)
         {
@@ -311,33 +314,33 @@ S9sSpreadsheet::print() const
                 theValue.resize(theWidth);
 
             // 
-            ::printf("%s", cellBegin(0, col, row));
+            ::fprintf(output, "%s", cellBegin(0, col, row));
 
             //
             // Printing the cell content.
             //
             if (!isAlignRight(0, col, row))
             {
-                ::printf("%s", STR(theValue));
+                ::fprintf(output, "%s", STR(theValue));
                 if (theWidth > (int)theValue.length())
                 {
                     for (uint n = 0; n < theWidth - theValue.length(); ++n)
-                        ::printf(" ");
+                        ::fprintf(output, " ");
                 }
             } else {
                 if (theWidth > (int)theValue.length())
                 {
                     for (uint n = 0; n < theWidth - theValue.length(); ++n)
-                        ::printf(" ");
+                        ::fprintf(output, " ");
                 }
-                ::printf("%s", STR(theValue));
+                ::fprintf(output, "%s", STR(theValue));
             }
             
             // 
-            ::printf("%s", cellEnd(0, col, row));
+            ::fprintf(output, "%s", cellEnd(0, col, row));
         }
         
-        ::printf("\r\n");
+        ::fprintf(output, "\r\n");
     }
 }
 
@@ -21,6 +21,8 @@
 
 #include "S9sObject"
 
+#include <stdio.h>
+
 /**
  * A class that represents a node/host/server. 
  */
@@ -40,7 +42,7 @@ class S9sSpreadsheet : public S9sObject
         int lastVisibleRow() const;
         int lastVisibleColumn() const;
 
-        void print() const;
+        void print(FILE *output = stdout) const;
 
         S9sString value(
                 const uint sheet,
@@ -0,0 +1,371 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9sstatcache.h"
+
+#include "S9sFile"
+#include "S9sDir"
+
+#include <algorithm>
+#include <cstdio>
+#include <unistd.h>
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+/*
+ * The samples at the end of the cached range might not have been stored on the
+ * controller at the time they were fetched, so we always download this many
+ * seconds again and drop the duplicates.
+ */
+#define STAT_CACHE_OVERLAP 120
+
+/**
+ * \returns The value of the sample by reference, the samples are compared a
+ *   lot while sorting, so nothing is copied here.
+ */
+static const S9sVariant &
+sampleValue(
+        const S9sVariantMap &sample,
+        const char          *key)
+{
+    return sample.valueByPath(key);
+}
+
+/**
+ * \returns The time when the interval of the sample ended.
+ */
+static time_t
+sampleEnded(
+        const S9sVariantMap &sample)
+{
+    return sampleValue(sample, "created").toTimeT() + 
+        sampleValue(sample, "interval").toInt() / 1000;
+}
+
+static bool
+compareSamplesByCreated(
+        const S9sVariant &sample1,
+        const S9sVariant &sample2)
+{
+    return sampleValue(sample1.toVariantMap(), "created").toTimeT() < 
+        sampleValue(sample2.toVariantMap(), "created").toTimeT();
+}
+
+/**
+ * \param controllerName The name of the controller the samples are received
+ *   from.
+ * \param controllerPort The port of the controller.
+ * \param clusterKey The cluster ID or the cluster name as it was passed to the
+ *   controller.
+ * \param statName The name of the statistics (e.g. "cpustat").
+ */
+S9sStatCache::S9sStatCache(
+        const S9sString &controllerName,
+        const int        controllerPort,
+        const S9sString &clusterKey,
+        const S9sString &statName) :
+    m_endDate(0)
+{
+    S9sString fileName;
+
+    fileName.sprintf("%s_%d_%s_%s.json",
+            STR(controllerName), controllerPort,
+            STR(clusterKey), STR(statName));
+
+    fileName.replace("/", "_");
+    fileName.replace(" ", "_");
+
+    m_path = S9sFile::buildPath(cacheDirectory(), fileName);
+}
+
+S9sStatCache::~S9sStatCache()
+{
+}
+
+/**
+ * \returns The directory where the statistics cache files are stored.
+ */
+S9sString
+S9sStatCache::cacheDirectory()
+{
+    return "~/.s9s/stat_cache";
+}
+
+/**
+ * \returns The path of the file that holds the cached samples.
+ */
+S9sString
+S9sStatCache::path() const
+{
+    return m_path;
+}
+
+S9sString
+S9sStatCache::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * Loads the cached samples from the disk. If the file does not exist or can
+ * not be parsed the cache will be empty and the method returns false.
+ */
+bool
+S9sStatCache::load()
+{
+    S9sFile       file(m_path);
+    S9sString     content;
+    S9sVariantMap theMap;
+
+    m_samples.clear();
+    m_hosts.clear();
+    m_endDate = 0;
+
+    if (!file.exists())
+        return false;
+
+    if (!file.readTxtFile(content))
+    {
+        m_errorString = file.errorString();
+        PRINT_LOG("%s", STR(m_errorString));
+        return false;
+    }
+
+    if (!theMap.parse(STR(content)))
+    {
+        m_errorString.sprintf("Error parsing stat cache '%s'.", STR(m_path));
+        PRINT_LOG("%s", STR(m_errorString));
+        return false;
+    }
+
+    m_samples = theMap["data"].toVariantList();
+    m_hosts   = theMap["hosts"].toVariantList();
+    m_endDate = theMap["enddate"].toTimeT();
+
+    PRINT_LOG("Loaded %u sample(s) from '%s'.", m_samples.size(), STR(m_path));
+    return true;
+}
+
+/**
+ * Writes the cached samples into the cache file, creates the cache directory
+ * if it does not exist. The file is written under a temporary name and then
+ * renamed, so the other s9s processes reading the cache see either the old or
+ * the new content, never a half written file.
+ */
+bool
+S9sStatCache::save()
+{
+    S9sDir        dir(cacheDirectory());
+    S9sString     tmpPath;
+    S9sFile       file;
+    S9sVariantMap theMap;
+
+    if (!dir.exists() && !dir.mkdir())
+    {
+        m_errorString = dir.errorString();
+        PRINT_LOG("%s", STR(m_errorString));
+        return false;
+    }
+
+    theMap["enddate"] = (ulonglong) m_endDate;
+    theMap["hosts"]   = m_hosts;
+    theMap["data"]    = m_samples;
+
+    tmpPath.sprintf("%s.%d.tmp", STR(m_path), (int) getpid());
+    file = S9sFile(tmpPath);
+
+    if (!file.writeTxtFile(theMap.toString()))
+    {
+        m_errorString = file.errorString();
+        PRINT_LOG("%s", STR(m_errorString));
+        ::unlink(STR(file.path()));
+        return false;
+    }
+
+    if (::rename(STR(file.path()), STR(S9sFile(m_path).path())) != 0)
+    {
+        m_errorString.sprintf(
+                "Error renaming '%s' to '%s': %m.", 
+                STR(tmpPath), STR(m_path));
+
+        PRINT_LOG("%s", STR(m_errorString));
+        ::unlink(STR(file.path()));
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * \param before The samples that ended before this time will be removed.
+ *
+ * Drops the samples that are too old to be shown, so that the cache does not
+ * grow forever.
+ */
+void
+S9sStatCache::expire(
+        const time_t before)
+{
+    S9sVariantList samples;
+
+    for (uint idx = 0u; idx < m_samples.size(); ++idx)
+    {
+        const S9sVariantMap &sample = m_samples[idx].toVariantMap();
+
+        if (sampleEnded(sample) < before)
+            continue;
+
+        samples << sample;
+    }
+
+    m_samples = samples;
+    if (m_samples.empty())
+        m_endDate = 0;
+}
+
+/**
+ * \param startDate The start of the interval the caller needs.
+ * \returns The start of the interval that we still need to request from the
+ *   controller.
+ */
+time_t
+S9sStatCache::missingStart(
+        const time_t startDate) const
+{
+    time_t retval;
+
+    if (m_samples.empty() || m_endDate <= startDate)
+        return startDate;
+
+    retval = m_endDate - STAT_CACHE_OVERLAP;
+    if (retval < startDate)
+        retval = startDate;
+
+    return retval;
+}
+
+/**
+ * \param samples The samples received from the controller.
+ * \param hosts The host list received together with the samples.
+ * \param endDate The end of the interval the samples were requested for.
+ *
+ * Adds the new samples to the cache. The samples we already have (the ones in
+ * the overlapping range) are not added twice.
+ */
+void
+S9sStatCache::merge(
+        const S9sVariantList &samples,
+        const S9sVariantList &hosts,
+        const time_t          endDate)
+{
+    S9sMap<S9sString, bool> keys;
+
+    for (uint idx = 0u; idx < m_samples.size(); ++idx)
+        keys[sampleKey(m_samples[idx].toVariantMap())] = true;
+
+    for (uint idx = 0u; idx < samples.size(); ++idx)
+    {
+        const S9sVariantMap &sample = samples[idx].toVariantMap();
+        S9sString            key    = sampleKey(sample);
+
+        if (keys.contains(key))
+            continue;
+
+        keys[key] = true;
+        m_samples << sample;
+    }
+
+    std::stable_sort(
+            m_samples.begin(), m_samples.end(), compareSamplesByCreated);
+
+    if (!hosts.empty())
+        m_hosts = hosts;
+
+    if (endDate > m_endDate)
+        m_endDate = endDate;
+}
+
+/**
+ * \param startDate The start of the interval.
+ * \returns The cached samples that have data for the interval starting at
+ *   startDate.
+ */
+S9sVariantList
+S9sStatCache::samples(
+        const time_t startDate) const
+{
+    S9sVariantList retval;
+
+    for (uint idx = 0u; idx < m_samples.size(); ++idx)
+    {
+        const S9sVariantMap &sample = m_samples[idx].toVariantMap();
+
+        if (sampleEnded(sample) < startDate)
+            continue;
+
+        retval << sample;
+    }
+
+    return retval;
+}
+
+const S9sVariantList &
+S9sStatCache::hosts() const
+{
+    return m_hosts;
+}
+
+uint
+S9sStatCache::nSamples() const
+{
+    return m_samples.size();
+}
+
+/**
+ * \returns A string that identifies the sample: the time and the series the
+ *   sample belongs to. The controller sends the series as "samplekey" (e.g.
+ *   "CmonCpuStats-1-7"), for older controllers the host, the cpu and the
+ *   device (mountpoint, interface) are used instead.
+ */
+S9sString
+S9sStatCache::sampleKey(
+        const S9sVariantMap &sample)
+{
+    S9sString retval;
+    S9sString seriesKey = sampleValue(sample, "samplekey").toString();
+
+    if (!seriesKey.empty())
+    {
+        retval.sprintf("%llu:%s",
+                sampleValue(sample, "created").toULongLong(),
+                STR(seriesKey));
+    } else {
+        retval.sprintf("%d:%llu:%d:%s:%s:%s",
+                sampleValue(sample, "hostid").toInt(),
+                sampleValue(sample, "created").toULongLong(),
+                sampleValue(sample, "cpuid").toInt(),
+                STR(sampleValue(sample, "interface").toString()),
+                STR(sampleValue(sample, "mountpoint").toString()),
+                STR(sampleValue(sample, "device").toString()));
+    }
+
+    return retval;
+}
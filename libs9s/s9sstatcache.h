@@ -0,0 +1,73 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sVariantMap"
+#include "S9sVariantList"
+
+/**
+ * A local, on-disk cache for the statistical samples received by the
+ * "statByName" requests. The samples are stored per controller, cluster and
+ * statistics name, so when the same graph is requested again only the time
+ * range that is not yet in the cache has to be downloaded from the controller.
+ */
+class S9sStatCache
+{
+    public:
+        S9sStatCache(
+                const S9sString &controllerName,
+                const int        controllerPort,
+                const S9sString &clusterKey,
+                const S9sString &statName);
+
+        virtual ~S9sStatCache();
+
+        S9sString path() const;
+
+        bool load();
+        bool save();
+
+        void expire(const time_t before);
+        time_t missingStart(const time_t startDate) const;
+
+        void 
+            merge(
+                const S9sVariantList &samples,
+                const S9sVariantList &hosts,
+                const time_t          endDate);
+
+        S9sVariantList samples(const time_t startDate) const;
+        const S9sVariantList &hosts() const;
+        uint nSamples() const;
+
+        S9sString errorString() const;
+
+        static S9sString cacheDirectory();
+    
+    private:
+        static S9sString sampleKey(const S9sVariantMap &sample);
+
+    private:
+        S9sString        m_path;
+        S9sVariantList   m_samples;
+        S9sVariantList   m_hosts;
+        time_t           m_endDate;
+        S9sString        m_errorString;
+};
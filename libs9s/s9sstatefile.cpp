@@ -0,0 +1,426 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9sstatefile.h"
+
+#include "S9sFile"
+#include "S9sDir"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+/**
+ * \param path The path of the state file, the "~" is expanded.
+ */
+S9sStateFile::S9sStateFile(
+        const S9sString &path) :
+    m_lockFd(-1)
+{
+    m_path         = S9sFile(path).path();
+    m_lockPath     = m_path + ".lock";
+    m_redirectPath = m_path + ".redirects";
+}
+
+S9sStateFile::~S9sStateFile()
+{
+    unlock();
+}
+
+/**
+ * \returns The full path of the JSON state file.
+ */
+S9sString
+S9sStateFile::path() const
+{
+    return m_path;
+}
+
+/**
+ * \returns The full path of the file where the redirects are stored.
+ */
+S9sString
+S9sStateFile::redirectPath() const
+{
+    return m_redirectPath;
+}
+
+S9sString
+S9sStateFile::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * \param state The content of the state file is returned here.
+ * \returns true if the state file exists and could be parsed.
+ *
+ * The file is always replaced by renaming, so reading it needs no lock.
+ */
+bool
+S9sStateFile::load(
+        S9sVariantMap &state)
+{
+    S9sFile   file(m_path);
+
+    state.clear();
+
+    if (!file.exists())
+    {
+        m_errorString.sprintf("File '%s' does not exist.", STR(m_path));
+        return false;
+    }
+
+    if (!file.readJsonFile(state))
+    {
+        m_errorString = file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * \param state The whole state to be saved.
+ * \returns true if the state file holds the state when the method returns.
+ *
+ * Writes the whole state into the file unless the file already has the same
+ * content.
+ */
+bool
+S9sStateFile::save(
+        const S9sVariantMap &state)
+{
+    S9sFile   file(m_path);
+    S9sString oldContent;
+    S9sString content = state.toString();
+    bool      retval  = true;
+
+    if (!lock())
+        return false;
+
+    if (!file.exists() || !file.readTxtFile(oldContent) || 
+            oldContent != content)
+    {
+        retval = replaceFile(m_path, content);
+    }
+
+    unlock();
+    return retval;
+}
+
+/**
+ * \param key The key to set.
+ * \param value The new value for the key.
+ * \param state The current state is returned here, with the changes the other
+ *   processes made.
+ * \returns true if the state file holds the value when the method returns.
+ *
+ * Sets one value in the state file. The file is read again while the lock is
+ * held, so the values the other s9s processes wrote are kept and the file is
+ * not written at all if it already holds the value.
+ */
+bool
+S9sStateFile::setValue(
+        const S9sString  &key,
+        const S9sVariant &value,
+        S9sVariantMap    &state)
+{
+    S9sVariantMap newValue;
+    S9sVariantMap oldValue;
+    bool          retval = true;
+
+    if (!lock())
+    {
+        state[key] = value;
+        return false;
+    }
+
+    load(state);
+
+    newValue[key] = value;
+    if (state.contains(key))
+        oldValue[key] = state.at(key);
+
+    state[key] = value;
+    if (!oldValue.contains(key) || 
+            oldValue.toString() != newValue.toString())
+    {
+        retval = replaceFile(m_path, state.toString());
+    } else {
+        S9S_DEBUG("Value of '%s' is unchanged.", STR(key));
+    }
+
+    unlock();
+    return retval;
+}
+
+/**
+ * \param url The controller URL the redirect was received for.
+ * \param controllers The controllers are returned here, the same way the
+ *   redirect notification holds them.
+ * \returns true if there was a redirect stored for the URL.
+ *
+ * The redirect file has one line for every controller with tab separated
+ * fields: the URL, the host name, the IP address and the port followed by the
+ * health of the controller: 1 if it was the leader, the time of the last failed
+ * connect, the number of failures and the round trip time in milliseconds.
+ */
+bool
+S9sStateFile::loadRedirect(
+        const S9sString  &url,
+        S9sVariantList   &controllers)
+{
+    struct stat  fileStat;
+    const char  *base, *end, *line;
+    void        *memory;
+    int          fd;
+
+    controllers.clear();
+
+    fd = ::open(STR(m_redirectPath), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    memory = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (memory == MAP_FAILED)
+    {
+        m_errorString.sprintf(
+                "Error mapping '%s': %m.", STR(m_redirectPath));
+        return false;
+    }
+
+    base = (const char *) memory;
+    end  = base + fileStat.st_size;
+
+    for (line = base; line < end; )
+    {
+        const char *endOfLine;
+
+        endOfLine = (const char *) memchr(line, '\n', end - line);
+        if (endOfLine == NULL)
+            endOfLine = end;
+
+        if ((size_t) (endOfLine - line) > url.length() && 
+                line[url.length()] == '\t' &&
+                memcmp(line, url.c_str(), url.length()) == 0)
+        {
+            S9sString      text(std::string(
+                        line + url.length() + 1, 
+                        endOfLine - line - url.length() - 1));
+            S9sVariantList fields = text.split("\t", true);
+            S9sVariantMap  controller;
+
+            if (fields.size() >= 3u)
+            {
+                controller["class_name"] = "CmonController";
+                controller["hostname"]   = fields[0].toString();
+                controller["ip"]         = fields[1].toString();
+                controller["port"]       = fields[2].toInt();
+
+                if (fields.size() >= 7u)
+                {
+                    controller["leader"]    = fields[3].toInt() != 0;
+                    controller["failed_at"] = 
+                        fields[4].toString().toULongLong();
+                    controller["failures"]  = fields[5].toInt();
+                    controller["rtt"]       = fields[6].toString().toDouble();
+                }
+
+                controllers << controller;
+            }
+        }
+
+        line = endOfLine + 1;
+    }
+
+    munmap(memory, fileStat.st_size);
+
+    return !controllers.empty();
+}
+
+/**
+ * \param url The controller URL the redirect was received for.
+ * \param controllers The controllers found in the redirect notification.
+ * \returns true if the redirect file holds the controllers when the method
+ *   returns.
+ *
+ * Replaces the lines of the given URL in the redirect file, keeps the lines
+ * of the other URLs. The file is not written if it already holds the same
+ * controllers.
+ */
+bool
+S9sStateFile::saveRedirect(
+        const S9sString      &url,
+        const S9sVariantList &controllers)
+{
+    S9sFile   file(m_redirectPath);
+    S9sString oldContent;
+    S9sString content;
+    S9sString prefix = url + "\t";
+    bool      retval = true;
+
+    if (!lock())
+        return false;
+
+    if (file.exists() && !file.readTxtFile(oldContent))
+        oldContent.clear();
+
+    for (size_t start = 0; start < oldContent.length(); )
+    {
+        size_t end = oldContent.find('\n', start);
+
+        if (end == std::string::npos)
+            end = oldContent.length();
+
+        if (oldContent.compare(start, prefix.length(), prefix) != 0 && 
+                end > start)
+        {
+            content += oldContent.substr(start, end - start);
+            content += "\n";
+        }
+
+        start = end + 1;
+    }
+
+    for (uint idx = 0u; idx < controllers.size(); ++idx)
+    {
+        S9sVariantMap controller = controllers[idx].toVariantMap();
+        S9sString     hostName   = controller["hostname"].toString();
+        S9sString     ip         = controller["ip"].toString();
+
+        if (ip.empty())
+            ip = hostName;
+
+        content.aprintf("%s\t%s\t%s\t%d\t%d\t%llu\t%d\t%.3f\n", 
+                STR(url), STR(hostName), STR(ip), 
+                controller["port"].toInt(),
+                controller["leader"].toBoolean() ? 1 : 0,
+                controller["failed_at"].toULongLong(),
+                controller["failures"].toInt(),
+                controller["rtt"].toDouble());
+    }
+
+    if (content != oldContent)
+        retval = replaceFile(m_redirectPath, content);
+
+    unlock();
+    return retval;
+}
+
+/**
+ * Takes the advisory lock that serializes the writers of the state files.
+ */
+bool
+S9sStateFile::lock()
+{
+    S9sDir dir(S9sFile::dirname(m_path));
+
+    if (m_lockFd >= 0)
+        return true;
+
+    if (!dir.exists() && !dir.mkdir())
+    {
+        m_errorString = dir.errorString();
+        return false;
+    }
+
+    m_lockFd = ::open(STR(m_lockPath), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (m_lockFd < 0)
+    {
+        m_errorString.sprintf("Error opening '%s': %m.", STR(m_lockPath));
+        return false;
+    }
+
+    while (flock(m_lockFd, LOCK_EX) != 0)
+    {
+        if (errno == EINTR)
+            continue;
+
+        m_errorString.sprintf("Error locking '%s': %m.", STR(m_lockPath));
+        ::close(m_lockFd);
+        m_lockFd = -1;
+        return false;
+    }
+
+    return true;
+}
+
+void
+S9sStateFile::unlock()
+{
+    if (m_lockFd < 0)
+        return;
+
+    flock(m_lockFd, LOCK_UN);
+    ::close(m_lockFd);
+    m_lockFd = -1;
+}
+
+/**
+ * Writes the content into a temporary file and renames it over the given
+ * file, so the readers see either the old or the new content.
+ */
+bool
+S9sStateFile::replaceFile(
+        const S9sString &path,
+        const S9sString &content)
+{
+    S9sString tmpPath;
+    S9sFile   file;
+
+    tmpPath.sprintf("%s.%d.tmp", STR(path), (int) getpid());
+    file = S9sFile(tmpPath);
+
+    PRINT_LOG("Writing state file '%s'.", STR(path));
+    if (!file.writeTxtFile(content))
+    {
+        m_errorString = file.errorString();
+        ::unlink(STR(tmpPath));
+        return false;
+    }
+
+    if (::rename(STR(tmpPath), STR(path)) != 0)
+    {
+        m_errorString.sprintf(
+                "Error renaming '%s' to '%s': %m.", 
+                STR(tmpPath), STR(path));
+
+        ::unlink(STR(tmpPath));
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,80 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sVariantMap"
+#include "S9sVariantList"
+
+/**
+ * The state file of the s9s program (~/.s9s/s9s.state) that can be used safely
+ * by many s9s processes running in parallel. The file is replaced atomically
+ * (written into a temporary file and renamed), so the readers never see a
+ * partially written file and need no lock. The writers hold an advisory lock,
+ * read the file again and merge their change into it, so they do not overwrite
+ * the changes of the others, and the file is only written if the value has
+ * changed.
+ *
+ * The controller redirects, that are read on every connect, are stored in a
+ * separate, line oriented file next to the state file (one controller per line,
+ * tab separated fields), which is mapped into the memory and scanned for the
+ * given URL without parsing the rest.
+ */
+class S9sStateFile
+{
+    public:
+        S9sStateFile(const S9sString &path);
+        virtual ~S9sStateFile();
+
+        S9sString path() const;
+        S9sString redirectPath() const;
+
+        bool load(S9sVariantMap &state);
+        bool save(const S9sVariantMap &state);
+
+        bool 
+            setValue(
+                const S9sString  &key,
+                const S9sVariant &value,
+                S9sVariantMap    &state);
+
+        bool 
+            loadRedirect(
+                const S9sString  &url,
+                S9sVariantList   &controllers);
+
+        bool 
+            saveRedirect(
+                const S9sString      &url,
+                const S9sVariantList &controllers);
+
+        S9sString errorString() const;
+
+    private:
+        bool lock();
+        void unlock();
+        bool replaceFile(const S9sString &path, const S9sString &content);
+
+    private:
+        S9sString   m_path;
+        S9sString   m_lockPath;
+        S9sString   m_redirectPath;
+        int         m_lockFd;
+        S9sString   m_errorString;
+};
@@ -0,0 +1,214 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9sstatestore.h"
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+S9sStateStore::S9sStateStore() :
+    m_version(0ull)
+{
+}
+
+S9sStateStore::~S9sStateStore()
+{
+}
+
+/**
+ * \param id The ID of the object.
+ * \param properties The properties of the object as received in the event.
+ * \returns true if the object was added or some of its properties changed.
+ *
+ * Replaces the properties of the stored object with the properties received
+ * (the events hold the whole object, so the properties that are not in the map
+ * are removed). If the properties are the same nothing is touched, so the
+ * version of the object changes only if the object really changed.
+ */
+bool
+S9sStateStore::apply(
+        const S9sVariant    &id,
+        const S9sVariantMap &properties)
+{
+    S9sMap<S9sVariant, Entry>::iterator it = m_entries.find(id);
+
+    if (it == m_entries.end())
+    {
+        Entry entry;
+
+        entry.properties = properties;
+        entry.version    = ++m_version;
+        m_entries[id]    = entry;
+
+        return true;
+    }
+
+    if (isSame(it->second.properties, properties))
+        return false;
+
+    it->second.properties = properties;
+    it->second.version    = ++m_version;
+
+    return true;
+}
+
+/**
+ * \returns true if the two maps have the same keys with the same values.
+ */
+bool
+S9sStateStore::isSame(
+        const S9sVariantMap &properties1,
+        const S9sVariantMap &properties2)
+{
+    if (properties1.size() != properties2.size())
+        return false;
+
+    for (S9sVariantMap::const_iterator prop = properties2.begin();
+            prop != properties2.end(); ++prop)
+    {
+        S9sVariantMap::const_iterator old = properties1.find(prop->first);
+
+        if (old == properties1.end() || old->second != prop->second)
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * \param id The ID of the object that was deleted.
+ * \returns true if the object was found and removed.
+ */
+bool
+S9sStateStore::remove(
+        const S9sVariant &id)
+{
+    if (m_entries.erase(id) == 0)
+        return false;
+
+    ++m_version;
+    return true;
+}
+
+void
+S9sStateStore::clear()
+{
+    if (m_entries.empty())
+        return;
+
+    m_entries.clear();
+    ++m_version;
+}
+
+bool
+S9sStateStore::contains(
+        const S9sVariant &id) const
+{
+    return m_entries.find(id) != m_entries.end();
+}
+
+/**
+ * \returns The properties of the object or an empty map if there is no such
+ *   object.
+ */
+const S9sVariantMap &
+S9sStateStore::properties(
+        const S9sVariant &id) const
+{
+    S9sMap<S9sVariant, Entry>::const_iterator it = m_entries.find(id);
+
+    if (it == m_entries.end())
+        return S9sVariant::sm_emptyMap;
+
+    return it->second.properties;
+}
+
+/**
+ * \returns The version of the object, 0 if there is no such object.
+ */
+ulonglong
+S9sStateStore::version(
+        const S9sVariant &id) const
+{
+    S9sMap<S9sVariant, Entry>::const_iterator it = m_entries.find(id);
+
+    return it == m_entries.end() ? 0ull : it->second.version;
+}
+
+/**
+ * \returns The version of the whole store, this changes whenever any object
+ *   is added, changed or removed.
+ */
+ulonglong
+S9sStateStore::version() const
+{
+    return m_version;
+}
+
+uint
+S9sStateStore::size() const
+{
+    return m_entries.size();
+}
+
+bool
+S9sStateStore::empty() const
+{
+    return m_entries.empty();
+}
+
+/**
+ * \returns The IDs of the objects in order.
+ */
+S9sVector<S9sVariant>
+S9sStateStore::ids() const
+{
+    S9sVector<S9sVariant> retval;
+
+    retval.reserve(m_entries.size());
+    for (S9sMap<S9sVariant, Entry>::const_iterator it = m_entries.begin();
+            it != m_entries.end(); ++it)
+    {
+        retval.push_back(it->first);
+    }
+
+    return retval;
+}
+
+/**
+ * \param version A version of the store.
+ * \returns The IDs of the objects that are changed or added after the given
+ *   version.
+ */
+S9sVector<S9sVariant>
+S9sStateStore::changedSince(
+        const ulonglong version) const
+{
+    S9sVector<S9sVariant> retval;
+
+    for (S9sMap<S9sVariant, Entry>::const_iterator it = m_entries.begin();
+            it != m_entries.end(); ++it)
+    {
+        if (it->second.version > version)
+            retval.push_back(it->first);
+    }
+
+    return retval;
+}
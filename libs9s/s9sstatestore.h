@@ -0,0 +1,76 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sVariant"
+#include "S9sVariantMap"
+#include "S9sVector"
+#include "S9sMap"
+
+/**
+ * An in-memory store for the objects (clusters, hosts) the monitor receives in
+ * events. The objects are stored as property maps keyed by the object ID (all
+ * the IDs in one store should have the same type). Every object has a version
+ * that grows only when some property of the object really changed, so the
+ * views can re-render only the objects that are changed since they were
+ * rendered the last time. The store itself also has a version that changes
+ * whenever any object is changed, added or removed.
+ */
+class S9sStateStore
+{
+    public:
+        S9sStateStore();
+        virtual ~S9sStateStore();
+
+        bool apply(
+                const S9sVariant    &id,
+                const S9sVariantMap &properties);
+
+        bool remove(const S9sVariant &id);
+        void clear();
+
+        bool contains(const S9sVariant &id) const;
+        const S9sVariantMap &properties(const S9sVariant &id) const;
+        ulonglong version(const S9sVariant &id) const;
+        ulonglong version() const;
+
+        uint size() const;
+        bool empty() const;
+        S9sVector<S9sVariant> ids() const;
+        S9sVector<S9sVariant> changedSince(const ulonglong version) const;
+
+    private:
+        static bool isSame(
+                const S9sVariantMap &properties1,
+                const S9sVariantMap &properties2);
+
+    private:
+        class Entry
+        {
+            public:
+                Entry() : version(0ull) {};
+
+                S9sVariantMap  properties;
+                ulonglong      version;
+        };
+
+        S9sMap<S9sVariant, Entry>  m_entries;
+        ulonglong                  m_version;
+};
@@ -0,0 +1,520 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9sstatframe.h"
+
+#include <algorithm>
+#include <cmath>
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+/**
+ * \returns The value from the map or an invalid variant if the map has no
+ *   such key. Does not insert anything into the map.
+ */
+static const S9sVariant &
+valueOf(
+        const S9sVariantMap &theMap,
+        const char          *key)
+{
+    static const S9sVariant invalid;
+    S9sVariantMap::const_iterator it = theMap.find(key);
+
+    return it == theMap.end() ? invalid : it->second;
+}
+
+/*
+ * The keys of the columns in the samples, in the order of the Column enum.
+ */
+static const char *columnKeys[] =
+{
+    "user", "sys", "idle", "iowait", "steal", 
+    "ramtotal", "ramfree", "rambuffers", "ramcached",
+    "swaptotal", "swapfree"
+};
+
+S9sStatFrame::S9sStatFrame()
+{
+}
+
+S9sStatFrame::~S9sStatFrame()
+{
+}
+
+void
+S9sStatFrame::clear()
+{
+    m_rowIndex.clear();
+    m_keys.clear();
+    m_created.clear();
+    m_hostIds.clear();
+    m_cpuIds.clear();
+    m_models.clear();
+    m_hosts.clear();
+
+    for (int idx = 0; idx < NColumns; ++idx)
+        m_columns[idx].clear();
+}
+
+/**
+ * \param samples The list of "cpustat" or "memorystat" samples as they are
+ *   sent by the controller.
+ *
+ * Adds the samples to the frame. If a sample key is found multiple times only
+ * the latest sample is kept. The new rows are added in the order of the
+ * sample keys.
+ */
+void
+S9sStatFrame::addSamples(
+        const S9sVariantList &samples)
+{
+    S9sMap<S9sString, uint>  latest;
+
+    for (uint idx = 0u; idx < samples.size(); ++idx)
+    {
+        const S9sVariantMap &sample = samples[idx].toVariantMap();
+        S9sString            key = valueOf(sample, "samplekey").toString();
+        S9sMap<S9sString, uint>::iterator it;
+
+        if (!sample.contains("samplekey"))
+            continue;
+
+        it = latest.find(key);
+        if (it == latest.end())
+        {
+            latest[key] = idx;
+            continue;
+        }
+
+        if (valueOf(samples[it->second].toVariantMap(), "created").toULongLong()
+                < valueOf(sample, "created").toULongLong())
+        {
+            it->second = idx;
+        }
+    }
+
+    m_keys.reserve(m_keys.size() + latest.size());
+    m_created.reserve(m_created.size() + latest.size());
+    m_hostIds.reserve(m_hostIds.size() + latest.size());
+    m_cpuIds.reserve(m_cpuIds.size() + latest.size());
+    m_models.reserve(m_models.size() + latest.size());
+    
+    for (int idx = 0; idx < NColumns; ++idx)
+        m_columns[idx].reserve(m_columns[idx].size() + latest.size());
+
+    for (S9sMap<S9sString, uint>::const_iterator it = latest.begin();
+            it != latest.end(); ++it)
+    {
+        addSample(samples[it->second].toVariantMap());
+    }
+}
+
+/**
+ * \param sample One "cpustat" or "memorystat" sample.
+ * \returns True if the sample was stored, false if the sample has no key or
+ *   the frame already has a newer sample with the same key.
+ */
+bool
+S9sStatFrame::addSample(
+        const S9sVariantMap &sample)
+{
+    S9sString  key     = valueOf(sample, "samplekey").toString();
+    ulonglong  created = valueOf(sample, "created").toULongLong();
+    int        hostId  = valueOf(sample, "hostid").toInt();
+    S9sMap<S9sString, uint>::iterator it;
+    uint       row;
+
+    // Without the key we could not replace the sample when a newer arrives.
+    if (!sample.contains("samplekey"))
+        return false;
+
+    it = m_rowIndex.find(key);
+    if (it != m_rowIndex.end())
+    {
+        row = it->second;
+        if (m_created[row] > created)
+            return false;
+
+        if (m_hostIds[row] != hostId)
+        {
+            if (--m_hosts[m_hostIds[row]] == 0u)
+                m_hosts.erase(m_hostIds[row]);
+
+            m_hosts[hostId] += 1u;
+        }
+    } else {
+        row = m_keys.size();
+        m_rowIndex[key] = row;
+
+        m_keys.push_back(key);
+        m_created.push_back(0ull);
+        m_hostIds.push_back(0);
+        m_cpuIds.push_back(0);
+        m_models.push_back(S9sString());
+
+        for (int idx = 0; idx < NColumns; ++idx)
+            m_columns[idx].push_back(0.0);
+        
+        m_hosts[hostId] += 1u;
+    }
+
+    m_created[row] = created;
+    m_hostIds[row] = hostId;
+    setRow(row, sample);
+
+    return true;
+}
+
+/**
+ * Decodes the values of one sample into the given row.
+ */
+void
+S9sStatFrame::setRow(
+        const uint           row,
+        const S9sVariantMap &sample)
+{
+    m_cpuIds[row] = valueOf(sample, "cpuid").toInt();
+    m_models[row] = valueOf(sample, "cpumodelname").toString();
+
+    for (int idx = 0; idx < NColumns; ++idx)
+        m_columns[idx][row] = valueOf(sample, columnKeys[idx]).toDouble();
+}
+
+/**
+ * \param hostId The ID of the host.
+ *
+ * Removes all the rows that belong to the given host.
+ */
+void
+S9sStatFrame::removeHost(
+        const int hostId)
+{
+    uint target = 0u;
+
+    if (m_hosts.find(hostId) == m_hosts.end())
+        return;
+
+    m_rowIndex.clear();
+    for (uint row = 0u; row < m_keys.size(); ++row)
+    {
+        if (m_hostIds[row] == hostId)
+            continue;
+
+        if (target != row)
+        {
+            m_keys[target]    = m_keys[row];
+            m_created[target] = m_created[row];
+            m_hostIds[target] = m_hostIds[row];
+            m_cpuIds[target]  = m_cpuIds[row];
+            m_models[target]  = m_models[row];
+
+            for (int idx = 0; idx < NColumns; ++idx)
+                m_columns[idx][target] = m_columns[idx][row];
+        }
+
+        m_rowIndex[m_keys[target]] = target;
+        ++target;
+    }
+
+    m_keys.resize(target);
+    m_created.resize(target);
+    m_hostIds.resize(target);
+    m_cpuIds.resize(target);
+    m_models.resize(target);
+
+    for (int idx = 0; idx < NColumns; ++idx)
+        m_columns[idx].resize(target);
+
+    m_hosts.erase(hostId);
+}
+
+/**
+ * \returns How many samples (cores for the CPU statistics, hosts for the
+ *   memory statistics) the frame has.
+ */
+uint
+S9sStatFrame::nRows() const
+{
+    return m_keys.size();
+}
+
+/**
+ * \returns How many different hosts the samples are coming from.
+ */
+uint
+S9sStatFrame::nHosts() const
+{
+    return m_hosts.size();
+}
+
+int
+S9sStatFrame::hostId(
+        const uint row) const
+{
+    return m_hostIds[row];
+}
+
+int
+S9sStatFrame::cpuId(
+        const uint row) const
+{
+    return m_cpuIds[row];
+}
+
+/**
+ * \returns The "cpumodelname" of the sample in the given row.
+ */
+S9sString
+S9sStatFrame::model(
+        const uint row) const
+{
+    return m_models[row];
+}
+
+double
+S9sStatFrame::value(
+        const Column column, 
+        const uint   row) const
+{
+    return m_columns[column][row];
+}
+
+/**
+ * \returns The values of one column in a continuous array with nRows()
+ *   elements.
+ */
+const double *
+S9sStatFrame::column(
+        const Column column) const
+{
+    return m_columns[column].data();
+}
+
+double
+S9sStatFrame::sum(
+        const Column column) const
+{
+    return sum(m_columns[column].data(), m_columns[column].size());
+}
+
+/**
+ * \returns The average of the values in the column, 0.0 if the frame is
+ *   empty.
+ */
+double
+S9sStatFrame::average(
+        const Column column) const
+{
+    if (m_columns[column].empty())
+        return 0.0;
+
+    return sum(column) / m_columns[column].size();
+}
+
+double
+S9sStatFrame::min(
+        const Column column) const
+{
+    return min(m_columns[column].data(), m_columns[column].size());
+}
+
+double
+S9sStatFrame::max(
+        const Column column) const
+{
+    return max(m_columns[column].data(), m_columns[column].size());
+}
+
+/**
+ * \param column The column to process.
+ * \param percent The percentile between 0 and 100.
+ * \returns The value of the given percentile using the nearest rank method,
+ *   0.0 if the frame is empty.
+ */
+double
+S9sStatFrame::percentile(
+        const Column column,
+        const double percent) const
+{
+    S9sVector<double> values;
+    int               rank;
+
+    if (m_columns[column].empty())
+        return 0.0;
+
+    values = m_columns[column];
+    rank   = (int) ceil(percent / 100.0 * values.size()) - 1;
+
+    if (rank < 0)
+        rank = 0;
+    else if (rank >= (int) values.size())
+        rank = values.size() - 1;
+
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+/**
+ * \returns A new frame that has one row for every host holding the average
+ *   of the samples of the host.
+ */
+S9sStatFrame
+S9sStatFrame::hostRollup() const
+{
+    S9sStatFrame     retval;
+    S9sMap<int, uint> hostRows;
+    uint             nHostRows = 0u;
+    
+    for (S9sMap<int, uint>::const_iterator it = m_hosts.begin();
+            it != m_hosts.end(); ++it)
+    {
+        S9sString key;
+
+        key.sprintf("host-%d", it->first);
+        hostRows[it->first] = nHostRows++;
+
+        retval.m_rowIndex[key] = retval.m_keys.size();
+        retval.m_keys.push_back(key);
+        retval.m_created.push_back(0ull);
+        retval.m_hostIds.push_back(it->first);
+        retval.m_cpuIds.push_back(-1);
+        retval.m_models.push_back(S9sString());
+        retval.m_hosts[it->first] = 1u;
+    }
+
+    for (int idx = 0; idx < NColumns; ++idx)
+        retval.m_columns[idx].resize(nHostRows, 0.0);
+
+    for (uint row = 0u; row < m_keys.size(); ++row)
+    {
+        uint target = hostRows[m_hostIds[row]];
+
+        if (retval.m_created[target] < m_created[row])
+            retval.m_created[target] = m_created[row];
+
+        if (retval.m_models[target].empty())
+            retval.m_models[target] = m_models[row];
+
+        for (int idx = 0; idx < NColumns; ++idx)
+            retval.m_columns[idx][target] += m_columns[idx][row];
+    }
+
+    for (uint target = 0u; target < nHostRows; ++target)
+    {
+        double nRows = m_hosts.at(retval.m_hostIds[target]);
+
+        for (int idx = 0; idx < NColumns; ++idx)
+            retval.m_columns[idx][target] /= nRows;
+    }
+
+    return retval;
+}
+
+/**
+ * The kernel that sums an array of doubles. The independent accumulators let
+ * the compiler use the vector registers and the pipelined adders, a single
+ * accumulator would make every addition wait for the previous one.
+ */
+double
+S9sStatFrame::sum(
+        const double *values,
+        const uint    size)
+{
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    uint   idx = 0u;
+
+    for (; idx + 4u <= size; idx += 4u)
+    {
+        s0 += values[idx];
+        s1 += values[idx + 1];
+        s2 += values[idx + 2];
+        s3 += values[idx + 3];
+    }
+
+    for (; idx < size; ++idx)
+        s0 += values[idx];
+
+    return (s0 + s1) + (s2 + s3);
+}
+
+/**
+ * \returns The smallest value in the array, 0.0 if the array is empty.
+ */
+double
+S9sStatFrame::min(
+        const double *values,
+        const uint    size)
+{
+    double m0, m1, m2, m3;
+    uint   idx = 0u;
+
+    if (size == 0u)
+        return 0.0;
+
+    m0 = m1 = m2 = m3 = values[0];
+    for (; idx + 4u <= size; idx += 4u)
+    {
+        m0 = values[idx]     < m0 ? values[idx]     : m0;
+        m1 = values[idx + 1] < m1 ? values[idx + 1] : m1;
+        m2 = values[idx + 2] < m2 ? values[idx + 2] : m2;
+        m3 = values[idx + 3] < m3 ? values[idx + 3] : m3;
+    }
+
+    for (; idx < size; ++idx)
+        m0 = values[idx] < m0 ? values[idx] : m0;
+
+    m0 = m1 < m0 ? m1 : m0;
+    m2 = m3 < m2 ? m3 : m2;
+
+    return m2 < m0 ? m2 : m0;
+}
+
+/**
+ * \returns The biggest value in the array, 0.0 if the array is empty.
+ */
+double
+S9sStatFrame::max(
+        const double *values,
+        const uint    size)
+{
+    double m0, m1, m2, m3;
+    uint   idx = 0u;
+
+    if (size == 0u)
+        return 0.0;
+
+    m0 = m1 = m2 = m3 = values[0];
+    for (; idx + 4u <= size; idx += 4u)
+    {
+        m0 = values[idx]     > m0 ? values[idx]     : m0;
+        m1 = values[idx + 1] > m1 ? values[idx + 1] : m1;
+        m2 = values[idx + 2] > m2 ? values[idx + 2] : m2;
+        m3 = values[idx + 3] > m3 ? values[idx + 3] : m3;
+    }
+
+    for (; idx < size; ++idx)
+        m0 = values[idx] > m0 ? values[idx] : m0;
+
+    m0 = m1 > m0 ? m1 : m0;
+    m2 = m3 > m2 ? m3 : m2;
+
+    return m2 > m0 ? m2 : m0;
+}
@@ -0,0 +1,99 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sVariantMap"
+#include "S9sVariantList"
+#include "S9sVector"
+#include "S9sMap"
+
+/**
+ * A table of the CPU and memory statistics (the "cpustat" and "memorystat"
+ * samples) stored column by column. Every sample is decoded only once, the
+ * values of one statistic are then in one continuous array, so the sums,
+ * minimums and maximums are computed by simple loops over doubles instead of
+ * map lookups and variant conversions. Only the latest sample is kept for
+ * every sample key (every core of every host), the same way the printouts
+ * showed them before.
+ */
+class S9sStatFrame
+{
+    public:
+        enum Column
+        {
+            User,
+            Sys,
+            Idle,
+            IoWait,
+            Steal,
+            RamTotal,
+            RamFree,
+            RamBuffers,
+            RamCached,
+            SwapTotal,
+            SwapFree,
+            NColumns
+        };
+
+        S9sStatFrame();
+        virtual ~S9sStatFrame();
+
+        void clear();
+
+        void addSamples(const S9sVariantList &samples);
+        bool addSample(const S9sVariantMap &sample);
+        void removeHost(const int hostId);
+
+        uint nRows() const;
+        uint nHosts() const;
+
+        int hostId(const uint row) const;
+        int cpuId(const uint row) const;
+        S9sString model(const uint row) const;
+        double value(const Column column, const uint row) const;
+        const double *column(const Column column) const;
+
+        double sum(const Column column) const;
+        double average(const Column column) const;
+        double min(const Column column) const;
+        double max(const Column column) const;
+        double percentile(const Column column, const double percent) const;
+
+        S9sStatFrame hostRollup() const;
+
+        static double sum(const double *values, const uint size);
+        static double min(const double *values, const uint size);
+        static double max(const double *values, const uint size);
+
+    private:
+        void setRow(const uint row, const S9sVariantMap &sample);
+
+    private:
+        /** The row index for every sample key. */
+        S9sMap<S9sString, uint>  m_rowIndex;
+        S9sVector<S9sString>     m_keys;
+        S9sVector<ulonglong>     m_created;
+        S9sVector<int>           m_hostIds;
+        S9sVector<int>           m_cpuIds;
+        S9sVector<S9sString>     m_models;
+        S9sVector<double>        m_columns[NColumns];
+        /** How many rows every host has. */
+        S9sMap<int, uint>        m_hosts;
+};
@@ -44,6 +44,132 @@ const S9sString S9sString::dash  = "-";
 //#define WARNING
 #include "s9sdebug.h"
 
+/*
+ * \returns The number of columns one Unicode character occupies on the
+ *   terminal: 0 for the control, combining and zero width characters, 2 for the
+ *   wide (e.g. CJK and emoji) characters and 1 for the rest.
+ */
+static int
+characterWidth(
+        unsigned int c)
+{
+    if (c < 0xa0)
+        return c >= 0x80 ? 0 : 1;
+
+    if ((c >= 0x0300 && c <= 0x036f) || (c >= 0x0483 && c <= 0x0489) ||
+            (c >= 0x0591 && c <= 0x05bd) || (c >= 0x1ab0 && c <= 0x1aff) ||
+            (c >= 0x1dc0 && c <= 0x1dff) || (c >= 0x200b && c <= 0x200f) ||
+            (c >= 0x20d0 && c <= 0x20ff) || (c >= 0xfe00 && c <= 0xfe0f) ||
+            (c >= 0xfe20 && c <= 0xfe2f) || c == 0xfeff)
+    {
+        return 0;
+    }
+
+    if ((c >= 0x1100 && c <= 0x115f) || (c >= 0x2e80 && c <= 0x303e) ||
+            (c >= 0x3041 && c <= 0x33ff) || (c >= 0x3400 && c <= 0x4dbf) ||
+            (c >= 0x4e00 && c <= 0x9fff) || (c >= 0xa000 && c <= 0xa4cf) ||
+            (c >= 0xac00 && c <= 0xd7a3) || (c >= 0xf900 && c <= 0xfaff) ||
+            (c >= 0xfe30 && c <= 0xfe4f) || (c >= 0xff00 && c <= 0xff60) ||
+            (c >= 0xffe0 && c <= 0xffe6) || (c >= 0x1f300 && c <= 0x1f64f) ||
+            (c >= 0x1f900 && c <= 0x1f9ff) || (c >= 0x20000 && c <= 0x3fffd))
+    {
+        return 2;
+    }
+
+    return 1;
+}
+
+/*
+ * \param str The string to process.
+ * \param length The length of the string in bytes.
+ * \param index The index of the first byte of the character.
+ * \param width The number of columns the character occupies is returned here,
+ *   0 for the ANSI escape sequences.
+ * \returns The index of the byte after the character or escape sequence.
+ *
+ * Steps over one UTF-8 encoded character or one terminal escape sequence (CSI
+ * sequences like the color codes, OSC sequences and the two byte escapes).
+ * The bytes that are not valid UTF-8 are counted as one column each.
+ */
+static size_t
+nextCharacter(
+        const char  *str,
+        size_t       length,
+        size_t       index,
+        int         &width)
+{
+    unsigned char c = str[index];
+    unsigned int  codePoint;
+    size_t        nBytes;
+
+    if (c == '\033')
+    {
+        width = 0;
+        if (++index >= length)
+            return length;
+
+        c = str[index];
+
+        if (c == '[')
+        {
+            // CSI: parameter and intermediate bytes, then one final byte.
+            for (++index; index < length; ++index)
+            {
+                c = str[index];
+                if (c >= 0x40 && c <= 0x7e)
+                    return index + 1;
+            }
+
+            return length;
+        } else if (c == ']')
+        {
+            // OSC: terminated by BEL or ST.
+            for (++index; index < length; ++index)
+            {
+                if (str[index] == '\007')
+                    return index + 1;
+
+                if (str[index] == '\033' && index + 1 < length && 
+                        str[index + 1] == '\\')
+                {
+                    return index + 2;
+                }
+            }
+
+            return length;
+        }
+
+        return index + 1;
+    }
+
+    width = 1;
+    if (c < 0x80)
+        return index + 1;
+    else if ((c & 0xe0) == 0xc0)
+        nBytes = 2, codePoint = c & 0x1f;
+    else if ((c & 0xf0) == 0xe0)
+        nBytes = 3, codePoint = c & 0x0f;
+    else if ((c & 0xf8) == 0xf0)
+        nBytes = 4, codePoint = c & 0x07;
+    else
+        return index + 1;
+
+    if (index + nBytes > length)
+        return index + 1;
+
+    for (size_t idx = 1; idx < nBytes; ++idx)
+    {
+        c = str[index + idx];
+        if ((c & 0xc0) != 0x80)
+            return index + 1;
+
+        codePoint = (codePoint << 6) | (c & 0x3f);
+    }
+
+    width = characterWidth(codePoint);
+    return index + nBytes;
+}
+
 
 S9sString::S9sString() :
     std::string()
@@ -234,14 +360,82 @@ S9sString::appendWord(
     return *this;
 }
 
+/**
+ * \returns The number of columns the string occupies when printed on the
+ *   terminal.
+ *
+ * The ANSI escape sequences (e.g. the colors) are not counted, the UTF-8
+ * encoded characters are counted as one column, the wide characters as two.
+ * The strings holding only plain ASCII characters take a fast path.
+ */
 int
-S9sString::terminalLength() const
+S9sString::displayWidth() const
+{
+    const char *str    = data();
+    size_t      len    = length();
+    size_t      index  = 0;
+    int         retval;
+    int         width;
+
+    while (index < len && (unsigned char) str[index] < 0x80 && 
+            str[index] != '\033')
+    {
+        ++index;
+    }
+
+    retval = (int) index;
+    while (index < len)
+    {
+        index   = nextCharacter(str, len, index, width);
+        retval += width;
+    }
+
+    return retval;
+}
+
+/**
+ * \param width The maximum number of columns the string may occupy.
+ *
+ * If the string is wider than the given number of columns this method cuts it
+ * and puts an ellipsis ("…") at the end so that it fits. The escape sequences
+ * are all kept, so the colors set or reset after the cut are still there.
+ */
+void
+S9sString::ellipsize(
+        const int width)
 {
-    S9sString copy = *this;
+    const char *str     = data();
+    size_t      len     = length();
+    size_t      index   = 0;
+    int         used    = 0;
+    bool        clipped = false;
+    S9sString   retval;
 
-    copy.replace("…", ".");
+    if (width <= 0 || displayWidth() <= width)
+        return;
+
+    while (index < len)
+    {
+        int    charWidth;
+        size_t next = nextCharacter(str, len, index, charWidth);
+
+        if (str[index] == '\033')
+        {
+            retval.append(str + index, next - index);
+        } else if (!clipped && used + charWidth <= width - 1)
+        {
+            retval.append(str + index, next - index);
+            used += charWidth;
+        } else if (!clipped)
+        {
+            retval  += "…";
+            clipped  = true;
+        }
+
+        index = next;
+    }
 
-    return copy.length();
+    *this = retval;
 }
 
 /**
@@ -58,7 +58,8 @@ class S9sString : public std::string
         inline bool contains(char c) const;
         inline bool contains(const char *s) const;
 
-        int terminalLength() const;
+        int displayWidth() const;
+        void ellipsize(const int width);
 
         void sprintf(const char *formatString, ...);
         void vsprintf(const char *formatString, va_list arguments);
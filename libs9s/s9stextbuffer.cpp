@@ -0,0 +1,440 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9stextbuffer.h"
+
+#include <climits>
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+/*
+ * The number of lines the gap is grown with at least.
+ */
+#define MIN_GAP_SIZE 64
+
+S9sTextBuffer::S9sTextBuffer() :
+    m_gapStart(0),
+    m_gapEnd(0),
+    m_treeValid(false),
+    m_dirtyFirst(INT_MAX),
+    m_cleanTail(INT_MAX),
+    m_modified(false)
+{
+}
+
+S9sTextBuffer::~S9sTextBuffer()
+{
+}
+
+/**
+ * \param text The text to be stored, the lines are separated by line feeds.
+ *
+ * Replaces the content of the buffer. The buffer is not modified after this
+ * call.
+ */
+void
+S9sTextBuffer::setText(
+        const S9sString &text)
+{
+    size_t start = 0;
+
+    clear();
+
+    if (text.empty())
+        return;
+
+    for (;;)
+    {
+        size_t end = text.find('\n', start);
+
+        if (end == std::string::npos)
+        {
+            appendLine(text.substr(start));
+            break;
+        }
+
+        appendLine(text.substr(start, end - start));
+        start = end + 1;
+    }
+
+    // Every line is terminated by a line feed in the text.
+    m_text       = text + "\n";
+    m_dirtyFirst = INT_MAX;
+    m_cleanTail  = INT_MAX;
+    m_modified   = false;
+}
+
+/**
+ * \returns The whole text with a line feed after every line.
+ *
+ * The text is cached, only the lines that changed since the last call are
+ * concatenated again, the unchanged beginning and the unchanged end of the
+ * document are copied from the previous version.
+ */
+const S9sString &
+S9sTextBuffer::text() const
+{
+    S9sString newText;
+    int       n     = nLines();
+    int       first;
+    int       tail;
+    size_t    prefixSize;
+    size_t    suffixSize;
+
+    if (m_dirtyFirst == INT_MAX)
+        return m_text;
+
+    first      = m_dirtyFirst < n ? m_dirtyFirst : n;
+    tail       = m_cleanTail < n - first ? m_cleanTail : n - first;
+    prefixSize = prefixLength(first);
+    suffixSize = length() - prefixLength(n - tail);
+
+    newText.reserve(length());
+    newText.append(m_text, 0, prefixSize);
+
+    for (int idx = first; idx < n - tail; ++idx)
+    {
+        newText += line(idx);
+        newText += '\n';
+    }
+
+    newText.append(m_text, m_text.length() - suffixSize, suffixSize);
+
+    m_text.swap(newText);
+    m_dirtyFirst = INT_MAX;
+    m_cleanTail  = INT_MAX;
+
+    return m_text;
+}
+
+void
+S9sTextBuffer::clear()
+{
+    m_lines.clear();
+    m_gapStart   = 0;
+    m_gapEnd     = 0;
+    m_tree.clear();
+    m_treeValid  = false;
+    m_text.clear();
+    m_dirtyFirst = INT_MAX;
+    m_cleanTail  = INT_MAX;
+    m_modified   = true;
+}
+
+int
+S9sTextBuffer::nLines() const
+{
+    return (int) m_lines.size() - gapSize();
+}
+
+/**
+ * \returns The line with the given index or an empty string if there is no such
+ *   line.
+ */
+const S9sString &
+S9sTextBuffer::line(
+        const int index) const
+{
+    static const S9sString empty;
+
+    if (index < 0 || index >= nLines())
+        return empty;
+
+    return m_lines[physicalIndex(index)];
+}
+
+void
+S9sTextBuffer::setLine(
+        const int        index,
+        const S9sString &value)
+{
+    if (index < 0)
+        return;
+
+    while (index >= nLines())
+        appendLine("");
+
+    S9sString &theLine = m_lines[physicalIndex(index)];
+
+    if (m_treeValid)
+    {
+        updateTree(
+                physicalIndex(index), 
+                (long) value.length() - (long) theLine.length());
+    }
+
+    theLine = value;
+    markDirty(index, nLines() - index - 1);
+}
+
+/**
+ * Inserts a new line before the line with the given index. The gap is moved to
+ * the place of the insertion, so inserting lines one after the other (e.g. when
+ * the user presses enter) is cheap and the line lengths are updated in
+ * O(log n) instead of rebuilding the tree.
+ */
+void
+S9sTextBuffer::insertLine(
+        const int        index,
+        const S9sString &value)
+{
+    if (gapSize() == 0)
+        growGap();
+
+    moveGap(index);
+    m_lines[m_gapStart] = value;
+
+    if (m_treeValid)
+        updateTree(m_gapStart, (long) value.length() + 1);
+
+    ++m_gapStart;
+    markDirty(index, nLines() - index - 1);
+}
+
+void
+S9sTextBuffer::appendLine(
+        const S9sString &value)
+{
+    insertLine(nLines(), value);
+}
+
+void
+S9sTextBuffer::removeLine(
+        const int index)
+{
+    if (index < 0 || index >= nLines())
+        return;
+
+    moveGap(index);
+    
+    if (m_treeValid)
+        updateTree(m_gapEnd, -((long) m_lines[m_gapEnd].length() + 1));
+
+    m_lines[m_gapEnd].clear();
+    ++m_gapEnd;
+
+    markDirty(index, nLines() - index);
+}
+
+/**
+ * \returns The offset of the given position in the text().
+ */
+size_t
+S9sTextBuffer::offset(
+        const int lineIndex,
+        const int column) const
+{
+    return prefixLength(lineIndex) + column;
+}
+
+/**
+ * \returns The length of the text() including the line feeds.
+ */
+size_t
+S9sTextBuffer::length() const
+{
+    return prefixLength(nLines());
+}
+
+/**
+ * \returns True if the text was changed since it was set by setText().
+ */
+bool
+S9sTextBuffer::isModified() const
+{
+    return m_modified;
+}
+
+int
+S9sTextBuffer::gapSize() const
+{
+    return m_gapEnd - m_gapStart;
+}
+
+int
+S9sTextBuffer::physicalIndex(
+        const int index) const
+{
+    return index < m_gapStart ? index : index + gapSize();
+}
+
+/**
+ * Moves the gap so that it starts at the given line index. Every line that is
+ * moved over the gap changes its slot, so it is moved in the tree too.
+ */
+void
+S9sTextBuffer::moveGap(
+        const int index)
+{
+    int size = gapSize();
+
+    while (m_gapStart > index)
+    {
+        --m_gapStart;
+        --m_gapEnd;
+        m_lines[m_gapEnd].swap(m_lines[m_gapStart]);
+        moveInTree(m_gapStart, m_gapEnd);
+    }
+
+    while (m_gapStart < index && size > 0)
+    {
+        m_lines[m_gapStart].swap(m_lines[m_gapEnd]);
+        moveInTree(m_gapEnd, m_gapStart);
+        ++m_gapStart;
+        ++m_gapEnd;
+    }
+
+    if (size == 0)
+    {
+        m_gapStart = index;
+        m_gapEnd   = index;
+    }
+}
+
+void
+S9sTextBuffer::growGap()
+{
+    std::vector<S9sString> lines;
+    int                    nTail   = (int) m_lines.size() - m_gapEnd;
+    int                    newSize = m_lines.size() * 2;
+    int                    newGapEnd;
+
+    if (newSize < (int) m_lines.size() + MIN_GAP_SIZE)
+        newSize = m_lines.size() + MIN_GAP_SIZE;
+
+    lines.resize(newSize);
+    newGapEnd = newSize - nTail;
+
+    for (int idx = 0; idx < m_gapStart; ++idx)
+        lines[idx].swap(m_lines[idx]);
+
+    for (int idx = 0; idx < nTail; ++idx)
+        lines[newGapEnd + idx].swap(m_lines[m_gapEnd + idx]);
+
+    m_lines.swap(lines);
+    m_gapEnd = newGapEnd;
+
+    // All the slots after the gap are changed, the gap is doubled, so this is
+    // amortized.
+    m_treeValid = false;
+}
+
+/**
+ * \param firstLine The first line that was changed.
+ * \param nCleanLines The number of lines after the change that were not
+ *   changed.
+ */
+void
+S9sTextBuffer::markDirty(
+        const int firstLine,
+        const int nCleanLines)
+{
+    if (firstLine < m_dirtyFirst)
+        m_dirtyFirst = firstLine;
+
+    if (nCleanLines < m_cleanTail)
+        m_cleanTail = nCleanLines;
+
+    m_modified = true;
+}
+
+/**
+ * Builds the tree from the lengths of the lines. The tree has an element for
+ * every slot of the line buffer, the slots of the gap have 0 length, so the
+ * insertions and removals around the gap are only updating the tree.
+ */
+void
+S9sTextBuffer::buildTree() const
+{
+    int n = (int) m_lines.size();
+
+    m_tree.assign(n + 1, 0);
+    for (int idx = 0; idx < n; ++idx)
+    {
+        int parent;
+
+        if (idx < m_gapStart || idx >= m_gapEnd)
+            m_tree[idx + 1] += m_lines[idx].length() + 1;
+
+        parent = (idx + 1) + ((idx + 1) & -(idx + 1));
+        if (parent <= n)
+            m_tree[parent] += m_tree[idx + 1];
+    }
+
+    m_treeValid = true;
+}
+
+/**
+ * \param slot The index of the slot in the line buffer (not the line index).
+ * \param delta The change of the length of the slot.
+ */
+void
+S9sTextBuffer::updateTree(
+        const int  slot,
+        const long delta) const
+{
+    int n = (int) m_tree.size() - 1;
+
+    for (int idx = slot + 1; idx <= n; idx += idx & -idx)
+        m_tree[idx] += delta;
+}
+
+/**
+ * \param from The slot the line was moved from, it is in the gap now.
+ * \param to The slot that holds the line now.
+ */
+void
+S9sTextBuffer::moveInTree(
+        const int from,
+        const int to)
+{
+    long length = (long) m_lines[to].length() + 1;
+
+    if (!m_treeValid)
+        return;
+
+    updateTree(from, -length);
+    updateTree(to, length);
+}
+
+/**
+ * \returns The number of characters in the first count lines (with the line
+ *   feeds).
+ */
+size_t
+S9sTextBuffer::prefixLength(
+        const int count) const
+{
+    size_t retval = 0;
+    int    nSlots = count < nLines() ? count : nLines();
+
+    if (!m_treeValid)
+        buildTree();
+
+    // The slots of the gap are empty, they can be counted.
+    if (nSlots > m_gapStart)
+        nSlots += gapSize();
+
+    for (int idx = nSlots; idx > 0; idx -= idx & -idx)
+        retval += m_tree[idx];
+
+    return retval;
+}
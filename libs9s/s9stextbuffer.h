@@ -0,0 +1,89 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2020  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sString"
+
+#include <vector>
+
+/**
+ * A class to hold the text edited in the S9sEditor. The lines are stored in a
+ * gap buffer, so inserting and removing lines around the cursor does not move
+ * the rest of the document. The lengths of the slots of the gap buffer are kept
+ * in a Fenwick tree, so mapping a line and column to a character offset and
+ * updating the tree when a line is changed, inserted or removed at the gap are
+ * O(log n), moving the gap costs O(log n) for every line moved. The text
+ * of the whole document is rebuilt only in the range of the lines that were
+ * changed since it was last requested.
+ */
+class S9sTextBuffer
+{
+    public:
+        S9sTextBuffer();
+        virtual ~S9sTextBuffer();
+
+        void setText(const S9sString &text);
+        const S9sString &text() const;
+        void clear();
+
+        int nLines() const;
+        const S9sString &line(const int index) const;
+
+        void setLine(const int index, const S9sString &value);
+        void insertLine(const int index, const S9sString &value);
+        void appendLine(const S9sString &value);
+        void removeLine(const int index);
+
+        size_t offset(const int lineIndex, const int column = 0) const;
+        size_t length() const;
+
+        bool isModified() const;
+
+    private:
+        int gapSize() const;
+        int physicalIndex(const int index) const;
+        void moveGap(const int index);
+        void growGap();
+
+        void markDirty(const int firstLine, const int nCleanLines);
+        void buildTree() const;
+        void updateTree(const int slot, const long delta) const;
+        void moveInTree(const int from, const int to);
+        size_t prefixLength(const int count) const;
+
+    private:
+        /** The lines with the gap between m_gapStart and m_gapEnd. */
+        std::vector<S9sString>  m_lines;
+        int                     m_gapStart;
+        int                     m_gapEnd;
+
+        /** Slot lengths (with the line feed) in a Fenwick tree. */
+        mutable std::vector<size_t> m_tree;
+        mutable bool            m_treeValid;
+
+        /** The text as it was when it was last requested. */
+        mutable S9sString       m_text;
+        /** The first line that changed since the text was built. */
+        mutable int             m_dirtyFirst;
+        /** The number of lines at the end that did not change. */
+        mutable int             m_cleanTail;
+
+        bool                    m_modified;
+};
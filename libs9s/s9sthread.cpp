@@ -28,6 +28,25 @@ S9sThread::start()
     return true;
 }
 
+/**
+ * \returns true if the thread was successfully joined.
+ *
+ * Waits until the thread returns from the exec() method. The caller should
+ * make sure the thread is going to stop (e.g. by overriding the shouldStop()
+ * method), otherwise this method will wait forever.
+ */
+bool
+S9sThread::join()
+{
+    if (pthread_join(m_thread, NULL))
+    {
+        S9S_WARNING("pthread_join() failed: %m");
+        return false;
+    }
+
+    return true;
+}
+
 int
 S9sThread::exec()
 {
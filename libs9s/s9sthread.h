@@ -9,6 +9,7 @@ class S9sThread
 {
     public:
         bool start();
+        bool join();
 
     protected:
         enum State 
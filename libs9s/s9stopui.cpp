@@ -24,17 +24,149 @@
 #include "S9sDateTime"
 #include "S9sMutexLocker"
 #include "S9sSqlProcess"
+#include "S9sSortKeys"
+#include "S9sEvent"
+#include "S9sNode"
+#include "S9sCluster"
+#include "S9sThread"
+#include "S9sEventRelay"
 
 #include <stdio.h>
 #include <unistd.h>
 #include <string.h>
+#include <atomic>
 
 #define DEBUG
 #define WARNING
 #include "s9sdebug.h"
         
+/*
+ * While the events keep the data up to date the full reload of the data is
+ * done only this often (in seconds).
+ */
+#define RESYNC_INTERVAL 60
+
 struct termios orig_termios;
 
+/**
+ * The thread that subscribes to the events of the controller and passes them
+ * to the S9sTopUi. The reader has its own connection to the controller, so the
+ * UI can still send requests while the event stream is open.
+ */
+class S9sTopUiEventReader : public S9sThread
+{
+    public:
+        S9sTopUiEventReader(
+                const S9sRpcClient &client,
+                S9sTopUi           *ui);
+
+        virtual ~S9sTopUiEventReader() {};
+
+        void stop();
+
+        /** True while the event stream is open and events are arriving. */
+        std::atomic<bool>   m_subscribed;
+
+    protected:
+        virtual int exec();
+        virtual bool shouldStop() const;
+
+    private:
+        void pause(const int seconds);
+
+    private:
+        std::atomic<bool>   m_stopRequested;
+        std::atomic<bool>   m_finished;
+        S9sRpcClient        m_client;
+        S9sEventRelay       m_relay;
+        S9sTopUi           *m_ui;
+};
+
+S9sTopUiEventReader::S9sTopUiEventReader(
+        const S9sRpcClient &client,
+        S9sTopUi           *ui) :
+    m_subscribed(false),
+    m_stopRequested(false),
+    m_finished(false),
+    m_client(client.newConnection()),
+    m_ui(ui)
+{
+}
+
+int
+S9sTopUiEventReader::exec()
+{
+    while (!shouldStop())
+    {
+        if (S9sEventRelay::isEnabled() && m_relay.attach())
+        {
+            m_relay.consume(S9sTopUi::eventHandler, (void *) m_ui);
+            m_subscribed = false;
+            continue;
+        }
+
+        if (!m_client.isAuthenticated())
+        {
+            m_client.maybeAuthenticate();
+
+            if (!m_client.isAuthenticated())
+            {
+                pause(3);
+                continue;
+            }
+        }
+
+        // This will not return while the controller sends the events.
+        m_client.subscribeEvents(S9sTopUi::eventHandler, (void *) m_ui);
+        
+        PRINT_LOG("Event stream closed: %s", STR(m_client.errorString()));
+
+        m_subscribed = false;
+        pause(3);
+    }
+
+    m_finished = true;
+    return 0;
+}
+
+bool
+S9sTopUiEventReader::shouldStop() const
+{
+    return m_stopRequested || S9sThread::shouldStop();
+}
+
+/**
+ * Sleeps, but returns early if the thread should stop.
+ */
+void
+S9sTopUiEventReader::pause(
+        const int seconds)
+{
+    for (int n = 0; n < seconds * 10 && !shouldStop(); ++n)
+        usleep(100000);
+}
+
+/**
+ * Stops the thread and waits until it is finished. The thread might be blocked
+ * reading the event stream or the relay, so the connection is shut down and the
+ * relay is stopped until the thread notices it should stop (the thread might
+ * be reconnecting meanwhile).
+ */
+void
+S9sTopUiEventReader::stop()
+{
+    m_stopRequested = true;
+
+    while (!m_finished)
+    {
+        m_relay.stop();
+        m_client.interrupt();
+        usleep(10000);
+    }
+
+    join();
+}
+
 S9sTopUi::S9sTopUi(
         S9sRpcClient       &client,
         S9sTopUi::ViewMode  viewMode) :
@@ -47,12 +179,26 @@ S9sTopUi::S9sTopUi(
     m_sortOrder(CpuUsage),
     m_communicating(false),
     m_viewDebug(false),
-    m_reloadRequested(false)
+    m_reloadRequested(false),
+    m_eventReader(NULL),
+    m_lastResync(0),
+    m_processEvents(false),
+    m_nEvents(0)
 {
 }
 
+/**
+ * The event reader thread calls back into this object, so it is stopped before
+ * the object is destroyed.
+ */
 S9sTopUi::~S9sTopUi()
 {
+    if (m_eventReader != NULL)
+    {
+        m_eventReader->stop();
+        delete m_eventReader;
+        m_eventReader = NULL;
+    }
 }
 
 /**
@@ -165,36 +311,39 @@ S9sTopUi::printHeader()
     if (!m_clusterName.empty())
     {
         title.sprintf("%s (s9s top)", STR(m_clusterName));
-        printf("%s%s%s", "\033]0;", STR(title), "\007");
+        ::fprintf(m_output, "%s%s%s", "\033]0;", STR(title), "\007");
     }
 
     title = "S9S TOP";
-    ::printf("%s%s%s ", TERM_SCREEN_TITLE_BOLD, STR(title), TERM_SCREEN_TITLE);
-    ::printf("%c ", rotatingCharacter());
-    ::printf("%s ", STR(dt.toString(S9sDateTime::LongTimeFormat)));
+    ::fprintf(m_output, "%s%s%s ", 
+            TERM_SCREEN_TITLE_BOLD, STR(title), TERM_SCREEN_TITLE);
+    ::fprintf(m_output, "%c ", rotatingCharacter());
+    ::fprintf(m_output, "%s ", STR(dt.toString(S9sDateTime::LongTimeFormat)));
 
     // Printing the network activity character.
     if (m_communicating || m_reloadRequested)
-        ::printf("❌ ");
+        ::fprintf(m_output, "❌ ");
     else
-        ::printf("⟳ ");
+        ::fprintf(m_output, "⟳ ");
 
     if (m_nReplies > 0)
     {
-        ::printf("%s - ", STR(m_clusterName));
-        ::printf("%s ", STR(m_clustersReply.clusterStatusText(m_clusterId)));
+        ::fprintf(m_output, "%s - ", STR(m_clusterName));
+        ::fprintf(m_output, "%s ", 
+                STR(m_clustersReply.clusterStatusText(m_clusterId)));
 
     } else {
-        ::printf("            ");
+        ::fprintf(m_output, "            ");
     }
    
     // If we are in debug mode we print a few internals that help us in
     // development.
     if (m_viewDebug)
     {
-        ::printf("0x%02x ",      lastKeyCode());
-        ::printf("%02dx%02d ",   width(), height());
-        ::printf("%02d:%03d,%03d ", m_lastButton, m_lastX, m_lastY);
+        ::fprintf(m_output, "0x%02x ",      lastKeyCode());
+        ::fprintf(m_output, "%02dx%02d ",   width(), height());
+        ::fprintf(m_output, "%02d:%03d,%03d ", m_lastButton, m_lastX, m_lastY);
+        ::fprintf(m_output, "%s%d ", isSubscribed() ? "E" : "P", m_nEvents);
     }
         
     printNewLine();
@@ -205,13 +354,13 @@ S9sTopUi::printHeader()
         switch (m_viewMode)
         {
             case OsProcesses:
-                m_cpuStatsReply.printCpuStatLine1();
+                S9sRpcReply::printCpuStatLine1(m_cpuStats);
                 printNewLine();
 
-                m_memoryStatsReply.printMemoryStatLine1();
+                S9sRpcReply::printMemoryStatLine1(m_memoryStats);
                 printNewLine();
 
-                m_memoryStatsReply.printMemoryStatLine2();
+                S9sRpcReply::printMemoryStatLine2(m_memoryStats);
                 printNewLine();
        
                 printProcesses(height() - 6);
@@ -234,12 +383,12 @@ S9sTopUi::printSqlProcesses(
         int maxLines)
 {
     S9sOptions     *options = S9sOptions::instance();
-    S9sFormat       pidFormat;
-    S9sFormat       commandFormat;
-    S9sFormat       timeFormat;
-    S9sFormat       userFormat;
-    S9sFormat       hostNameFormat;
-    S9sFormat       instanceFormat;
+    S9sFormat       pidFormat(m_output);
+    S9sFormat       commandFormat(m_output);
+    S9sFormat       timeFormat(m_output);
+    S9sFormat       userFormat(m_output);
+    S9sFormat       hostNameFormat(m_output);
+    S9sFormat       instanceFormat(m_output);
     int             nLines;
 
     sort(m_sqlProcesses.begin(), m_sqlProcesses.end(), 
@@ -314,24 +463,24 @@ S9sTopUi::printSqlProcesses(
         commandFormat.printf(command);
         timeFormat.printf(time);
 
-        ::printf("%s", XTERM_COLOR_ORANGE);
+        ::fprintf(m_output, "%s", XTERM_COLOR_ORANGE);
         userFormat.printf(user);
-        ::printf("%s", TERM_NORMAL);
+        ::fprintf(m_output, "%s", TERM_NORMAL);
 
 
-        ::printf("%s", XTERM_COLOR_GREEN);
+        ::fprintf(m_output, "%s", XTERM_COLOR_GREEN);
         hostNameFormat.printf(hostName);
-        ::printf("%s", TERM_NORMAL);
+        ::fprintf(m_output, "%s", TERM_NORMAL);
 
         instanceFormat.printf(instance);
 
         if (!query.empty())
         {
-            ::printf("%s",  XTERM_COLOR_SQL);
-            ::printf("%s ", STR(query));
-            ::printf("%s",  TERM_NORMAL);
+            ::fprintf(m_output, "%s",  XTERM_COLOR_SQL);
+            ::fprintf(m_output, "%s ", STR(query));
+            ::fprintf(m_output, "%s",  TERM_NORMAL);
         } else {
-            ::printf("- ");
+            ::fprintf(m_output, "- ");
         }
 
         printNewLine();
@@ -347,36 +496,6 @@ S9sTopUi::printSqlProcesses(
 
 }
 
-static bool 
-compareProcessPid(
-        const S9sProcess &a,
-        const S9sProcess &b)
-{
-    return a.pid() < b.pid();
-}
-
-static bool 
-compareProcessCpu(
-        const S9sProcess &a,
-        const S9sProcess &b)
-{
-    if (a.cpuUsage() == b.cpuUsage())
-        return a.pid() > b.pid();
-
-    return a.cpuUsage() > b.cpuUsage();
-}
-
-static bool 
-compareProcessMem(
-        const S9sProcess &a,
-        const S9sProcess &b)
-{
-    if (a.memUsage() == b.memUsage())
-        return a.pid() > b.pid();
-
-    return a.memUsage() > b.memUsage();
-}
-
 /**
  * \param maxLines The number of lines we have on the screen for the printout.
  *
@@ -388,40 +507,61 @@ S9sTopUi::printProcesses(
         int maxLines)
 {
     S9sOptions     *options = S9sOptions::instance();
-    S9sFormat       pidFormat;
-    S9sFormat       userFormat(userColorBegin(), userColorEnd());
-    S9sFormat       hostFormat(XTERM_COLOR_GREEN, TERM_NORMAL);
-    S9sFormat       priorityFormat;
-    S9sFormat       virtFormat;
-    S9sFormat       resFormat;
-    S9sFormat       stateFormat;
-    S9sFormat       cpuFormat;
-    S9sFormat       memFormat;
-    S9sFormat       commandFormat("\033[1;2m\033[38;5;46m", TERM_NORMAL);
+    S9sFormat       pidFormat(m_output);
+    S9sFormat       userFormat(userColorBegin(), userColorEnd(), m_output);
+    S9sFormat       hostFormat(XTERM_COLOR_GREEN, TERM_NORMAL, m_output);
+    S9sFormat       priorityFormat(m_output);
+    S9sFormat       virtFormat(m_output);
+    S9sFormat       resFormat(m_output);
+    S9sFormat       stateFormat(m_output);
+    S9sFormat       cpuFormat(m_output);
+    S9sFormat       memFormat(m_output);
+    S9sFormat       commandFormat(
+            "\033[1;2m\033[38;5;46m", TERM_NORMAL, m_output);
+    S9sSortKeys< std::pair<double, int> > sortKeys;
     int             nLines;
 
-    switch (m_sortOrder)
+    /*
+     * Sorting the processes that we show, only as many as fits the screen. The
+     * equal CPU and memory usages are ordered by the PID.
+     */
+    sortKeys.reserve(m_processes.size());
+    for (uint idx = 0u; idx < m_processes.size(); ++idx)
     {
-        case PidOrder:
-            sort(m_processes.begin(), m_processes.end(), compareProcessPid);
-            break;
+        const S9sProcess &process = m_processes[idx];
+        
+        if (!options->isStringMatchExtraArguments(process.executable()))
+            continue;
 
-        case CpuUsage:
-            sort(m_processes.begin(), m_processes.end(), compareProcessCpu);
-            break;
+        switch (m_sortOrder)
+        {
+            case PidOrder:
+                sortKeys.add(std::make_pair(process.pid(), 0), idx);
+                break;
 
-        case MemUsage:
-            sort(m_processes.begin(), m_processes.end(), compareProcessMem);
-            break;
+            case CpuUsage:
+                sortKeys.add(
+                        std::make_pair(process.cpuUsage(), process.pid()), 
+                        idx);
+                break;
+
+            case MemUsage:
+                sortKeys.add(
+                        std::make_pair(process.memUsage(), process.pid()), 
+                        idx);
+                break;
+        }
     }
+
+    sortKeys.sort(m_sortOrder != PidOrder, maxLines > 0 ? maxLines : 0);
     
     /*
      * Collecting data.
      */
     nLines = 0;
-    for (uint idx = 0u; idx < m_processes.size(); ++idx)
+    for (uint idx = 0u; idx < sortKeys.size(); ++idx)
     {
-        const S9sProcess  &process = m_processes[idx];
+        const S9sProcess  &process = m_processes[sortKeys.index(idx)];
         int           pid        = process.pid();
         S9sString     user       = process.userName();
         S9sString     hostName   = process.hostName();
@@ -432,9 +572,6 @@ S9sTopUi::printProcesses(
         S9sString     memUsage   = process.memUsage("");
         S9sString     executable = process.executable();
 
-        if (!options->isStringMatchExtraArguments(executable))
-            continue;
-
         pidFormat.widen(pid);
         userFormat.widen(user);
         hostFormat.widen(hostName);
@@ -473,7 +610,7 @@ S9sTopUi::printProcesses(
         memFormat.widen("%MEM");
         commandFormat.widen("COMMAND");
 
-        printf("%s", TERM_SCREEN_HEADER);
+        ::fprintf(m_output, "%s", TERM_SCREEN_HEADER);
         pidFormat.printf("PID", false);
         userFormat.printf("USER", false);
         hostFormat.printf("HOST", false);
@@ -488,9 +625,9 @@ S9sTopUi::printProcesses(
     }
     
     nLines = 0;
-    for (uint idx = 0u; idx < m_processes.size(); ++idx)
+    for (uint idx = 0u; idx < sortKeys.size(); ++idx)
     {
-        const S9sProcess  &process = m_processes[idx];
+        const S9sProcess  &process = m_processes[sortKeys.index(idx)];
         int           pid        = process.pid();
         S9sString     user       = process.userName();
         S9sString     hostName   = process.hostName();
@@ -503,9 +640,6 @@ S9sTopUi::printProcesses(
         S9sString     rss        = process.resMem("");
         S9sString     virtMem    = process.virtMem("");
         S9sString     executable = process.executable();
-        
-        if (!options->isStringMatchExtraArguments(executable))
-            continue;
 
         pidFormat.printf(pid);
         userFormat.printf(user);
@@ -515,7 +649,7 @@ S9sTopUi::printProcesses(
         virtFormat.printf(virtMem);
         resFormat.printf(rss);
 
-        printf("%1s ", STR(state));
+        ::fprintf(m_output, "%1s ", STR(state));
         cpuFormat.printf(cpuUsage);
         memFormat.printf(memUsage);
         commandFormat.printf(executable);
@@ -537,21 +671,28 @@ S9sTopUi::printFooter()
     // Goint to the last line.
     for (;m_lineCounter < height() - 1; ++m_lineCounter)
     {
-        ::printf("\n\r");
-        ::printf("%s", TERM_ERASE_EOL);
+        ::fprintf(m_output, "\n\r");
+        ::fprintf(m_output, "%s", TERM_ERASE_EOL);
     } 
 
-    ::printf("%s ", normal);
-    ::printf("%sC%s-CPU Order ", bold, normal);
-    ::printf("%sM%s-Memory Order ", bold, normal);
-    ::printf("%sQ%s-Quit ", bold, normal);
+    ::fprintf(m_output, "%s ", normal);
+    ::fprintf(m_output, "%sC%s-CPU Order ", bold, normal);
+    ::fprintf(m_output, "%sM%s-Memory Order ", bold, normal);
+    ::fprintf(m_output, "%sQ%s-Quit ", bold, normal);
 
     // No new-line at the end, this is the last line.
-    ::printf("%s", TERM_ERASE_EOL);
-    ::printf("%s", TERM_NORMAL);
-    fflush(stdout);
+    ::fprintf(m_output, "%s", TERM_ERASE_EOL);
+    ::fprintf(m_output, "%s", TERM_NORMAL);
+    fflush(m_output);
 }
 
+/**
+ * The main loop of the top UI. The data is loaded from the controller with a
+ * full reload and then (for the OS processes) it is kept up to date by the
+ * events the controller sends. While the events are arriving the full reload
+ * is done only on a slow timer, if the event stream is not available we fall
+ * back to polling the controller with the update frequency.
+ */
 void
 S9sTopUi::executeTop()
 {
@@ -574,7 +715,19 @@ S9sTopUi::executeTop()
         switch  (m_viewMode)
         {
             case OsProcesses:
-                success = getProcesses();
+                if (m_reloadRequested || !isSubscribed() ||
+                        startTime - m_lastResync >= RESYNC_INTERVAL)
+                {
+                    success = getProcesses();
+                    startEvents();
+                } else if (!m_processEvents)
+                {
+                    // The stats are coming in events, but the processes are
+                    // not, we have to poll them.
+                    success = getRunningProcesses();
+                } else {
+                    success = true;
+                }
                 break;
 
             case SqlProcesses:
@@ -603,13 +756,12 @@ S9sTopUi::getProcesses()
 {
     S9sMutexLocker         locker(m_networkMutex);
     S9sOptions            *options     = S9sOptions::instance();
-    S9sVariantList         hostList;
     S9sString              clusterStatusText;
     S9sRpcReply            reply;
     S9sRpcReply            clustersReply;
     time_t                 clustersReplyReceived;
-    S9sRpcReply            cpuStatsReply;
-    S9sRpcReply            memoryStatsReply;
+    S9sStatFrame           cpuStats;
+    S9sStatFrame           memoryStats;
     S9sRpcReply            processReply;
     S9sVector<S9sProcess>  processes;
     int                    clusterId;
@@ -652,7 +804,7 @@ S9sTopUi::getProcesses()
     if (!m_communicating)
         return true;
 
-    cpuStatsReply = m_client.reply();
+    cpuStats = m_client.reply().statFrame();
     
     /*
      * The memory statistics.
@@ -663,39 +815,14 @@ S9sTopUi::getProcesses()
     if (!m_communicating)
         return true;
 
-    memoryStatsReply = m_client.reply();
+    memoryStats = m_client.reply().statFrame();
     
     /*
      * Getting the list of the running processes.
      */
-    m_client.getRunningProcesses();
-    
-    // If the user aborted download.
-    if (!m_communicating)
+    if (!getRunningProcesses(processReply, processes))
         return true;
 
-    processReply = m_client.reply();
-    hostList = processReply["data"].toVariantList();
-    for (uint idx = 0u; idx < hostList.size(); ++idx)
-    {
-        S9sString hostName = hostList[idx]["hostname"].toString();
-        S9sVariantList processList = hostList[idx]["processes"].toVariantList();
-    
-        for (uint idx1 = 0u; idx1 < processList.size(); ++idx1)
-        {
-            S9sVariantMap processMap = processList[idx1].toVariantMap();
-            S9sProcess    process;
-
-            processMap["hostname"] = hostName;
-            process = processMap;
-            processes << process;
-        }
-
-        // If the user aborted download.
-        if (!m_communicating)
-            return true;
-    }
-
     /*
      * Pushing the received data into the object so that the screen refresh can
      * print them.
@@ -704,12 +831,13 @@ S9sTopUi::getProcesses()
 
     m_clustersReply         = clustersReply;
     m_clustersReplyReceived = clustersReplyReceived;
-    m_cpuStatsReply         = cpuStatsReply;
-    m_memoryStatsReply      = memoryStatsReply;
+    m_cpuStats              = cpuStats;
+    m_memoryStats           = memoryStats;
     m_processReply          = processReply;
     m_processes             = processes;
     m_clusterId             = clusterId;
     m_clusterName           = m_clustersReply.clusterName(m_clusterId);
+    m_lastResync            = time(NULL);
 
     m_communicating         = false;
     m_nReplies++;
@@ -752,3 +880,312 @@ S9sTopUi::getSqlProcesses()
     m_communicating   = false;
     return true;
 }
+
+/**
+ * \returns True if everything went well, false on communication error.
+ *
+ * Downloads only the list of the running processes. This is used when the
+ * statistics are received in events, but the processes are not.
+ */
+bool
+S9sTopUi::getRunningProcesses()
+{
+    S9sMutexLocker         locker(m_networkMutex);
+    S9sRpcReply            processReply;
+    S9sVector<S9sProcess>  processes;
+
+    m_communicating = true;
+
+    if (!getRunningProcesses(processReply, processes))
+        return true;
+
+    m_mutex.lock(); 
+    m_processReply   = processReply;
+    m_processes      = processes;
+    m_communicating  = false;
+    m_refreshCounter++;
+    m_mutex.unlock();
+
+    return true;
+}
+
+/**
+ * \param processReply The reply of the controller will be placed here.
+ * \param processes The processes found in the reply will be placed here.
+ * \returns False if the user aborted the download.
+ *
+ * Sends the request for the running processes and converts the reply into a
+ * list of processes.
+ */
+bool
+S9sTopUi::getRunningProcesses(
+        S9sRpcReply           &processReply,
+        S9sVector<S9sProcess> &processes)
+{
+    S9sVariantList         hostList;
+
+    m_client.getRunningProcesses();
+    
+    // If the user aborted download.
+    if (!m_communicating)
+        return false;
+
+    processReply = m_client.reply();
+    hostList = processReply["data"].toVariantList();
+    for (uint idx = 0u; idx < hostList.size(); ++idx)
+    {
+        S9sString hostName = hostList[idx]["hostname"].toString();
+        S9sVariantList processList = hostList[idx]["processes"].toVariantList();
+    
+        for (uint idx1 = 0u; idx1 < processList.size(); ++idx1)
+        {
+            S9sVariantMap processMap = processList[idx1].toVariantMap();
+            S9sProcess    process;
+
+            processMap["hostname"] = hostName;
+            process = processMap;
+            processes << process;
+        }
+
+        // If the user aborted download.
+        if (!m_communicating)
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * Starts the thread that receives the events from the controller. Only the
+ * first call starts the thread, the later calls do nothing.
+ */
+void
+S9sTopUi::startEvents()
+{
+    if (m_eventReader != NULL)
+        return;
+
+    m_eventReader = new S9sTopUiEventReader(m_client, this);
+    if (!m_eventReader->start())
+    {
+        delete m_eventReader;
+        m_eventReader = NULL;
+    }
+}
+
+/**
+ * \returns True if the events from the controller are arriving and so the
+ *   data is kept up to date without polling.
+ */
+bool
+S9sTopUi::isSubscribed() const
+{
+    return m_eventReader != NULL && m_eventReader->m_subscribed;
+}
+
+/**
+ * Static callback function for the event processing. This is called from the
+ * event reader thread.
+ */
+void
+S9sTopUi::eventHandler(
+        const S9sVariantMap &jsonMessage,
+        void                *userData)
+{
+    S9sTopUi *ui = (S9sTopUi *) userData;
+
+    if (ui == NULL)
+        return;
+
+    if (!jsonMessage.contains("class_name") ||
+            jsonMessage.at("class_name").toString() != "CmonEvent")
+    {
+        // Not an event, probably an error reply.
+        return;
+    }
+
+    S9sEvent event = jsonMessage;
+
+    if (ui->m_eventReader != NULL)
+        ui->m_eventReader->m_subscribed = true;
+
+    ui->m_mutex.lock();
+    ui->processEvent(event);
+    ui->m_mutex.unlock();
+}
+
+/**
+ * \param event The event that arrived and shall be processed.
+ *
+ * Applies the changes the event carries on the data we show. The caller
+ * should hold the mutex.
+ */
+void
+S9sTopUi::processEvent(
+        S9sEvent &event)
+{
+    // Nothing to update before the first full load.
+    if (m_nReplies == 0)
+        return;
+
+    if (event.clusterId() > 0 && event.clusterId() != m_clusterId)
+        return;
+
+    ++m_nEvents;
+
+    switch (event.eventType())
+    {
+        case S9sEvent::EventCluster:
+            if (event.hasCluster())
+            {
+                S9sVariantMap  clusterMap = event.cluster().toVariantMap();
+                S9sVariantList theList;
+
+                if (clusterMap["cluster_id"].toInt() != m_clusterId)
+                    break;
+
+                if (m_clustersReply.contains("clusters"))
+                {
+                    theList = m_clustersReply["clusters"].toVariantList();
+                    for (uint idx = 0u; idx < theList.size(); ++idx)
+                    {
+                        if (theList[idx]["cluster_id"].toInt() == m_clusterId)
+                            theList[idx] = clusterMap;
+                    }
+
+                    m_clustersReply["clusters"] = theList;
+                } else {
+                    m_clustersReply["cluster"] = clusterMap;
+                }
+
+                m_clusterName = m_clustersReply.clusterName(m_clusterId);
+                ++m_refreshCounter;
+            }
+            break;
+
+        case S9sEvent::EventHost:
+            if (event.eventSubClass() == S9sEvent::Measurements)
+            {
+                S9sVariantMap specifics = 
+                    event.toVariantMap().valueByPath(
+                            "event_specifics").toVariantMap();
+                S9sString     hostName = specifics["host_name"].toString();
+                
+                if (specifics["measurements"].isVariantList())
+                {
+                    S9sVariantList samples = 
+                        specifics["measurements"].toVariantList();
+
+                    for (uint idx = 0u; idx < samples.size(); ++idx)
+                    {
+                        processMeasurement(
+                                hostName, samples[idx].toVariantMap());
+                    }
+                } else {
+                    processMeasurement(
+                            hostName, 
+                            specifics["measurements"].toVariantMap());
+                }
+
+                if (specifics["processes"].isVariantList())
+                {
+                    S9sVariantMap sample;
+
+                    sample["class_name"] = "CmonProcessList";
+                    sample["processes"]  = specifics["processes"];
+                    processMeasurement(hostName, sample);
+                }
+
+                ++m_refreshCounter;
+            } else if (event.eventSubClass() == S9sEvent::Destroyed &&
+                    event.hasHost())
+            {
+                S9sNode node = event.host();
+
+                processHostRemoved(node.id(), node.hostName());
+                ++m_refreshCounter;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * \param hostName The name of the host that sent the sample.
+ * \param sample One sample from a measurement event.
+ *
+ * Updates the CPU, memory statistics or the processes of one host.
+ */
+void
+S9sTopUi::processMeasurement(
+        const S9sString     &hostName,
+        const S9sVariantMap &sample)
+{
+    S9sString className;
+
+    if (!sample.contains("class_name"))
+        return;
+
+    className = sample.at("class_name").toString();
+    if (className == "CmonCpuStats")
+    {
+        m_cpuStats.addSample(sample);
+    } else if (className == "CmonMemoryStats")
+    {
+        m_memoryStats.addSample(sample);
+    } else if (className == "CmonProcessList" && !hostName.empty())
+    {
+        S9sVariantList         processList;
+        S9sVector<S9sProcess>  processes;
+
+        processList = sample.at("processes").toVariantList();
+        processes.reserve(m_processes.size() + processList.size());
+
+        for (uint idx = 0u; idx < m_processes.size(); ++idx)
+        {
+            if (m_processes[idx].hostName() != hostName)
+                processes << m_processes[idx];
+        }
+
+        for (uint idx = 0u; idx < processList.size(); ++idx)
+        {
+            S9sVariantMap processMap = processList[idx].toVariantMap();
+            S9sProcess    process;
+
+            processMap["hostname"] = hostName;
+            process = processMap;
+            processes << process;
+        }
+
+        m_processes     = processes;
+        m_processEvents = true;
+    }
+}
+
+/**
+ * \param hostId The ID of the host that was removed.
+ * \param hostName The name of the host that was removed.
+ *
+ * Drops the statistics and the processes of a host that is removed from the
+ * cluster.
+ */
+void
+S9sTopUi::processHostRemoved(
+        const int            hostId,
+        const S9sString     &hostName)
+{
+    S9sVector<S9sProcess>  processes;
+
+    m_cpuStats.removeHost(hostId);
+    m_memoryStats.removeHost(hostId);
+
+    for (uint idx = 0u; idx < m_processes.size(); ++idx)
+    {
+        if (m_processes[idx].hostName() != hostName)
+            processes << m_processes[idx];
+    }
+
+    m_processes = processes;
+}
@@ -27,8 +27,11 @@
 #include "S9sProcess"
 #include "S9sSqlProcess"
 #include "S9sVector"
+#include "S9sStatFrame"
 
 class S9sRpcClient;
+class S9sEvent;
+class S9sTopUiEventReader;
 
 /*
  * http://stackoverflow.com/questions/905060/non-blocking-getch-ncurses
@@ -64,6 +67,10 @@ class S9sTopUi :
 
         void executeTop();
 
+        static void eventHandler(
+                const S9sVariantMap &jsonMessage,
+                void                *userData);
+
     protected:
         virtual bool refreshScreen();
         virtual void printHeader();
@@ -71,6 +78,21 @@ class S9sTopUi :
         
         bool getProcesses();
         bool getSqlProcesses();
+        bool getRunningProcesses();
+        bool getRunningProcesses(
+                S9sRpcReply           &processReply,
+                S9sVector<S9sProcess> &processes);
+
+        void startEvents();
+        bool isSubscribed() const;
+        void processEvent(S9sEvent &event);
+        void processMeasurement(
+                const S9sString     &hostName,
+                const S9sVariantMap &sample);
+        void processHostRemoved(
+                const int            hostId,
+                const S9sString     &hostName);
+
         void printProcesses(int maxLines);
         void printSqlProcesses(int maxLines);
 
@@ -82,8 +104,8 @@ class S9sTopUi :
         S9sMutex               m_networkMutex;        
         S9sRpcReply            m_clustersReply;
         time_t                 m_clustersReplyReceived;
-        S9sRpcReply            m_cpuStatsReply;
-        S9sRpcReply            m_memoryStatsReply;
+        S9sStatFrame           m_cpuStats;
+        S9sStatFrame           m_memoryStats;
         S9sRpcReply            m_processReply;
         S9sVector<S9sProcess>     m_processes;
         S9sVector<S9sSqlProcess>  m_sqlProcesses;
@@ -94,6 +116,16 @@ class S9sTopUi :
         bool                   m_communicating;
         bool                   m_viewDebug;
         bool                   m_reloadRequested;
+
+        /** The thread that receives the events, NULL if not started. */
+        S9sTopUiEventReader   *m_eventReader;
+        /** When the last full reload of the data happened. */
+        time_t                 m_lastResync;
+        /** True if the controller sends us the processes in events. */
+        bool                   m_processEvents;
+        int                    m_nEvents;
+
+        friend class UtS9sTopUi;
 };
 
 
@@ -29,6 +29,8 @@ class S9sNode;
 class S9sAccount;
 class S9sContainer;
 
+template <typename T> class S9sSharedData;
+
 /** 
  * An enum to identify the basic types for S9s. Well, basic types are types that
  * we consider basic, some of them are quite complex.
@@ -55,8 +57,8 @@ union S9sUnion
     double            dVal;
     bool              bVal;
     ulonglong         ullVal;
-    S9sVariantMap    *mapValue;
-    S9sVariantList   *listValue;
+    S9sSharedData<S9sVariantMap>  *mapData;
+    S9sSharedData<S9sVariantList> *listData;
     S9sVariantArray  *arrayValue;
     S9sString        *stringValue;
     S9sNode          *nodeValue;
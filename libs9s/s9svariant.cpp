@@ -27,6 +27,7 @@
 #include <climits>
 #include <cmath>
 #include <limits> 
+#include <atomic>
 
 #include "S9sNode"
 #include "S9sContainer"
@@ -53,6 +54,42 @@ static const S9sAccount          sm_emptyAccount;
 #pragma GCC visibility push(hidden)
 #endif
 
+/**
+ * The maps and the lists held by the variants are implicitly shared: copying a
+ * variant only increments a reference counter and the actual copy is made when
+ * one of the variants is modified through the non-const operator[]. This way
+ * the objects created from a reply (e.g. an S9sNode from a host map) and the
+ * lists taken from the reply do not duplicate the nested maps and lists of the
+ * reply, only the values that are actually changed.
+ */
+template <typename T>
+class S9sSharedData
+{
+    public:
+        S9sSharedData(const T &value) :
+            m_referenceCounter(1),
+            m_value(value)
+        {
+        };
+
+        /**
+         * Takes over the content of the container without copying the
+         * elements.
+         */
+        S9sSharedData(T &&value) :
+            m_referenceCounter(1)
+        {
+            m_value.swap(value);
+        };
+
+        void ref() { ++m_referenceCounter; };
+        bool unRef() { return --m_referenceCounter == 0; };
+        bool isShared() const { return m_referenceCounter > 1; };
+
+        std::atomic<int>  m_referenceCounter;
+        T                 m_value;
+};
+
 /**
  * A proper copy constructor. Makes a copy of the object if the variant holds an
  * object.
@@ -78,11 +115,13 @@ S9sVariant::S9sVariant(
             break;
 
         case List:
-            m_union.listValue = new S9sVariantList(*orig.m_union.listValue);
+            m_union.listData = orig.m_union.listData;
+            m_union.listData->ref();
             break;
 
         case Map:
-            m_union.mapValue = new S9sVariantMap(*orig.m_union.mapValue);
+            m_union.mapData = orig.m_union.mapData;
+            m_union.mapData->ref();
             break;
 
         case Node:
@@ -99,6 +138,19 @@ S9sVariant::S9sVariant(
     }
 }
 
+/**
+ * The move constructor. Takes over the value of the original variant without
+ * copying it, the original variant becomes invalid.
+ */
+S9sVariant::S9sVariant(
+        S9sVariant &&orig) :
+    m_type(orig.m_type),
+    m_union(orig.m_union)
+{
+    orig.m_type       = Invalid;
+    orig.m_union.iVal = 0;
+}
+
 /**
  * A constructor to create a variant that holds a node. Makes a copy of the node
  * object.
@@ -132,14 +184,36 @@ S9sVariant::S9sVariant(
         const S9sVariantMap &mapValue) :
     m_type(Map)
 {
-    m_union.mapValue = new S9sVariantMap(mapValue);
+    m_union.mapData = new S9sSharedData<S9sVariantMap>(mapValue);
 }
 
 S9sVariant::S9sVariant(
         const S9sVariantList &listValue) :
     m_type(List)
 {
-    m_union.listValue = new S9sVariantList(listValue);
+    m_union.listData = new S9sSharedData<S9sVariantList>(listValue);
+}
+
+/**
+ * A constructor that takes over the elements of the map, the map passed as
+ * argument is left empty.
+ */
+S9sVariant::S9sVariant(
+        S9sVariantMap &&mapValue) :
+    m_type(Map)
+{
+    m_union.mapData = new S9sSharedData<S9sVariantMap>(std::move(mapValue));
+}
+
+/**
+ * A constructor that takes over the elements of the list, the list passed as
+ * argument is left empty.
+ */
+S9sVariant::S9sVariant(
+        S9sVariantList &&listValue) :
+    m_type(List)
+{
+    m_union.listData = new S9sSharedData<S9sVariantList>(std::move(listValue));
 }
 
 S9sVariant::~S9sVariant()
@@ -181,11 +255,13 @@ S9sVariant::operator=(
             break;
 
         case List:
-            m_union.listValue = new S9sVariantList(*rhs.m_union.listValue);
+            m_union.listData = rhs.m_union.listData;
+            m_union.listData->ref();
             break;
 
         case Map:
-            m_union.mapValue = new S9sVariantMap(*rhs.m_union.mapValue);
+            m_union.mapData = rhs.m_union.mapData;
+            m_union.mapData->ref();
             break;
 
         case Node:
@@ -205,6 +281,31 @@ S9sVariant::operator=(
     return *this;
 }
 
+/**
+ * \param rhs The right-hand-side of the operator.
+ * \returns The variant itself as it is usually done.
+ *
+ * The move assignment operator. Takes over the value of the right hand side
+ * argument without copying it, the right hand side becomes invalid.
+ */
+S9sVariant &
+S9sVariant::operator=(
+        S9sVariant &&rhs)
+{
+    if (this == &rhs)
+        return *this;
+
+    clear();
+
+    m_type      = rhs.m_type;
+    m_union     = rhs.m_union;
+
+    rhs.m_type       = Invalid;
+    rhs.m_union.iVal = 0;
+
+    return *this;
+}
+
 /**
  * \param rhs The right-hand-side of the operator.
  * \returns True if the two variants are holding equal values.
@@ -452,7 +553,8 @@ S9sVariant::operator[] (
         return this->operator[](index);
     } else if (m_type == List)
     {
-        return m_union.listValue->S9sVariantList::operator[](index);
+        detach();
+        return m_union.listData->m_value.S9sVariantList::operator[](index);
     }
     
     S9S_WARNING("");
@@ -471,7 +573,8 @@ S9sVariant::operator[] (
         return this->operator[](index);
     } else if (m_type == Map)
     {
-        return m_union.mapValue->S9sMap<
+        detach();
+        return m_union.mapData->m_value.S9sMap<
                 S9sString, S9sVariant>::operator[](index);
     } 
    
@@ -637,7 +740,7 @@ S9sVariant::toVariantMap() const
             return sm_emptyMap;
 
         case Map:
-            return *m_union.mapValue;
+            return m_union.mapData->m_value;
 
         case Container:
             return m_union.containerValue->toVariantMap();
@@ -673,7 +776,7 @@ S9sVariant::toVariantList() const
             return sm_emptyList;
 
         case List:
-            return *m_union.listValue;
+            return m_union.listData->m_value;
     }
             
     return sm_emptyList;
@@ -690,7 +793,7 @@ S9sVariant::size() const
         return 0;
     } else if (m_type == List)
     {
-        return m_union.listValue->size();
+        return m_union.listData->m_value.size();
     }
     
     S9S_WARNING("");
@@ -1353,9 +1456,11 @@ S9sVariant::contains(
 {
     if (isVariantList())
     {
-        for (uint idx = 0u; idx < m_union.listValue->size(); ++idx)
+        const S9sVariantList &list = m_union.listData->m_value;
+
+        for (uint idx = 0u; idx < list.size(); ++idx)
         {
-            const S9sVariant &thisValue = (*m_union.listValue)[idx];
+            const S9sVariant &thisValue = list[idx];
 
             if (thisValue == value)
                 return true;
@@ -1371,7 +1476,7 @@ S9sVariant::contains(
 {
     if (m_type == Map)
     {
-        return m_union.mapValue->contains(key);
+        return m_union.mapData->m_value.contains(key);
     }
 
     return false;
@@ -1383,7 +1488,7 @@ S9sVariant::contains(
 {
     if (m_type == Map)
     {
-        return m_union.mapValue->contains(key);
+        return m_union.mapData->m_value.contains(key);
     }
 
     return false;
@@ -1413,13 +1518,17 @@ S9sVariant::clear()
             break;
 
         case Map:
-            delete m_union.mapValue;
-            m_union.mapValue = NULL;
+            if (m_union.mapData->unRef())
+                delete m_union.mapData;
+
+            m_union.mapData = NULL;
             break;
 
         case List:
-            delete m_union.listValue;
-            m_union.listValue = NULL;
+            if (m_union.listData->unRef())
+                delete m_union.listData;
+
+            m_union.listData = NULL;
             break;
 
         case Node:
@@ -1441,6 +1550,30 @@ S9sVariant::clear()
     m_type = Invalid;
 }
 
+/**
+ * Makes a private copy of the map or the list the variant holds if it is shared
+ * with other variants. This should be called before the value is modified.
+ */
+void
+S9sVariant::detach()
+{
+    if (m_type == Map && m_union.mapData->isShared())
+    {
+        S9sSharedData<S9sVariantMap> *data = m_union.mapData;
+
+        m_union.mapData = new S9sSharedData<S9sVariantMap>(data->m_value);
+        if (data->unRef())
+            delete data;
+    } else if (m_type == List && m_union.listData->isShared())
+    {
+        S9sSharedData<S9sVariantList> *data = m_union.listData;
+
+        m_union.listData = new S9sSharedData<S9sVariantList>(data->m_value);
+        if (data->unRef())
+            delete data;
+    }
+}
+
 /**
  * \param depth The recursion depth in the data structure beginning with 0 and
  *   growing bigger as we go into maps and lists.
@@ -64,6 +64,7 @@ class S9sVariant
 
         inline S9sVariant();
         S9sVariant(const S9sVariant &orig);
+        S9sVariant(S9sVariant &&orig);
         inline S9sVariant(const int integerValue);
         inline S9sVariant(const ulonglong ullValue);
         inline S9sVariant(const double doubleValue);
@@ -77,10 +78,13 @@ class S9sVariant
         
         S9sVariant(const S9sVariantMap &mapValue);
         S9sVariant(const S9sVariantList &listValue);
+        S9sVariant(S9sVariantMap &&mapValue);
+        S9sVariant(S9sVariantList &&listValue);
 
         virtual ~S9sVariant();
 
         S9sVariant &operator=(const S9sVariant &rhs);
+        S9sVariant &operator=(S9sVariant &&rhs);
         bool operator==(const S9sVariant &rhs) const;
         bool operator!=(const S9sVariant &rhs) const;
         S9sVariant &operator+=(const S9sVariant &rhs);
@@ -147,13 +151,15 @@ class S9sVariant
                 int depth, 
                 const S9sFormatFlags &formatFlags);
 
+        /** The empty map that is returned when no map value is available. */
+        static const S9sVariantMap  sm_emptyMap;
+        /** The empty list that is returned when no list value is available. */
+        static const S9sVariantList sm_emptyList;
+
     protected:
         static bool fuzzyCompare(double first, double second);
         void additionWithOverflow(const int arg1, const int arg2);
-
-    private:
-        static const S9sVariantMap  sm_emptyMap;
-        static const S9sVariantList sm_emptyList;
+        void detach();
 
     private:
         S9sBasicType    m_type;
@@ -37,6 +37,17 @@ const S9sVariant &
 S9sVariantMap::valueByPath(
         const S9sString &path) const
 {
+    /*
+     * Most of the paths are simple keys, for those we don't need to split the
+     * path into a newly allocated list.
+     */
+    if (!path.empty() && path.find('/') == S9sString::npos)
+    {
+        const_iterator it = find(path);
+
+        return it == end() ? S9sVariantMap::sm_invalid : it->second;
+    }
+
     return valueByPath(path.split("/"));
 }
 
@@ -77,6 +88,32 @@ S9sVariantMap::parse(
         const char *source)
 {
     S9sJsonParseContext context(source);
+
+    return parse(context);
+}
+
+/**
+ * \param source The JSON string to parse, need not be null terminated.
+ * \param length The length of the source in bytes.
+ * \returns true if the parsing was successful.
+ *
+ * Parses the source in place without copying it, so this can be used to parse
+ * directly from a mapped file.
+ */
+bool
+S9sVariantMap::parse(
+        const char   *source,
+        const size_t  length)
+{
+    S9sJsonParseContext context(source, length);
+
+    return parse(context);
+}
+
+bool
+S9sVariantMap::parse(
+        S9sJsonParseContext &context)
+{
     int retval;
     bool success;
 
@@ -88,13 +125,15 @@ S9sVariantMap::parse(
 
     json_lex_destroy(context.m_flex_scanner);
 
+    /*
+     * The values are all in the context, the temporary values the parser
+     * created in the arena are gone by now, so we can simply take over the
+     * result.
+     */
     if (success)
     {
         clear();
-
-        std::vector<S9sString> newKeys = context.keys();
-        for (uint idx = 0; idx < newKeys.size(); ++idx)
-            (*this)[newKeys[idx]] = context[newKeys[idx]];
+        swap(context);
     }
 
     return success;
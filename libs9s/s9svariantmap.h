@@ -10,6 +10,7 @@
 #include "S9sParseContext"
 
 class S9sVariantList;
+class S9sJsonParseContext;
 
 class S9sVariantMap : public S9sMap<S9sString, S9sVariant>
 {
@@ -23,6 +24,7 @@ class S9sVariantMap : public S9sMap<S9sString, S9sVariant>
         const S9sVariant &valueByPath(S9sVariantList path) const;
 
         bool parse(const char *source);
+        bool parse(const char *source, const size_t length);
 
         S9sString toString() const;
 
@@ -47,6 +49,8 @@ class S9sVariantMap : public S9sMap<S9sString, S9sVariant>
         static const S9sVariant sm_invalid;
 
     private:
+        bool parse(S9sJsonParseContext &context);
+
         S9sString toString(
                 int                  depth, 
                 const S9sVariantMap &variantMap) const;
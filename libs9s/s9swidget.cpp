@@ -25,7 +25,8 @@ S9sWidget::S9sWidget() :
     m_width(0),
     m_height(0),
     m_isVisible(false),    
-    m_hasFocus(true)
+    m_hasFocus(true),
+    m_output(stdout)
 {
 }
  
@@ -181,3 +182,36 @@ S9sWidget::userData(
     return S9sVariant();
 }
 
+/**
+ * \param output The stream where the widget prints itself.
+ *
+ * The widgets are printing to the standard output by default, the displays
+ * are setting their output to render a whole screen in memory and send it to
+ * the terminal in one piece.
+ */
+void
+S9sWidget::setOutput(
+        FILE *output)
+{
+    m_output = output;
+}
+
+FILE *
+S9sWidget::output() const
+{
+    return m_output;
+}
+
+/**
+ * \param x The column measured in characters, starting from 1.
+ * \param y The line measured in characters, starting from 1.
+ *
+ * Prints the escape sequence that moves the cursor to the given location.
+ */
+void 
+S9sWidget::gotoXy(
+        int x,
+        int y) const
+{
+    ::fprintf(m_output, "\033[%d;%dH", y, x);
+}
@@ -23,6 +23,8 @@
 #include "S9sVariant"
 #include "S9sVariantMap"
 
+#include <stdio.h>
+
 class S9sWidget
 {
     public:
@@ -56,6 +58,11 @@ class S9sWidget
         S9sVariant userData(
                 const S9sString  &key) const;
 
+        virtual void setOutput(FILE *output);
+        FILE *output() const;
+
+        void gotoXy(int x, int y) const;
+
     protected:
         int            m_x;
         int            m_y;
@@ -64,5 +71,6 @@ class S9sWidget
         bool           m_isVisible;        
         bool           m_hasFocus;
         S9sVariantMap  m_userData;
+        FILE          *m_output;
 };
 
@@ -21,6 +21,10 @@
 #include "S9sOptions"
 #include "S9sRpcClient"
 #include "S9sBusinessLogic"
+#include "S9sDaemon"
+#include "S9sEventRelay"
+#include "S9sScript"
+#include "S9sRpcStats"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -43,32 +47,24 @@ void intHandler(int dummy)
 {
     enable_cursor();
     printf("\nAborted...\n");
+    
+    // The log writer is not stopped by the exit() in the signal handler.
+    s9s_log_flush_in_signal_handler();
     exit(128);
 }
 
-int 
-main(int argc, char **argv)
+/**
+ * Executes one command, this is what the program does when there is no daemon
+ * to execute the command for us.
+ */
+static int 
+runCommand(int argc, char **argv)
 {
     S9sOptions *options = S9sOptions::instance();
     S9sBusinessLogic businessLogic;
     bool        success, finished;
     int         exitStatus;
 
-    setlocale(LC_NUMERIC, getenv("C"));
-    setlocale(LC_ALL,     getenv("C"));
-    //setlocale(LC_NUMERIC, getenv("LC_NUMERIC"));
-    //setlocale(LC_ALL,     getenv("LC_ALL"));
-
-    #if 0
-    for (;;)
-    {
-        S9sString progress = S9sRpcReply::progressBar(true);
-        printf("-> %s\n", STR(progress));
-
-        sleep(1);
-    }
-    #endif
-
     signal(SIGINT, intHandler);
 
     success = options->readOptions(&argc, argv);
@@ -99,7 +95,16 @@ main(int argc, char **argv)
     PRINT_VERBOSE("Command line options processed.");
     
     if (options->useSyntaxHighlight())
-        atexit(enable_cursor);
+    {
+        // In script mode this is executed for every command.
+        static bool registered = false;
+
+        if (!registered)
+        {
+            atexit(enable_cursor);
+            registered = true;
+        }
+    }
 
     options->loadStateFile();
 
@@ -107,6 +112,35 @@ main(int argc, char **argv)
     if (finished)
         goto finalize;
 
+    if (options->isDaemonRequested())
+    {
+        S9sDaemon daemon;
+
+        if (daemon.exec())
+        {
+            // We are a worker forked by the daemon.
+            S9sOptions::uninit();
+            return runCommand(daemon.argc(), daemon.argv());
+        }
+        
+        PRINT_ERROR("%s", STR(daemon.errorString()));
+        options->setExitStatus(S9sOptions::Failed);
+        goto finalize;
+    }
+    
+    if (options->isEventRelayRequested())
+    {
+        S9sEventRelay relay;
+
+        if (!relay.exec())
+        {
+            PRINT_ERROR("%s", STR(relay.errorString()));
+            options->setExitStatus(S9sOptions::Failed);
+        }
+
+        goto finalize;
+    }
+
     //perform_task();
     businessLogic.execute();
 
@@ -121,3 +155,69 @@ finalize:
     return exitStatus;
 }
 
+/**
+ * Executes the commands of a batch script (s9s --script=FILE) in this process,
+ * so that the commands share one authenticated session.
+ */
+static int
+runScript(
+        const S9sString      &fileName,
+        const S9sVariantList &commonArguments)
+{
+    S9sScript script;
+
+    script.setCommonArguments(commonArguments);
+    if (!script.load(fileName))
+    {
+        PRINT_ERROR("%s", STR(script.errorString()));
+        return S9sOptions::Failed;
+    }
+
+    return script.exec(runCommand);
+}
+
+int 
+main(int argc, char **argv)
+{
+    S9sString      scriptFile;
+    S9sVariantList commonArguments;
+    int            exitStatus;
+
+    setlocale(LC_NUMERIC, getenv("C"));
+    setlocale(LC_ALL,     getenv("C"));
+    //setlocale(LC_NUMERIC, getenv("LC_NUMERIC"));
+    //setlocale(LC_ALL,     getenv("LC_ALL"));
+
+    #if 0
+    for (;;)
+    {
+        S9sString progress = S9sRpcReply::progressBar(true);
+        printf("-> %s\n", STR(progress));
+
+        sleep(1);
+    }
+    #endif
+
+    /*
+     * The batch script mode executes all the commands here, in one process.
+     */
+    if (S9sScript::scriptRequested(argc, argv, scriptFile, commonArguments))
+    {
+        exitStatus = runScript(scriptFile, commonArguments);
+        S9sRpcStats::finalize();
+
+        return exitStatus;
+    }
+
+    /*
+     * If there is an s9s --daemon running the command is executed by the
+     * daemon, that has the authenticated session ready.
+     */
+    if (S9sDaemon::forwardCommand(argc, argv, exitStatus))
+        return exitStatus;
+
+    exitStatus = runCommand(argc, argv);
+    S9sRpcStats::finalize();
+
+    return exitStatus;
+}
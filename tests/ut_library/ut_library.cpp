@@ -20,8 +20,21 @@
 #include "ut_library.h"
 
 #include <libs9s/library.h>
+#include "S9sOptions"
+#include "S9sFile"
+#include "S9sScript"
+#include "S9sEventRelay"
+#include "S9sDaemon"
+#include "S9sDir"
 #include <cstdio>
+#include <cstdlib>
+#include <signal.h>
+#include <sys/wait.h>
 #include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 //#define DEBUG
 #include "s9sdebug.h"
@@ -42,6 +55,11 @@ UtLibrary::runTest(const char *testName)
 
     S9S_DEBUG(" *** running test: %s\n", testName ? testName: "all");
     PERFORM_TEST(test01, retval);
+    PERFORM_TEST(testLog, retval);
+    PERFORM_TEST(testScript, retval);
+    PERFORM_TEST(testScriptOptions, retval);
+    PERFORM_TEST(testEventRelay, retval);
+    PERFORM_TEST(testDaemon, retval);
 
     return retval;
 }
@@ -52,4 +70,360 @@ UtLibrary::test01()
     return true;
 }
 
+static int nEvaluated = 0;
+
+static const char *
+logArgument()
+{
+    ++nEvaluated;
+    return "argument";
+}
+
+/**
+ * The arguments of the log lines should be evaluated only if there is a log
+ * file and the lines should get into the file.
+ */
+bool
+UtLibrary::testLog()
+{
+    S9sOptions *options  = S9sOptions::instance();
+    S9sString   fileName = "/tmp/ut_library.log";
+    S9sFile     file(fileName);
+    S9sString   content;
+    const char *argv[]   = 
+    { 
+        "s9s", "tree", "--list", "--log-file=/tmp/ut_library.log", NULL 
+    };
+    int         argc     = 4;
+
+    ::unlink(STR(fileName));
+    
+    S9S_VERIFY(!s9s_log_enabled());
+    PRINT_LOG("This is not printed: %s", logArgument());
+    S9S_COMPARE(nEvaluated, 0);
+
+    S9S_VERIFY(options->readOptions(&argc, (char **) argv));
+    S9S_VERIFY(s9s_log_enabled());
+
+    PRINT_LOG("This is printed: %s", logArgument());
+    S9S_COMPARE(nEvaluated, 1);
+
+    s9s_log_flush();
+    S9S_VERIFY(file.readTxtFile(content));
+    S9S_VERIFY(content.contains("DEBUG This is printed: argument"));
+    S9S_VERIFY(!content.contains("This is not printed"));
+
+    ::unlink(STR(fileName));
+    S9sOptions::uninit();
+    s9s_log_reset();
+
+    return true;
+}
+
+/**
+ * Testing how the lines of the batch scripts are split into arguments.
+ */
+bool
+UtLibrary::testScript()
+{
+    S9sVariantList arguments;
+    bool           background;
+    S9sString      errorString;
+
+    S9S_VERIFY(S9sScript::parseLine(
+                "s9s node --list --long", arguments, background, 
+                errorString));
+    S9S_COMPARE(arguments.size(), 3);
+    S9S_COMPARE(arguments[0], "node");
+    S9S_COMPARE(arguments[2], "--long");
+    S9S_VERIFY(!background);
+
+    S9S_VERIFY(S9sScript::parseLine(
+                "cluster --create --cluster-name='my cluster' "
+                "--nodes=\"10.0.0.1;10.0.0.2\" a\\ b # comment", 
+                arguments, background, errorString));
+    S9S_COMPARE(arguments.size(), 5);
+    S9S_COMPARE(arguments[2], "--cluster-name=my cluster");
+    S9S_COMPARE(arguments[3], "--nodes=10.0.0.1;10.0.0.2");
+    S9S_COMPARE(arguments[4], "a b");
+    
+    S9S_VERIFY(S9sScript::parseLine(
+                "job --list --cluster-id=1 &", arguments, background, 
+                errorString));
+    S9S_COMPARE(arguments.size(), 3);
+    S9S_VERIFY(background);
+    
+    S9S_VERIFY(S9sScript::parseLine(
+                "  # Just a comment.", arguments, background, errorString));
+    S9S_VERIFY(arguments.empty());
+
+    S9S_VERIFY(!S9sScript::parseLine(
+                "node --list --nodes='10.0.0.1", arguments, background, 
+                errorString));
+    S9S_VERIFY(!S9sScript::parseLine(
+                "node --list & --long", arguments, background, errorString));
+
+    return true;
+}
+
+/*
+ * The command function for testScriptOptions(), it only parses the command
+ * line and records what it found.
+ */
+static S9sVariantList parsedCommands;
+
+static int
+parseCommand(
+        int    argc,
+        char **argv)
+{
+    S9sOptions    *options = S9sOptions::instance();
+    S9sVariantMap  command;
+
+    command["success"]    = options->readOptions(&argc, argv);
+    command["node"]       = options->isNodeOperation();
+    command["list"]       = options->isListRequested();
+    command["long"]       = options->isLongRequested();
+    command["cluster_id"] = options->clusterId();
+    parsedCommands << command;
+
+    S9sOptions::uninit();
+    return 0;
+}
+
+/**
+ * Executing a script with two commands in one process, the second command
+ * should have all of its options parsed.
+ */
+bool
+UtLibrary::testScriptOptions()
+{
+    S9sString  fileName = "/tmp/ut_library.s9s";
+    S9sFile    file(fileName);
+    S9sScript  script;
+
+    S9S_VERIFY(file.writeTxtFile(
+                "cluster --list --long --cluster-id=2\n"
+                "node --list --cluster-id=1 --long\n"));
+
+    S9S_VERIFY(script.load(fileName));
+    S9S_COMPARE(script.exec(parseCommand), 0);
+    S9S_COMPARE(parsedCommands.size(), 2);
+
+    for (uint idx = 0u; idx < parsedCommands.size(); ++idx)
+    {
+        S9sVariantMap command = parsedCommands[idx].toVariantMap();
+
+        S9S_VERIFY(command["success"].toBoolean());
+        S9S_VERIFY(command["list"].toBoolean());
+        S9S_VERIFY(command["long"].toBoolean());
+    }
+
+    S9S_VERIFY(parsedCommands[1].toVariantMap().at("node").toBoolean());
+    S9S_COMPARE(parsedCommands[0].toVariantMap().at("cluster_id"), 2);
+    S9S_COMPARE(parsedCommands[1].toVariantMap().at("cluster_id"), 1);
+
+    ::unlink(STR(fileName));
+    return true;
+}
+
+/**
+ * \returns The name of the ring the event relay test uses, so a relay the user
+ *   runs does not disturb the test.
+ */
+static S9sString
+testRelayName()
+{
+    S9sString retval;
+
+    retval.sprintf("/s9s-ut-library-%d", (int) getpid());
+    return retval;
+}
+
+/**
+ * Testing the ring buffer of the event relay with one writer and two readers,
+ * one of them is too slow, the other one attaches late.
+ */
+bool
+UtLibrary::testEventRelay()
+{
+    S9sOptions    *options = S9sOptions::instance();
+    S9sString      name    = testRelayName();
+    S9sEventRelay  relay(name);
+    S9sEventRelay  reader(name);
+    S9sEventRelay  lateReader(name);
+    S9sString      origController;
+    S9sString      record;
+    S9sString      expected;
+    S9sString      otherName;
+    int            first;
+    int            fd;
+
+    S9S_VERIFY(relay.create(1024));
+    S9S_COMPARE(relay.name(), name);
+    S9S_VERIFY(reader.attach());
+    S9S_VERIFY(!reader.read(record));
+
+    S9S_VERIFY(relay.publish("record-0"));
+    S9S_VERIFY(relay.publish("record-1"));
+    S9S_VERIFY(reader.read(record));
+    S9S_COMPARE(record, "record-0");
+    S9S_VERIFY(reader.read(record));
+    S9S_COMPARE(record, "record-1");
+    S9S_VERIFY(!reader.read(record));
+
+    // Writing much more than what fits, the ring wraps a few times.
+    for (int idx = 2; idx < 200; ++idx)
+    {
+        record.sprintf("record-%d", idx);
+        S9S_VERIFY(relay.publish(record));
+    }
+
+    // The reader lost some records, but continues with the oldest one that
+    // is still in the ring and gets the rest in order.
+    S9S_VERIFY(reader.read(record));
+    S9S_VERIFY(reader.nLost() > 0ull);
+    S9S_VERIFY(record.startsWith("record-"));
+    first = S9sString(record.substr(7)).toInt();
+    S9S_VERIFY(first > 2);
+
+    for (int idx = first + 1; idx < 200; ++idx)
+    {
+        expected.sprintf("record-%d", idx);
+        S9S_VERIFY(reader.read(record));
+        S9S_COMPARE(record, expected);
+    }
+    
+    S9S_VERIFY(!reader.read(record));
+
+    // The late reader replays what is in the ring.
+    S9S_VERIFY(lateReader.attach());
+    S9S_VERIFY(lateReader.read(record));
+    S9S_COMPARE(S9sString(record.substr(7)).toInt(), first);
+
+    // Only one relay can run at a time.
+    S9S_VERIFY(!S9sEventRelay(name).create(1024));
+
+    // A ring that other users could write is not accepted.
+    fd = shm_open(STR(name), O_RDONLY, 0);
+    S9S_VERIFY(fd >= 0);
+    S9S_VERIFY(fchmod(fd, 0622) == 0);
+    S9S_VERIFY(!S9sEventRelay(name).attach());
+    S9S_VERIFY(fchmod(fd, 0600) == 0);
+    S9S_VERIFY(S9sEventRelay(name).attach());
+    ::close(fd);
+
+    // The controllers with similar names have their own rings.
+    origController.sprintf("%s:%d",
+            STR(options->controllerHostName()), options->controllerPort());
+
+    options->setController("a b:9501");
+    name = S9sEventRelay::shmName();
+    options->setController("a_b:9501");
+    otherName = S9sEventRelay::shmName();
+    options->setController(origController);
+
+    S9S_VERIFY(name != otherName);
+    S9S_VERIFY(!name.contains(" "));
+
+    return true;
+}
+
+/**
+ * \returns The exit code the test daemon's workers return: it shows the
+ *   command line the worker got from the daemon.
+ */
+static int
+workerExitCode(
+        int     argc,
+        char  **argv)
+{
+    if (argc == 3 && strcmp(argv[1], "cluster") == 0 && 
+            strcmp(argv[2], "--list") == 0)
+    {
+        return 42;
+    } else if (argc == 4 && strcmp(argv[1], "node") == 0 &&
+            strcmp(argv[2], "--list") == 0 &&
+            strcmp(argv[3], "--long") == 0)
+    {
+        return 43;
+    }
+
+    return 1;
+}
+
+/**
+ * Starts a daemon in a child process and forwards commands to it. The workers
+ * of the daemon exit with a code that shows the command line they got.
+ */
+bool
+UtLibrary::testDaemon()
+{
+    S9sString   origHome = getenv("HOME");
+    S9sString   tmpHome  = "/tmp/ut_library_home";
+    S9sDir      dir(tmpHome + "/.s9s");
+    const char *clusterList[] = { "s9s", "cluster", "--list", NULL };
+    const char *nodeList[]    = { "s9s", "node", "--list", "--long", NULL };
+    const char *daemonArgs[]  = { "s9s", "--daemon", NULL };
+    int         exitStatus = 0;
+    bool        forwarded  = false;
+    int         status;
+    pid_t       pid;
+
+    setenv("HOME", STR(tmpHome), 1);
+    unsetenv("S9S_NO_DAEMON");
+    S9S_VERIFY(dir.exists() || dir.mkdir());
+    ::unlink(STR(S9sDaemon::socketPath()));
+
+    // There is no daemon.
+    S9S_VERIFY(!S9sDaemon::forwardCommand(3, (char **) clusterList, exitStatus));
+
+    fflush(NULL);
+    pid = fork();
+    if (pid == 0)
+    {
+        S9sDaemon daemon;
+
+        if (daemon.exec())
+            _exit(workerExitCode(daemon.argc(), daemon.argv()));
+
+        _exit(1);
+    }
+
+    S9S_VERIFY(pid > 0);
+
+    // Waiting for the daemon to listen.
+    for (int idx = 0; idx < 500 && !forwarded; ++idx)
+    {
+        forwarded = S9sDaemon::forwardCommand(
+                3, (char **) clusterList, exitStatus);
+
+        if (!forwarded)
+            usleep(10000);
+    }
+
+    S9S_VERIFY(forwarded);
+    S9S_COMPARE(exitStatus, 42);
+
+    // The second command is parsed by a new worker.
+    S9S_VERIFY(S9sDaemon::forwardCommand(4, (char **) nodeList, exitStatus));
+    S9S_COMPARE(exitStatus, 43);
+
+    // Only one daemon can listen and the daemon is not forwarded to itself.
+    S9S_VERIFY(!S9sDaemon().exec());
+    S9S_VERIFY(!S9sDaemon::forwardCommand(2, (char **) daemonArgs, exitStatus));
+
+    // The daemon can be switched off by the environment.
+    setenv("S9S_NO_DAEMON", "1", 1);
+    S9S_VERIFY(!S9sDaemon::forwardCommand(3, (char **) clusterList, exitStatus));
+    unsetenv("S9S_NO_DAEMON");
+
+    kill(pid, SIGTERM);
+    S9S_VERIFY(waitpid(pid, &status, 0) == pid);
+    ::unlink(STR(S9sDaemon::socketPath()));
+
+    setenv("HOME", STR(origHome), 1);
+    return true;
+}
+
 S9S_UNIT_TEST_MAIN(UtLibrary)
@@ -30,5 +30,10 @@ class UtLibrary : public S9sUnitTest
     protected:
 
         bool test01();
+        bool testLog();
+        bool testScript();
+        bool testScriptOptions();
+        bool testEventRelay();
+        bool testDaemon();
 };
 
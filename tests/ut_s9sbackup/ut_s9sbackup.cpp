@@ -23,6 +23,7 @@
 #include "S9sVariantMap"
 #include "S9sRpcClient"
 #include "S9sOptions"
+#include "S9sRowRenderer"
 
 #define DEBUG
 #define WARNING
@@ -115,6 +116,7 @@ UtS9sBackup::runTest(const char *testName)
     PERFORM_TEST(testCreate,          retval);
     PERFORM_TEST(testSetProperties,   retval);
     PERFORM_TEST(testAssign,          retval);
+    PERFORM_TEST(testRowRenderer,     retval);
 
     return retval;
 }
@@ -247,5 +249,80 @@ UtS9sBackup::testAssign()
     return true;
 }
 
+static void
+widenBackupRow(
+        void                 *userData,
+        const S9sVariant     &row,
+        S9sVector<S9sFormat> &columns)
+{
+    S9sBackup backup = row.toVariantMap();
+
+    columns[0].widen(backup.id());
+    columns[1].widen(backup.backupHost());
+}
+
+static void
+renderBackupRow(
+        void                 *userData,
+        const S9sVariant     &row,
+        S9sVector<S9sFormat> &columns,
+        S9sString            &output)
+{
+    S9sBackup backup = row.toVariantMap();
+
+    columns[0].printf(backup.id());
+    columns[1].printf(backup.backupHost());
+    output += backup.status();
+    output += "\n";
+}
+
+/**
+ * Rendering a list of backups with one and with several threads, the results
+ * should be the same.
+ */
+bool
+UtS9sBackup::testRowRenderer()
+{
+    S9sVariantMap        theMap;
+    S9sVariantList       rows;
+    S9sVector<S9sFormat> columns1;
+    S9sVector<S9sFormat> columns2;
+    S9sString            output1;
+    S9sString            output2;
+
+    S9S_VERIFY(theMap.parse(backupJson1));
+    for (int idx = 1; idx <= 1000; ++idx)
+    {
+        theMap["id"] = idx;
+        rows << theMap;
+    }
+
+    columns1.resize(2);
+    columns2.resize(2);
+
+    S9sRowRenderer renderer1(rows, NULL);
+    renderer1.setMaxThreads(1);
+    S9S_COMPARE(renderer1.nThreads(), 1);
+
+    renderer1.widen(widenBackupRow, columns1);
+    output1 = renderer1.render(renderBackupRow, columns1);
+
+    S9sRowRenderer renderer2(rows, NULL);
+    renderer2.setMaxThreads(4);
+    renderer2.setRowsPerThread(100);
+    S9S_COMPARE(renderer2.nThreads(), 4);
+
+    renderer2.widen(widenBackupRow, columns2);
+    output2 = renderer2.render(renderBackupRow, columns2);
+
+    S9S_COMPARE(columns2[0].realWidth(), 5);
+    S9S_COMPARE(columns2[1].realWidth(), 14);
+    S9S_COMPARE(output2.split("\n").size(), 1000);
+    S9S_VERIFY(output2.startsWith("   1 192.168.1.134 COMPLETED\n"));
+    S9S_VERIFY(output1 == output2);
+
+    return true;
+}
+
 S9S_UNIT_TEST_MAIN(UtS9sBackup)
 
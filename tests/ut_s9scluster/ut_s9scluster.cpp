@@ -20,6 +20,7 @@
 #include "ut_s9scluster.h"
 
 #include "S9sCluster"
+#include "S9sReplicationTopology"
 #include "S9sVariantMap"
 #include "S9sRpcClient"
 #include "S9sOptions"
@@ -337,6 +338,7 @@ UtS9sCluster::runTest(const char *testName)
     PERFORM_TEST(testCreate,          retval);
     PERFORM_TEST(testAssign,          retval);
     PERFORM_TEST(testToString,        retval);
+    PERFORM_TEST(testReplicationTopology, retval);
 
     return retval;
 }
@@ -459,5 +461,86 @@ UtS9sCluster::testToString()
     return true;
 }
 
+/*
+ * A master with a chain of two slaves and a master-master pair.
+ */
+static const char *replicationJson = 
+"{\n"
+"    'cluster_id': 5,\n"
+"    'hosts': [\n"
+"    {\n"
+"        'hostname': '10.0.0.1', 'port': 3306, 'role': 'master'\n"
+"    },\n"
+"    {\n"
+"        'hostname': '10.0.0.2', 'port': 3306, 'role': 'slave',\n"
+"        'replication_slave': {\n"
+"            'master_host': '10.0.0.1', 'master_port': '3306',\n"
+"            'seconds_behind_master': '4'\n"
+"        }\n"
+"    },\n"
+"    {\n"
+"        'hostname': '10.0.0.3', 'port': 3306, 'role': 'slave',\n"
+"        'replication_slave': {\n"
+"            'master_host': '10.0.0.2', 'master_port': '3306',\n"
+"            'seconds_behind_master': '8'\n"
+"        }\n"
+"    },\n"
+"    {\n"
+"        'hostname': '10.0.0.4', 'port': 3306, 'role': 'multi',\n"
+"        'replication_slave': {\n"
+"            'master_host': '10.0.0.5', 'master_port': '3306'\n"
+"        }\n"
+"    },\n"
+"    {\n"
+"        'hostname': '10.0.0.5', 'port': 3306, 'role': 'multi',\n"
+"        'replication_slave': {\n"
+"            'master_host': '10.0.0.4', 'master_port': '3306'\n"
+"        }\n"
+"    }\n"
+"    ]\n"
+"}\n";
+
+bool
+UtS9sCluster::testReplicationTopology()
+{
+    S9sVariantMap          theMap;
+    S9sVariantList         clusterList;
+    S9sReplicationTopology topology;
+    S9sVector<uint>        links;
+    S9sVector<int>         history;
+
+    S9S_VERIFY(theMap.parse(replicationJson));
+    clusterList << theMap;
+
+    topology.build(clusterList);
+    S9S_COMPARE(topology.nLinks(), 4);
+    S9S_VERIFY(topology.hasNode("10.0.0.3", 3306));
+    S9S_VERIFY(!topology.hasNode("10.0.0.3", 3307));
+    S9S_COMPARE(topology.node("10.0.0.1", 3306).role(), "master");
+    
+    links = topology.slaveLinks("10.0.0.2:3306");
+    S9S_COMPARE(links.size(), 1);
+    S9S_COMPARE(topology.link(links[0]).slaveName(), "10.0.0.3:3306");
+    S9S_COMPARE(topology.link(links[0]).clusterId(), 5);
+    S9S_COMPARE(topology.link(links[0]).secondsBehindMaster(), 8);
+    
+    S9S_VERIFY(topology.hasCycle());
+    S9S_VERIFY(topology.isInCycle("10.0.0.4:3306"));
+    S9S_VERIFY(topology.isInCycle("10.0.0.5:3306"));
+    S9S_VERIFY(!topology.isInCycle("10.0.0.2:3306"));
+    S9S_VERIFY(!topology.isInCycle("10.0.0.1:3306"));
+
+    /*
+     * Building again adds a new lag sample to the history of every link.
+     */
+    topology.build(clusterList);
+    history = topology.lagHistory(links[0]);
+    S9S_COMPARE(history.size(), 2);
+    S9S_COMPARE(history[0], 8);
+    S9S_COMPARE(history[1], 8);
+
+    return true;
+}
+
 S9S_UNIT_TEST_MAIN(UtS9sCluster)
 
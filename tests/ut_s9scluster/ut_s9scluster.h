@@ -30,5 +30,6 @@ class UtS9sCluster : public S9sUnitTest
         bool testCreate();
         bool testAssign();
         bool testToString();
+        bool testReplicationTopology();
 };
 
@@ -22,9 +22,13 @@
 #include "S9sFile"
 #include "S9sEvent"
 #include "S9sDateTime"
+#include "S9sStateFile"
 
 #include <cstdio>
 #include <cstring>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
 
 #define DEBUG
 #define WARNING
@@ -48,6 +52,9 @@ UtS9sFile::runTest(
     bool retval = true;
 
     PERFORM_TEST(testConstruct,   retval);
+    PERFORM_TEST(testStateFile,   retval);
+    PERFORM_TEST(testMappedRead,  retval);
+    PERFORM_TEST(testReadPipe,    retval);
 
     return retval;
 }
@@ -91,4 +98,198 @@ UtS9sFile::testConstruct()
     return true;
 }
 
+/**
+ * Two state file objects are used as if they were in two s9s processes, they
+ * should not overwrite the values of each other.
+ */
+bool
+UtS9sFile::testStateFile()
+{
+    S9sString      path = "/tmp/ut_s9sfile.state";
+    S9sStateFile   stateFile1(path);
+    S9sStateFile   stateFile2(path);
+    S9sVariantMap  state1, state2, controller;
+    S9sVariantList controllers, loaded;
+    struct stat    stat1, stat2;
+
+    ::unlink(STR(stateFile1.path()));
+    ::unlink(STR(stateFile1.redirectPath()));
+
+    S9S_VERIFY(!stateFile1.load(state1));
+    S9S_VERIFY(stateFile1.setValue("first", 1, state1));
+    S9S_VERIFY(stateFile2.setValue("second", "two", state2));
+    S9S_COMPARE(state2["first"].toInt(), 1);
+
+    S9S_VERIFY(stateFile1.load(state1));
+    S9S_COMPARE(state1["first"].toInt(), 1);
+    S9S_COMPARE(state1["second"].toString(), "two");
+
+    // Setting the same value should not write the file.
+    S9S_VERIFY(::stat(STR(stateFile1.path()), &stat1) == 0);
+    S9S_VERIFY(stateFile1.setValue("second", "two", state1));
+    S9S_VERIFY(::stat(STR(stateFile1.path()), &stat2) == 0);
+    S9S_COMPARE((ulonglong) stat1.st_ino, (ulonglong) stat2.st_ino);
+
+    // The redirects.
+    controller["hostname"] = "192.168.0.127";
+    controller["ip"]       = "192.168.0.127";
+    controller["port"]     = 9556;
+    controllers << controller;
+    controller["port"]     = 10001;
+    controllers << controller;
+
+    S9S_VERIFY(!stateFile1.loadRedirect("https://127.0.0.1:9501", loaded));
+    S9S_VERIFY(stateFile1.saveRedirect("https://127.0.0.1:9501", controllers));
+    S9S_VERIFY(stateFile2.saveRedirect("https://127.0.0.1:9502", controllers));
+    S9S_VERIFY(stateFile2.loadRedirect("https://127.0.0.1:9501", loaded));
+    S9S_COMPARE(loaded.size(), 2);
+    S9S_COMPARE(loaded[1].toVariantMap().at("port").toInt(), 10001);
+    S9S_COMPARE(
+            loaded[0].toVariantMap().at("hostname").toString(), 
+            "192.168.0.127");
+
+    S9S_VERIFY(stateFile2.saveRedirect(
+                "https://127.0.0.1:9501", S9sVariantList()));
+    S9S_VERIFY(!stateFile1.loadRedirect("https://127.0.0.1:9501", loaded));
+    S9S_VERIFY(stateFile1.loadRedirect("https://127.0.0.1:9502", loaded));
+    S9S_COMPARE(loaded.size(), 2);
+
+    ::unlink(STR(stateFile1.path()));
+    ::unlink(STR(stateFile1.redirectPath()));
+    ::unlink(STR(stateFile1.path() + ".lock"));
+
+    return true;
+}
+
+/**
+ * Reading events and JSON files through the mapped read path.
+ */
+bool
+UtS9sFile::testMappedRead()
+{
+    S9sString      path = "/tmp/ut_s9sfile.events";
+    S9sFile        file(path);
+    S9sFile        inputFile(path);
+    S9sFile        emptyFile("/tmp/ut_s9sfile.empty");
+    S9sEvent       event;
+    S9sVariantMap  theMap;
+    const char    *json = "{ \"a\": 1 }{ \"a\": 2 }";
+
+    // Parsing only a part of a buffer that is not null terminated.
+    S9S_VERIFY(theMap.parse(json, 10));
+    S9S_COMPARE(theMap["a"].toInt(), 1);
+    S9S_VERIFY(theMap.parse(json + 10, 10));
+    S9S_COMPARE(theMap["a"].toInt(), 2);
+
+    // The events are separated by empty lines, the last one is not.
+    S9S_VERIFY(file.writeTxtFile(
+            "\n"
+            "{\n"
+            "    \"event_class\": \"EventJob\",\n"
+            "    \"event_origins\": { \"sender_line\": 1 }\n"
+            "}\n"
+            "\r\n"
+            "\n"
+            "{\n"
+            "    \"event_class\": \"EventHost\",\n"
+            "    \"event_origins\": { \"sender_line\": 2 }\n"
+            "}"));
+
+    S9S_VERIFY(inputFile.readEvent(event));
+    S9S_VERIFY(inputFile.isMapped());
+    S9S_COMPARE(event.eventTypeString(), "EventJob");
+    S9S_COMPARE(event.senderLine(), 1);
+    S9S_VERIFY(inputFile.readEvent(event));
+    S9S_COMPARE(event.eventTypeString(), "EventHost");
+    S9S_COMPARE(event.senderLine(), 2);
+    S9S_VERIFY(!inputFile.readEvent(event));
+    S9S_COMPARE((int) inputFile.lineNumber(), 10);
+
+    // A whole JSON file.
+    S9S_VERIFY(file.writeTxtFile("{ \"name\": \"value\", \"number\": 42 }"));
+    S9S_VERIFY(file.readJsonFile(theMap));
+    S9S_VERIFY(!file.isMapped());
+    S9S_COMPARE(theMap["name"].toString(), "value");
+    S9S_COMPARE(theMap["number"].toInt(), 42);
+
+    S9S_VERIFY(file.writeTxtFile("{ \"name\": "));
+    S9S_VERIFY(!file.readJsonFile(theMap));
+    S9S_VERIFY(theMap.empty());
+
+    // An empty file can be mapped, but has no events in it.
+    S9S_VERIFY(emptyFile.writeTxtFile(""));
+    S9S_VERIFY(emptyFile.mapForRead());
+    S9S_VERIFY(emptyFile.mappedData() == NULL);
+    S9S_VERIFY(emptyFile.mappedSize() == 0);
+    S9S_VERIFY(!emptyFile.readEvent(event));
+
+    // A file truncated while it is mapped is not read beyond its end.
+    S9S_VERIFY(file.writeTxtFile(
+            "{ \"event_class\": \"EventJob\" }\n"
+            "\n"
+            "{ \"event_class\": \"EventHost\" }\n"));
+
+    S9S_VERIFY(inputFile.mapForRead());
+    S9S_VERIFY(::truncate(STR(path), 0) == 0);
+    S9S_VERIFY(!inputFile.readEvent(event));
+    S9S_VERIFY(!inputFile.errorString().empty());
+    inputFile.close();
+
+    ::unlink(STR(path));
+    ::unlink(STR(emptyFile.path()));
+    return true;
+}
+
+/**
+ * A pipe is not mapped, the events written into it are read by the stream
+ * reader and nothing is lost.
+ */
+bool
+UtS9sFile::testReadPipe()
+{
+    S9sString      path = "/tmp/ut_s9sfile.fifo";
+    S9sFile        inputFile(path);
+    S9sEvent       event;
+    int            status;
+    pid_t          pid;
+
+    ::unlink(STR(path));
+    S9S_VERIFY(::mkfifo(STR(path), 0600) == 0);
+
+    S9S_VERIFY(!S9sFile(path).mapForRead());
+
+    fflush(NULL);
+    pid = fork();
+    if (pid == 0)
+    {
+        FILE *output = fopen(STR(path), "w");
+
+        if (output == NULL)
+            _exit(1);
+
+        fprintf(output, 
+                "{ \"event_class\": \"EventJob\" }\n"
+                "\n"
+                "{ \"event_class\": \"EventHost\" }\n"
+                "\n");
+
+        _exit(fclose(output) == 0 ? 0 : 1);
+    }
+
+    S9S_VERIFY(pid > 0);
+    S9S_VERIFY(inputFile.readEvent(event));
+    S9S_VERIFY(!inputFile.isMapped());
+    S9S_COMPARE(event.eventTypeString(), "EventJob");
+    S9S_VERIFY(inputFile.readEvent(event));
+    S9S_COMPARE(event.eventTypeString(), "EventHost");
+    S9S_VERIFY(!inputFile.readEvent(event));
+
+    S9S_VERIFY(waitpid(pid, &status, 0) == pid);
+    S9S_VERIFY(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    inputFile.close();
+    ::unlink(STR(path));
+    return true;
+}
+
 S9S_UNIT_TEST_MAIN(UtS9sFile)
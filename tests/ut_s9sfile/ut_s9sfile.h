@@ -29,6 +29,9 @@ class UtS9sFile : public S9sUnitTest
     
     protected:
         bool testConstruct();
+        bool testStateFile();
+        bool testMappedRead();
+        bool testReadPipe();
 };
 
 
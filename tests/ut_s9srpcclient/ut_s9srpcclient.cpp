@@ -21,6 +21,14 @@
 
 #include "S9sNode"
 #include "S9sOptions"
+#include "S9sStatCache"
+#include "S9sReplyCache"
+#include "S9sRpcStats"
+#include "S9sFile"
+#include "s9srpcclient_p.h"
+
+#include <unistd.h>
+#include <sys/stat.h>
 
 //#define DEBUG
 #define WARNING
@@ -106,6 +114,10 @@ UtS9sRpcClient::runTest(
     PERFORM_TEST(testGetSqlStats,         retval);
     PERFORM_TEST(testGetMemStats,         retval);
     PERFORM_TEST(testGetMemoryStats,      retval);
+    PERFORM_TEST(testStatCache,           retval);
+    PERFORM_TEST(testReplyCache,          retval);
+    PERFORM_TEST(testSessionReuse,        retval);
+    PERFORM_TEST(testRpcStats,            retval);
     PERFORM_TEST(testGetRunningProcesses, retval);
     PERFORM_TEST(testGetJobInstances,     retval);
     PERFORM_TEST(testKillJobInstance,     retval);
@@ -132,6 +144,7 @@ UtS9sRpcClient::runTest(
     PERFORM_TEST(testGetJobInstance,      retval);
     PERFORM_TEST(testDeleteJobInstance,   retval);
     PERFORM_TEST(testGetJobLog,           retval);
+    PERFORM_TEST(testGetLogEntries,       retval);
     PERFORM_TEST(testGetAlarm,            retval);
     PERFORM_TEST(testGetAlarmStatistics,  retval);
     PERFORM_TEST(testCreateFailJob,       retval);
@@ -513,6 +526,345 @@ UtS9sRpcClient::testGetMemoryStats()
     return true;
 }
 
+/**
+ * Testing the merging and expiring of the samples in the stat cache, the
+ * samples that are received twice should be stored only once.
+ */
+bool
+UtS9sRpcClient::testStatCache()
+{
+    S9sString       origHome = getenv("HOME");
+    S9sStatCache    cache("localhost", 9501, "42", "cpustat");
+    S9sStatCache    loaded("localhost", 9501, "42", "cpustat");
+    S9sVariantList  samples;
+    S9sVariantList  hosts;
+    S9sVariantList  files;
+    S9sVariantMap   sample;
+    S9sVariantMap   host;
+
+    S9S_COMPARE(cache.nSamples(), 0);
+    S9S_COMPARE(cache.missingStart(1000), 1000);
+
+    host["hostid"]      = 1;
+    host["hostname"]    = "192.168.0.1";
+    hosts << host;
+
+    for (int idx = 0; idx < 10; ++idx)
+    {
+        sample["hostid"]   = 1;
+        sample["created"]  = 1000 + idx * 60;
+        sample["interval"] = 60000;
+        samples << sample;
+    }
+
+    cache.merge(samples, hosts, 1600);
+    S9S_COMPARE(cache.nSamples(), 10);
+    S9S_COMPARE(cache.hosts().size(), 1);
+    S9S_COMPARE(cache.missingStart(1000), 1480);
+    S9S_COMPARE(cache.missingStart(1500), 1500);
+    S9S_COMPARE(cache.missingStart(2000), 2000);
+
+    /*
+     * Merging the overlapping samples again should not add new samples.
+     */
+    sample["created"] = 1600;
+    samples << sample;
+    
+    cache.merge(samples, S9sVariantList(), 1700);
+    S9S_COMPARE(cache.nSamples(), 11);
+    S9S_COMPARE(cache.hosts().size(), 1);
+    S9S_COMPARE(cache.samples(1300).size(), 7);
+
+    cache.expire(1300);
+    S9S_COMPARE(cache.nSamples(), 7);
+
+    /*
+     * The per-core samples of a host are taken at the same time, they should
+     * not be merged into one.
+     */
+    samples.clear();
+    sample.clear();
+
+    for (int cpuId = 0; cpuId < 4; ++cpuId)
+    {
+        sample["hostid"]   = 1;
+        sample["cpuid"]    = cpuId;
+        sample["created"]  = 2000;
+        sample["interval"] = 60000;
+        samples << sample;
+    }
+    
+    cache.merge(samples, S9sVariantList(), 2100);
+    S9S_COMPARE(cache.nSamples(), 11);
+    
+    cache.merge(samples, S9sVariantList(), 2100);
+    S9S_COMPARE(cache.nSamples(), 11);
+
+    samples.clear();
+    for (int cpuId = 0; cpuId < 4; ++cpuId)
+    {
+        S9sString key;
+
+        key.sprintf("CmonCpuStats-1-%d", cpuId);
+        sample["samplekey"] = key;
+        sample["cpuid"]     = 0;
+        sample["created"]   = 2060;
+        samples << sample;
+    }
+    
+    cache.merge(samples, S9sVariantList(), 2200);
+    S9S_COMPARE(cache.nSamples(), 15);
+
+    /*
+     * Saving into a temporary home directory, the cache file is replaced in
+     * one step, no temporary file is left behind.
+     */
+    setenv("HOME", "/tmp/ut_s9srpcclient_home", 1);
+
+    S9S_VERIFY(cache.save());
+    S9S_VERIFY(cache.save());
+    S9S_VERIFY(loaded.load());
+    S9S_COMPARE(loaded.nSamples(), 15);
+
+    S9sFile::listFiles(S9sFile::dirname(S9sFile(cache.path()).path()), 
+            files, true);
+    S9S_COMPARE(files.size(), 1);
+    
+    ::unlink(STR(S9sFile(cache.path()).path()));
+    setenv("HOME", STR(origHome), 1);
+
+    return true;
+}
+
+/**
+ * Storing and finding the replies in the reply cache. The shared store is
+ * written into a temporary home directory.
+ */
+bool
+UtS9sRpcClient::testReplyCache()
+{
+    S9sString       origHome = getenv("HOME");
+    S9sString       tmpHome;
+    S9sReplyCache   cache("localhost", 9501, "pipas");
+    S9sReplyCache   otherUser("localhost", 9501, "system");
+    S9sVariantMap   request;
+    S9sVariantMap   reply;
+    S9sVariantMap   cached;
+    S9sVariantList  files;
+    ulonglong       sent;
+
+    tmpHome = "/tmp/ut_s9srpcclient_home";
+    setenv("HOME", STR(tmpHome), 1);
+    S9sReplyCache::invalidate();
+
+    S9S_VERIFY(S9sReplyCache::isReadOnly("getAllClusterInfo"));
+    S9S_VERIFY(S9sReplyCache::isReadOnly("ping"));
+    S9S_VERIFY(!S9sReplyCache::isReadOnly("createJobInstance"));
+    S9S_VERIFY(!S9sReplyCache::isReadOnly("deleteUser"));
+    S9S_COMPARE(S9sReplyCache::timeToLive("getMetaTypes"), 3600);
+    S9S_COMPARE(S9sReplyCache::timeToLive("getJobInstances"), 0);
+
+    request["operation"]  = "getAllClusterInfo";
+    request["with_hosts"] = true;
+    reply["request_status"] = "Ok";
+    reply["total"]          = 2;
+
+    S9S_VERIFY(S9sReplyCache::isCacheable(request));
+    S9S_VERIFY(!cache.find("/v2/clusters/", request, cached));
+
+    // The request ID and the creation time are not part of the key.
+    request["request_id"] = 42;
+    cache.store("/v2/clusters/", request, reply, S9sReplyCache::timeStamp());
+    request["request_id"] = 43;
+
+    S9S_VERIFY(cache.find("/v2/clusters/", request, cached));
+    S9S_COMPARE(cached["total"].toInt(), 2);
+    S9S_VERIFY(!otherUser.find("/v2/clusters/", request, cached));
+
+    /*
+     * The stored files are only readable by the owner, even if they existed
+     * with other permissions.
+     */
+    S9sFile::listFiles(tmpHome + "/.s9s/reply_cache", files, true);
+    for (uint idx = 0u; idx < files.size(); ++idx)
+    {
+        if (!files[idx].toString().endsWith(".json"))
+            files.erase(files.begin() + idx--);
+    }
+
+    S9S_COMPARE(files.size(), 1);
+    ::chmod(STR(files[0].toString()), 0644);
+
+    cache.store("/v2/clusters/", request, reply, S9sReplyCache::timeStamp());
+
+    for (uint idx = 0u; idx < files.size(); ++idx)
+    {
+        struct stat info;
+
+        S9S_VERIFY(::stat(STR(files[idx].toString()), &info) == 0);
+        S9S_COMPARE((int) (info.st_mode & 0777), 0600);
+    }
+
+    S9S_VERIFY(!cache.find("/v2/tree", request, cached));
+
+    request["with_hosts"] = false;
+    S9S_VERIFY(!cache.find("/v2/clusters/", request, cached));
+
+    request["refresh_now"] = true;
+    S9S_VERIFY(!S9sReplyCache::isCacheable(request));
+
+    // Invalidating the cache.
+    request.erase("refresh_now");
+    request["with_hosts"] = true;
+    S9sReplyCache::invalidate();
+    S9S_VERIFY(!cache.find("/v2/clusters/", request, cached));
+
+    /*
+     * A reply to a request that was sent before the cache was invalidated
+     * might show the state before the change, it is not stored.
+     */
+    sent = S9sReplyCache::timeStamp();
+    usleep(1000);
+    S9sReplyCache::invalidate();
+    cache.store("/v2/clusters/", request, reply, sent);
+    S9S_VERIFY(!cache.find("/v2/clusters/", request, cached));
+
+    setenv("HOME", STR(origHome), 1);
+    return true;
+}
+
+/**
+ * The sessions remembered by the process should only be reused with the same
+ * credentials, a wrong password or an other key has to authenticate again.
+ */
+bool
+UtS9sRpcClient::testSessionReuse()
+{
+    S9sOptions     *options = S9sOptions::instance();
+    S9sRpcClient    client("localhost", 9501, "", false);
+    S9sRpcClient    otherController("localhost", 9502, "", false);
+    S9sFile         keyFile("/tmp/ut_s9srpcclient.key");
+
+    S9sRpcClient::forgetSessions();
+    options->m_options["cmon_user"] = "pipas";
+    options->m_options["password"]  = "secret";
+
+    // Nothing to reuse yet.
+    S9S_VERIFY(!client.reuseSession());
+
+    client.m_priv->m_cookies["cmon-sid"] = "1234";
+    client.rememberSession();
+
+    S9S_VERIFY(S9sRpcClient("localhost", 9501, "", false).reuseSession());
+    S9S_VERIFY(!otherController.reuseSession());
+
+    // An other password.
+    options->m_options["password"] = "wrong";
+    S9S_VERIFY(!S9sRpcClient("localhost", 9501, "", false).reuseSession());
+
+    options->m_options["password"] = "secret";
+    S9S_VERIFY(S9sRpcClient("localhost", 9501, "", false).reuseSession());
+    
+    // An other user.
+    options->m_options["cmon_user"] = "system";
+    S9S_VERIFY(!S9sRpcClient("localhost", 9501, "", false).reuseSession());
+    options->m_options["cmon_user"] = "pipas";
+
+    // Authentication with a key, the content of the key file matters.
+    options->m_options.erase("password");
+    options->m_options["private_key_file"] = keyFile.path();
+
+    S9S_VERIFY(keyFile.writeTxtFile("first key", 0600));
+    S9S_VERIFY(!S9sRpcClient("localhost", 9501, "", false).reuseSession());
+    client.rememberSession();
+    S9S_VERIFY(S9sRpcClient("localhost", 9501, "", false).reuseSession());
+
+    S9S_VERIFY(keyFile.writeTxtFile("second key", 0600));
+    S9S_VERIFY(!S9sRpcClient("localhost", 9501, "", false).reuseSession());
+
+    ::unlink(STR(keyFile.path()));
+    S9sRpcClient::forgetSessions();
+    return true;
+}
+
+/**
+ * Testing the RPC statistics: the requests are only recorded when the
+ * statistics are requested and they are summarized by the operations. Only the
+ * time until printingFinished() is called counts as printing.
+ */
+bool
+UtS9sRpcClient::testRpcStats()
+{
+    S9sOptions     *options = S9sOptions::instance();
+    S9sRpcStats     stats;
+    S9sVariantList  records;
+    S9sString       text;
+
+    S9sRpcStats::reset();
+
+    // Not requested, not recorded.
+    stats.start("getTree");
+    stats.addBytesReceived(2000);
+    stats.finish(true);
+    S9S_COMPARE(S9sRpcStats::records().size(), 0);
+    S9S_VERIFY(stats.toVariantMap().empty());
+
+    options->m_options["rpc_stats"] = "json";
+    S9S_VERIFY(S9sRpcStats::isEnabled());
+
+    for (int idx = 0; idx < 2; ++idx)
+    {
+        stats.start("getTree");
+        stats.setController("localhost", 9501);
+        stats.phaseFinished("dns");
+        stats.phaseFinished("connect");
+        stats.addBytesSent(100);
+        stats.addBytesReceived(2000);
+        stats.addAllocations(50);
+        stats.phaseFinished("parse");
+        stats.finish(idx == 0);
+
+        // Sleeping between the requests is not printing.
+        usleep(5000);
+    }
+
+    S9sRpcStats::printingFinished();
+    records = S9sRpcStats::records();
+    S9S_COMPARE(records.size(), 2);
+    S9S_COMPARE(records[0]["phases"]["print"].toULongLong(), 0ull);
+    S9S_VERIFY(records[1]["phases"]["print"].toULongLong() >= 5000ull);
+
+    // Printing is counted once.
+    S9sRpcStats::printingFinished();
+    S9S_COMPARE(
+            S9sRpcStats::records()[1]["phases"]["print"], 
+            records[1]["phases"]["print"]);
+
+    S9S_COMPARE(stats.toVariantMap().at("controller"), "localhost:9501");
+    S9S_COMPARE(stats.toVariantMap().at("bytes_received"), 2000);
+    S9S_VERIFY(stats.toVariantMap().at("phases").contains("parse"));
+
+    text = S9sRpcStats::prometheusText();
+    if (isVerbose())
+        printf("\n%s\n", STR(text));
+
+    S9S_VERIFY(text.contains(
+                "s9s_rpc_requests_total{operation=\"getTree\"} 2\n"));
+    S9S_VERIFY(text.contains(
+                "s9s_rpc_failed_requests_total{operation=\"getTree\"} 1\n"));
+    S9S_VERIFY(text.contains(
+                "s9s_rpc_sent_bytes_total{operation=\"getTree\"} 200\n"));
+    S9S_VERIFY(text.contains(
+                "s9s_rpc_parse_allocations_total{operation=\"getTree\"} 100"));
+    S9S_VERIFY(text.contains(
+                "{operation=\"getTree\",phase=\"first_byte\"} 0.000000\n"));
+
+    options->m_options.erase("rpc_stats");
+    S9sRpcStats::reset();
+
+    return true;
+}
+
 bool
 UtS9sRpcClient::testGetRunningProcesses()
 {
@@ -1260,6 +1612,26 @@ UtS9sRpcClient::testGetJobLog()
     return true;
 }
 
+bool
+UtS9sRpcClient::testGetLogEntries()
+{
+    S9sRpcClientTester client;
+    S9sVariantMap      payload;
+
+    S9S_VERIFY(client.getLogEntries(1000, 2000, true));
+    S9S_COMPARE(client.uri(0u), "/v2/log/");
+    
+    payload = client.lastPayload();
+    S9S_COMPARE(payload["operation"],  "getLogEntries");
+    S9S_COMPARE(payload["ascending"],  true);
+    S9S_COMPARE(payload["limit"],      1000);
+    S9S_COMPARE(payload["offset"],     2000);
+
+    S9S_VERIFY(payload["request_created"].toString().startsWith("202"));
+
+    return true;
+}
+
 bool
 UtS9sRpcClient::testGetAlarm()
 {
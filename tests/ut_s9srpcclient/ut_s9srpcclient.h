@@ -47,6 +47,10 @@ class UtS9sRpcClient : public S9sUnitTest
         bool testGetSqlStats();
         bool testGetMemStats();
         bool testGetMemoryStats();
+        bool testStatCache();
+        bool testReplyCache();
+        bool testSessionReuse();
+        bool testRpcStats();
         bool testGetRunningProcesses();
         bool testGetJobInstances();
         bool testKillJobInstance();
@@ -71,6 +75,7 @@ class UtS9sRpcClient : public S9sUnitTest
         bool testGetMetaTypeProps();
         bool testGetJobInstance();
         bool testGetJobLog();
+        bool testGetLogEntries();
         bool testGetAlarm();
         bool testGetAlarmStatistics();
         bool testCreateFailJob();
@@ -21,6 +21,7 @@
 
 #include "S9sUser"
 #include "S9sServer"
+#include "S9sController"
 #include <cstdio>
 #include <cstring>
 
@@ -44,6 +45,7 @@ UtS9sServer::runTest(
 
     PERFORM_TEST(testConstruct,   retval);
     PERFORM_TEST(testProperties,  retval);
+    PERFORM_TEST(testController,  retval);
 
     return retval;
 }
@@ -902,10 +904,82 @@ UtS9sServer::testProperties()
     S9S_COMPARE(server.protocol(),  "lxc");
     S9S_COMPARE(server.status(),    "CmonHostOnline");
 
+    /*
+     * The subnets and the templates are accessed through references into the
+     * properties of the server.
+     */
+    S9S_COMPARE(server.nSubnets(),         3);
+    S9S_COMPARE(server.subnetCidr(1),      "10.0.3.1/24");
+    S9S_COMPARE(server.subnetId(2),        "core1-virbr0");
+    S9S_COMPARE(server.subnetVpcId(0),     "vpc-region1");
+    S9S_COMPARE(server.subnetCidr(3),      "");
+    S9S_VERIFY(server.subnet(-1).empty());
+    S9S_VERIFY(&server.subnets() == &server.subnets());
+
+    S9S_COMPARE(server.nTemplates(),       2);
+    S9S_COMPARE(server.templateName(1),    "ubuntu");
+    S9S_COMPARE(server.templateProvider(0), "lxc");
+    S9S_COMPARE(server.templateRegion(0),  "region1");
+    S9S_COMPARE(server.templateName(2),    "");
+    S9S_VERIFY(server.serverTemplate(5).empty());
+
     return true;
 }
 
 
+/**
+ * Testing the health the CLI keeps about the controllers: the back off after
+ * the failed connects and the round trip time.
+ */
+bool
+UtS9sServer::testController()
+{
+    S9sController controller;
+    time_t        now = time(NULL);
+
+    S9S_VERIFY(controller.isAvailable(now));
+    S9S_VERIFY(!controller.isLeader());
+    S9S_COMPARE(controller.retryAfter(), 0);
+
+    controller.setConnectFailed();
+    S9S_VERIFY(controller.connectFailed());
+    S9S_COMPARE(controller.nFailures(), 1);
+    S9S_VERIFY(!controller.isAvailable(now));
+
+    // Not tried in this process, but in the back off period of the failure.
+    controller.setConnectFailed(false);
+    S9S_VERIFY(!controller.isAvailable(now));
+    S9S_VERIFY(controller.isAvailable(controller.failedAt() + 10));
+    
+    controller.setConnectFailed();
+    controller.setConnectFailed();
+    S9S_COMPARE(controller.retryAfter() - controller.failedAt(), 40);
+
+    S9S_VERIFY(controller.isRttChanged(0.2));
+    controller.setConnectSucceeded(10.0);
+    S9S_COMPARE(controller.nFailures(), 0);
+    S9S_VERIFY(controller.isAvailable(now));
+    S9S_COMPARE(controller.rtt(), 10.0);
+    
+    controller.setConnectSucceeded(20.0);
+    S9S_COMPARE(controller.rtt(), 13.0);
+
+    // Jitter on a fast network is not a change, only a big absolute change.
+    S9S_VERIFY(!controller.isRttChanged(16.0));
+    S9S_VERIFY(controller.isRttChanged(20.0));
+    
+    S9sController fast;
+    fast.setConnectSucceeded(0.2);
+    S9S_VERIFY(!fast.isRttChanged(0.9));
+    S9S_VERIFY(!fast.isRttChanged(4.0));
+    S9S_VERIFY(fast.isRttChanged(6.0));
+
+    controller.setLeader();
+    S9S_VERIFY(controller.isLeader());
+
+    return true;
+}
+
 S9S_UNIT_TEST_MAIN(UtS9sServer)
 
 
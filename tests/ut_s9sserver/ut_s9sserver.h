@@ -30,6 +30,7 @@ class UtS9sServer : public S9sUnitTest
     protected:
         bool testConstruct();
         bool testProperties();
+        bool testController();
 };
 
 
@@ -0,0 +1,156 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2016  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Foobar is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Foobar. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ut_s9sstatframe.h"
+
+#include "S9sStatFrame"
+
+#include <math.h>
+
+#define DEBUG
+#define WARNING
+#include "s9sdebug.h"
+
+UtS9sStatFrame::UtS9sStatFrame()
+{
+}
+
+UtS9sStatFrame::~UtS9sStatFrame()
+{
+}
+
+bool
+UtS9sStatFrame::runTest(
+        const char *testName)
+{
+    bool retval = true;
+
+    PERFORM_TEST(testAddSamples,  retval);
+    PERFORM_TEST(testSampleKey,   retval);
+
+    return retval;
+}
+
+/**
+ * Testing the S9sStatFrame with a few CPU samples, one of them is an older
+ * sample of the same core that should be dropped.
+ */
+bool
+UtS9sStatFrame::testAddSamples()
+{
+    S9sVariantList samples;
+    S9sVariantMap  old;
+    S9sStatFrame   frame;
+    S9sStatFrame   hosts;
+
+    for (int hostId = 1; hostId <= 2; ++hostId)
+    {
+        for (int cpuId = 0; cpuId < 3; ++cpuId)
+        {
+            S9sVariantMap sample;
+            S9sString     key;
+
+            key.sprintf("CmonCpuStats-%d-%d", hostId, cpuId);
+            sample["samplekey"] = key;
+            sample["created"]   = 100;
+            sample["hostid"]    = hostId;
+            sample["cpuid"]     = cpuId;
+            sample["user"]      = 0.1 * (hostId * 3 + cpuId);
+            sample["idle"]      = 0.5;
+
+            samples << sample;
+        }
+    }
+
+    // An older sample that should not be used.
+    old["samplekey"] = "CmonCpuStats-1-0";
+    old["created"]   = 50;
+    old["hostid"]    = 1;
+    old["cpuid"]     = 0;
+    old["user"]      = 10.0;
+    samples << old;
+
+    frame.addSamples(samples);
+    S9S_COMPARE((int) frame.nRows(),  6);
+    S9S_COMPARE((int) frame.nHosts(), 2);
+    S9S_VERIFY(fabs(frame.sum(S9sStatFrame::User) - 3.3) < 0.0001);
+    S9S_VERIFY(fabs(frame.average(S9sStatFrame::Idle) - 0.5) < 0.0001);
+    S9S_VERIFY(fabs(frame.min(S9sStatFrame::User) - 0.3) < 0.0001);
+    S9S_VERIFY(fabs(frame.max(S9sStatFrame::User) - 0.8) < 0.0001);
+    S9S_VERIFY(fabs(frame.percentile(S9sStatFrame::User, 50) - 0.5) < 0.0001);
+
+    // The rows are in the order of the sample keys.
+    S9S_COMPARE(frame.hostId(0), 1);
+    S9S_COMPARE(frame.cpuId(2),  2);
+
+    // The older sample is not accepted, the newer replaces the row.
+    S9S_VERIFY(!frame.addSample(old));
+    old["created"] = 200;
+    S9S_VERIFY(frame.addSample(old));
+    S9S_COMPARE((int) frame.nRows(), 6);
+    S9S_VERIFY(fabs(frame.max(S9sStatFrame::User) - 10.0) < 0.0001);
+
+    hosts = frame.hostRollup();
+    S9S_COMPARE((int) hosts.nRows(), 2);
+    S9S_VERIFY(fabs(hosts.value(S9sStatFrame::User, 1) - 0.7) < 0.0001);
+
+    frame.removeHost(1);
+    S9S_COMPARE((int) frame.nRows(),  3);
+    S9S_COMPARE((int) frame.nHosts(), 1);
+    S9S_COMPARE(frame.hostId(0), 2);
+
+    return true;
+}
+
+/**
+ * The samples without a sample key are not stored, neither one by one nor in a
+ * list of samples.
+ */
+bool
+UtS9sStatFrame::testSampleKey()
+{
+    S9sVariantList samples;
+    S9sVariantMap  sample;
+    S9sStatFrame   frame;
+
+    sample["created"] = 100;
+    sample["hostid"]  = 1;
+    sample["cpuid"]   = 0;
+    sample["user"]    = 0.5;
+
+    S9S_VERIFY(!frame.addSample(sample));
+    S9S_COMPARE((int) frame.nRows(),  0);
+    S9S_COMPARE((int) frame.nHosts(), 0);
+
+    samples << sample;
+    sample["hostid"] = 2;
+    samples << sample;
+    frame.addSamples(samples);
+    S9S_COMPARE((int) frame.nRows(), 0);
+
+    // The same sample with a key is stored.
+    sample["samplekey"] = "CmonCpuStats-2-0";
+    S9S_VERIFY(frame.addSample(sample));
+    S9S_COMPARE((int) frame.nRows(), 1);
+    S9S_COMPARE(frame.hostId(0), 2);
+
+    return true;
+}
+
+S9S_UNIT_TEST_MAIN(UtS9sStatFrame)
@@ -26,6 +26,7 @@
 #include "S9sVariantList"
 #include "S9sFormat"
 #include "S9sOptions"
+#include "S9sTextBuffer"
 
 //#define DEBUG
 #include "s9sdebug.h"
@@ -58,6 +59,8 @@ UtS9sString::runTest(const char *testName)
     PERFORM_TEST(testSplit,         retval);
     PERFORM_TEST(testSizeString,    retval);
     PERFORM_TEST(testMilliseconds,  retval);
+    PERFORM_TEST(testTextBuffer,    retval);
+    PERFORM_TEST(testDisplayWidth,  retval);
 
     return retval;
 }
@@ -426,5 +429,119 @@ UtS9sString::testMilliseconds()
     return true;
 }
 
+/**
+ * Editing the lines of the text buffer and checking that the text built
+ * incrementally is the same as the one built from scratch.
+ */
+bool
+UtS9sString::testTextBuffer()
+{
+    S9sTextBuffer buffer;
+    S9sString     expected;
+
+    buffer.setText("one\ntwo\nthree");
+    S9S_COMPARE(buffer.nLines(),   3);
+    S9S_COMPARE(buffer.line(1),    "two");
+    S9S_COMPARE(buffer.text(),     "one\ntwo\nthree\n");
+    S9S_COMPARE((int) buffer.offset(2), 8);
+    S9S_VERIFY(!buffer.isModified());
+
+    buffer.setLine(1, "TWO!");
+    S9S_VERIFY(buffer.isModified());
+    S9S_COMPARE((int) buffer.offset(2, 1), 10);
+    S9S_COMPARE(buffer.text(),       "one\nTWO!\nthree\n");
+
+    buffer.insertLine(1, "inserted");
+    buffer.insertLine(2, "again");
+    buffer.removeLine(0);
+    S9S_COMPARE(buffer.text(), "inserted\nagain\nTWO!\nthree\n");
+
+    buffer.appendLine("last");
+    buffer.setLine(0, "");
+    S9S_COMPARE(buffer.text(),   "\nagain\nTWO!\nthree\nlast\n");
+    S9S_COMPARE((int) buffer.length(), (int) buffer.text().length());
+    
+    /*
+     * Many lines, edits scattered all over the document.
+     */
+    buffer.clear();
+    for (int idx = 0; idx < 1000; ++idx)
+    {
+        S9sString line;
+
+        line.sprintf("line %d", idx);
+        buffer.appendLine(line);
+    }
+
+    for (int idx = 0; idx < 1000; idx += 7)
+    {
+        buffer.insertLine(idx, "x");
+        buffer.setLine(999 - idx, "y");
+        
+        if (idx % 3 == 0)
+            buffer.removeLine(idx / 2);
+        
+        if (idx % 5 == 0)
+            buffer.text();
+
+        // Keeping the tree valid, so it is updated on the edits.
+        buffer.offset(idx);
+    }
+
+    for (int idx = 0; idx < buffer.nLines(); ++idx)
+    {
+        S9S_COMPARE((int) buffer.offset(idx), (int) expected.length());
+        expected += buffer.line(idx);
+        expected += "\n";
+    }
+
+    S9S_COMPARE(buffer.text(),   expected);
+    S9S_COMPARE((int) buffer.length(), (int) expected.length());
+    S9S_COMPARE((int) buffer.offset(buffer.nLines()), (int) expected.length());
+
+    return true;
+}
+
+/**
+ * Testing the display width and the ellipsize() with colors and UTF-8
+ * characters.
+ */
+bool
+UtS9sString::testDisplayWidth()
+{
+    S9sString string1;
+
+    S9S_COMPARE(S9sString("").displayWidth(), 0);
+    S9S_COMPARE(S9sString("plain text").displayWidth(), 10);
+    S9S_COMPARE(S9sString("\033[1;31mred\033[0m").displayWidth(), 3);
+    S9S_COMPARE(S9sString("\033]0;title\007ok").displayWidth(), 2);
+    S9S_COMPARE(S9sString("dots…").displayWidth(), 5);
+    S9S_COMPARE(S9sString("árvíztűrő").displayWidth(), 9);
+    S9S_COMPARE(S9sString("e\xcc\x81").displayWidth(), 1);
+    S9S_COMPARE(S9sString("日本語").displayWidth(), 6);
+    S9S_COMPARE(S9sString("\xff\xfe").displayWidth(), 2);
+
+    string1 = "short";
+    string1.ellipsize(10);
+    S9S_COMPARE(string1, "short");
+
+    string1 = "a long string";
+    string1.ellipsize(6);
+    S9S_COMPARE(string1, "a lon…");
+    S9S_COMPARE(string1.displayWidth(), 6);
+
+    string1 = "\033[32mgreen text\033[0m";
+    string1.ellipsize(6);
+    S9S_COMPARE(string1, "\033[32mgreen…\033[0m");
+    S9S_COMPARE(string1.displayWidth(), 6);
+
+    string1 = "日本語テキスト";
+    string1.ellipsize(6);
+    S9S_COMPARE(string1, "日本…");
+    S9S_COMPARE(string1.displayWidth(), 5);
+
+    return true;
+}
+
 S9S_UNIT_TEST_MAIN(UtS9sString)
 
@@ -41,5 +41,7 @@ class UtS9sString : public S9sUnitTest
         bool testSplit();
         bool testSizeString();
         bool testMilliseconds();
+        bool testTextBuffer();
+        bool testDisplayWidth();
 };
 
@@ -0,0 +1,300 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2016  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Foobar is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Foobar. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ut_s9stopui.h"
+
+#include "S9sTopUi"
+#include "S9sRpcClient"
+#include "S9sEvent"
+
+#include <cstdio>
+
+#define DEBUG
+#define WARNING
+#include "s9sdebug.h"
+
+/**
+ * \returns A CPU statistics sample as the controller sends it in the
+ *   measurement events.
+ */
+static S9sVariantMap
+cpuSample(
+        const int    hostId,
+        const int    cpuId,
+        const double idle)
+{
+    S9sVariantMap sample;
+    S9sString     key;
+
+    key.sprintf("cpu-%d-%d", hostId, cpuId);
+
+    sample["class_name"] = "CmonCpuStats";
+    sample["samplekey"]  = key;
+    sample["hostid"]     = hostId;
+    sample["cpuid"]      = cpuId;
+    sample["created"]    = 1000;
+    sample["idle"]       = idle;
+
+    return sample;
+}
+
+/**
+ * \returns A process list that holds one process for every PID.
+ */
+static S9sVariantList
+processList(
+        const int firstPid,
+        const int nProcesses)
+{
+    S9sVariantList retval;
+
+    for (int idx = 0; idx < nProcesses; ++idx)
+    {
+        S9sVariantMap process;
+
+        process["class_name"] = "CmonProcess";
+        process["pid"]        = firstPid + idx;
+        process["executable"] = "mysqld";
+        retval << process;
+    }
+
+    return retval;
+}
+
+/**
+ * \returns A process list sample for the processMeasurement() method.
+ */
+static S9sVariantMap
+processSample(
+        const int firstPid,
+        const int nProcesses)
+{
+    S9sVariantMap sample;
+
+    sample["class_name"] = "CmonProcessList";
+    sample["processes"]  = processList(firstPid, nProcesses);
+
+    return sample;
+}
+
+UtS9sTopUi::UtS9sTopUi()
+{
+    S9S_DEBUG("");
+    setlocale(LC_NUMERIC, getenv("C"));
+    setlocale(LC_ALL,     getenv("C"));
+}
+
+UtS9sTopUi::~UtS9sTopUi()
+{
+}
+
+bool
+UtS9sTopUi::runTest(
+        const char *testName)
+{
+    bool retval = true;
+
+    PERFORM_TEST(testProcessMeasurement,   retval);
+    PERFORM_TEST(testProcessHostRemoved,   retval);
+    PERFORM_TEST(testProcessEvent,         retval);
+
+    return retval;
+}
+
+/**
+ * The measurements update the statistics and replace the processes of the host
+ * that sent them, the processes of the other hosts are kept.
+ */
+bool
+UtS9sTopUi::testProcessMeasurement()
+{
+    S9sRpcClient  client;
+    S9sTopUi      ui(client);
+    S9sVariantMap memorySample;
+
+    // Samples without a class name are ignored.
+    ui.processMeasurement("host1", S9sVariantMap());
+    S9S_COMPARE((int) ui.m_cpuStats.nRows(), 0);
+    S9S_VERIFY(!ui.m_processEvents);
+
+    ui.processMeasurement("host1", cpuSample(1, 0, 90.0));
+    ui.processMeasurement("host1", cpuSample(1, 1, 80.0));
+    ui.processMeasurement("host2", cpuSample(2, 0, 70.0));
+    S9S_COMPARE((int) ui.m_cpuStats.nRows(),  3);
+    S9S_COMPARE((int) ui.m_cpuStats.nHosts(), 2);
+    
+    memorySample["class_name"] = "CmonMemoryStats";
+    memorySample["samplekey"]  = "memory-1";
+    memorySample["hostid"]     = 1;
+    memorySample["created"]    = 1000;
+    ui.processMeasurement("host1", memorySample);
+    S9S_COMPARE((int) ui.m_memoryStats.nRows(), 1);
+    S9S_COMPARE((int) ui.m_cpuStats.nRows(),    3);
+
+    // The process list needs the name of the host.
+    ui.processMeasurement("", processSample(100, 2));
+    S9S_COMPARE((int) ui.m_processes.size(), 0);
+    S9S_VERIFY(!ui.m_processEvents);
+
+    ui.processMeasurement("host1", processSample(100, 2));
+    ui.processMeasurement("host2", processSample(200, 3));
+    S9S_COMPARE((int) ui.m_processes.size(), 5);
+    S9S_VERIFY(ui.m_processEvents);
+
+    // A new list from host1 replaces the old one of host1 only.
+    ui.processMeasurement("host1", processSample(300, 1));
+    S9S_COMPARE((int) ui.m_processes.size(), 4);
+    for (uint idx = 0u; idx < ui.m_processes.size(); ++idx)
+    {
+        const S9sProcess &process = ui.m_processes[idx];
+
+        if (process.hostName() == "host1")
+        {
+            S9S_COMPARE(process.pid(), 300);
+        } else {
+            S9S_COMPARE(process.hostName(), "host2");
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Removing a host drops its statistics and its processes.
+ */
+bool
+UtS9sTopUi::testProcessHostRemoved()
+{
+    S9sRpcClient  client;
+    S9sTopUi      ui(client);
+
+    ui.processMeasurement("host1", cpuSample(1, 0, 90.0));
+    ui.processMeasurement("host1", cpuSample(1, 1, 80.0));
+    ui.processMeasurement("host2", cpuSample(2, 0, 70.0));
+    ui.processMeasurement("host1", processSample(100, 2));
+    ui.processMeasurement("host2", processSample(200, 3));
+
+    // A host we don't know about changes nothing.
+    ui.processHostRemoved(3, "host3");
+    S9S_COMPARE((int) ui.m_cpuStats.nRows(),  3);
+    S9S_COMPARE((int) ui.m_processes.size(),  5);
+
+    ui.processHostRemoved(1, "host1");
+    S9S_COMPARE((int) ui.m_cpuStats.nRows(),  1);
+    S9S_COMPARE(ui.m_cpuStats.hostId(0), 2);
+    S9S_COMPARE((int) ui.m_processes.size(),  3);
+    for (uint idx = 0u; idx < ui.m_processes.size(); ++idx)
+        S9S_COMPARE(ui.m_processes[idx].hostName(), "host2");
+
+    return true;
+}
+
+/**
+ * The events are ignored before the first full load and when they belong to
+ * some other cluster, the measurement, the host removed and the cluster events
+ * are applied.
+ */
+bool
+UtS9sTopUi::testProcessEvent()
+{
+    S9sRpcClient    client;
+    S9sTopUi        ui(client);
+    S9sVariantMap   properties;
+    S9sVariantMap   specifics;
+    S9sVariantMap   host;
+    S9sVariantMap   cluster;
+    S9sVariantList  measurements;
+    S9sEvent        event;
+
+    ui.m_clusterId = 1;
+    
+    measurements << cpuSample(1, 0, 90.0);
+    measurements << cpuSample(1, 1, 80.0);
+
+    specifics["cluster_id"]   = 1;
+    specifics["host_name"]    = "host1";
+    specifics["measurements"] = measurements;
+    specifics["processes"]    = processList(100, 2);
+
+    properties["event_class"]     = "EventHost";
+    properties["event_name"]      = "Measurements";
+    properties["event_specifics"] = specifics;
+    event = S9sEvent(properties);
+
+    // Nothing is updated before the first reply.
+    ui.processEvent(event);
+    S9S_COMPARE(ui.m_nEvents, 0);
+    S9S_COMPARE((int) ui.m_cpuStats.nRows(), 0);
+
+    ui.m_nReplies = 1;
+    ui.processEvent(event);
+    S9S_COMPARE(ui.m_nEvents, 1);
+    S9S_COMPARE((int) ui.m_cpuStats.nRows(),  2);
+    S9S_COMPARE((int) ui.m_processes.size(),  2);
+    S9S_COMPARE(ui.m_processes[0].hostName(), "host1");
+    S9S_VERIFY(ui.m_processEvents);
+
+    // The events of the other clusters are ignored.
+    specifics["cluster_id"]       = 2;
+    specifics["host_name"]        = "host2";
+    properties["event_specifics"] = specifics;
+    event = S9sEvent(properties);
+
+    ui.processEvent(event);
+    S9S_COMPARE(ui.m_nEvents, 1);
+    S9S_COMPARE((int) ui.m_processes.size(), 2);
+    
+    // The host is removed.
+    host["class_name"] = "CmonMySqlHost";
+    host["hostId"]     = 1;
+    host["hostname"]   = "host1";
+
+    specifics = S9sVariantMap();
+    specifics["cluster_id"]       = 1;
+    specifics["host"]             = host;
+    properties["event_name"]      = "Destroyed";
+    properties["event_specifics"] = specifics;
+    event = S9sEvent(properties);
+
+    ui.processEvent(event);
+    S9S_COMPARE(ui.m_nEvents, 2);
+    S9S_COMPARE((int) ui.m_cpuStats.nRows(), 0);
+    S9S_COMPARE((int) ui.m_processes.size(), 0);
+
+    // The cluster changed.
+    cluster["class_name"]   = "CmonClusterInfo";
+    cluster["cluster_id"]   = 1;
+    cluster["cluster_name"] = "ft_galera";
+
+    specifics = S9sVariantMap();
+    specifics["cluster_id"]       = 1;
+    specifics["cluster"]          = cluster;
+    properties["event_class"]     = "EventCluster";
+    properties["event_name"]      = "Changed";
+    properties["event_specifics"] = specifics;
+    event = S9sEvent(properties);
+
+    ui.processEvent(event);
+    S9S_COMPARE(ui.m_nEvents, 3);
+    S9S_COMPARE(ui.m_clusterName, "ft_galera");
+
+    return true;
+}
+
+S9S_UNIT_TEST_MAIN(UtS9sTopUi)
@@ -50,6 +50,7 @@ UtS9sVariant::runTest(const char *testName)
     PERFORM_TEST(testToULongLong, retval);
     PERFORM_TEST(testOperators01, retval);
     PERFORM_TEST(testEqual,       retval);
+    PERFORM_TEST(testShared,      retval);
 
     return retval;
 }
@@ -304,5 +305,45 @@ UtS9sVariant::testEqual()
     return true;
 }
 
+/**
+ * The maps and lists in the variants are shared between the copies, this test
+ * checks that modifying a copy does not change the original.
+ */
+bool
+UtS9sVariant::testShared()
+{
+    S9sVariantMap  host;
+    S9sVariantList hosts;
+    S9sVariant     reply;
+    S9sVariant     copy;
+
+    host["hostname"] = "192.168.0.1";
+    host["port"]     = 3306;
+    hosts << host;
+    reply["hosts"]   = hosts;
+    
+    copy = reply;
+    S9S_VERIFY(&copy.toVariantMap() == &reply.toVariantMap());
+    
+    // Changing the copy makes a copy of the outer map only.
+    copy["cluster_id"] = 1;
+    S9S_VERIFY(&copy.toVariantMap() != &reply.toVariantMap());
+    S9S_VERIFY(
+            &copy["hosts"].toVariantList() ==
+            &reply["hosts"].toVariantList());
+    S9S_VERIFY(!reply.contains("cluster_id"));
+
+    copy["hosts"][0]["port"] = 3307;
+    S9S_COMPARE(copy["hosts"][0]["port"].toInt(), 3307);
+    S9S_COMPARE(reply["hosts"][0]["port"].toInt(), 3306);
+    S9S_COMPARE(reply["hosts"][0]["hostname"], "192.168.0.1");
+
+    copy = reply;
+    reply.clear();
+    S9S_COMPARE(copy["hosts"][0]["port"].toInt(), 3306);
+
+    return true;
+}
+
 S9S_UNIT_TEST_MAIN(UtS9sVariant)
 
@@ -36,6 +36,7 @@ class UtS9sVariant : public S9sUnitTest
         bool testToULongLong();
         bool testOperators01();
         bool testEqual();
+        bool testShared();
 };
 
 
@@ -20,11 +20,50 @@
 #include "ut_s9svariantmap.h"
 
 #include "S9sVariantMap"
+#include "S9sVariantList"
+#include "S9sSortKeys"
+#include "S9sStateStore"
+#include "S9sFile"
+
+#include <cstdlib>
+#include <new>
+#include <time.h>
 
 //#define DEBUG
 #define WARNING
 #include "s9sdebug.h"
 
+/*
+ * The global allocator is replaced in this test program so that we can count
+ * how many times the JSON parser calls it.
+ */
+static ulonglong sm_nAllocations   = 0ull;
+static ulonglong sm_nDeallocations = 0ull;
+
+void *
+operator new(
+        size_t size)
+{
+    void *retval = malloc(size == 0 ? 1 : size);
+
+    if (retval == NULL)
+        throw std::bad_alloc();
+
+    ++sm_nAllocations;
+    return retval;
+}
+
+void
+operator delete(
+        void *ptr) noexcept
+{
+    if (ptr == NULL)
+        return;
+
+    ++sm_nDeallocations;
+    free(ptr);
+}
+
 UtS9sVariantMap::UtS9sVariantMap()
 {
     S9S_DEBUG("");
@@ -49,7 +88,10 @@ UtS9sVariantMap::runTest(
     PERFORM_TEST(testParser03,      retval);
     PERFORM_TEST(testParser04,      retval);
     PERFORM_TEST(testParser05,      retval);
+    PERFORM_TEST(testParserAllocations, retval);
     PERFORM_TEST(testAssignments01, retval);
+    PERFORM_TEST(testSortKeys,      retval);
+    PERFORM_TEST(testStateStore,    retval);
 
     return retval;
 }
@@ -285,6 +327,89 @@ UtS9sVariantMap::testParser05()
     return true;
 }
 
+/**
+ * Parsing some captured controller replies and counting the allocations the
+ * parser makes. All the memory should be released when the parsed map is
+ * destroyed and the temporary values of the parser should not show up here,
+ * they are all allocated in the arena of the parse context.
+ */
+bool
+UtS9sVariantMap::testParserAllocations()
+{
+    const char *fileNames[] = 
+    {
+        "../request-examples/Ok-getTree-rep.json",
+        "../request-examples/Ok-getAllClusterInfo-rep.json",
+        "../request-examples/Ok-getClusterInfo-rep.json",
+        NULL
+    };
+    const int   nRounds = 20;
+
+    for (int idx = 0; fileNames[idx] != NULL; ++idx)
+    {
+        S9sFile         file(fileNames[idx]);
+        S9sString       content;
+        ulonglong       nAllocations;
+        ulonglong       nDeallocations;
+        struct timespec start, end;
+        double          elapsed;
+        bool            success;
+
+        success = file.readTxtFile(content);
+        S9S_VERIFY(success);
+
+        nAllocations   = sm_nAllocations;
+        nDeallocations = sm_nDeallocations;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        for (int round = 0; round < nRounds; ++round)
+        {
+            S9sVariantMap theMap;
+
+            success = theMap.parse(STR(content));
+            S9S_VERIFY(success);
+            S9S_COMPARE(theMap["request_status"], "Ok");
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        elapsed  = (end.tv_sec - start.tv_sec) * 1000000.0;
+        elapsed += (end.tv_nsec - start.tv_nsec) / 1000.0;
+
+        nAllocations   = sm_nAllocations - nAllocations;
+        nDeallocations = sm_nDeallocations - nDeallocations;
+
+        // Everything the parser allocated is released.
+        S9S_VERIFY(nAllocations > 0ull);
+        S9S_COMPARE(nAllocations, nDeallocations);
+
+        if (isVerbose())
+        {
+            printf("\n%s\n", fileNames[idx]);
+            printf("  %6u bytes\n", (uint) content.length());
+            printf("  %6llu allocations/parse\n", nAllocations / nRounds);
+            printf("  %8.1f us/parse\n", elapsed / nRounds);
+        }
+    }
+
+    /*
+     * A few values from the parsed replies, so we know the move semantics are
+     * not losing anything.
+     */
+    S9sFile       file("../request-examples/Ok-getClusterInfo-rep.json");
+    S9sString     content;
+    S9sVariantMap theMap;
+
+    S9S_VERIFY(file.readTxtFile(content));
+    S9S_VERIFY(theMap.parse(STR(content)));
+
+    S9S_COMPARE(
+            theMap["cluster"]["cluster_name"].toString(), "ft_scripts_6683");
+    S9S_COMPARE(theMap["cluster"]["hosts"].size(), 2);
+    S9S_COMPARE(theMap["request_user_id"], 4);
+
+    return true;
+}
+
 bool
 UtS9sVariantMap::testAssignments01()
 {
@@ -310,6 +435,98 @@ UtS9sVariantMap::testAssignments01()
     return true;
 }
 
+/**
+ * Sorting a list of maps using the S9sSortKeys, the full and the partial sort.
+ */
+bool
+UtS9sVariantMap::testSortKeys()
+{
+    S9sVariantList      list;
+    S9sSortKeys<double> sortKeys;
+    double              usages[] = { 5.0, 70.5, 0.0, 12.0, 70.5, 3.25 };
+
+    for (uint idx = 0u; idx < sizeof(usages) / sizeof(double); ++idx)
+    {
+        S9sVariantMap process;
+
+        process["pid"]       = (int) idx;
+        process["cpu_usage"] = usages[idx];
+        
+        sortKeys.add(process["cpu_usage"].toDouble(), list.size());
+        list << process;
+    }
+
+    sortKeys.sort(true, 3);
+    S9S_COMPARE(sortKeys.size(), 6);
+    S9S_COMPARE(list[sortKeys.index(0)]["pid"], 1);
+    S9S_COMPARE(list[sortKeys.index(1)]["pid"], 4);
+    S9S_COMPARE(list[sortKeys.index(2)]["pid"], 3);
+
+    sortKeys.sort();
+    S9S_COMPARE(list[sortKeys.index(0)]["pid"], 2);
+    S9S_COMPARE(list[sortKeys.index(1)]["pid"], 5);
+    S9S_COMPARE(list[sortKeys.index(5)]["pid"], 4);
+
+    return true;
+}
+
+/**
+ * Applying property changes and deletes to the state store and checking the
+ * versions of the objects.
+ */
+bool
+UtS9sVariantMap::testStateStore()
+{
+    S9sStateStore  store;
+    S9sVariantMap  host;
+    ulonglong      version;
+
+    host["hostname"]    = "192.168.0.1";
+    host["hoststatus"]  = "CmonHostOnline";
+    host["port"]        = 3306;
+
+    S9S_VERIFY(store.apply(1, host));
+    host["hostname"]    = "192.168.0.2";
+    S9S_VERIFY(store.apply(2, host));
+    S9S_COMPARE((int) store.size(), 2);
+    S9S_VERIFY(store.version(1) < store.version(2));
+
+    // Applying the same properties again is not a change.
+    version = store.version();
+    S9S_VERIFY(!store.apply(2, host));
+    S9S_VERIFY(store.version() == version);
+
+    // Only the changed objects get a new version.
+    host["hostname"]    = "192.168.0.1";
+    host["hoststatus"]  = "CmonHostOffLine";
+    S9S_VERIFY(store.apply(1, host));
+    S9S_COMPARE(store.properties(1).at("hoststatus"), "CmonHostOffLine");
+    S9S_COMPARE(store.properties(1).at("port"), 3306);
+    S9S_COMPARE((int) store.changedSince(version).size(), 1);
+    S9S_COMPARE(store.changedSince(version)[0], 1);
+
+    // The properties that are not in the object any more are removed.
+    version = store.version();
+    host.erase("port");
+    S9S_VERIFY(store.apply(1, host));
+    S9S_VERIFY(!store.properties(1).contains("port"));
+    S9S_COMPARE((int) store.properties(1).size(), 2);
+    S9S_VERIFY(store.version(1) > version);
+    S9S_VERIFY(!store.apply(1, host));
+
+    // The deleted objects are gone.
+    version = store.version();
+    S9S_VERIFY(store.remove(2));
+    S9S_VERIFY(!store.remove(2));
+    S9S_VERIFY(!store.contains(2));
+    S9S_VERIFY(store.version() > version);
+    S9S_VERIFY(store.version(2) == 0ull);
+    S9S_VERIFY(store.properties(2).empty());
+    S9S_COMPARE((int) store.ids().size(), 1);
+
+    return true;
+}
+
 S9S_UNIT_TEST_MAIN(UtS9sVariantMap)
 
 
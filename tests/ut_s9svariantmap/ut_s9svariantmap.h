@@ -36,6 +36,9 @@ class UtS9sVariantMap : public S9sUnitTest
         bool testParser03();
         bool testParser04();
         bool testParser05();
+        bool testParserAllocations();
         bool testAssignments01();
+        bool testSortKeys();
+        bool testStateStore();
 };
 